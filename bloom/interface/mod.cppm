@@ -18,11 +18,33 @@ namespace bloom {
     public:
         struct Config {
             bool useAMDShaderImageLoadStoreLod = false;
+
+            /**
+             * @brief Whether the device has <tt>vulkanMemoryModel</tt> feature enabled. If <tt>true</tt>, all mip
+             * levels are downsampled by a single dispatch whose workgroups are synchronized by the scoped atomic.
+             * Otherwise, the mip levels after 6 are downsampled by the second dispatch.
+             */
+            bool useVulkanMemoryModel = false;
         };
 
-        using DescriptorSetLayout = vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage>;
+        /**
+         * @brief Descriptor set layout of the pipelines.
+         *
+         * - Binding 0: combined image sampler of the whole mip levels.
+         * - Binding 1: storage image of the whole mip levels (if <tt>Config::useAMDShaderImageLoadStoreLod</tt> is
+         *   <tt>true</tt>) or storage images of each mip level.
+         * - Binding 2: storage buffer of <tt>std::uint32_t</tt> atomic counters, one per array layer, which must be
+         *   zero-initialized before the first use. Downsample pass resets the counters to zero after its use, so the
+         *   buffer can be reused without clearing. Unused if <tt>Config::useVulkanMemoryModel</tt> is <tt>false</tt>.
+         */
+        using DescriptorSetLayout = vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage, vk::DescriptorType::eStorageBuffer>;
 
+        /**
+         * @brief Image format that must be used for the bloom image, as it is read by storage image load.
+         */
+        static constexpr vk::Format requiredImageFormat = vk::Format::eR16G16B16A16Sfloat;
         static constexpr vk::ImageUsageFlags requiredImageUsageFlags = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage;
+        static constexpr vk::BufferUsageFlags requiredCounterBufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer;
 
         DescriptorSetLayout descriptorSetLayout;
 
@@ -33,7 +55,47 @@ namespace bloom {
             }
         );
 
+        /**
+         * @brief Record the bloom calculation commands to \p computeCommandBuffer.
+         *
+         * All mip levels are downsampled from the mip level 0 by a single dispatch (two if
+         * <tt>Config::useVulkanMemoryModel</tt> is <tt>false</tt>), and then upsampled to \p resultMipLevel by a
+         * dispatch per mip level. Therefore, the number of pipeline barriers is <tt>imageMipLevels - resultMipLevel - 1</tt>
+         * (plus one for the second downsample dispatch), instead of twice of the mip level count.
+         *
+         * @param computeCommandBuffer Command buffer to record the commands.
+         * @param descriptorSet Descriptor set that is updated with the image and counter buffer.
+         * @param imageExtent Extent of the mip level 0.
+         * @param imageMipLevels Mip level count of the image.
+         * @param imageArrayLayers Array layer count of the image.
+         * @param resultMipLevel Mip level that the bloom result is accumulated. If it is 1, upsampling to the mip level 0
+         * is skipped and the mip level 0 remains as the input, therefore the consumer must upsample the mip level 1 by
+         * itself and add it to the mip level 0.
+         * @pre Whole mip levels of the image must be in <tt>vk::ImageLayout::eGeneral</tt> layout.
+         * @pre \p resultMipLevel must be less than \p imageMipLevels.
+         */
         void compute(
+            vk::CommandBuffer computeCommandBuffer,
+            vku::DescriptorSet<DescriptorSetLayout> descriptorSet,
+            const vk::Extent2D &imageExtent,
+            std::uint32_t imageMipLevels,
+            std::uint32_t imageArrayLayers,
+            std::uint32_t resultMipLevel = 0
+        ) const;
+
+        /**
+         * @brief Record the commands that generate the mip levels <tt>[1, imageMipLevels)</tt> from the mip level 0 by
+         * a single dispatch (two if <tt>Config::useVulkanMemoryModel</tt> is <tt>false</tt>), without upsampling. It
+         * can be used for making a mip chain of an image that is not for bloom.
+         *
+         * @param computeCommandBuffer Command buffer to record the commands.
+         * @param descriptorSet Descriptor set that is updated with the image and counter buffer.
+         * @param imageExtent Extent of the mip level 0.
+         * @param imageMipLevels Mip level count of the image.
+         * @param imageArrayLayers Array layer count of the image.
+         * @pre Whole mip levels of the image must be in <tt>vk::ImageLayout::eGeneral</tt> layout.
+         */
+        void downsample(
             vk::CommandBuffer computeCommandBuffer,
             vku::DescriptorSet<DescriptorSetLayout> descriptorSet,
             const vk::Extent2D &imageExtent,
@@ -44,6 +106,10 @@ namespace bloom {
     private:
         struct PushConstant;
 
+        /// Number of mip levels that are generated by a workgroup of the downsample pass, excluding the mip level 0.
+        static constexpr std::uint32_t workgroupMipLevels = 6;
+
+        bool useVulkanMemoryModel;
         vk::raii::PipelineLayout pipelineLayout;
         vk::raii::Pipeline downsamplePipeline;
         vk::raii::Pipeline upsamplePipeline;
@@ -55,8 +121,8 @@ module :private;
 #endif
 
 struct bloom::BloomComputePipeline::PushConstant {
+    std::int32_t mipLevels;
     std::int32_t srcMipLevel;
-    std::int32_t dstMipLevel;
 };
 
 bloom::BloomComputePipeline::BloomComputePipeline(
@@ -74,8 +140,10 @@ bloom::BloomComputePipeline::BloomComputePipeline(
             DescriptorSetLayout::getCreateInfoBinding<0>(vk::ShaderStageFlagBits::eCompute, *linearSampler),
             // TODO: use variable descriptor count or partially bounding
             DescriptorSetLayout::getCreateInfoBinding<1>(config.useAMDShaderImageLoadStoreLod ? 1U : 16U, vk::ShaderStageFlagBits::eCompute),
+            DescriptorSetLayout::getCreateInfoBinding<2>(1, vk::ShaderStageFlagBits::eCompute),
         }),
     } },
+    useVulkanMemoryModel { config.useVulkanMemoryModel },
     pipelineLayout { device, vk::PipelineLayoutCreateInfo {
         {},
         *descriptorSetLayout,
@@ -91,9 +159,14 @@ bloom::BloomComputePipeline::BloomComputePipeline(
             vk::ShaderStageFlagBits::eCompute,
             *vku::lvalue(vk::raii::ShaderModule { device, vk::ShaderModuleCreateInfo {
                 {},
-                vku::lvalue(config.useAMDShaderImageLoadStoreLod
-                    ? std::span<const std::uint32_t> { shader::downsample_comp<1> }
-                    : std::span<const std::uint32_t> { shader::downsample_comp<0> }),
+                vku::lvalue([&] -> std::span<const std::uint32_t> {
+                    if (config.useAMDShaderImageLoadStoreLod) {
+                        if (config.useVulkanMemoryModel) return shader::downsample_comp<1, 1>;
+                        return shader::downsample_comp<1, 0>;
+                    }
+                    if (config.useVulkanMemoryModel) return shader::downsample_comp<0, 1>;
+                    return shader::downsample_comp<0, 0>;
+                }()),
             } }),
             "main",
         },
@@ -115,37 +188,36 @@ bloom::BloomComputePipeline::BloomComputePipeline(
         *pipelineLayout,
     } } { }
 
-void bloom::BloomComputePipeline::compute(vk::CommandBuffer computeCommandBuffer, vku::DescriptorSet<DescriptorSetLayout> descriptorSet, const vk::Extent2D &imageExtent, std::uint32_t imageMipLevels, std::uint32_t imageArrayLayers) const {
+void bloom::BloomComputePipeline::compute(
+    vk::CommandBuffer computeCommandBuffer,
+    vku::DescriptorSet<DescriptorSetLayout> descriptorSet,
+    const vk::Extent2D &imageExtent,
+    std::uint32_t imageMipLevels,
+    std::uint32_t imageArrayLayers,
+    std::uint32_t _resultMipLevel
+) const {
+    if (imageMipLevels <= 1) {
+        // Nothing to bloom.
+        return;
+    }
+
+    const std::int32_t resultMipLevel = _resultMipLevel;
     const auto *d = device.get().getDispatcher();
-    computeCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, descriptorSet, {}, *d);
 
-    computeCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *downsamplePipeline, *d);
-    for (std::int32_t dstMipLevel = 1; dstMipLevel < imageMipLevels; ++dstMipLevel) {
-        computeCommandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute,
-            0, PushConstant {
-                .srcMipLevel = dstMipLevel - 1,
-                .dstMipLevel = dstMipLevel,
-            }, *d);
-        const vk::Extent2D mipExtent = vku::mipExtent(imageExtent, dstMipLevel);
-        computeCommandBuffer.dispatch(
-            vku::divCeil(mipExtent.width, 16U),
-            vku::divCeil(mipExtent.height, 16U),
-            imageArrayLayers,
-            *d);
+    downsample(computeCommandBuffer, descriptorSet, imageExtent, imageMipLevels, imageArrayLayers);
 
-        computeCommandBuffer.pipelineBarrier(
-            vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,
-            {}, vk::MemoryBarrier {
-                vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead,
-            }, {}, {}, *d);
-    }
+    computeCommandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,
+        {}, vk::MemoryBarrier {
+            vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead,
+        }, {}, {}, *d);
 
     computeCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *upsamplePipeline, *d);
-    for (std::int32_t srcMipLevel = imageMipLevels - 1; srcMipLevel >= 1; --srcMipLevel) {
+    for (std::int32_t srcMipLevel = imageMipLevels - 1; srcMipLevel > resultMipLevel; --srcMipLevel) {
         computeCommandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute,
             0, PushConstant {
+                .mipLevels = static_cast<std::int32_t>(imageMipLevels),
                 .srcMipLevel = srcMipLevel,
-                .dstMipLevel = srcMipLevel - 1,
             }, *d);
         const vk::Extent2D mipExtent = vku::mipExtent(imageExtent, srcMipLevel - 1);
         computeCommandBuffer.dispatch(
@@ -154,7 +226,7 @@ void bloom::BloomComputePipeline::compute(vk::CommandBuffer computeCommandBuffer
             imageArrayLayers,
             *d);
 
-        if (srcMipLevel != 1) {
+        if (srcMipLevel != resultMipLevel + 1) {
             computeCommandBuffer.pipelineBarrier(
                 vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,
                 {}, vk::MemoryBarrier {
@@ -162,4 +234,49 @@ void bloom::BloomComputePipeline::compute(vk::CommandBuffer computeCommandBuffer
                 }, {}, {}, *d);
         }
     }
+}
+
+void bloom::BloomComputePipeline::downsample(
+    vk::CommandBuffer computeCommandBuffer,
+    vku::DescriptorSet<DescriptorSetLayout> descriptorSet,
+    const vk::Extent2D &imageExtent,
+    std::uint32_t imageMipLevels,
+    std::uint32_t imageArrayLayers
+) const {
+    if (imageMipLevels <= 1) {
+        // Nothing to downsample.
+        return;
+    }
+
+    const auto *d = device.get().getDispatcher();
+    computeCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, descriptorSet, {}, *d);
+
+    // Downsample all mip levels at once. Each workgroup covers 32x32 texels of the mip level 1.
+    computeCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *downsamplePipeline, *d);
+    computeCommandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute,
+        0, PushConstant {
+            .mipLevels = static_cast<std::int32_t>(imageMipLevels),
+        }, *d);
+    const vk::Extent2D mip1Extent = vku::mipExtent(imageExtent, 1);
+    computeCommandBuffer.dispatch(
+        vku::divCeil(mip1Extent.width, 32U),
+        vku::divCeil(mip1Extent.height, 32U),
+        imageArrayLayers,
+        *d);
+
+    if (!useVulkanMemoryModel && imageMipLevels > workgroupMipLevels + 1) {
+        // Workgroups cannot be synchronized within the dispatch, therefore the remaining mip levels are reduced from
+        // the last mip level of the workgroups by a workgroup per layer after them.
+        computeCommandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,
+            {}, vk::MemoryBarrier {
+                vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead,
+            }, {}, {}, *d);
+        computeCommandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute,
+            0, PushConstant {
+                .mipLevels = static_cast<std::int32_t>(imageMipLevels),
+                .srcMipLevel = static_cast<std::int32_t>(workgroupMipLevels),
+            }, *d);
+        computeCommandBuffer.dispatch(1, 1, imageArrayLayers, *d);
+    }
 }
\ No newline at end of file
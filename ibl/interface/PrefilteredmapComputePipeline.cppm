@@ -1,7 +1,5 @@
 module;
 
-#include <cstddef>
-
 #include <lifetimebound.hpp>
 
 export module ibl.PrefilteredmapComputePipeline;
@@ -14,10 +12,6 @@ import ibl.shader.prefilteredmap_comp;
 namespace ibl {
     export class PrefilteredmapComputePipeline {
     public:
-        struct SpecializationConstants {
-            std::uint32_t samples = 1024;
-        };
-
         struct Config {
             /**
              * @brief Boolean indicates whether to utilize <tt>VK_AMD_shader_image_load_store_lod</tt> extension.
@@ -30,7 +24,35 @@ namespace ibl {
              */
             bool useShaderImageLoadStoreLod = false;
 
-            SpecializationConstants specializationConstants = {};
+            /**
+             * @brief Number of GGX importance samples per texel.
+             *
+             * If \p adaptiveSampleCount is <tt>true</tt>, this is the sample count of the roughest mip level.
+             */
+            std::uint32_t sampleCount = 1024;
+
+            /**
+             * @brief Boolean indicates whether to scale the sample count by the roughness of each mip level.
+             *
+             * As the source cubemap mip level is chosen by the sample PDF (filtered importance sampling), the narrow
+             * specular lobe of the low roughness level converges with much fewer samples, and the zero roughness level
+             * only needs a single sample. Since the low roughness levels have the most texels, it greatly reduces the
+             * total cost.
+             */
+            bool adaptiveSampleCount = false;
+        };
+
+        /**
+         * @brief A subregion of the prefilteredmap, specified in the unit of the compute shader workgroup.
+         *
+         * Prefiltering a high resolution mip level with a large sample count may take a long time in a single dispatch.
+         * Splitting the dispatch into the regions allows distributing the work across multiple submissions.
+         */
+        struct DispatchRegion {
+            std::uint32_t mipLevel;
+            std::uint32_t face;
+            std::uint32_t workgroupRowOffset;
+            std::uint32_t workgroupRowCount;
         };
 
         static constexpr vk::ImageUsageFlags requiredCubemapImageUsageFlags = vk::ImageUsageFlagBits::eSampled;
@@ -38,38 +60,87 @@ namespace ibl {
 
         PrefilteredmapComputePipeline(
             const vk::raii::Device &device LIFETIMEBOUND,
+            const vma::raii::Allocator &allocator LIFETIMEBOUND,
             const vku::Image &cubemapImage,
             const vku::raii::AllocatedImage &prefilteredmapImage LIFETIMEBOUND,
             const Config &config = {
                 .useShaderImageLoadStoreLod = false,
-                .specializationConstants = {
-                    .samples = 1024,
-                },
+                .sampleCount = 1024,
+                .adaptiveSampleCount = false,
             }
         );
 
         void setCubemapImage(const vku::Image &cubemapImage);
         void setPrefilteredmapImage(const vku::raii::AllocatedImage &prefilteredmapImage LIFETIME_CAPTURE_BY(this));
 
+        /**
+         * @brief Get number of workgroup rows (and columns) required for processing a face of \p mipLevel.
+         * @param mipLevel Mip level of the prefilteredmap.
+         * @return Number of workgroup rows.
+         */
+        [[nodiscard]] std::uint32_t getWorkgroupRowCount(std::uint32_t mipLevel) const noexcept;
+
+        /**
+         * @brief Get number of the effective samples (whose contribution is nonzero) per texel of \p mipLevel.
+         * @param mipLevel Mip level of the prefilteredmap.
+         * @return Number of samples.
+         */
+        [[nodiscard]] std::uint32_t getSampleCount(std::uint32_t mipLevel) const noexcept;
+
         void recordCommands(vk::CommandBuffer computeCommandBuffer) const;
 
+        /**
+         * @brief Record the commands that only process the given \p regions.
+         *
+         * Recording commands for all regions that cover the whole prefilteredmap is equivalent to
+         * <tt>recordCommands(computeCommandBuffer)</tt>.
+         *
+         * @param computeCommandBuffer Command buffer to be recorded.
+         * @param regions Regions to be processed.
+         */
+        void recordCommands(vk::CommandBuffer computeCommandBuffer, std::span<const DispatchRegion> regions) const;
+
     private:
         struct PushConstant;
 
+        /**
+         * @brief Range of the per-mip level samples in \p sampleBuffer, in the unit of sample.
+         */
+        struct SampleRange {
+            std::uint32_t offset;
+            std::uint32_t count;
+        };
+
         Config config;
         std::reference_wrapper<const vk::raii::Device> device;
+        std::reference_wrapper<const vma::raii::Allocator> allocator;
         std::reference_wrapper<const vku::raii::AllocatedImage> prefilteredmapImage;
+        std::uint32_t cubemapSize;
         vk::raii::Sampler cubemapSampler;
-        vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage> descriptorSetLayout;
+        vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage, vk::DescriptorType::eStorageBuffer> descriptorSetLayout;
         vk::raii::PipelineLayout pipelineLayout;
         vk::raii::Pipeline pipeline;
         vk::raii::ImageView cubemapImageView;
         std::vector<vk::raii::ImageView> prefilteredmapMipImageViews;
+        std::vector<SampleRange> sampleRanges;
+        vku::raii::AllocatedBuffer sampleBuffer;
 
-        [[nodiscard]] vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage> createDescriptorSetLayout() const;
+        [[nodiscard]] vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage, vk::DescriptorType::eStorageBuffer> createDescriptorSetLayout() const;
         [[nodiscard]] vk::raii::PipelineLayout createPipelineLayout() const;
         [[nodiscard]] vk::raii::Pipeline createPipeline() const;
         [[nodiscard]] std::vector<vk::raii::ImageView> createPrefilteredmapMipImageViews() const;
+
+        /**
+         * @brief Create a buffer of the precomputed samples for all mip levels, and write their ranges to \p ranges.
+         *
+         * Each sample is (tangent space incident direction, source cubemap mip level), therefore compute shader does
+         * not have to evaluate the low discrepancy sequence and GGX PDF for every texel. Samples below the horizon are
+         * discarded as they have no contribution.
+         */
+        [[nodiscard]] vku::raii::AllocatedBuffer createSampleBuffer(std::vector<SampleRange> &ranges) const;
+
+        void recordBindCommands(vk::CommandBuffer computeCommandBuffer) const;
+        void recordPushConstantCommand(vk::CommandBuffer computeCommandBuffer, std::uint32_t mipLevel) const;
     };
 }
 
@@ -79,26 +150,46 @@ module :private;
 
 struct ibl::PrefilteredmapComputePipeline::PushConstant {
     std::int32_t mipLevel;
-    float roughness;
+    std::uint32_t sampleOffset;
+    std::uint32_t sampleCount;
 };
 
+// Van der Corput sequence, identical to vdcSequence in pbr.glsl.
+[[nodiscard]] constexpr float vdcSequence(std::uint32_t bits) noexcept {
+    bits = (bits << 16U) | (bits >> 16U);
+    bits = ((bits & 0x55555555U) << 1U) | ((bits & 0xAAAAAAAAU) >> 1U);
+    bits = ((bits & 0x33333333U) << 2U) | ((bits & 0xCCCCCCCCU) >> 2U);
+    bits = ((bits & 0x0F0F0F0FU) << 4U) | ((bits & 0xF0F0F0F0U) >> 4U);
+    bits = ((bits & 0x00FF00FFU) << 8U) | ((bits & 0xFF00FF00U) >> 8U);
+    return static_cast<float>(bits) * 2.3283064365386963e-10f; // / 0x100000000
+}
+
 ibl::PrefilteredmapComputePipeline::PrefilteredmapComputePipeline(
     const vk::raii::Device &device,
+    const vma::raii::Allocator &allocator,
     const vku::Image &cubemapImage,
     const vku::raii::AllocatedImage &prefilteredmapImage,
     const Config &config
 ) : config { config },
     device { device },
+    allocator { allocator },
     prefilteredmapImage { prefilteredmapImage },
+    cubemapSize { cubemapImage.extent.width },
     cubemapSampler { device, vk::SamplerCreateInfo { {}, vk::Filter::eLinear, vk::Filter::eLinear }.setMaxLod(vk::LodClampNone) },
     descriptorSetLayout { createDescriptorSetLayout() },
     pipelineLayout { createPipelineLayout() },
     pipeline { createPipeline() },
     cubemapImageView { device, cubemapImage.getViewCreateInfo(vk::ImageViewType::eCube) },
-    prefilteredmapMipImageViews { createPrefilteredmapMipImageViews() } { }
+    prefilteredmapMipImageViews { createPrefilteredmapMipImageViews() },
+    sampleBuffer { createSampleBuffer(sampleRanges) } { }
 
 void ibl::PrefilteredmapComputePipeline::setCubemapImage(const vku::Image &cubemapImage) {
     cubemapImageView = { device, cubemapImage.getViewCreateInfo(vk::ImageViewType::eCube) };
+    if (cubemapSize != cubemapImage.extent.width) {
+        // Source mip level of each sample depends on the cubemap texel solid angle.
+        cubemapSize = cubemapImage.extent.width;
+        sampleBuffer = createSampleBuffer(sampleRanges);
+    }
 }
 
 void ibl::PrefilteredmapComputePipeline::setPrefilteredmapImage(const vku::raii::AllocatedImage &prefilteredmapImage) {
@@ -110,35 +201,52 @@ void ibl::PrefilteredmapComputePipeline::setPrefilteredmapImage(const vku::raii:
         pipeline = createPipeline();
     }
     prefilteredmapMipImageViews = createPrefilteredmapMipImageViews();
+    sampleBuffer = createSampleBuffer(sampleRanges);
+}
+
+std::uint32_t ibl::PrefilteredmapComputePipeline::getWorkgroupRowCount(std::uint32_t mipLevel) const noexcept {
+    return vku::divCeil(std::max(prefilteredmapImage.get().extent.width >> mipLevel, 1U), 16U);
+}
+
+std::uint32_t ibl::PrefilteredmapComputePipeline::getSampleCount(std::uint32_t mipLevel) const noexcept {
+    return sampleRanges[mipLevel].count;
 }
 
 void ibl::PrefilteredmapComputePipeline::recordCommands(vk::CommandBuffer computeCommandBuffer) const {
     const auto *d = device.get().getDispatcher();
 
-    computeCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline, *d);
-    computeCommandBuffer.pushDescriptorSetKHR(
-        vk::PipelineBindPoint::eCompute, *pipelineLayout,
-        0, {
-            decltype(descriptorSetLayout)::getWriteDescriptorSet<0>({}, 0, vku::lvalue(vk::DescriptorImageInfo { {}, *cubemapImageView, vk::ImageLayout::eShaderReadOnlyOptimal })),
-            decltype(descriptorSetLayout)::getWriteDescriptorSet<1>({}, 0, vku::lvalue(prefilteredmapMipImageViews
-                | std::views::transform([](vk::ImageView view) {
-                    return vk::DescriptorImageInfo { {}, view, vk::ImageLayout::eGeneral };
-                })
-                | std::ranges::to<std::vector>())),
-        }, *d);
+    recordBindCommands(computeCommandBuffer);
 
     for (std::uint32_t level = 0; level < prefilteredmapImage.get().mipLevels; ++level) {
-        computeCommandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, PushConstant {
-            .mipLevel = static_cast<std::int32_t>(level),
-            .roughness = static_cast<float>(level) / (prefilteredmapImage.get().mipLevels - 1),
-        }, *d);
+        recordPushConstantCommand(computeCommandBuffer, level);
 
-        const std::uint32_t groupCountXY = vku::divCeil(prefilteredmapImage.get().extent.width >> level, 16U);
+        const std::uint32_t groupCountXY = getWorkgroupRowCount(level);
         computeCommandBuffer.dispatch(groupCountXY, groupCountXY, 6, *d);
     }
 }
 
-[[nodiscard]] vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage> ibl::PrefilteredmapComputePipeline::createDescriptorSetLayout() const {
+void ibl::PrefilteredmapComputePipeline::recordCommands(vk::CommandBuffer computeCommandBuffer, std::span<const DispatchRegion> regions) const {
+    const auto *d = device.get().getDispatcher();
+
+    recordBindCommands(computeCommandBuffer);
+
+    std::optional<std::uint32_t> boundMipLevel;
+    for (const DispatchRegion &region : regions) {
+        if (boundMipLevel != region.mipLevel) {
+            recordPushConstantCommand(computeCommandBuffer, region.mipLevel);
+            boundMipLevel = region.mipLevel;
+        }
+
+        // gl_GlobalInvocationID is offset by the base workgroup, therefore the shader does not have to be aware of the
+        // region.
+        computeCommandBuffer.dispatchBase(
+            0, region.workgroupRowOffset, region.face,
+            getWorkgroupRowCount(region.mipLevel), region.workgroupRowCount, 1,
+            *d);
+    }
+}
+
+[[nodiscard]] vku::raii::DescriptorSetLayout<vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage, vk::DescriptorType::eStorageBuffer> ibl::PrefilteredmapComputePipeline::createDescriptorSetLayout() const {
     return {
         device,
         vk::DescriptorSetLayoutCreateInfo {
@@ -146,6 +254,7 @@ void ibl::PrefilteredmapComputePipeline::recordCommands(vk::CommandBuffer comput
             vku::lvalue({
                 decltype(descriptorSetLayout)::getCreateInfoBinding<0>(vk::ShaderStageFlagBits::eCompute, *cubemapSampler),
                 decltype(descriptorSetLayout)::getCreateInfoBinding<1>(config.useShaderImageLoadStoreLod ? 1U : prefilteredmapImage.get().mipLevels, vk::ShaderStageFlagBits::eCompute),
+                decltype(descriptorSetLayout)::getCreateInfoBinding<2>(1, vk::ShaderStageFlagBits::eCompute),
             }),
         },
     };
@@ -164,7 +273,8 @@ void ibl::PrefilteredmapComputePipeline::recordCommands(vk::CommandBuffer comput
 
 [[nodiscard]] vk::raii::Pipeline ibl::PrefilteredmapComputePipeline::createPipeline() const {
     return { device, nullptr, vk::ComputePipelineCreateInfo {
-        {},
+        // Allow the pipeline to be dispatched with non-zero base workgroup, which is used for region dispatch.
+        vk::PipelineCreateFlagBits::eDispatchBase,
         vk::PipelineShaderStageCreateInfo {
             {},
             vk::ShaderStageFlagBits::eCompute,
@@ -175,10 +285,6 @@ void ibl::PrefilteredmapComputePipeline::recordCommands(vk::CommandBuffer comput
                     : std::span<const std::uint32_t> { shader::prefilteredmap_comp<0> }),
             } }),
             "main",
-            &vku::lvalue(vk::SpecializationInfo {
-                vku::lvalue(vk::SpecializationMapEntry { 0, offsetof(SpecializationConstants, samples), sizeof(SpecializationConstants::samples) }),
-                vk::ArrayProxyNoTemporaries<const SpecializationConstants> { config.specializationConstants },
-            }),
         },
         *pipelineLayout,
     } };
@@ -196,4 +302,106 @@ void ibl::PrefilteredmapComputePipeline::recordCommands(vk::CommandBuffer comput
             }));
     }
     return result;
+}
+
+vku::raii::AllocatedBuffer ibl::PrefilteredmapComputePipeline::createSampleBuffer(std::vector<SampleRange> &ranges) const {
+    // (x, y, z): tangent space incident direction, w: source cubemap mip level.
+    std::vector<std::array<float, 4>> samples;
+
+    const float saTexel = 4.f * std::numbers::pi_v<float> / (6.f * cubemapSize * cubemapSize);
+    const std::uint32_t mipLevels = prefilteredmapImage.get().mipLevels;
+
+    ranges.clear();
+    for (std::uint32_t level = 0; level < mipLevels; ++level) {
+        const float roughness = mipLevels == 1 ? 0.f : static_cast<float>(level) / (mipLevels - 1);
+        const auto offset = static_cast<std::uint32_t>(samples.size());
+
+        if (roughness == 0.f) {
+            // Specular lobe is a delta function: all samples are equal to the normal direction.
+            samples.push_back({ 0.f, 0.f, 1.f, 0.f });
+            ranges.emplace_back(offset, 1U);
+            continue;
+        }
+
+        std::uint32_t sampleCount = config.sampleCount;
+        if (config.adaptiveSampleCount) {
+            // Linearly scale the sample count by the roughness, but at least 1/16 of the maximum sample count.
+            sampleCount = std::max(static_cast<std::uint32_t>(config.sampleCount * roughness), std::max(config.sampleCount / 16U, 1U));
+        }
+
+        const float alpha = roughness * roughness;
+        const float alpha2 = alpha * alpha;
+        for (std::uint32_t i = 0; i < sampleCount; ++i) {
+            // Hammersley point -> GGX half vector (in tangent space, N = (0, 0, 1)).
+            const float phi = 2.f * std::numbers::pi_v<float> * i / sampleCount;
+            const float xi = vdcSequence(i);
+            const float cosTheta = std::sqrt((1.f - xi) / (1.f + (alpha2 - 1.f) * xi));
+            const float sinTheta = std::sqrt(1.f - cosTheta * cosTheta);
+
+            // L = reflect(-V, H) where V = N.
+            const float dotNL = 2.f * cosTheta * cosTheta - 1.f;
+            if (dotNL <= 0.f) {
+                // No contribution.
+                continue;
+            }
+
+            // Source mip level by the sample PDF.
+            const float denom = cosTheta * cosTheta * (alpha2 - 1.f) + 1.f;
+            const float D = alpha2 / (std::numbers::pi_v<float> * denom * denom);
+            const float pdf = 0.25f * D + 0.0001f;
+            const float saSample = 1.f / (sampleCount * pdf + 0.0001f);
+            const float lod = std::max(0.5f * std::log2(saSample / saTexel), 0.f);
+
+            samples.push_back({
+                2.f * cosTheta * std::cos(phi) * sinTheta,
+                2.f * cosTheta * std::sin(phi) * sinTheta,
+                dotNL,
+                lod,
+            });
+        }
+
+        ranges.emplace_back(offset, static_cast<std::uint32_t>(samples.size()) - offset);
+    }
+
+    vku::raii::AllocatedBuffer result {
+        allocator,
+        vk::BufferCreateInfo {
+            {},
+            sizeof(std::array<float, 4>) * samples.size(),
+            vk::BufferUsageFlagBits::eStorageBuffer,
+        },
+        vma::AllocationCreateInfo {
+            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+            vma::MemoryUsage::eAutoPreferDevice,
+        },
+    };
+    std::ranges::copy(samples, static_cast<std::array<float, 4>*>(result.getAllocation().getInfo().pMappedData));
+    result.getAllocation().flush(0, vk::WholeSize);
+
+    return result;
+}
+
+void ibl::PrefilteredmapComputePipeline::recordBindCommands(vk::CommandBuffer computeCommandBuffer) const {
+    const auto *d = device.get().getDispatcher();
+
+    computeCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline, *d);
+    computeCommandBuffer.pushDescriptorSetKHR(
+        vk::PipelineBindPoint::eCompute, *pipelineLayout,
+        0, {
+            decltype(descriptorSetLayout)::getWriteDescriptorSet<0>({}, 0, vku::lvalue(vk::DescriptorImageInfo { {}, *cubemapImageView, vk::ImageLayout::eShaderReadOnlyOptimal })),
+            decltype(descriptorSetLayout)::getWriteDescriptorSet<1>({}, 0, vku::lvalue(prefilteredmapMipImageViews
+                | std::views::transform([](vk::ImageView view) {
+                    return vk::DescriptorImageInfo { {}, view, vk::ImageLayout::eGeneral };
+                })
+                | std::ranges::to<std::vector>())),
+            decltype(descriptorSetLayout)::getWriteDescriptorSet<2>({}, 0, vku::lvalue(vk::DescriptorBufferInfo { sampleBuffer, 0, vk::WholeSize })),
+        }, *d);
+}
+
+void ibl::PrefilteredmapComputePipeline::recordPushConstantCommand(vk::CommandBuffer computeCommandBuffer, std::uint32_t mipLevel) const {
+    computeCommandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, PushConstant {
+        .mipLevel = static_cast<std::int32_t>(mipLevel),
+        .sampleOffset = sampleRanges[mipLevel].offset,
+        .sampleCount = sampleRanges[mipLevel].count,
+    }, *device.get().getDispatcher());
 }
\ No newline at end of file
@@ -22,7 +22,34 @@ _LIBCPP_END_NAMESPACE_STD
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <vulkan/vulkan_hpp_macros.hpp>
+#ifdef ENABLE_CPU_PROFILER
+#include <cstdlib>
+#include <new>
+#endif
 
 import vulkan;
+#ifdef ENABLE_CPU_PROFILER
+import vk_gltf_viewer.cpu_profiler;
+#endif
+
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
+
+#ifdef ENABLE_CPU_PROFILER
+// Count the heap allocations for the CPU profiler. Array and nothrow forms are forwarded to these by default, and
+// over-aligned allocations are not counted.
+void *operator new(std::size_t size) {
+    vk_gltf_viewer::cpu_profiler::countAllocation();
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
 
-VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
\ No newline at end of file
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#endif
\ No newline at end of file
@@ -46,6 +46,7 @@ module;
 
 module vk_gltf_viewer.MainApp;
 
+import BS.thread_pool;
 import cubemap;
 import fmt;
 import ibl;
@@ -53,6 +54,7 @@ import imgui.glfw;
 import imgui.vulkan;
 
 import vk_gltf_viewer.asset;
+import vk_gltf_viewer.cpu_profiler;
 import vk_gltf_viewer.global;
 import vk_gltf_viewer.gltf.algorithm.miniball;
 import vk_gltf_viewer.gui.popup;
@@ -61,7 +63,9 @@ import vk_gltf_viewer.helpers.fastgltf;
 import vk_gltf_viewer.helpers.functional;
 import vk_gltf_viewer.helpers.optional;
 import vk_gltf_viewer.helpers.ranges;
+import vk_gltf_viewer.image.RadianceHdr;
 import vk_gltf_viewer.imgui.TaskCollector;
+import vk_gltf_viewer.math.pack;
 import vk_gltf_viewer.vulkan.FrameDeferredTask;
 import vk_gltf_viewer.vulkan.imgui.GuiTextures;
 import vk_gltf_viewer.vulkan.mipmap;
@@ -102,6 +106,252 @@ template <typename T, glm::qualifier Q>
     }
 }
 
+struct AnimationSamplingResult {
+    /**
+     * @brief Indices of the transformed nodes, without duplicates and descendants of the other transformed nodes.
+     */
+    std::vector<std::size_t> transformedNodes;
+    std::vector<std::size_t> morphedNodes;
+};
+
+/**
+ * @brief Sample the enabled animations at \p time, and update the CPU side world transforms of the transformed nodes.
+ *
+ * As it only accesses \p assetExtended, it can be run in a worker thread while the main thread is not accessing it.
+ */
+[[nodiscard]] AnimationSamplingResult sampleAnimations(vk_gltf_viewer::gltf::AssetExtended &assetExtended, double time) {
+    const vk_gltf_viewer::cpu_profiler::Zone zone { "Sample animations" };
+
+    AnimationSamplingResult result;
+    for (const auto &[animation, enabled] : assetExtended.animations) {
+        if (!enabled) continue;
+        animation.update(time, result.transformedNodes, result.morphedNodes, assetExtended.externalBuffers);
+    }
+
+    if (!result.transformedNodes.empty()) {
+        // Remove duplicates in transformedNodes.
+        std::ranges::sort(result.transformedNodes);
+        const auto [begin, end] = std::ranges::unique(result.transformedNodes);
+        result.transformedNodes.erase(begin, end);
+
+        const vk_gltf_viewer::cpu_profiler::Zone worldTransformZone { "SceneHierarchy::updateWorldTransform" };
+        assetExtended.sceneHierarchy.pruneDescendantNodesInPlace(result.transformedNodes);
+        for (std::size_t nodeIndex : result.transformedNodes) {
+            assetExtended.sceneHierarchy.updateWorldTransform(nodeIndex);
+        }
+    }
+
+    return result;
+}
+
+template <typename Rep, typename Period>
+void updateMovingAverage(std::chrono::duration<float, std::milli> &average, std::chrono::duration<Rep, Period> sample) noexcept {
+    constexpr float weight = 0.05f;
+    average += weight * (std::chrono::duration<float, std::milli> { sample } - average);
+}
+
+/**
+ * @brief Update the moving averages of the profiler ranges by \p samples, or replace them if the names of the ranges
+ * are changed (e.g. bloom is toggled).
+ */
+void updateProfilerRanges(std::vector<vk_gltf_viewer::AppState::Profiler::Range> &ranges, std::span<const vk_gltf_viewer::AppState::Profiler::Range> samples) {
+    using Range = vk_gltf_viewer::AppState::Profiler::Range;
+    if (!std::ranges::equal(ranges, samples, {}, &Range::name, &Range::name)) {
+        ranges.assign_range(samples);
+        return;
+    }
+
+    for (auto &&[range, sample] : std::views::zip(ranges, samples)) {
+        updateMovingAverage(range.begin, sample.begin);
+        updateMovingAverage(range.end, sample.end);
+    }
+}
+
+/**
+ * @brief Append the trace events of \p ranges, which are relative to \p origin, and discard the oldest events that
+ * exceed <tt>AppState::Profiler::maxTraceEventCount</tt>.
+ */
+void appendTraceEvents(
+    vk_gltf_viewer::AppState::Profiler &profiler,
+    vk_gltf_viewer::AppState::Profiler::TraceEvent::Track track,
+    std::chrono::steady_clock::time_point origin,
+    std::span<const vk_gltf_viewer::AppState::Profiler::Range> ranges
+) {
+    for (const vk_gltf_viewer::AppState::Profiler::Range &range : ranges) {
+        profiler.traceEvents.emplace_back(
+            range.name,
+            track,
+            origin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(range.begin),
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(range.end - range.begin));
+    }
+    while (profiler.traceEvents.size() > vk_gltf_viewer::AppState::Profiler::maxTraceEventCount) {
+        profiler.traceEvents.pop_front();
+    }
+}
+
+/**
+ * @brief Aggregate the CPU zone \p events of a frame by their names into <tt>profiler.zoneStatistics</tt>, and append
+ * them as the trace events of their threads.
+ */
+void updateZoneStatistics(vk_gltf_viewer::AppState::Profiler &profiler, std::span<const vk_gltf_viewer::cpu_profiler::ZoneEvent> events) {
+    using ZoneStatistics = vk_gltf_viewer::AppState::Profiler::ZoneStatistics;
+
+    profiler.zoneStatistics.clear();
+    for (const vk_gltf_viewer::cpu_profiler::ZoneEvent &event : events) {
+        auto it = std::ranges::find(profiler.zoneStatistics, event.name, &ZoneStatistics::name);
+        if (it == profiler.zoneStatistics.end()) {
+            it = profiler.zoneStatistics.insert(it, ZoneStatistics { event.name, 0, {}, 0 });
+        }
+        ++it->callCount;
+        it->totalTime += event.duration;
+        it->allocationCount += event.allocationCount;
+
+        profiler.traceEvents.emplace_back(
+            event.name,
+            vk_gltf_viewer::AppState::Profiler::TraceEvent::Track::Zone,
+            event.begin,
+            event.duration,
+            event.threadIndex);
+    }
+    std::ranges::sort(profiler.zoneStatistics, std::greater{}, &ZoneStatistics::totalTime);
+
+    while (profiler.traceEvents.size() > vk_gltf_viewer::AppState::Profiler::maxTraceEventCount) {
+        profiler.traceEvents.pop_front();
+    }
+}
+
+/**
+ * @brief Get the label of a multi-draw-indirect call from its state, e.g. <tt>Opaque / TriangleList / Uint16 / Back</tt>.
+ *
+ * <tt>vk::to_string</tt> is not available as the Vulkan module is compiled with <tt>VULKAN_HPP_NO_TO_STRING</tt>.
+ */
+[[nodiscard]] std::string getDrawBucketLabel(const vk_gltf_viewer::vulkan::Frame::ExecutionResult::DrawStatistics &statistics) {
+    constexpr auto getTopologyName = [](vk::PrimitiveTopology topology) noexcept -> std::string_view {
+        switch (topology) {
+            case vk::PrimitiveTopology::ePointList: return "PointList";
+            case vk::PrimitiveTopology::eLineList: return "LineList";
+            case vk::PrimitiveTopology::eLineStrip: return "LineStrip";
+            case vk::PrimitiveTopology::eTriangleList: return "TriangleList";
+            case vk::PrimitiveTopology::eTriangleStrip: return "TriangleStrip";
+            case vk::PrimitiveTopology::eTriangleFan: return "TriangleFan";
+            default: return "Unknown";
+        }
+    };
+    constexpr auto getIndexTypeName = [](const std::optional<vk::IndexType> &indexType) noexcept -> std::string_view {
+        if (!indexType) return "Non-indexed";
+        switch (*indexType) {
+            case vk::IndexType::eUint8: return "Uint8";
+            case vk::IndexType::eUint16: return "Uint16";
+            case vk::IndexType::eUint32: return "Uint32";
+            default: return "Unknown";
+        }
+    };
+    constexpr auto getCullModeName = [](vk::CullModeFlagBits cullMode) noexcept -> std::string_view {
+        switch (cullMode) {
+            case vk::CullModeFlagBits::eNone: return "None";
+            case vk::CullModeFlagBits::eFront: return "Front";
+            case vk::CullModeFlagBits::eBack: return "Back";
+            default: return "FrontAndBack";
+        }
+    };
+
+    return fmt::format(
+        "{} / {} / {} / {}",
+        statistics.subpass == 0 ? "Opaque" : "Blend",
+        getTopologyName(statistics.primitiveTopology),
+        getIndexTypeName(statistics.indexType),
+        getCullModeName(statistics.cullMode));
+}
+
+/**
+ * @brief Write the trace events of \p profiler as Chrome trace event format (JSON object format) to \p path.
+ *
+ * GPU pass events are written in a single thread track, and the instrumented CPU zones are written in the track of
+ * their threads, all in a single process.
+ *
+ * @see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+ */
+void writeChromeTrace(const vk_gltf_viewer::AppState::Profiler &profiler, const std::filesystem::path &path) {
+    std::ofstream file { path };
+    if (!file) {
+        std::cerr << "Failed to open the trace file: " << path << '\n';
+        return;
+    }
+
+    // Events are not sorted by their begin time points, as the GPU passes of a frame are appended after its execution.
+    const std::chrono::steady_clock::time_point origin = profiler.traceEvents.empty()
+        ? std::chrono::steady_clock::time_point{}
+        : std::ranges::min(profiler.traceEvents | std::views::transform(&vk_gltf_viewer::AppState::Profiler::TraceEvent::begin));
+
+    file << R"({"traceEvents":[)";
+    file << R"({"name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"GPU"}})";
+
+    // CPU zones of the thread i are written in the track 1 + i.
+    std::set<std::uint32_t> zoneThreadIndices;
+    for (const vk_gltf_viewer::AppState::Profiler::TraceEvent &event : profiler.traceEvents) {
+        using enum vk_gltf_viewer::AppState::Profiler::TraceEvent::Track;
+        if (event.track == Zone && zoneThreadIndices.insert(event.threadIndex).second) {
+            file << fmt::format(
+                R"(,{{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"Thread {}"}}}})",
+                1 + event.threadIndex, event.threadIndex);
+        }
+
+        file << fmt::format(
+            R"(,{{"name":"{}","cat":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":0,"tid":{}}})",
+            event.name,
+            event.track == Gpu ? "gpu" : "cpu",
+            std::chrono::duration<double, std::micro> { event.begin - origin }.count(),
+            std::chrono::duration<double, std::micro> { event.duration }.count(),
+            event.track == Zone ? 1 + event.threadIndex : 0U);
+    }
+    file << "]}\n";
+}
+
+/**
+ * @brief Get the render scale of the next frames from the dynamic resolution setting.
+ * @param dynamicResolution Dynamic resolution state.
+ * @param hasGpuTime Whether <tt>dynamicResolution.gpuTime</tt> is measured at the current render scale. If
+ * <tt>false</tt>, the current render scale is kept in <tt>Mode::Dynamic</tt>.
+ * @return Render scale, quantized by 0.05 not to change the render area on every GPU time sample.
+ */
+[[nodiscard]] float getRenderScale(const vk_gltf_viewer::AppState::DynamicResolution &dynamicResolution, bool hasGpuTime) noexcept {
+    switch (dynamicResolution.mode) {
+        using enum vk_gltf_viewer::AppState::DynamicResolution::Mode;
+        case Disabled:
+            return 1.f;
+        case Fixed:
+            return dynamicResolution.fixedScale;
+        case Dynamic: {
+            if (!hasGpuTime) {
+                return dynamicResolution.scale;
+            }
+
+            // Keep the current scale while the GPU time is in [80%, 100%] of the target, to avoid oscillation.
+            const float ratio = dynamicResolution.gpuTime / dynamicResolution.targetGpuTime;
+            if (ratio >= 0.8f && ratio <= 1.f) {
+                return dynamicResolution.scale;
+            }
+
+            // GPU time is roughly proportional to the pixel count, i.e. the square of the scale. Aim 90% of the target.
+            const float scale = dynamicResolution.scale * std::sqrt(0.9f / ratio);
+            return std::clamp(std::round(scale * 20.f) / 20.f, dynamicResolution.minScale, 1.f);
+        }
+    }
+    std::unreachable();
+}
+
+[[nodiscard]] std::uint32_t getPrefilteredmapSampleCount(vk_gltf_viewer::AppState::ImageBasedLighting::Prefilteredmap::Quality quality) noexcept {
+    switch (quality) {
+        using enum vk_gltf_viewer::AppState::ImageBasedLighting::Prefilteredmap::Quality;
+        case Fast:
+            return 256;
+        case Balanced:
+        case Reference:
+            return 1024;
+    }
+    std::unreachable();
+}
+
 vk_gltf_viewer::MainApp::MainApp()
     : instance { createInstance() }
     , window { instance }
@@ -129,8 +379,7 @@ vk_gltf_viewer::MainApp::MainApp()
         }(),
         .perFragmentBloom = gpu.supportShaderStencilExport,
     }) }
-    , sharedData { gpu, window.getSurface(), toExtent2D(window.getFramebufferSize()) }
-    , frames { ARRAY_OF(2, vulkan::Frame { renderer, sharedData }) } {
+    , sharedData { gpu, window.getSurface(), toExtent2D(window.getFramebufferSize()) } {
     const ibl::BrdfmapRenderPipeline brdfmapRenderPipeline { gpu.device, brdfmapImage, {} };
     const vk::raii::CommandPool graphicsCommandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.graphicsPresent } };
     const vk::raii::Fence fence { gpu.device, vk::FenceCreateInfo{} };
@@ -185,21 +434,9 @@ vk_gltf_viewer::MainApp::MainApp()
             });
     }, *fence);
 
-    gpu.device.updateDescriptorSets({
-        sharedData.imageBasedLightingDescriptorSet.getWrite<0>(0, vku::lvalue(vk::DescriptorBufferInfo { imageBasedLightingResources.cubemapSphericalHarmonicsBuffer, 0, vk::WholeSize })),
-        sharedData.imageBasedLightingDescriptorSet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *imageBasedLightingResources.prefilteredmapImageView,
-            vk::ImageLayout::eShaderReadOnlyOptimal,
-        })),
-        sharedData.imageBasedLightingDescriptorSet.getWrite<2>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *brdfmapImageView,
-            vk::ImageLayout::eShaderReadOnlyOptimal,
-        })),
-    }, {});
-
     std::ignore = gpu.device.waitForFences(*fence, true, ~0ULL);
+
+    appState.profiler.supportPipelineStatistics = gpu.supportPipelineStatisticsQuery;
 }
 
 void vk_gltf_viewer::MainApp::run() {
@@ -207,11 +444,10 @@ void vk_gltf_viewer::MainApp::run() {
     // lead to data hazards. Since resource updates occur when one of the frames is fenced, that frame can be updated
     // safely, but the others cannot.
     // One way to handle this is by storing update tasks for the other frames and executing them once the target frame
-    // becomes idle. This approach is especially efficient for two frames in flight, as it requires only a single task
-    // vector to store updates for the “another” frame.
-    vulkan::FrameDeferredTask frameDeferredTask;
+    // becomes idle. Each frame has its own task, and an update is deferred to the tasks of all the other frames.
+    std::vector<vulkan::FrameDeferredTask> frameDeferredTasks(frames.size());
 
-    std::array<bool, FRAMES_IN_FLIGHT> regenerateDrawCommands{};
+    std::vector<bool> regenerateDrawCommands(frames.size());
 
     // Current application running loop flow is like:
     //
@@ -235,42 +471,127 @@ void vk_gltf_viewer::MainApp::run() {
     // destroyed texture.
     //
     // To work-around, before destroying the previously loaded asset, its ownership is shared to
-    // retainedAssetExtended[frameIndex % FRAMES_IN_FLIGHT], to prevent the asset is completely destroyed. The asset
-    // will be retained during its frame execution, and should be destroyed after the frame execution is completed.
-    std::array<std::shared_ptr<const gltf::AssetExtended>, FRAMES_IN_FLIGHT> retainedAssetExtended;
-
-    // TODO: we need more general mechanism to upload the GPU buffer data in shared data. This is just a stopgap solution
-    //  for current KHR_materials_variants implementation.
-    vk::raii::CommandPool graphicsCommandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.graphicsPresent } };
-    vk::CommandBuffer sharedDataUpdateCommandBuffer = (*gpu.device).allocateCommandBuffers({
-        *graphicsCommandPool,
-        vk::CommandBufferLevel::ePrimary,
-        1,
-    })[0];
-    std::vector<vku::raii::AllocatedBuffer> sharedDataStagingBuffers;
+    // retainedAssetExtended[frameSlot], to prevent the asset is completely destroyed. The asset will be retained during
+    // its frame execution, and should be destroyed after the frame execution is completed.
+    std::vector<std::shared_ptr<const gltf::AssetExtended>> retainedAssetExtended(frames.size());
+
+    // Draw commands of the current frame are prepared in this thread while the swapchain image is being acquired.
+    // Then, animations of the next frame are sampled in this thread while the current frame is being recorded and
+    // submitted, if AppState::FramePacing::overlapAnimationSampling is enabled.
+    BS::thread_pool<> workerThreadPool { 1 };
+
+    // The sampling task owns the asset until it is joined, therefore assetExtended is null meanwhile and the main
+    // thread cannot access the asset.
+    struct NextFrameAnimationSampling {
+        std::shared_ptr<gltf::AssetExtended> assetExtended;
+        AnimationSamplingResult result;
+    };
+    std::future<NextFrameAnimationSampling> nextFrameAnimationSampling;
+
+    // Secondary command buffers of a frame are recorded in parallel using this.
+    BS::thread_pool<> commandRecordingThreadPool;
+
+    // Frame index of the first execution of the current frames, which may be recreated by changing the frames in
+    // flight. Frame fences are not waited until all frames are executed at least once.
+    std::uint64_t framesCreationFrameIndex = 0;
+    std::optional<std::uint32_t> requestedFramesInFlight;
+
+    // Viewport extent of the frames, to be applied when the frames are recreated.
+    std::optional<vk::Extent2D> lastViewportExtent;
+
+    // Frames recorded before this frame index may be rendered in the previous render scale, therefore their GPU times
+    // are not used for the dynamic resolution.
+    std::uint64_t renderScaleChangeFrameIndex = 0;
+    std::uint32_t renderScaleGpuTimeSampleCount = 0;
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<Clock::time_point> frameInputTimePoints(frames.size());
+
+    // CPU time points of the frame submissions, used as the origins of the GPU pass trace events.
+    std::vector<Clock::time_point> frameSubmitTimePoints(frames.size());
+    std::optional<Clock::time_point> lastFrameStartTimePoint;
+
+    // Selected level of details of the last retrieved frame execution result, for the visualization.
+    std::vector<vulkan::Frame::ExecutionResult::LevelOfDetailMarker> levelOfDetailMarkers;
+
+    // Shared data (e.g. material buffer, primitive buffer) updates are recorded into a command buffer and submitted
+    // to the graphics queue timeline before the frame submission, without waiting for its completion.
+
+    // As the previously submitted command buffer may be still pending, command pools are recycled only if their last
+    // submission is finished, and a new command pool is created otherwise.
+    struct SharedDataUpdateCommandPool {
+        vk::raii::CommandPool commandPool;
+        vk::CommandBuffer commandBuffer;
+        std::uint64_t lastSubmissionTimelineValue;
+    };
+    std::vector<SharedDataUpdateCommandPool> sharedDataUpdateCommandPools;
 
     for (std::uint64_t frameIndex = 0; !glfwWindowShouldClose(window); ++frameIndex) {
+        const Clock::time_point frameStartTimePoint = Clock::now();
+        const std::uint64_t frameStartAllocationCount = cpu_profiler::getAllocationCount();
+        Clock::duration frameFenceWaitDuration{};
+
         bool hasUpdateData = false;
 
+        // Proceed the background image based lighting generation, if exists.
+        updateImageBasedLightingGeneration(frameDeferredTasks);
+
+        // Animation sampling for this frame, either started in the previous frame or sampled in here.
+        std::optional<AnimationSamplingResult> animationSamplingResult;
+        if (nextFrameAnimationSampling.valid()) {
+            // Asset is not changed since the sampling started, as the tasks were already processed at that time.
+            NextFrameAnimationSampling sampling = nextFrameAnimationSampling.get();
+            assetExtended = std::move(sampling.assetExtended);
+            animationSamplingResult.emplace(std::move(sampling.result));
+        }
+        else if (assetExtended) {
+            animationSamplingResult.emplace(sampleAnimations(*assetExtended, glfwGetTime()));
+        }
+
+        // As the asset is not accessed by the worker thread from here, the frames can be recreated.
+        if (requestedFramesInFlight) {
+            gpu.device.waitIdle();
+
+            frames.clear();
+            frames = createFrames(*requestedFramesInFlight);
+            for (vulkan::Frame &frame : frames) {
+                if (sharedData.assetExtended) {
+                    frame.updateAsset();
+                }
+                frame.setRenderScale(appState.dynamicResolution.scale);
+                if (lastViewportExtent) {
+                    frame.setViewportExtent(*lastViewportExtent);
+                }
+            }
+
+            // The recreated frames already have the latest state, therefore the deferred tasks are no longer needed.
+            frameDeferredTasks.assign(frames.size(), {});
+            regenerateDrawCommands.assign(frames.size(), true);
+            retainedAssetExtended.assign(frames.size(), nullptr);
+            frameInputTimePoints.assign(frames.size(), {});
+            frameSubmitTimePoints.assign(frames.size(), {});
+            framesCreationFrameIndex = frameIndex;
+
+            appState.framePacing.framesInFlight = *requestedFramesInFlight;
+            requestedFramesInFlight.reset();
+        }
+
+        const std::size_t frameSlot = (frameIndex - framesCreationFrameIndex) % frames.size();
+
         std::queue<control::Task> tasks;
 
         std::vector<std::size_t> transformedNodes;
 
         // Collect task from animation system.
-        if (assetExtended) {
-            std::vector<std::size_t> morphedNodes;
-            for (const auto &[animation, enabled] : assetExtended->animations) {
-                if (!enabled) continue;
-                animation.update(glfwGetTime(), transformedNodes, morphedNodes, assetExtended->externalBuffers);
-            }
-
-            for (std::size_t nodeIndex : morphedNodes) {
+        if (animationSamplingResult) {
+            for (std::size_t nodeIndex : animationSamplingResult->morphedNodes) {
                 const std::size_t targetWeightCount = getTargetWeightCount(assetExtended->asset.nodes[nodeIndex], assetExtended->asset);
                 tasks.emplace(std::in_place_type<control::task::MorphTargetWeightChanged>, nodeIndex, 0, targetWeightCount);
             }
         }
 
         // Collect task from window event (mouse, keyboard, drag and drop, ...).
+        frameInputTimePoints[frameSlot] = Clock::now();
         window.pollEvents(tasks);
 
         // ImGui is not rendered at the first frame, and its passthrough region is evaluated as the window size.
@@ -285,6 +606,8 @@ void vk_gltf_viewer::MainApp::run() {
         static ImRect passthruRect { {}, toImVec2(window.getSize()) };
 
         {
+            const cpu_profiler::Zone zone { "ImGuiTaskCollector" };
+
             ImGui_ImplGlfw_NewFrame();
             ImGui_ImplVulkan_NewFrame();
 
@@ -313,6 +636,10 @@ void vk_gltf_viewer::MainApp::run() {
                 imguiTaskCollector.imageBasedLighting(*iblInfo, vku::toUint64(skyboxResources->imGuiEqmapTextureDescriptorSet));
             }
             imguiTaskCollector.rendererSetting(*renderer);
+            imguiTaskCollector.framePacing(appState.framePacing);
+            imguiTaskCollector.dynamicResolution(appState.dynamicResolution);
+            imguiTaskCollector.meshOptimization(appState.meshOptimization, assetExtended.get());
+            imguiTaskCollector.profiler(appState.profiler, windowHandle);
             if (assetExtended) {
                 imguiTaskCollector.imguizmo(*renderer, lastMouseEnteredViewIndex, *assetExtended);
             }
@@ -341,11 +668,79 @@ void vk_gltf_viewer::MainApp::run() {
                 ImGui::GetBackgroundDrawList()->AddRectFilled(region.Min, region.Max, ImGui::GetColorU32({ 1.f, 1.f, 1.f, 0.2f }));
                 ImGui::GetBackgroundDrawList()->AddRect(region.Min, region.Max, ImGui::GetColorU32({ 1.f, 1.f, 1.f, 1.f }));
             }
+
+            if (renderer->levelOfDetail && renderer->levelOfDetail->visualize && renderer->cameras.size() == 1) {
+                // Level 0 (full detail) is green, and coarser level is more reddish.
+                constexpr std::array levelColors {
+                    IM_COL32(0, 255, 0, 255), IM_COL32(128, 255, 0, 255), IM_COL32(255, 255, 0, 255), IM_COL32(255, 192, 0, 255),
+                    IM_COL32(255, 128, 0, 255), IM_COL32(255, 64, 0, 255), IM_COL32(255, 0, 0, 255), IM_COL32(255, 0, 128, 255),
+                };
+
+                const ImRect viewportRect = renderer->getViewportRect(passthruRect, 0);
+                ImDrawList &drawList = *ImGui::GetBackgroundDrawList();
+                drawList.PushClipRect(viewportRect.Min, viewportRect.Max);
+                for (const vulkan::Frame::ExecutionResult::LevelOfDetailMarker &marker : levelOfDetailMarkers) {
+                    const ImVec2 center = viewportRect.Min + toImVec2(marker.position) * viewportRect.GetSize();
+                    const ImU32 color = levelColors[std::min<std::size_t>(marker.level, levelColors.size() - 1)];
+                    drawList.AddCircle(center, marker.radius * viewportRect.GetHeight(), color);
+                    drawList.AddText(center, color, std::format("LOD {}", marker.level).c_str());
+                }
+                drawList.PopClipRect();
+            }
         }
 
-        vulkan::Frame &frame = frames[frameIndex % FRAMES_IN_FLIGHT];
-        if (frameIndex >= FRAMES_IN_FLIGHT) {
-            const vulkan::Frame::ExecutionResult result = frame.getExecutionResult();
+        vulkan::Frame &frame = frames[frameSlot];
+        if (frameIndex - framesCreationFrameIndex >= frames.size()) {
+            const Clock::time_point fenceWaitStartTimePoint = Clock::now();
+            const vulkan::Frame::ExecutionResult result = cpu_profiler::zoned("Frame wait", [&] { return frame.getExecutionResult(); });
+            frameFenceWaitDuration = Clock::now() - fenceWaitStartTimePoint;
+            updateMovingAverage(appState.framePacing.latency, Clock::now() - frameInputTimePoints[frameSlot]);
+
+            // A render scale change is applied to each frame when it is reused, and its result is retrieved after
+            // another frames in flight.
+            if (result.sceneRenderingGpuTime && frameIndex >= renderScaleChangeFrameIndex + 2 * frames.size()) {
+                if (renderScaleGpuTimeSampleCount++ == 0) {
+                    appState.dynamicResolution.gpuTime = *result.sceneRenderingGpuTime;
+                }
+                else {
+                    updateMovingAverage(appState.dynamicResolution.gpuTime, *result.sceneRenderingGpuTime);
+                }
+            }
+
+            // Update the profiler by the GPU execution result.
+            {
+                const std::vector gpuPasses
+                    = result.gpuPassTimes
+                    | std::views::transform([](const vulkan::Frame::ExecutionResult::GpuPassTime &passTime) {
+                        return AppState::Profiler::Range { passTime.name, passTime.begin, passTime.end };
+                    })
+                    | std::ranges::to<std::vector>();
+                updateProfilerRanges(appState.profiler.gpuPasses, gpuPasses);
+                appendTraceEvents(appState.profiler, AppState::Profiler::TraceEvent::Track::Gpu, frameSubmitTimePoints[frameSlot], gpuPasses);
+
+                appState.profiler.pipelineStatistics = result.pipelineStatistics.transform([](const vulkan::Frame::ExecutionResult::PipelineStatistics &statistics) {
+                    return AppState::Profiler::PipelineStatistics {
+                        statistics.vertexShaderInvocations,
+                        statistics.clippingPrimitives,
+                        statistics.fragmentShaderInvocations,
+                    };
+                });
+
+                levelOfDetailMarkers = result.levelOfDetailMarkers;
+
+                appState.profiler.drawBuckets.clear();
+                for (const vulkan::Frame::ExecutionResult::DrawStatistics &statistics : result.drawStatistics) {
+                    appState.profiler.drawBuckets.emplace_back(getDrawBucketLabel(statistics), statistics.drawCount, statistics.primitiveCount);
+                }
+
+                const vulkan::SharedData::ScenePipelineCounts pipelineCounts = sharedData.getScenePipelineCounts();
+                appState.profiler.pipelineCounts = {
+                    pipelineCounts.primitive,
+                    pipelineCounts.primitiveWithMaterialExtension,
+                    pipelineCounts.unlitPrimitive,
+                };
+            }
+
             if (auto *indices = get_if<std::vector<std::size_t>>(&result.mousePickingResult)) {
                 if (ImGui::GetIO().KeyCtrl) {
                     assetExtended->selectedNodes.insert_range(*indices);
@@ -362,29 +757,88 @@ void vk_gltf_viewer::MainApp::run() {
             }
         }
 
-        if (auto &retained = retainedAssetExtended[frameIndex % FRAMES_IN_FLIGHT]) {
+        if (auto &retained = retainedAssetExtended[frameSlot]) {
             // The previous execution of the frame requested destroying the asset, and now the request can be done
             // (as ImGui will not refer its texture).
             retained.reset();
         }
 
-        graphicsCommandPool.reset();
+        // Destroy the resources retired to the queue timelines that are no longer used.
+        timelines.collect();
+
+        auto sharedDataUpdateCommandPoolIt = std::ranges::find_if(sharedDataUpdateCommandPools, [&](const SharedDataUpdateCommandPool &pool) {
+            return timelines.graphicsPresent.isReached(pool.lastSubmissionTimelineValue);
+        });
+        if (sharedDataUpdateCommandPoolIt == sharedDataUpdateCommandPools.end()) {
+            vk::raii::CommandPool commandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.graphicsPresent } };
+            const vk::CommandBuffer commandBuffer = (*gpu.device).allocateCommandBuffers({
+                *commandPool,
+                vk::CommandBufferLevel::ePrimary,
+                1,
+            })[0];
+            sharedDataUpdateCommandPoolIt = sharedDataUpdateCommandPools.insert(
+                sharedDataUpdateCommandPools.end(),
+                SharedDataUpdateCommandPool { std::move(commandPool), commandBuffer, 0 });
+        }
+        else {
+            sharedDataUpdateCommandPoolIt->commandPool.reset();
+        }
+
+        const vk::CommandBuffer sharedDataUpdateCommandBuffer = sharedDataUpdateCommandPoolIt->commandBuffer;
         sharedDataUpdateCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
+        // Must be called before recording any shared data update. The update waits for the reads of the previously
+        // submitted frames and the writes of the previously submitted updates.
+        const auto beginSharedDataUpdate = [&] {
+            if (!hasUpdateData) {
+                sharedDataUpdateCommandBuffer.pipelineBarrier(
+                    vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eTransfer,
+                    vk::PipelineStageFlagBits::eTransfer,
+                    {}, vk::MemoryBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite }, {}, {});
+                hasUpdateData = true;
+            }
+        };
+
+        // Buffers that are used by the shared data update as the copy source (e.g. staging buffer, or the material
+        // buffer replaced by enlarging). They are retired to the graphics queue timeline after the submission.
+        std::vector<vku::raii::AllocatedBuffer> sharedDataUpdateSourceBuffers;
+
         const glm::vec2 framebufferScale = window.getFramebufferSize() / window.getSize();
 
-        // As we're going to update the frame resource from here, frameDeferredTask has to be reset. It can be done by
+        // As we're going to update the frame resource from here, its deferred task has to be reset. It can be done by
         // calling FrameDeferredTask::executeAndReset() in here, but there's a problem: what we updated in the previous
         // frame may useless, by either the current frame need to cancel it (e.g. changing asset) or current frame also
         // need to update the same thing (e.g. playing animation that changes the node world transforms).
         //
         // There's good solution for this: we're going to process the collected task, and will cancel the deferred task
-        // if necessary. frameDeferredTask will be replaced with the newly created one, and the existing one will be
-        // retained until the collected tasks are processed. After the processing finished, it will be executed.
-        vulkan::FrameDeferredTask currentFrameTask = std::exchange(frameDeferredTask, vulkan::FrameDeferredTask{});
+        // if necessary. The frame's deferred task will be replaced with the newly created one, and the existing one
+        // will be retained until the collected tasks are processed. After the processing finished, it will be executed.
+        vulkan::FrameDeferredTask currentFrameTask = std::exchange(frameDeferredTasks[frameSlot], vulkan::FrameDeferredTask{});
+
+        // Apply the update to the current frame and defer it to the other frames.
+        const auto updateFrames = [&](const auto &f) {
+            f(currentFrameTask);
+            for (std::size_t slot = 0; slot < frameDeferredTasks.size(); ++slot) {
+                if (slot != frameSlot) {
+                    f(frameDeferredTasks[slot]);
+                }
+            }
+        };
+
+        // CPU side world transforms of the animated nodes are already updated by sampleAnimations().
+        if (animationSamplingResult && !animationSamplingResult->transformedNodes.empty()) {
+            for (std::size_t nodeIndex : animationSamplingResult->transformedNodes) {
+                updateFrames([&](vulkan::FrameDeferredTask &task) {
+                    task.updateNodeWorldTransformHierarchical(nodeIndex);
+                });
+                assetExtended->subtreeBoundingBoxes.invalidateHierarchical(nodeIndex);
+            }
+            assetExtended->sceneMiniball.invalidate();
+        }
 
         // Process the collected tasks.
         for (; !tasks.empty(); tasks.pop()) {
+            const cpu_profiler::Zone zone { "Process task" };
             visit(multilambda {
                 [this](const control::task::WindowKey &task) {
                     if (const ImGuiIO &io = ImGui::GetIO(); io.WantCaptureKeyboard) return;
@@ -567,8 +1021,10 @@ void vk_gltf_viewer::MainApp::run() {
                     extent.height += extent.height % 2; // Make sure the height is even number.
 
                     // Update frame viewports.
-                    currentFrameTask.setViewportExtent(extent);
-                    frameDeferredTask.setViewportExtent(extent);
+                    updateFrames([&](vulkan::FrameDeferredTask &task) {
+                        task.setViewportExtent(extent);
+                    });
+                    lastViewportExtent = extent;
 
                     // Calculate camera aspect ratio and apply it to the cameras.
                     float aspectRatio = vku::aspect(extent);
@@ -585,11 +1041,12 @@ void vk_gltf_viewer::MainApp::run() {
 
                     sharedData.setSampleCount(static_cast<vk::SampleCountFlagBits>(task.sampleCount));
 
-                    currentFrameTask.updateSampleCount();
-                    frameDeferredTask.updateSampleCount();
+                    updateFrames([](vulkan::FrameDeferredTask &task) {
+                        task.updateSampleCount();
+                    });
 
                     // TODO: only re-generate scene render pass commands only
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
                 },
                 [&](const control::task::ChangeViewCount &task) {
                     gpu.device.waitIdle();
@@ -628,48 +1085,70 @@ void vk_gltf_viewer::MainApp::run() {
 
                     sharedData.setViewCount(renderer->cameras.size());
 
-                    currentFrameTask.updateViewCount();
-                    frameDeferredTask.updateViewCount();
+                    updateFrames([](vulkan::FrameDeferredTask &task) {
+                        task.updateViewCount();
+                    });
 
                     // TODO: only re-generate jump flood seed rendering commands only
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
+                },
+                [&](const control::task::ChangeFramesInFlight &task) {
+                    // Frames cannot be recreated in here, as the current frame is in use. They will be recreated at
+                    // the start of the next frame.
+                    requestedFramesInFlight.emplace(task.framesInFlight);
                 },
                 [&](const control::task::LoadGltf &task) {
                     for (auto name : control::ImGuiTaskCollector::assetPopupNames) {
                         gui::popup::close(name);
                     }
-                    retainedAssetExtended[frameIndex % FRAMES_IN_FLIGHT] = assetExtended;
+                    retainedAssetExtended[frameSlot] = assetExtended;
 
                     loadGltf(task.path);
 
                     // All planned updates related to the previous glTF asset have to be canceled.
-                    currentFrameTask.resetAssetRelated();
-                    frameDeferredTask.resetAssetRelated();
+                    updateFrames([](vulkan::FrameDeferredTask &task) {
+                        task.resetAssetRelated();
+                    });
                     transformedNodes.clear();
 
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
                 },
                 [&](control::task::CloseGltf) {
                     for (auto name : control::ImGuiTaskCollector::assetPopupNames) {
                         gui::popup::close(name);
                     }
-                    retainedAssetExtended[frameIndex % FRAMES_IN_FLIGHT] = assetExtended;
+                    retainedAssetExtended[frameSlot] = assetExtended;
 
                     closeGltf();
 
                     // All planned updates related to the previous glTF asset have to be canceled.
-                    currentFrameTask.resetAssetRelated();
-                    frameDeferredTask.resetAssetRelated();
+                    updateFrames([](vulkan::FrameDeferredTask &task) {
+                        task.resetAssetRelated();
+                    });
                     transformedNodes.clear();
                 },
                 [this](const control::task::LoadEqmap &task) {
-                    loadEqmap(task.path);
+                    // Use the quality preset of the current skybox, if exists.
+                    loadEqmap(task.path, appState.imageBasedLightingProperties
+                        .transform([](const AppState::ImageBasedLighting &properties) { return properties.prefilteredmap.quality; })
+                        .value_or(AppState::ImageBasedLighting::Prefilteredmap::Quality::Balanced));
+                },
+                [this](const control::task::ChangePrefilteredmapQuality &task) {
+                    if (appState.imageBasedLightingProperties) {
+                        // Regenerate the prefilteredmap from the current skybox. Copy the path as the properties will
+                        // be replaced.
+                        loadEqmap(std::filesystem::path { appState.imageBasedLightingProperties->eqmap.path }, task.quality);
+                    }
                 },
                 [&](control::task::ChangeScene task) {
                     assetExtended->setScene(task.newSceneIndex);
 
                     frame.gltfAsset->updateNodeWorldTransformScene(task.newSceneIndex);
-                    frameDeferredTask.updateNodeWorldTransformScene(task.newSceneIndex);
+                    for (std::size_t slot = 0; slot < frameDeferredTasks.size(); ++slot) {
+                        if (slot != frameSlot) {
+                            frameDeferredTasks[slot].updateNodeWorldTransformScene(task.newSceneIndex);
+                        }
+                    }
 
                     // Adjust the camera and grid size based on the scene enclosing sphere.
                     const auto &[center, radius, cameraOrLightPoints] = assetExtended->sceneMiniball.get();
@@ -685,11 +1164,11 @@ void vk_gltf_viewer::MainApp::run() {
                         std::abs(center.z() + std::copysign(radius, center.z())));
 
                     transformedNodes.clear(); // They are all related to the previous glTF asset.
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
                 },
                 [&](control::task::NodeVisibilityChanged task) {
                     // TODO: instead of calculate all draw commands, update only changed stuffs based on task.nodeIndex.
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
                 },
                 [this](control::task::NodeSelectionChanged) {
                     // If selected nodes have a single material, show it in the Material Editor window.
@@ -723,31 +1202,28 @@ void vk_gltf_viewer::MainApp::run() {
                 },
                 [&](const control::task::NodeWorldTransformChanged &task) {
                     // It merges the current node world transform update request with the previous requests.
-                    currentFrameTask.updateNodeWorldTransform(task.nodeIndex);
-                    frameDeferredTask.updateNodeWorldTransform(task.nodeIndex);
+                    updateFrames([&](vulkan::FrameDeferredTask &frameTask) {
+                        frameTask.updateNodeWorldTransform(task.nodeIndex);
+                    });
 
+                    assetExtended->subtreeBoundingBoxes.invalidate(task.nodeIndex);
                     assetExtended->sceneMiniball.invalidate();
                 },
                 [&](control::task::MaterialAdded) {
                     vulkan::gltf::AssetExtended &vkAsset = *dynamic_cast<vulkan::gltf::AssetExtended*>(assetExtended.get());
-                    if (!vkAsset.materialBuffer.canAddMaterial()) {
-                        // Enlarge the material buffer.
-                        gpu.device.waitIdle();
-                        if (auto oldMaterialBuffer = vkAsset.materialBuffer.enlarge(sharedDataUpdateCommandBuffer)) {
-                            sharedDataStagingBuffers.push_back(std::move(*oldMaterialBuffer));
-                            hasUpdateData = true;
-                        }
-
-                        // Update asset descriptor set by each frame to make them point to the new material buffer.
-                        INDEX_SEQ(Is, FRAMES_IN_FLIGHT, {
-                            sharedData.gpu.device.updateDescriptorSets(
-                                { get<Is>(frames).assetDescriptorSet.template getWrite<2>(0, vkAsset.materialBuffer.descriptorInfo)... },
-                                {});
+                    if (!vkAsset.materials.canAddMaterial()) {
+                        // Enlarge the material buffer. As the old buffer may be still used by the frames in flight, it
+                        // is retired instead of being destroyed, and each frame's asset descriptor set is updated to
+                        // point the new buffer when the frame is reused.
+                        beginSharedDataUpdate();
+                        sharedDataUpdateSourceBuffers.push_back(vkAsset.materials.enlarge(sharedDataUpdateCommandBuffer));
+                        updateFrames([](vulkan::FrameDeferredTask &task) {
+                            task.updateMaterialBuffer();
                         });
                     }
 
-                    // Add the new material to the material buffer.
-                    hasUpdateData |= vkAsset.materialBuffer.add(assetExtended->asset, assetExtended->asset.materials.back(), sharedDataUpdateCommandBuffer);
+                    // Add the new material to the material buffer. It will be written with the other material updates.
+                    vkAsset.materials.add(assetExtended->asset, assetExtended->asset.materials.back());
                 },
                 [&](const control::task::MaterialPropertyChanged &task) {
                     const fastgltf::Material &changedMaterial = assetExtended->asset.materials[task.materialIndex];
@@ -758,25 +1234,22 @@ void vk_gltf_viewer::MainApp::run() {
                         case Property::AlphaMode:
                         case Property::Unlit:
                         case Property::DoubleSided:
-                            regenerateDrawCommands.fill(true);
+                            std::ranges::fill(regenerateDrawCommands, true);
                             break;
                         case Property::AlphaCutoff:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::alphaCutOff>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::alphaCutOff>(
                                 task.materialIndex,
-                                changedMaterial.alphaCutoff,
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.alphaCutoff);
                             break;
                         case Property::BaseColorFactor:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::baseColorFactor>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::baseColorFactor>(
                                 task.materialIndex,
-                                glm::make_vec4(changedMaterial.pbrData.baseColorFactor.data()),
-                                sharedDataUpdateCommandBuffer);
+                                glm::make_vec4(changedMaterial.pbrData.baseColorFactor.data()));
                             break;
                         case Property::BaseColorTextureTransform:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::baseColorTextureTransform>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::baseColorTextureTransform>(
                                 task.materialIndex,
-                                getTextureTransform(changedMaterial.pbrData.baseColorTexture->transform.get()),
-                                sharedDataUpdateCommandBuffer);
+                                getTextureTransform(changedMaterial.pbrData.baseColorTexture->transform.get()));
                             break;
                         case Property::EmissiveStrength: {
                             using namespace std::string_view_literals;
@@ -788,7 +1261,7 @@ void vk_gltf_viewer::MainApp::run() {
                             constexpr auto extensionName = "KHR_materials_emissive_strength"sv;
                             if (it != assetExtended->bloomMaterials.end() && !useBloom) {
                                 assetExtended->bloomMaterials.erase(it);
-                                regenerateDrawCommands.fill(true);
+                                std::ranges::fill(regenerateDrawCommands, true);
 
                                 if (assetExtended->bloomMaterials.empty()) {
                                     // If there's no bloom material left, remove the extension from extensionsUsed if exists.
@@ -807,74 +1280,64 @@ void vk_gltf_viewer::MainApp::run() {
                             // Material emissive strength is changed to 1.
                             else if (it == assetExtended->bloomMaterials.end() && useBloom) {
                                 assetExtended->bloomMaterials.emplace_hint(it, task.materialIndex);
-                                regenerateDrawCommands.fill(true);
+                                std::ranges::fill(regenerateDrawCommands, true);
 
                                 // Add the extension to extensionsUsed if not exists.
                                 if (!std::ranges::contains(assetExtended->asset.extensionsUsed, extensionName)) {
                                     assetExtended->asset.extensionsUsed.emplace_back(extensionName);
                                 }
                             }
-                            [[fallthrough]]; // materialBuffer also needs to be updated.
+                            [[fallthrough]]; // materials also need to be updated.
                         }
                         case Property::Emissive:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::emissive>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::emissive>(
                                 task.materialIndex,
-                                changedMaterial.emissiveStrength * glm::make_vec3(changedMaterial.emissiveFactor.data()),
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.emissiveStrength * glm::make_vec3(changedMaterial.emissiveFactor.data()));
                             break;
                         case Property::EmissiveTextureTransform:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::emissiveTextureTransform>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::emissiveTextureTransform>(
                                 task.materialIndex,
-                                getTextureTransform(changedMaterial.emissiveTexture->transform.get()),
-                                sharedDataUpdateCommandBuffer);
+                                getTextureTransform(changedMaterial.emissiveTexture->transform.get()));
                             break;
                         case Property::Ior:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::ior>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::ior>(
                                 task.materialIndex,
-                                changedMaterial.ior,
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.ior);
                             break;
                         case Property::MetallicFactor:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::metallicFactor>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::metallicFactor>(
                                 task.materialIndex,
-                                changedMaterial.pbrData.metallicFactor,
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.pbrData.metallicFactor);
                             break;
                         case Property::MetallicRoughnessTextureTransform:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::metallicRoughnessTextureTransform>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::metallicRoughnessTextureTransform>(
                                 task.materialIndex,
-                                getTextureTransform(changedMaterial.pbrData.metallicRoughnessTexture->transform.get()),
-                                sharedDataUpdateCommandBuffer);
+                                getTextureTransform(changedMaterial.pbrData.metallicRoughnessTexture->transform.get()));
                             break;
                         case Property::NormalScale:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::normalScale>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::normalScale>(
                                 task.materialIndex,
-                                changedMaterial.normalTexture->scale,
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.normalTexture->scale);
                             break;
                         case Property::NormalTextureTransform:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::normalTextureTransform>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::normalTextureTransform>(
                                 task.materialIndex,
-                                getTextureTransform(changedMaterial.normalTexture->transform.get()),
-                                sharedDataUpdateCommandBuffer);
+                                getTextureTransform(changedMaterial.normalTexture->transform.get()));
                             break;
                         case Property::OcclusionStrength:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::occlusionStrength>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::occlusionStrength>(
                                 task.materialIndex,
-                                changedMaterial.occlusionTexture->strength,
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.occlusionTexture->strength);
                             break;
                         case Property::OcclusionTextureTransform:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::occlusionTextureTransform>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::occlusionTextureTransform>(
                                 task.materialIndex,
-                                getTextureTransform(changedMaterial.occlusionTexture->transform.get()),
-                                sharedDataUpdateCommandBuffer);
+                                getTextureTransform(changedMaterial.occlusionTexture->transform.get()));
                             break;
                         case Property::RoughnessFactor:
-                            hasUpdateData |= vkAssetExtended->materialBuffer.update<&vulkan::shader_type::Material::roughnessFactor>(
+                            vkAssetExtended->materials.update<&vulkan::shader_type::Material::roughnessFactor>(
                                 task.materialIndex,
-                                changedMaterial.pbrData.roughnessFactor,
-                                sharedDataUpdateCommandBuffer);
+                                changedMaterial.pbrData.roughnessFactor);
                             break;
                         case Property::TextureTransformEnabled: {
                             constexpr auto extensionName = "KHR_texture_transform"sv;
@@ -895,7 +1358,7 @@ void vk_gltf_viewer::MainApp::run() {
 
                                 // Asset was loaded without KHR_texture_transform extension, and all pipelines were
                                 // created with texture transform disabled. Pipelines need to be recreated.
-                                regenerateDrawCommands.fill(true);
+                                std::ranges::fill(regenerateDrawCommands, true);
                             }
                             break;
                         }
@@ -904,46 +1367,47 @@ void vk_gltf_viewer::MainApp::run() {
                 [&](const control::task::PrimitiveMaterialChanged &task) {
                     vkgltf::PrimitiveBuffer &primitiveBuffer = dynamic_cast<vulkan::gltf::AssetExtended*>(assetExtended.get())->primitiveBuffer;
                     const std::size_t primitiveIndex = primitiveBuffer.getPrimitiveIndex(*task.primitive);
-                    std::int32_t &dstData = primitiveBuffer.mappedData[primitiveIndex].materialIndex;
+                    const std::int32_t &dstData = primitiveBuffer.mappedData[primitiveIndex].materialIndex;
 
-                    if (vku::contains(primitiveBuffer.getAllocation().getMemoryProperties(), vk::MemoryPropertyFlagBits::eHostVisible)) {
-                        gpu.device.waitIdle();
+                    // The buffer is updated in the queue order even if it is host visible, as the frames in flight may
+                    // be reading it.
+                    beginSharedDataUpdate();
 
-                        if (task.primitive->materialIndex) {
-                            dstData = *task.primitive->materialIndex + 1;
-                        }
-                        else {
-                            dstData = 0;
-                        }
-                    }
-                    else {
-                        const vk::DeviceSize dstOffset
-                            = reinterpret_cast<const std::byte*>(&dstData)
-                            - reinterpret_cast<const std::byte*>(primitiveBuffer.mappedData.data());
+                    const vk::DeviceSize dstOffset
+                        = reinterpret_cast<const std::byte*>(&dstData)
+                        - reinterpret_cast<const std::byte*>(primitiveBuffer.mappedData.data());
 
-                        std::uint32_t data = 0;
-                        if (task.primitive->materialIndex) {
-                            data = *task.primitive->materialIndex + 1;
-                        }
-
-                        sharedDataUpdateCommandBuffer.updateBuffer<std::remove_cvref_t<decltype(dstData)>>(
-                            primitiveBuffer, dstOffset, data);
-                        hasUpdateData = true;
+                    std::int32_t data = 0;
+                    if (task.primitive->materialIndex) {
+                        data = *task.primitive->materialIndex + 1;
                     }
 
+                    sharedDataUpdateCommandBuffer.updateBuffer<std::remove_cvref_t<decltype(dstData)>>(
+                        primitiveBuffer, dstOffset, data);
+
                     // Draw commands need to be regenerated if changed material has different alpha mode/unlit/double-sided.
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
                 },
                 [&](const control::task::MorphTargetWeightChanged &task) {
                     // It merges the current node target weight update request with the previous requests.
-                    currentFrameTask.updateNodeTargetWeights(task.nodeIndex, task.targetWeightStartIndex, task.targetWeightCount);
-                    frameDeferredTask.updateNodeTargetWeights(task.nodeIndex, task.targetWeightStartIndex, task.targetWeightCount);
+                    updateFrames([&](vulkan::FrameDeferredTask &frameTask) {
+                        frameTask.updateNodeTargetWeights(task.nodeIndex, task.targetWeightStartIndex, task.targetWeightCount);
+                    });
 
+                    assetExtended->subtreeBoundingBoxes.invalidate(task.nodeIndex);
                     assetExtended->sceneMiniball.invalidate();
                 },
                 [&](control::task::BloomModeChanged) {
                     // Primitive rendering pipelines have to be recreated to use shader stencil export or not.
-                    regenerateDrawCommands.fill(true);
+                    std::ranges::fill(regenerateDrawCommands, true);
+                },
+                [&](control::task::OutlineResolutionChanged) {
+                    updateFrames([](vulkan::FrameDeferredTask &task) {
+                        task.updateJumpFloodResolution();
+                    });
+                },
+                [this](const control::task::ExportChromeTrace &task) {
+                    writeChromeTrace(appState.profiler, task.path);
                 },
             }, tasks.front());
         }
@@ -954,6 +1418,7 @@ void vk_gltf_viewer::MainApp::run() {
             const auto [begin, end] = std::ranges::unique(transformedNodes);
             transformedNodes.erase(begin, end);
 
+            const cpu_profiler::Zone zone { "SceneHierarchy::updateWorldTransform" };
             assetExtended->sceneHierarchy.pruneDescendantNodesInPlace(transformedNodes);
             for (std::size_t nodeIndex : transformedNodes) {
                 // Update CPU side world transform data.
@@ -961,8 +1426,11 @@ void vk_gltf_viewer::MainApp::run() {
 
                 // Update GPU side world transform data.
                 // It merges the current node world transform update request with the previous requests.
-                currentFrameTask.updateNodeWorldTransformHierarchical(nodeIndex);
-                frameDeferredTask.updateNodeWorldTransformHierarchical(nodeIndex);
+                updateFrames([&](vulkan::FrameDeferredTask &task) {
+                    task.updateNodeWorldTransformHierarchical(nodeIndex);
+                });
+
+                assetExtended->subtreeBoundingBoxes.invalidateHierarchical(nodeIndex);
             }
 
             assetExtended->sceneMiniball.invalidate();
@@ -978,13 +1446,49 @@ void vk_gltf_viewer::MainApp::run() {
             }
         }
 
+        // Apply the render scale to the frames if it is changed. As only the render area is changed, the viewport
+        // resources are not recreated. The GPU time is averaged over some samples before being used for the adjustment.
+        if (lastViewportExtent) {
+            constexpr std::uint32_t minGpuTimeSampleCount = 8;
+            const float renderScale = getRenderScale(appState.dynamicResolution, renderScaleGpuTimeSampleCount >= minGpuTimeSampleCount);
+            if (renderScale != appState.dynamicResolution.scale) {
+                appState.dynamicResolution.scale = renderScale;
+                updateFrames([&](vulkan::FrameDeferredTask &task) {
+                    task.setRenderScale(renderScale);
+                });
+
+                renderScaleChangeFrameIndex = frameIndex;
+                renderScaleGpuTimeSampleCount = 0;
+            }
+        }
+
+        // Material edits in this frame are coalesced, and copied to the material buffer at once.
+        auto *vkAsset = dynamic_cast<vulkan::gltf::AssetExtended*>(assetExtended.get());
+        if (vkAsset && vkAsset->materials.hasPendingUpdates()) {
+            beginSharedDataUpdate();
+            sharedDataUpdateSourceBuffers.push_back(vkAsset->materials.recordPendingUpdates(sharedDataUpdateCommandBuffer));
+        }
+
         if (hasUpdateData) {
-            sharedDataUpdateCommandBuffer.end();
+            // The frames submitted after this will see the updated data, as the barrier's synchronization scope follows
+            // the queue submission order.
+            sharedDataUpdateCommandBuffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+                {}, vk::MemoryBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead }, {}, {});
+        }
 
-            vk::raii::Fence fence { gpu.device, vk::FenceCreateInfo{} };
-            gpu.queues.graphicsPresent.submit(vk::SubmitInfo { {}, {}, sharedDataUpdateCommandBuffer }, *fence);
-            std::ignore = gpu.device.waitForFences(*fence, true, ~0ULL); // TODO: failure handling
-            sharedDataStagingBuffers.clear();
+        // The command buffer is always ended, to be reset with its command pool.
+        sharedDataUpdateCommandBuffer.end();
+        if (hasUpdateData) {
+            const std::uint64_t sharedDataUpdateFinishValue
+                = timelines.graphicsPresent.submit({}, vk::CommandBufferSubmitInfo { sharedDataUpdateCommandBuffer });
+            sharedDataUpdateCommandPoolIt->lastSubmissionTimelineValue = sharedDataUpdateFinishValue;
+
+            // The frames in flight that may read the replaced buffers are submitted before the update, therefore they
+            // are also finished when the timeline reaches the value.
+            for (vku::raii::AllocatedBuffer &buffer : sharedDataUpdateSourceBuffers) {
+                timelines.graphicsPresent.retire(sharedDataUpdateFinishValue, std::move(buffer));
+            }
         }
 
         // Update frame resources.
@@ -1009,11 +1513,16 @@ void vk_gltf_viewer::MainApp::run() {
                 break;
         }
 
-        frame.update({
+        const std::shared_future<void> drawCommandPreparation = frame.update({
             .passthruOffset = passthruOffset,
             .gltf = value_if(static_cast<bool>(assetExtended), [&] {
                 return vulkan::Frame::ExecutionTask::Gltf {
-                    .regenerateDrawCommands = std::exchange(regenerateDrawCommands[frameIndex % FRAMES_IN_FLIGHT], false),
+                    .regenerateDrawCommands = [&] {
+                        // std::exchange cannot be used for std::vector<bool>::reference.
+                        const bool result = regenerateDrawCommands[frameSlot];
+                        regenerateDrawCommands[frameSlot] = false;
+                        return result;
+                    }(),
                     .mousePickingInput = [&] -> std::optional<std::pair<std::uint32_t, vk::Rect2D>> {
                         if (frameIndex == 0) {
                             // Passthrough region is not defined at the first frame (as ImGui is not rendered).
@@ -1084,15 +1593,52 @@ void vk_gltf_viewer::MainApp::run() {
                     }(),
                 };
             }),
-        });
+            .recordPipelineStatistics = appState.profiler.recordPipelineStatistics,
+        }, workerThreadPool);
+
+        // Frame::update() is the last access to the asset by the main thread in this frame. Animations of the next
+        // frame can be sampled from now, while the current frame is being recorded and submitted. The node transforms
+        // used by the draw command preparation are already copied, but it still reads the other asset data (e.g. morph
+        // target weights), therefore the sampling starts after the preparation is finished.
+        if (assetExtended && appState.framePacing.overlapAnimationSampling) {
+            // Predict the start time of the next frame with the current frame interval.
+            const double nextFrameTime = glfwGetTime()
+                + std::chrono::duration<double>(appState.framePacing.frameInterval).count()
+                - std::chrono::duration<double>(Clock::now() - frameStartTimePoint).count();
+            nextFrameAnimationSampling = workerThreadPool.submit_task([assetExtended = std::move(assetExtended), drawCommandPreparation, nextFrameTime] mutable {
+                drawCommandPreparation.wait();
+                AnimationSamplingResult result = sampleAnimations(*assetExtended, nextFrameTime);
+                return NextFrameAnimationSampling { std::move(assetExtended), std::move(result) };
+            });
+        }
 
+        frameSubmitTimePoints[frameSlot] = Clock::now();
         if (frameIndex == 0) {
             frame.recordCommandsAndSubmitFirstFrame();
         }
         else {
-            frame.recordCommandsAndSubmit();
+            frame.recordCommandsAndSubmit(commandRecordingThreadPool);
+        }
+
+        // Update frame pacing statistics.
+        const Clock::time_point frameEndTimePoint = Clock::now();
+        updateMovingAverage(appState.framePacing.cpuTime, frameEndTimePoint - frameStartTimePoint - frameFenceWaitDuration);
+        if (lastFrameStartTimePoint) {
+            updateMovingAverage(appState.framePacing.frameInterval, frameStartTimePoint - *lastFrameStartTimePoint);
+        }
+        lastFrameStartTimePoint = frameStartTimePoint;
+
+        // Update the profiler CPU zones.
+        if constexpr (cpu_profiler::enabled) {
+            // Allocation count is taken first, as the statistics update also allocates.
+            appState.profiler.frameAllocationCount = cpu_profiler::getAllocationCount() - frameStartAllocationCount;
+            updateZoneStatistics(appState.profiler, cpu_profiler::collect());
         }
     }
+
+    if (nextFrameAnimationSampling.valid()) {
+        assetExtended = std::move(nextFrameAnimationSampling.get().assetExtended);
+    }
     gpu.device.waitIdle();
 }
 
@@ -1132,8 +1678,10 @@ vk_gltf_viewer::MainApp::ImGuiContext::ImGuiContext(const control::AppWindow &wi
         .Queue = gpu.queues.graphicsPresent,
         .DescriptorPoolSize = 512,
         // ImGui requires ImGui_ImplVulkan_InitInfo::{MinImageCount,ImageCount} ≥ 2 (I don't know why...).
-        .MinImageCount = std::max(FRAMES_IN_FLIGHT, 2U),
-        .ImageCount = std::max(FRAMES_IN_FLIGHT, 2U),
+        // ImageCount determines the number of ImGui vertex/index buffers used in round-robin, therefore it must not be
+        // less than the frames in flight, which can be changed at runtime.
+        .MinImageCount = 2,
+        .ImageCount = std::max(AppState::FramePacing::maxFramesInFlight, 2U),
         .PipelineInfoMain = {
             .PipelineRenderingCreateInfo = vk::PipelineRenderingCreateInfo { {}, colorAttachmentFormat },
             .SwapChainImageUsage = static_cast<vk::ImageUsageFlags::MaskType>(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc),
@@ -1271,12 +1819,34 @@ vku::raii::AllocatedImage vk_gltf_viewer::MainApp::createBrdfmapImage() const {
     };
 }
 
+std::vector<vk_gltf_viewer::vulkan::Frame> vk_gltf_viewer::MainApp::createFrames(std::uint32_t count) {
+    std::vector<vulkan::Frame> result;
+    result.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        vulkan::Frame &frame = result.emplace_back(renderer, sharedData, timelines);
+        frame.updateImageBasedLighting(
+            { imageBasedLightingResources.cubemapSphericalHarmonicsBuffer, 0, vk::WholeSize },
+            *imageBasedLightingResources.prefilteredmapImageView,
+            *brdfmapImageView);
+        if (skyboxResources) {
+            frame.updateSkybox(*skyboxResources->cubemapImageView);
+        }
+    }
+    return result;
+}
+
 void vk_gltf_viewer::MainApp::loadGltf(const std::filesystem::path &path) {
     std::shared_ptr<vulkan::gltf::AssetExtended> vkAssetExtended;
     vk::raii::CommandPool transferCommandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.transfer } };
-    vkgltf::StagingBufferStorage stagingBufferStorage { gpu.device, gpu.allocator, transferCommandPool, gpu.queues.transfer };
+
+    // Staging buffers are retired after the upload, therefore the storage is heap allocated.
+    auto stagingBufferStorage = std::make_unique<vkgltf::StagingBufferStorage>(gpu.device, gpu.allocator, *transferCommandPool, gpu.queues.transfer);
+
+    // Frames submitted until now may use the current asset, but the uploads of the new asset do not need to be
+    // waited before replacing it.
+    const std::uint64_t framesFinishValue = timelines.graphicsPresent.getLastSubmittedValue();
     try {
-        vkAssetExtended = std::make_shared<vulkan::gltf::AssetExtended>(path, gpu, sharedData.fallbackTexture, stagingBufferStorage);
+        vkAssetExtended = std::make_shared<vulkan::gltf::AssetExtended>(path, gpu, timelines, sharedData.fallbackTexture, *stagingBufferStorage, threadPool, appState.meshOptimization.enabled, appState.meshOptimization.generateLevelOfDetails, appState.meshOptimization.buildMeshlets, appState.meshOptimization.quantizeVertexAttributes, appState.meshOptimization.fastTangentGeneration);
     }
     catch (gltf::AssetProcessError error) {
         std::cerr << "The glTF file cannot be processed because of an error: " << format_as(error) << '\n';
@@ -1296,11 +1866,20 @@ void vk_gltf_viewer::MainApp::loadGltf(const std::filesystem::path &path) {
         }
     }
 
+    // Submit the buffer uploads without waiting for their completion. The frames are gated by the upload completion
+    // value, and the staging buffers are destroyed after it is reached.
+    if (const std::optional<vk::CommandBuffer> copyCommandBuffer = stagingBufferStorage->end()) {
+        const std::uint64_t copyFinishValue = timelines.transfer.submit({}, vk::CommandBufferSubmitInfo { *copyCommandBuffer });
+        timelines.graphicsPresent.addDependency({ timelines.transfer, copyFinishValue }, vk::PipelineStageFlagBits2::eAllCommands);
+        timelines.transfer.retire(copyFinishValue, std::move(stagingBufferStorage));
+        timelines.transfer.retire(copyFinishValue, std::move(transferCommandPool));
+    }
+
     assetExtended = vkAssetExtended;
 
-    // TODO: I'm aware that there are better solutions compare to the waitIdle, but I don't have much time for it
-    //  so I'll just use it for now.
-    gpu.device.waitIdle();
+    // TODO: the frames in flight are waited as they refer the current asset. It can be avoided by deferring the asset
+    //  update to each frame's deferred task.
+    timelines.graphicsPresent.wait(framesFinishValue);
     sharedData.assetExtended = std::move(vkAssetExtended);
     for (vulkan::Frame &frame : frames) {
         frame.updateAsset();
@@ -1348,11 +1927,52 @@ void vk_gltf_viewer::MainApp::closeGltf() {
     window.setTitle("Vulkan glTF Viewer");
 }
 
-void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath) {
+void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath, AppState::ImageBasedLighting::Prefilteredmap::Quality prefilteredmapQuality) {
+    if (imageBasedLightingGeneration) {
+        // The previous generation is not finished yet and will be superseded. Its GPU work may be still in progress,
+        // therefore it is retired until the last submission is finished.
+        if (const std::uint64_t value = imageBasedLightingGeneration->lastRefinementFinishValue) {
+            timelines.compute.retire(value, std::move(imageBasedLightingGeneration));
+        }
+        else {
+            timelines.graphicsPresent.retire(imageBasedLightingGeneration->initialPassFinishValue, std::move(imageBasedLightingGeneration));
+        }
+    }
+
+    const bool progressive = imGuiContext.userData.progressiveImageBasedLighting;
+
     vk::Extent2D eqmapImageExtent;
     vk::Format eqmapImageFormat;
-    const vku::raii::AllocatedBuffer eqmapStagingBuffer = [&]() {
-        std::unique_ptr<std::byte[]> data; // It should be freed after copying to the staging buffer, therefore declared as unique_ptr.
+    vku::raii::AllocatedBuffer eqmapStagingBuffer = [&]() {
+        const auto createStagingBuffer = [&]() {
+            return vku::raii::AllocatedBuffer {
+                gpu.allocator,
+                vk::BufferCreateInfo {
+                    {},
+                    blockSize(eqmapImageFormat) * eqmapImageExtent.width * eqmapImageExtent.height,
+                    vk::BufferUsageFlagBits::eTransferSrc,
+                },
+                vma::AllocationCreateInfo {
+                    vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+                    vma::MemoryUsage::eAutoPreferHost,
+                },
+            };
+        };
+
+        // HDR image is decoded into RGBA16F, or B10G11R11 if it is too large, directly in the mapped staging buffer
+        // without FP32 intermediate.
+        const auto selectHdrFormat = [&]() {
+            constexpr vk::FormatFeatureFlags requiredFeatures
+                = vk::FormatFeatureFlagBits::eTransferDst | vk::FormatFeatureFlagBits::eSampledImage
+                | vk::FormatFeatureFlagBits::eSampledImageFilterLinear
+                | vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst;
+            if (blockSize(vk::Format::eR16G16B16A16Sfloat) * eqmapImageExtent.width * eqmapImageExtent.height > MAX_EQMAP_STAGING_BUFFER_SIZE_RGBA16F &&
+                vku::contains(gpu.physicalDevice.getFormatProperties(vk::Format::eB10G11R11UfloatPack32).optimalTilingFeatures, requiredFeatures)) {
+                return vk::Format::eB10G11R11UfloatPack32;
+            }
+            return vk::Format::eR16G16B16A16Sfloat;
+        };
+
         const std::filesystem::path extension = eqmapPath.extension();
 #ifdef SUPPORT_EXR_SKYBOX
         if (extension == ".exr") {
@@ -1361,53 +1981,85 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
             const Imath::Box2i dw = file.header().dataWindow();
             eqmapImageExtent.width = static_cast<std::uint32_t>(dw.max.x - dw.min.x + 1);
             eqmapImageExtent.height = static_cast<std::uint32_t>(dw.max.y - dw.min.y + 1);
-            eqmapImageFormat = vk::Format::eR32G32B32A32Sfloat;
+            // OpenEXR can only convert the channels to HALF, UINT or FLOAT.
+            eqmapImageFormat = vk::Format::eR16G16B16A16Sfloat;
 
-            data = std::make_unique_for_overwrite<std::byte[]>(4 * eqmapImageExtent.width * eqmapImageExtent.height * sizeof(float));
+            vku::raii::AllocatedBuffer result = createStagingBuffer();
+            char* const data = static_cast<char*>(result.getAllocation().getInfo().pMappedData);
 
-            // Create frame buffers for each channel.
+            // Create frame buffers for each channel. OpenEXR converts them into half float while reading, with its
+            // own thread pool.
             // Note: Alpha channel will be ignored.
             Imf::FrameBuffer frameBuffer;
-            constexpr std::size_t xStride = sizeof(float[4]);
+            constexpr std::size_t xStride = sizeof(std::uint16_t[4]);
             const std::size_t yStride = eqmapImageExtent.width * xStride;
-            frameBuffer.insert("R", Imf::Slice{ Imf::FLOAT, reinterpret_cast<char*>(data.get()), xStride, yStride });
-            frameBuffer.insert("G", Imf::Slice{ Imf::FLOAT, reinterpret_cast<char*>(data.get() + sizeof(float)), xStride, yStride });
-            frameBuffer.insert("B", Imf::Slice{ Imf::FLOAT, reinterpret_cast<char*>(data.get() + 2 * sizeof(float)), xStride, yStride });
+            // Base pointer must be offset by the data window origin.
+            char* const base = data - static_cast<std::ptrdiff_t>(dw.min.x * xStride + dw.min.y * yStride);
+            frameBuffer.insert("R", Imf::Slice{ Imf::HALF, base, xStride, yStride });
+            frameBuffer.insert("G", Imf::Slice{ Imf::HALF, base + sizeof(std::uint16_t), xStride, yStride });
+            frameBuffer.insert("B", Imf::Slice{ Imf::HALF, base + 2 * sizeof(std::uint16_t), xStride, yStride });
 
             file.readPixels(frameBuffer, dw.min.y, dw.max.y);
+
+            result.getAllocation().flush(0, vk::WholeSize);
+            return result;
         }
-        else
 #endif
-        {
-            int width, height;
-            if (extension == ".hdr") {
-                data.reset(reinterpret_cast<std::byte*>(stbi_loadf(PATH_C_STR(eqmapPath), &width, &height, nullptr, 4)));
-                eqmapImageFormat = vk::Format::eR32G32B32A32Sfloat;
-            }
-            else {
-                data.reset(reinterpret_cast<std::byte*>(stbi_load(PATH_C_STR(eqmapPath), &width, &height, nullptr, 4)));
-                eqmapImageFormat = vk::Format::eR8G8B8A8Srgb;
-            }
-            if (!data) {
-                throw std::runtime_error { fmt::format("Failed to load image: {}", stbi_failure_reason()) };
-            }
+        if (extension == ".hdr") {
+            const image::RadianceHdr hdr { eqmapPath };
+            eqmapImageExtent.width = hdr.width;
+            eqmapImageExtent.height = hdr.height;
+            eqmapImageFormat = selectHdrFormat();
+
+            vku::raii::AllocatedBuffer result = createStagingBuffer();
+            std::byte* const data = static_cast<std::byte*>(result.getAllocation().getInfo().pMappedData);
+
+            // Decode the row bands in parallel. Each band converts its scanlines into the destination format and
+            // writes them to the staging buffer.
+            threadPool.submit_blocks(0U, hdr.height, [&](std::uint32_t rowStart, std::uint32_t rowEnd) {
+                std::vector<image::RadianceHdr::Texel> scanline(hdr.width);
+                for (std::uint32_t y = rowStart; y < rowEnd; ++y) {
+                    hdr.decodeScanline(y, scanline);
+
+                    std::byte* const rowData = data + blockSize(eqmapImageFormat) * hdr.width * y;
+                    if (eqmapImageFormat == vk::Format::eB10G11R11UfloatPack32) {
+                        std::ranges::transform(scanline, reinterpret_cast<std::uint32_t*>(rowData), [](const image::RadianceHdr::Texel &texel) {
+                            const auto [r, g, b] = image::RadianceHdr::toRgb(texel);
+                            return math::pack::packB10G11R11Ufloat(r, g, b);
+                        });
+                    }
+                    else {
+                        std::ranges::transform(scanline, reinterpret_cast<std::array<std::uint16_t, 4>*>(rowData), [](const image::RadianceHdr::Texel &texel) {
+                            const auto [r, g, b] = image::RadianceHdr::toRgb(texel);
+                            return std::array {
+                                math::pack::packHalf1x16(r),
+                                math::pack::packHalf1x16(g),
+                                math::pack::packHalf1x16(b),
+                                math::pack::packHalf1x16(1.f),
+                            };
+                        });
+                    }
+                }
+            }, vku::divCeil(hdr.height, EQMAP_DECODE_BAND_ROW_COUNT)).get();
 
-            eqmapImageExtent.width = static_cast<std::uint32_t>(width);
-            eqmapImageExtent.height = static_cast<std::uint32_t>(height);
+            result.getAllocation().flush(0, vk::WholeSize);
+            return result;
         }
 
-        vku::raii::AllocatedBuffer result {
-            gpu.allocator,
-            vk::BufferCreateInfo {
-                {},
-                blockSize(eqmapImageFormat) * eqmapImageExtent.width * eqmapImageExtent.height,
-                vk::BufferUsageFlagBits::eTransferSrc,
-            },
-            vma::AllocationCreateInfo {
-                vma::AllocationCreateFlagBits::eHostAccessSequentialWrite,
-                vma::MemoryUsage::eAutoPreferHost,
-            },
+        int width, height;
+        const std::unique_ptr<stbi_uc[], decltype(&stbi_image_free)> data {
+            stbi_load(PATH_C_STR(eqmapPath), &width, &height, nullptr, 4),
+            &stbi_image_free,
         };
+        if (!data) {
+            throw std::runtime_error { fmt::format("Failed to load image: {}", stbi_failure_reason()) };
+        }
+
+        eqmapImageExtent.width = static_cast<std::uint32_t>(width);
+        eqmapImageExtent.height = static_cast<std::uint32_t>(height);
+        eqmapImageFormat = vk::Format::eR8G8B8A8Srgb;
+
+        vku::raii::AllocatedBuffer result = createStagingBuffer();
         result.getAllocation().copyFromMemory(data.get(), 0, result.size);
 
         return result;
@@ -1417,7 +2069,7 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
     std::uint32_t eqmapImageMipLevels = 1;
     for (std::uint32_t mipWidth = eqmapImageExtent.width >> 1; mipWidth > 512; mipWidth >>= 1, ++eqmapImageMipLevels);
 
-    const vku::raii::AllocatedImage eqmapImage {
+    vku::raii::AllocatedImage eqmapImage {
         gpu.allocator,
         vk::ImageCreateInfo {
             {},
@@ -1460,8 +2112,9 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
         vk::ImageCreateInfo {
             vk::ImageCreateFlagBits::eCubeCompatible,
             vk::ImageType::e2D,
-            // Use non-sRGB format as sRGB format is usually not compatible with storage image.
-            eqmapImageFormat == vk::Format::eR8G8B8A8Srgb ? vk::Format::eR8G8B8A8Unorm : eqmapImageFormat,
+            // Use non-sRGB format as sRGB format is usually not compatible with storage image. HDR eqmap may be
+            // B10G11R11, which is not guaranteed to be supported as storage image.
+            eqmapImageFormat == vk::Format::eR8G8B8A8Srgb ? vk::Format::eR8G8B8A8Unorm : vk::Format::eR16G16B16A16Sfloat,
             vk::Extent3D { cubemapSize, cubemapSize, 1 },
             vku::maxMipLevels(cubemapSize), 6,
             vk::SampleCountFlagBits::e1,
@@ -1477,32 +2130,46 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
         },
     };
 
-    const vk::raii::Sampler eqmapSampler { gpu.device, vk::SamplerCreateInfo { {}, vk::Filter::eLinear, vk::Filter::eLinear }.setMaxLod(vk::LodClampNone) };
+    vk::raii::Sampler eqmapSampler { gpu.device, vk::SamplerCreateInfo { {}, vk::Filter::eLinear, vk::Filter::eLinear }.setMaxLod(vk::LodClampNone) };
 
-    const cubemap::CubemapComputePipeline cubemapComputePipeline { gpu.device, eqmapImage, eqmapSampler, cubemapImage };
-    const cubemap::SubgroupMipmapComputePipeline subgroupMipmapComputePipeline { gpu.device, cubemapImage, {
+    cubemap::CubemapComputePipeline cubemapComputePipeline { gpu.device, eqmapImage, eqmapSampler, cubemapImage };
+    cubemap::SubgroupMipmapComputePipeline subgroupMipmapComputePipeline { gpu.device, cubemapImage, {
         .subgroupSize = gpu.subgroupSize,
         .useShaderImageLoadStoreLod = gpu.supportShaderImageLoadStoreLod,
     } };
 
     const std::uint32_t prefilteredmapSize = std::min(cubemapSize, 256U);
-    vku::raii::AllocatedImage prefilteredmapImage {
-        gpu.allocator,
-        vk::ImageCreateInfo {
-            vk::ImageCreateFlagBits::eCubeCompatible,
-            vk::ImageType::e2D,
-            cubemapImage.format,
-            vk::Extent3D { prefilteredmapSize, prefilteredmapSize, 1 },
-            vku::maxMipLevels(prefilteredmapSize), 6,
-            vk::SampleCountFlagBits::e1,
-            vk::ImageTiling::eOptimal,
-            ibl::PrefilteredmapComputePipeline::requiredPrefilteredmapImageUsageFlags | vk::ImageUsageFlagBits::eSampled,
-        },
-        vma::AllocationCreateInfo {
-            {},
-            vma::MemoryUsage::eAutoPreferDevice,
-        },
+    const auto createPrefilteredmapImage = [&](std::span<const std::uint32_t> queueFamilyIndices) {
+        return vku::raii::AllocatedImage {
+            gpu.allocator,
+            vk::ImageCreateInfo {
+                vk::ImageCreateFlagBits::eCubeCompatible,
+                vk::ImageType::e2D,
+                cubemapImage.format,
+                vk::Extent3D { prefilteredmapSize, prefilteredmapSize, 1 },
+                vku::maxMipLevels(prefilteredmapSize), 6,
+                vk::SampleCountFlagBits::e1,
+                vk::ImageTiling::eOptimal,
+                ibl::PrefilteredmapComputePipeline::requiredPrefilteredmapImageUsageFlags | vk::ImageUsageFlagBits::eSampled,
+                vku::getSharingMode(queueFamilyIndices), queueFamilyIndices,
+            },
+            vma::AllocationCreateInfo {
+                {},
+                vma::MemoryUsage::eAutoPreferDevice,
+            },
+        };
     };
+
+    // Low sample count prefilteredmap that is generated with the other resources, and shown until the full sample
+    // count prefilteredmap is ready.
+    std::optional<vku::raii::AllocatedImage> previewPrefilteredmapImage = value_if(progressive, [&] {
+        return createPrefilteredmapImage({});
+    });
+
+    // Full sample count prefilteredmap, generated over multiple frames in the compute queue. As it is written by the
+    // compute queue and read by the graphics queue without the initial pass's ownership transfer chain, it is created
+    // with concurrent sharing mode.
+    vku::raii::AllocatedImage prefilteredmapImage = createPrefilteredmapImage(gpu.queueFamilies.uniqueIndices);
     vku::raii::AllocatedBuffer sphericalHarmonicsBuffer {
         gpu.allocator,
         vk::BufferCreateInfo {
@@ -1518,16 +2185,17 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
         },
     };
 
-    const ibl::SphericalHarmonicCoefficientComputePipeline sphericalHarmonicCoefficientComputePipeline { gpu.device, gpu.allocator, cubemapImage, sphericalHarmonicsBuffer, {
+    ibl::SphericalHarmonicCoefficientComputePipeline sphericalHarmonicCoefficientComputePipeline { gpu.device, gpu.allocator, cubemapImage, sphericalHarmonicsBuffer, {
         .sampleMipLevel = 0,
         .subgroupSize = gpu.subgroupSize,
     } };
-    const ibl::PrefilteredmapComputePipeline prefilteredmapComputePipeline { gpu.device, cubemapImage, prefilteredmapImage, {
-        .useShaderImageLoadStoreLod = gpu.supportShaderImageLoadStoreLod,
-        .specializationConstants = {
-            .samples = 1024,
-        },
-    } };
+    std::optional<ibl::PrefilteredmapComputePipeline> previewPrefilteredmapComputePipeline = previewPrefilteredmapImage.transform([&](const vku::raii::AllocatedImage &image) {
+        return ibl::PrefilteredmapComputePipeline { gpu.device, gpu.allocator, cubemapImage, image, {
+            .useShaderImageLoadStoreLod = gpu.supportShaderImageLoadStoreLod,
+            .sampleCount = PREVIEW_PREFILTEREDMAP_SAMPLE_COUNT,
+            .adaptiveSampleCount = true,
+        } };
+    });
 
     // Generate tonemapped cubemap.
     vku::raii::AllocatedImage tonemappedCubemapImage {
@@ -1548,21 +2216,21 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
         },
     };
 
-    const vulkan::rp::Tonemapping cubemapTonemappingRenderPass { gpu.device, {
+    vulkan::rp::Tonemapping cubemapTonemappingRenderPass { gpu.device, {
         .inputFormat = cubemapImage.format,
         .outputFormat = tonemappedCubemapImage.format,
         .inputImagePreserved = false,
         .multiviewMask = 0b111111U,
     } };
-    const vulkan::TonemappingRenderPipeline cubemapTonemappingRenderPipeline { gpu, cubemapTonemappingRenderPass };
+    vulkan::TonemappingRenderPipeline cubemapTonemappingRenderPipeline { gpu, cubemapTonemappingRenderPass };
 
-    const std::vector perMipLevelCubemapImageViews
+    std::vector perMipLevelCubemapImageViews
         = cubemapImage.getPerMipLevelViewCreateInfos(vk::ImageViewType::e2DArray)
         | std::views::transform([&](const vk::ImageViewCreateInfo &createInfo) {
             return vk::raii::ImageView { gpu.device, createInfo };
         })
         | std::ranges::to<std::vector>();
-    const std::vector perMipLevelTonemappedCubemapImageViews
+    std::vector perMipLevelTonemappedCubemapImageViews
         = tonemappedCubemapImage.getPerMipLevelViewCreateInfos(vk::ImageViewType::e2DArray)
         | std::views::transform([&](const vk::ImageViewCreateInfo &createInfo) {
             return vk::raii::ImageView { gpu.device, createInfo };
@@ -1589,11 +2257,13 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
     vk::CommandPool graphicsCommandPool = *commandPools.try_emplace(gpu.queueFamilies.graphicsPresent, gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.graphicsPresent }).first->second;
     vk::CommandPool transferCommandPool = *commandPools.try_emplace(gpu.queueFamilies.transfer, gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.transfer }).first->second;
 
-    std::array semaphores = ARRAY_OF(2, vk::raii::Semaphore { gpu.device, vk::StructureChain {
-        vk::SemaphoreCreateInfo{},
-        vk::SemaphoreTypeCreateInfo { vk::SemaphoreType::eTimeline, 0 },
-    }.get() });
-    std::array<std::uint64_t, 2> signalValues { 0ULL, 0ULL };
+    // The commands are split into the submissions of the multiple queues if their queue families are different. Each
+    // submission waits for the previous one.
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+    const auto submitAndChain = [&](vulkan::QueueTimeline &timeline, vk::CommandBuffer cb) {
+        const std::uint64_t signalValue = timeline.submit(waitInfos, vku::lvalue(vk::CommandBufferSubmitInfo { cb }));
+        waitInfos = { timeline.getWaitInfo(signalValue, vk::PipelineStageFlagBits2::eAllCommands) };
+    };
 
     vk::CommandBuffer transferCb = (*gpu.device).allocateCommandBuffers({ transferCommandPool, vk::CommandBufferLevel::ePrimary, 1 })[0];
     transferCb.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
@@ -1634,13 +2304,7 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
     vk::CommandBuffer graphicsCb = transferCb;
     if (graphicsCommandPool != transferCommandPool) {
         transferCb.end();
-        gpu.queues.transfer.submit2KHR(vk::SubmitInfo2 {
-            {},
-            {},
-            vku::lvalue(vk::CommandBufferSubmitInfo { transferCb }),
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), 1, vk::PipelineStageFlagBits2::eAllCommands }),
-        });
-        get<0>(signalValues) = 1;
+        submitAndChain(timelines.transfer, transferCb);
 
         graphicsCb = (*gpu.device).allocateCommandBuffers({ graphicsCommandPool, vk::CommandBufferLevel::ePrimary, 1 })[0];
         graphicsCb.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
@@ -1707,13 +2371,7 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
     vk::CommandBuffer computeCb = graphicsCb;
     if (computeCommandPool != graphicsCommandPool) {
         graphicsCb.end();
-        gpu.queues.graphicsPresent.submit2KHR(vk::SubmitInfo2 {
-            {},
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), get<0>(signalValues), {} }),
-            vku::lvalue(vk::CommandBufferSubmitInfo { graphicsCb }),
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), 2, vk::PipelineStageFlagBits2::eAllCommands }),
-        });
-        get<0>(signalValues) = 2;
+        submitAndChain(timelines.graphicsPresent, graphicsCb);
 
         graphicsCb = (*gpu.device).allocateCommandBuffers({ graphicsCommandPool, vk::CommandBufferLevel::ePrimary, 1 })[0];
         graphicsCb.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
@@ -1758,53 +2416,55 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
     // Generate cubemapImage mipmaps.
     subgroupMipmapComputePipeline.recordCommands(computeCb);
 
-    computeCb.pipelineBarrier2KHR({
-        {}, {}, {},
-        vku::lvalue({
-            // cubemapImage : General -> ShaderReadOnlyOptimal.
-            vk::ImageMemoryBarrier2 {
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
-                vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
-                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-            },
-            // prefilteredmapImage: Undefined -> ShaderReadOnlyOptimal.
-            vk::ImageMemoryBarrier2 {
-                {}, {},
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
-                {}, vk::ImageLayout::eGeneral,
-                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                prefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-            },
-        }),
-    });
+    boost::container::static_vector<vk::ImageMemoryBarrier2, 2> imageMemoryBarriers {
+        // cubemapImage : General -> ShaderReadOnlyOptimal.
+        vk::ImageMemoryBarrier2 {
+            vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+            vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
+            vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+            cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+        },
+    };
+    if (previewPrefilteredmapImage) {
+        // previewPrefilteredmapImage: Undefined -> General.
+        imageMemoryBarriers.push_back({
+            {}, {},
+            vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+            {}, vk::ImageLayout::eGeneral,
+            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+            *previewPrefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+        });
+    }
+    computeCb.pipelineBarrier2KHR({ {}, {}, {}, imageMemoryBarriers });
 
-    // Generate prefiltered map.
-    prefilteredmapComputePipeline.recordCommands(computeCb);
+    // Generate preview prefiltered map.
+    if (previewPrefilteredmapComputePipeline) {
+        previewPrefilteredmapComputePipeline->recordCommands(computeCb);
+    }
 
     // Reduce spherical harmonic coefficients.
     sphericalHarmonicCoefficientComputePipeline.recordCommands(computeCb);
 
-    computeCb.pipelineBarrier2KHR({
-        {}, {}, {},
-        vku::lvalue({
-            vk::ImageMemoryBarrier2 {
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
-                vk::PipelineStageFlagBits2::eAllCommands, {},
-                {}, {},
-                gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
-                cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-            },
-            vk::ImageMemoryBarrier2 {
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
-                vk::PipelineStageFlagBits2::eAllCommands, {},
-                vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
-                gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
-                prefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-            },
-        }),
-    });
+    imageMemoryBarriers = {
+        vk::ImageMemoryBarrier2 {
+            vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
+            vk::PipelineStageFlagBits2::eAllCommands, {},
+            {}, {},
+            gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
+            cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+        },
+    };
+    if (previewPrefilteredmapImage) {
+        imageMemoryBarriers.push_back({
+            vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+            vk::PipelineStageFlagBits2::eAllCommands, {},
+            vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+            gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
+            *previewPrefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+        });
+    }
+    computeCb.pipelineBarrier2KHR({ {}, {}, {}, imageMemoryBarriers });
 
     // ----- Generate reducedEqmapImage mipmaps -----
 
@@ -1842,46 +2502,34 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
 
     if (graphicsCommandPool != computeCommandPool) {
         computeCb.end();
-        gpu.queues.compute.submit2KHR(vk::SubmitInfo2 {
-            {},
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), get<0>(signalValues), {} }),
-            vku::lvalue(vk::CommandBufferSubmitInfo { computeCb }),
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), 3, vk::PipelineStageFlagBits2::eAllCommands }),
-        });
-        get<0>(signalValues) = 3;
+        submitAndChain(timelines.compute, computeCb);
 
         graphicsCb.end();
-        gpu.queues.graphicsPresent.submit2KHR(vk::SubmitInfo2 {
-            {},
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), get<0>(signalValues), {} }),
-            vku::lvalue(vk::CommandBufferSubmitInfo { graphicsCb }),
-            vku::lvalue(vk::SemaphoreSubmitInfo { *get<1>(semaphores), 1, vk::PipelineStageFlagBits2::eAllCommands }),
-        });
-        get<1>(signalValues) = 1;
+        submitAndChain(timelines.graphicsPresent, graphicsCb);
 
         graphicsCb = (*gpu.device).allocateCommandBuffers({ graphicsCommandPool, vk::CommandBufferLevel::ePrimary, 1 })[0];
         graphicsCb.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
-        // Acquire queue family onwership of cubemapImage and prefilteredmapImage from compute to graphics.
-        graphicsCb.pipelineBarrier2KHR({
-            {}, {}, {},
-            vku::lvalue({
-                vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eAllCommands, {},
-                    {}, {},
-                    gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
-                    cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-                },
-                vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eAllCommands, {},
-                    vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
-                    gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
-                    prefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-                },
-            }),
-        });
+        // Acquire queue family onwership of cubemapImage and previewPrefilteredmapImage from compute to graphics.
+        imageMemoryBarriers = {
+            vk::ImageMemoryBarrier2 {
+                {}, {},
+                vk::PipelineStageFlagBits2::eAllCommands, {},
+                {}, {},
+                gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
+                cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+            },
+        };
+        if (previewPrefilteredmapImage) {
+            imageMemoryBarriers.push_back({
+                {}, {},
+                vk::PipelineStageFlagBits2::eAllCommands, {},
+                vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+                gpu.queueFamilies.compute, gpu.queueFamilies.graphicsPresent,
+                *previewPrefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+            });
+        }
+        graphicsCb.pipelineBarrier2KHR({ {}, {}, {}, imageMemoryBarriers });
     }
 
     // ----- Create tonemapped cubemap image (=tonemappedCubemapImage) from high-precision image (=cubemapImage) -----
@@ -1914,26 +2562,27 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
         renderArea.extent.height = std::max(renderArea.extent.height >> 1, 1U);
     }
 
-    graphicsCb.end();
-    gpu.queues.graphicsPresent.submit2KHR(vk::SubmitInfo2 {
-        {},
-        vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), get<0>(signalValues), {} }),
-        vku::lvalue(vk::CommandBufferSubmitInfo { graphicsCb }),
-        vku::lvalue(vk::SemaphoreSubmitInfo { *get<0>(semaphores), 4, {} }),
+    // Release queue family ownership of cubemapImage from graphics to compute, as it will be sampled by the
+    // prefilteredmap refinement.
+    graphicsCb.pipelineBarrier2KHR({
+        {}, {}, {},
+        vku::lvalue(vk::ImageMemoryBarrier2 {
+            vk::PipelineStageFlagBits2::eFragmentShader, {},
+            vk::PipelineStageFlagBits2::eAllCommands, {},
+            vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+            gpu.queueFamilies.graphicsPresent, gpu.queueFamilies.compute,
+            cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+        }),
     });
-    get<0>(signalValues) = 4;
 
-    std::ignore = gpu.device.waitSemaphores({ {}, vku::lvalue({ *get<0>(semaphores), *get<1>(semaphores) }), signalValues }, ~0ULL);
+    graphicsCb.end();
+    const std::uint64_t initialPassFinishValue = timelines.graphicsPresent.submit(waitInfos, vku::lvalue(vk::CommandBufferSubmitInfo { graphicsCb }));
 
-    const std::span<glm::vec3, 9> sphericalHarmonicCoefficients { static_cast<glm::vec3*>(sphericalHarmonicsBuffer.getAllocation().getInfo().pMappedData), 9 };
-    for (float multiplier = 4.f * std::numbers::pi_v<float> / (cubemapSize * cubemapSize * 6.f);
-        glm::vec3 &v : sphericalHarmonicCoefficients) {
-        v *= multiplier;
-    }
+    const auto makeTypeErased = []<typename... Ts>(Ts &&...xs) {
+        return std::static_pointer_cast<void>(std::make_shared<std::tuple<std::remove_cvref_t<Ts>...>>(FWD(xs)...));
+    };
 
-    // Update AppState.
-    renderer->setSkybox({} /* TODO */);
-    appState.imageBasedLightingProperties = AppState::ImageBasedLighting {
+    AppState::ImageBasedLighting properties {
         .eqmap = {
             .path = eqmapPath,
             .dimension = { eqmapImage.extent.width, eqmapImage.extent.height },
@@ -1944,49 +2593,265 @@ void vk_gltf_viewer::MainApp::loadEqmap(const std::filesystem::path &eqmapPath)
         .prefilteredmap = {
             .size = prefilteredmapSize,
             .roughnessLevels = prefilteredmapImage.mipLevels,
-            .sampleCount = 1024,
-        }
+            .quality = prefilteredmapQuality,
+            .sampleCount = getPrefilteredmapSampleCount(prefilteredmapQuality),
+        },
     };
-    std::ranges::copy(
-        sphericalHarmonicCoefficients,
-        appState.imageBasedLightingProperties->diffuseIrradiance.sphericalHarmonicCoefficients.begin());
-
-    // Emplace the results into skyboxResources and imageBasedLightingResources.
-    vk::raii::ImageView reducedEqmapImageView { gpu.device, reducedEqmapImage.getViewCreateInfo(vk::ImageViewType::e2D) };
-    const vk::DescriptorSet imGuiEqmapImageDescriptorSet = ImGui_ImplVulkan_AddTexture(
-        *reducedEqmapSampler,
-        *reducedEqmapImageView,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    vk::raii::ImageView tonemappedCubemapImageView { gpu.device, tonemappedCubemapImage.getViewCreateInfo(vk::ImageViewType::eCube) };
-    skyboxResources.emplace(
-        std::move(reducedEqmapImage),
-        std::move(reducedEqmapImageView),
-        std::move(tonemappedCubemapImage),
-        std::move(tonemappedCubemapImageView),
-        imGuiEqmapImageDescriptorSet);
 
-    vk::raii::ImageView prefilteredmapImageView { gpu.device, prefilteredmapImage.getViewCreateInfo(vk::ImageViewType::eCube) };
-    imageBasedLightingResources = {
-        std::move(sphericalHarmonicsBuffer),
-        std::move(prefilteredmapImage),
-        std::move(prefilteredmapImageView),
-    };
+    imageBasedLightingGeneration = std::make_unique<ImageBasedLightingGeneration>(
+        std::move(properties),
+        initialPassFinishValue,
+        // GPU may still be executing the commands that use these resources, therefore their destruction is deferred.
+        makeTypeErased(
+            std::move(eqmapStagingBuffer), std::move(eqmapImage), std::move(eqmapSampler),
+            std::move(cubemapComputePipeline), std::move(subgroupMipmapComputePipeline),
+            std::move(sphericalHarmonicCoefficientComputePipeline), std::move(previewPrefilteredmapComputePipeline),
+            std::move(cubemapTonemappingRenderPass), std::move(cubemapTonemappingRenderPipeline),
+            std::move(perMipLevelCubemapImageViews), std::move(perMipLevelTonemappedCubemapImageViews),
+            std::move(tonemappingFramebuffers), std::move(commandPools)),
+        ImageBasedLightingGeneration::InitialPassResult {
+            std::move(reducedEqmapImage),
+            std::move(tonemappedCubemapImage),
+            std::move(sphericalHarmonicsBuffer),
+            std::move(previewPrefilteredmapImage),
+        },
+        std::move(cubemapImage),
+        std::move(prefilteredmapImage));
+
+    // Pipeline for refinement must refer the images owned by imageBasedLightingGeneration.
+    imageBasedLightingGeneration->prefilteredmapComputePipeline.emplace(
+        gpu.device, gpu.allocator, imageBasedLightingGeneration->cubemapImage, imageBasedLightingGeneration->prefilteredmapImage,
+        ibl::PrefilteredmapComputePipeline::Config {
+            .useShaderImageLoadStoreLod = gpu.supportShaderImageLoadStoreLod,
+            .sampleCount = getPrefilteredmapSampleCount(prefilteredmapQuality),
+            .adaptiveSampleCount = prefilteredmapQuality != AppState::ImageBasedLighting::Prefilteredmap::Quality::Reference,
+        });
 
-    // Update the related descriptor sets.
-    gpu.device.updateDescriptorSets({
-        sharedData.imageBasedLightingDescriptorSet.getWrite<0>(0, vku::lvalue(vk::DescriptorBufferInfo { imageBasedLightingResources.cubemapSphericalHarmonicsBuffer, 0, vk::WholeSize })),
-        sharedData.imageBasedLightingDescriptorSet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *imageBasedLightingResources.prefilteredmapImageView,
-            vk::ImageLayout::eShaderReadOnlyOptimal,
-        })),
-        sharedData.skyboxDescriptorSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *skyboxResources->cubemapImageView,
-            vk::ImageLayout::eShaderReadOnlyOptimal,
-        })),
-    }, {});
+    // Split the full sample count prefilteredmap generation into the regions of a single workgroup row, which are the
+    // smallest unit of a refinement batch.
+    for (std::uint32_t mipLevel = 0; mipLevel < imageBasedLightingGeneration->prefilteredmapImage.mipLevels; ++mipLevel) {
+        const std::uint32_t workgroupRowCount = imageBasedLightingGeneration->prefilteredmapComputePipeline->getWorkgroupRowCount(mipLevel);
+        for (std::uint32_t face = 0; face < 6; ++face) {
+            for (std::uint32_t workgroupRow = 0; workgroupRow < workgroupRowCount; ++workgroupRow) {
+                imageBasedLightingGeneration->prefilteredmapRegions.push_back({ mipLevel, face, workgroupRow, 1 });
+            }
+        }
+    }
+
+    imageBasedLightingGeneration->computeCommandPool.emplace(gpu.device, vk::CommandPoolCreateInfo { vk::CommandPoolCreateFlagBits::eTransient, gpu.queueFamilies.compute });
+    imageBasedLightingGeneration->computeCommandBuffer = (*gpu.device).allocateCommandBuffers({
+        **imageBasedLightingGeneration->computeCommandPool,
+        vk::CommandBufferLevel::ePrimary,
+        1,
+    })[0];
+    if (gpu.supportComputeQueueTimestamp) {
+        imageBasedLightingGeneration->timestampQueryPool.emplace(gpu.device, vk::QueryPoolCreateInfo { {}, vk::QueryType::eTimestamp, 2 });
+    }
 
     // Update AppState.
     imGuiContext.userData.pushRecentSkyboxPath(eqmapPath.u8string());
 }
+
+void vk_gltf_viewer::MainApp::updateImageBasedLightingGeneration(std::span<vulkan::FrameDeferredTask> frameDeferredTasks) {
+    if (!imageBasedLightingGeneration) return;
+
+    ImageBasedLightingGeneration &generation = *imageBasedLightingGeneration;
+    if (!timelines.graphicsPresent.isReached(generation.initialPassFinishValue) ||
+        !timelines.compute.isReached(generation.lastRefinementFinishValue)) {
+        // GPU is still executing the last submitted work. Do not stall the frame.
+        return;
+    }
+
+    // Replace the application's IBL resources with the generated ones. The frames submitted until now may still use
+    // the current resources, therefore they are retired until the frames are finished, and each frame's descriptor
+    // sets are updated to the new resources when the frame is reused.
+    const auto replaceResources = [&](vku::raii::AllocatedImage prefilteredmapImage) {
+        const std::uint64_t framesFinishValue = timelines.graphicsPresent.getLastSubmittedValue();
+
+        if (generation.initialPassResult) {
+            auto &[reducedEqmapImage, tonemappedCubemapImage, sphericalHarmonicsBuffer, _] = *generation.initialPassResult;
+
+            renderer->setSkybox({} /* TODO */);
+
+            vk::raii::ImageView reducedEqmapImageView { gpu.device, reducedEqmapImage.getViewCreateInfo(vk::ImageViewType::e2D) };
+            const vk::DescriptorSet imGuiEqmapImageDescriptorSet = ImGui_ImplVulkan_AddTexture(
+                *reducedEqmapSampler,
+                *reducedEqmapImageView,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            vk::raii::ImageView tonemappedCubemapImageView { gpu.device, tonemappedCubemapImage.getViewCreateInfo(vk::ImageViewType::eCube) };
+            if (skyboxResources) {
+                timelines.graphicsPresent.retire(framesFinishValue, std::move(skyboxResources));
+            }
+            skyboxResources = std::make_unique<SkyboxResources>(
+                std::move(reducedEqmapImage),
+                std::move(reducedEqmapImageView),
+                std::move(tonemappedCubemapImage),
+                std::move(tonemappedCubemapImageView),
+                imGuiEqmapImageDescriptorSet);
+
+            timelines.graphicsPresent.retire(framesFinishValue, std::move(imageBasedLightingResources.cubemapSphericalHarmonicsBuffer));
+            imageBasedLightingResources.cubemapSphericalHarmonicsBuffer = std::move(sphericalHarmonicsBuffer);
+            generation.initialPassResult.reset();
+
+            for (vulkan::FrameDeferredTask &task : frameDeferredTasks) {
+                task.updateSkybox(*skyboxResources->cubemapImageView);
+            }
+        }
+
+        timelines.graphicsPresent.retire(framesFinishValue, std::move(imageBasedLightingResources.prefilteredmapImageView));
+        timelines.graphicsPresent.retire(framesFinishValue, std::move(imageBasedLightingResources.prefilteredmapImage));
+        imageBasedLightingResources.prefilteredmapImageView = { gpu.device, prefilteredmapImage.getViewCreateInfo(vk::ImageViewType::eCube) };
+        imageBasedLightingResources.prefilteredmapImage = std::move(prefilteredmapImage);
+
+        for (vulkan::FrameDeferredTask &task : frameDeferredTasks) {
+            task.updateImageBasedLighting(
+                { imageBasedLightingResources.cubemapSphericalHarmonicsBuffer, 0, vk::WholeSize },
+                *imageBasedLightingResources.prefilteredmapImageView,
+                *brdfmapImageView);
+        }
+
+        appState.imageBasedLightingProperties = generation.properties;
+    };
+
+    if (generation.initialPassResources) {
+        // Initial pass is finished, and its resources can be destroyed.
+        generation.initialPassResources.reset();
+
+        const std::span<glm::vec3, 9> sphericalHarmonicCoefficients {
+            static_cast<glm::vec3*>(generation.initialPassResult->sphericalHarmonicsBuffer.getAllocation().getInfo().pMappedData),
+            9,
+        };
+        for (float multiplier = 4.f * std::numbers::pi_v<float> / (generation.properties.cubemap.size * generation.properties.cubemap.size * 6.f);
+            glm::vec3 &v : sphericalHarmonicCoefficients) {
+            v *= multiplier;
+        }
+        std::ranges::copy(sphericalHarmonicCoefficients, generation.properties.diffuseIrradiance.sphericalHarmonicCoefficients.begin());
+
+        if (generation.initialPassResult->previewPrefilteredmapImage) {
+            // Show the preview until the refinement is finished.
+            const AppState::ImageBasedLighting properties = generation.properties;
+            generation.properties.prefilteredmap.sampleCount = PREVIEW_PREFILTEREDMAP_SAMPLE_COUNT;
+            generation.properties.prefilteredmap.refinementProgress.emplace(0.f);
+            replaceResources(std::move(*generation.initialPassResult->previewPrefilteredmapImage));
+            generation.properties = properties;
+        }
+    }
+    else if (generation.timestampQueryPool && generation.lastBatchSampleCount != 0) {
+        // Update the GPU throughput estimation by the execution time of the last batch.
+        const auto [result, timestamps] = generation.timestampQueryPool->getResults<std::uint64_t>(
+            0, 2, sizeof(std::uint64_t[2]), sizeof(std::uint64_t), vk::QueryResultFlagBits::e64);
+        if (result == vk::Result::eSuccess && timestamps[1] > timestamps[0]) {
+            const double elapsedNanoseconds = (timestamps[1] - timestamps[0]) * static_cast<double>(gpu.timestampPeriod);
+            // Use the moving average to avoid the fluctuation by the measurement noise.
+            generation.samplesPerNanosecond = std::lerp(generation.samplesPerNanosecond, generation.lastBatchSampleCount / elapsedNanoseconds, 0.5);
+        }
+    }
+
+    if (generation.nextRegionIndex == generation.prefilteredmapRegions.size()) {
+        // Refinement is finished. As the prefilteredmap is written by the compute queue, make the graphics queue
+        // wait for it before any frame uses it.
+        timelines.graphicsPresent.addDependency({ timelines.compute, generation.lastRefinementFinishValue }, vk::PipelineStageFlagBits2::eFragmentShader);
+        replaceResources(std::move(generation.prefilteredmapImage));
+        imageBasedLightingGeneration.reset();
+        return;
+    }
+
+    // ----- Record and submit the next refinement batch -----
+
+    // Collect regions whose estimated execution time fits in the budget. At least one region is always processed to
+    // guarantee the progress.
+    const double budgetSampleCount = generation.samplesPerNanosecond * std::chrono::nanoseconds { PREFILTEREDMAP_REFINEMENT_BUDGET }.count();
+    const bool isFirstBatch = generation.nextRegionIndex == 0;
+    std::vector<ibl::PrefilteredmapComputePipeline::DispatchRegion> batchRegions;
+    std::uint64_t batchSampleCount = 0;
+    do {
+        const ibl::PrefilteredmapComputePipeline::DispatchRegion &region = generation.prefilteredmapRegions[generation.nextRegionIndex];
+        const std::uint32_t mipSize = std::max(generation.prefilteredmapImage.extent.width >> region.mipLevel, 1U);
+        const std::uint64_t regionSampleCount
+            = static_cast<std::uint64_t>(mipSize)
+            * std::min(16U * region.workgroupRowCount, mipSize - std::min(16U * region.workgroupRowOffset, mipSize))
+            * generation.prefilteredmapComputePipeline->getSampleCount(region.mipLevel);
+        if (!batchRegions.empty() && batchSampleCount + regionSampleCount > budgetSampleCount) {
+            break;
+        }
+
+        // Merge with the previous region if they are contiguous, to reduce the dispatch count.
+        if (!batchRegions.empty() &&
+            batchRegions.back().mipLevel == region.mipLevel &&
+            batchRegions.back().face == region.face &&
+            batchRegions.back().workgroupRowOffset + batchRegions.back().workgroupRowCount == region.workgroupRowOffset) {
+            batchRegions.back().workgroupRowCount += region.workgroupRowCount;
+        }
+        else {
+            batchRegions.push_back(region);
+        }
+
+        batchSampleCount += regionSampleCount;
+    } while (++generation.nextRegionIndex < generation.prefilteredmapRegions.size());
+    const bool isLastBatch = generation.nextRegionIndex == generation.prefilteredmapRegions.size();
+
+    generation.computeCommandPool->reset();
+    generation.computeCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    if (isFirstBatch) {
+        generation.computeCommandBuffer.pipelineBarrier2KHR({
+            {}, {}, {},
+            vku::lvalue({
+                // Acquire queue family ownership of cubemapImage from graphics to compute.
+                vk::ImageMemoryBarrier2 {
+                    {}, {},
+                    vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
+                    vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                    gpu.queueFamilies.graphicsPresent, gpu.queueFamilies.compute,
+                    generation.cubemapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+                },
+                // prefilteredmapImage: Undefined -> General.
+                vk::ImageMemoryBarrier2 {
+                    {}, {},
+                    vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+                    {}, vk::ImageLayout::eGeneral,
+                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+                    generation.prefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+                },
+            }),
+        });
+    }
+
+    if (generation.timestampQueryPool) {
+        generation.computeCommandBuffer.resetQueryPool(**generation.timestampQueryPool, 0, 2);
+        generation.computeCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, **generation.timestampQueryPool, 0);
+    }
+
+    generation.prefilteredmapComputePipeline->recordCommands(generation.computeCommandBuffer, batchRegions);
+
+    if (generation.timestampQueryPool) {
+        generation.computeCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, **generation.timestampQueryPool, 1);
+    }
+
+    if (isLastBatch) {
+        // prefilteredmapImage: General -> ShaderReadOnlyOptimal.
+        generation.computeCommandBuffer.pipelineBarrier2KHR({
+            {}, {}, {},
+            vku::lvalue(vk::ImageMemoryBarrier2 {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+                vk::PipelineStageFlagBits2::eAllCommands, {},
+                vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+                generation.prefilteredmapImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
+            }),
+        });
+    }
+
+    generation.computeCommandBuffer.end();
+
+    generation.lastRefinementFinishValue = timelines.compute.submit(
+        timelines.graphicsPresent.getWaitInfo(generation.initialPassFinishValue, vk::PipelineStageFlagBits2::eComputeShader),
+        vku::lvalue(vk::CommandBufferSubmitInfo { generation.computeCommandBuffer }));
+    generation.lastBatchSampleCount = batchSampleCount;
+
+    // Update the refinement progress shown in the GUI.
+    if (appState.imageBasedLightingProperties && appState.imageBasedLightingProperties->prefilteredmap.refinementProgress) {
+        appState.imageBasedLightingProperties->prefilteredmap.refinementProgress.emplace(
+            static_cast<float>(generation.nextRegionIndex) / generation.prefilteredmapRegions.size());
+    }
+}
@@ -12,6 +12,7 @@ module vk_gltf_viewer.imgui.TaskCollector;
 
 import fmt;
 
+import vk_gltf_viewer.cpu_profiler;
 import vk_gltf_viewer.global;
 import vk_gltf_viewer.gltf.algorithm.miniball;
 import vk_gltf_viewer.gltf.util;
@@ -57,6 +58,52 @@ int boundFpPrecision = 2;
     }
 }
 
+[[nodiscard]] std::optional<std::filesystem::path> processSaveFileDialog(std::span<const nfdfilteritem_t> filterItems, const char *defaultName, const nfdwindowhandle_t &windowHandle) {
+    static NFD::Guard nfdGuard;
+
+    NFD::UniquePath outPath;
+    if (nfdresult_t nfdResult = SaveDialog(outPath, filterItems.data(), filterItems.size(), nullptr, defaultName, windowHandle); nfdResult == NFD_OKAY) {
+        return outPath.get();
+    }
+    else if (nfdResult == NFD_CANCEL) {
+        return std::nullopt;
+    }
+    else {
+        throw std::runtime_error { fmt::format("File dialog error: {}", NFD::GetError() ) };
+    }
+}
+
+/**
+ * @brief Draw \p items as horizontal bars in a single row, scaled to fit the available width.
+ *
+ * Ranges may overlap (e.g. jump flood in the compute queue runs concurrently with the scene rendering), and the later
+ * one is drawn over the earlier one.
+ */
+void rangeTimeline(const char *id, std::span<const vk_gltf_viewer::AppState::Profiler::Range> items) {
+    if (items.empty()) return;
+
+    const float totalTime = std::ranges::max(items | std::views::transform([](const auto &range) { return range.end.count(); }));
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const ImVec2 size { ImGui::GetContentRegionAvail().x, ImGui::GetFrameHeight() };
+    ImGui::InvisibleButton(id, size);
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    for (const auto &[i, range] : items | ranges::views::enumerate) {
+        const ImVec2 min { origin.x + size.x * range.begin.count() / std::max(totalTime, 1e-3f), origin.y };
+        const ImVec2 max { origin.x + size.x * range.end.count() / std::max(totalTime, 1e-3f), origin.y + size.y };
+        drawList->AddRectFilled(min, max, ImColor::HSV(static_cast<float>(i) / items.size(), 0.6f, 0.8f));
+
+        const std::string_view label = range.name;
+        if (const ImVec2 labelSize = vk_gltf_viewer::imgui::CalcTextSize(label); labelSize.x < max.x - min.x) {
+            drawList->AddText({ min.x + 2.f, min.y + (size.y - labelSize.y) / 2.f }, IM_COL32_WHITE, label.data(), label.data() + label.size());
+        }
+
+        if (ImGui::IsItemHovered() && ImRect { min, max }.Contains(ImGui::GetMousePos())) {
+            ImGui::SetTooltip("%.*s: %.3f ms", static_cast<int>(label.size()), label.data(), (range.end - range.begin).count());
+        }
+    }
+}
+
 void attributeTable(const fastgltf::Asset &asset, std::ranges::viewable_range auto const &attributes) {
     vk_gltf_viewer::imgui::widget::Table<false>(
         "attributes-table",
@@ -392,6 +439,10 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::menuBar(nfdwindowhandle_t wind
         }
         if (ImGui::BeginMenu("Setting")) {
             ImGui::MenuItem("Automatically resolve animation collision", nullptr, &static_cast<imgui::UserData*>(ImGui::GetIO().UserData)->resolveAnimationCollisionAutomatically);
+            ImGui::MenuItem("Progressive IBL generation", nullptr, &static_cast<imgui::UserData*>(ImGui::GetIO().UserData)->progressiveImageBasedLighting);
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip)) {
+                ImGui::SetTooltip("Show low quality prefiltered map first, and refine it in background.");
+            }
             ImGui::EndMenu();
         }
         ImGui::EndMainMenuBar();
@@ -792,14 +843,12 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::assetInspector(gltf::AssetExte
                             if (texture.ddsImageIndex) {
                                 imgui::WithDisabled([&] {
                                     ImGui::Selectable(tempStringBuffer.write("{} (DDS)", *texture.ddsImageIndex).view().c_str(), *texture.ddsImageIndex == selectedImageIndex);
-                                }/*, assetExtended.isImageLoaded(*texture.ddsImageIndex)*/ /* TODO: currently application does not handle this format at all */);
+                                }, !assetExtended.isImageLoaded(*texture.ddsImageIndex));
                             }
                             if (texture.webpImageIndex) {
                                 imgui::WithDisabled([&] {
-                                    if (ImGui::Selectable(tempStringBuffer.write("{} (WEBP)", *texture.webpImageIndex).view().c_str(), *texture.webpImageIndex == selectedImageIndex)) {
-                                        // TODO
-                                    }
-                                }/*, assetExtended.isImageLoaded(*texture.webpImageIndex)*/ /* TODO: currently application does not handle this format at all */);
+                                    ImGui::Selectable(tempStringBuffer.write("{} (WEBP)", *texture.webpImageIndex).view().c_str(), *texture.webpImageIndex == selectedImageIndex);
+                                }, !assetExtended.isImageLoaded(*texture.webpImageIndex));
                             }
 
                             ImGui::EndCombo();
@@ -1437,7 +1486,7 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::sceneHierarchy(Renderer &rende
 
                         if (!nodeIndicesToFit.empty()) {
                             auto fitCameraToNodeMiniball = [
-                                currentNodeMiniball = gltf::algorithm::getMiniball<false>(assetExtended.asset, std::move(nodeIndicesToFit), assetExtended.sceneHierarchy.getWorldTransforms(), assetExtended.externalBuffers),
+                                currentNodeMiniball = gltf::algorithm::getMiniball(assetExtended.asset, nodeIndicesToFit, assetExtended.subtreeBoundingBoxes, assetExtended.threadPool),
                                 &cameraOrLightPoints = get<2>(assetExtended.sceneMiniball.get())
                             ](Camera &camera) {
                                 const auto &[center, radius] = currentNodeMiniball;
@@ -2038,7 +2087,18 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::imageBasedLighting(
         if (ImGui::CollapsingHeader("Prefiltered map")) {
             ImGui::LabelText("Size", "%u", info.prefilteredmap.size);
             ImGui::LabelText("Roughness levels", "%u", info.prefilteredmap.roughnessLevels);
+            if (int quality = static_cast<int>(info.prefilteredmap.quality);
+                ImGui::Combo("Quality", &quality, "Fast\0Balanced\0Reference\0")) {
+                tasks.emplace(std::in_place_type<task::ChangePrefilteredmapQuality>, static_cast<AppState::ImageBasedLighting::Prefilteredmap::Quality>(quality));
+            }
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Fast and Balanced preset scale the sample count by the roughness level.");
             ImGui::LabelText("Samples", "%u", info.prefilteredmap.sampleCount);
+            if (info.prefilteredmap.refinementProgress) {
+                imgui::WithLabel("Refinement"sv, [&]() {
+                    ImGui::ProgressBar(*info.prefilteredmap.refinementProgress);
+                });
+            }
         }
     }
     ImGui::End();
@@ -2146,6 +2206,27 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::rendererSetting(Renderer &rend
                     }
                     ImGui::EndCombo();
                 }
+
+                ImGui::SeparatorText("Level of Detail");
+
+                bool levelOfDetail = renderer.levelOfDetail.has_value();
+                if (ImGui::Checkbox("Enable level of detail", &levelOfDetail)) {
+                    renderer.levelOfDetail.set_active(levelOfDetail);
+                }
+                ImGui::SameLine();
+                imgui::widget::HelperMarker("(?)", "Select the level of detail of each primitive by its screen space simplification error, calculated from the projected bounding sphere. Level of details must be generated at the asset loading (Mesh Optimization section).");
+
+                imgui::WithDisabled([&] {
+                    ImGui::DragFloat("Pixel error", &renderer.levelOfDetail.raw().pixelError, 0.05f, 0.1f, 64.f, "%.2f px", ImGuiSliderFlags_Logarithmic);
+                    ImGui::SliderFloat("Hysteresis", &renderer.levelOfDetail.raw().hysteresis, 0.f, 0.9f, "%.2f");
+                    ImGui::Checkbox("Visualize", &renderer.levelOfDetail.raw().visualize);
+                }, !levelOfDetail);
+
+                ImGui::SeparatorText("Meshlet Culling");
+
+                ImGui::Checkbox("Enable meshlet culling", &renderer.meshletCulling);
+                ImGui::SameLine();
+                imgui::widget::HelperMarker("(?)", "Cull the meshlets of the rendered primitives by the frustum and their normal cone (backface) in the compute shader. Meshlets must be built at the asset loading (Mesh Optimization section). Instanced nodes are not culled.");
             }
         }
 
@@ -2197,6 +2278,10 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::rendererSetting(Renderer &rend
                 ImGui::DragFloat("Thickness##selectedNodeOutline", &renderer.selectedNodeOutline->thickness, 1.f, 1.f, 1.f);
                 ImGui::ColorEdit4("Color##selectedNodeOutline", value_ptr(renderer.selectedNodeOutline->color));
             }, !showSelectedNodeOutline);
+
+            if (ImGui::Checkbox("Half resolution outline", &renderer.halfResolutionOutline)) {
+                tasks.emplace(std::in_place_type<task::OutlineResolutionChanged>);
+            }
         }
 
         if (ImGui::CollapsingHeader("Bloom")) {
@@ -2248,6 +2333,7 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::rendererSetting(Renderer &rend
                 }
 
                 ImGui::DragFloat("Intensity", &renderer.bloom.raw().intensity, 1e-2f, 0.f, 0.1f);
+                ImGui::Checkbox("Half resolution", &renderer.bloom.raw().halfResolution);
             }, !bloom);
         }
 
@@ -2274,6 +2360,214 @@ void vk_gltf_viewer::control::ImGuiTaskCollector::rendererSetting(Renderer &rend
     ImGui::End();
 }
 
+void vk_gltf_viewer::control::ImGuiTaskCollector::framePacing(AppState::FramePacing &framePacing) {
+    // Appended to the renderer setting window.
+    if (ImGui::Begin("Renderer Setting")) {
+        if (ImGui::CollapsingHeader("Frame Pacing")) {
+            int framesInFlight = framePacing.framesInFlight;
+            if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, AppState::FramePacing::maxFramesInFlight, "%d", ImGuiSliderFlags_AlwaysClamp) &&
+                static_cast<std::uint32_t>(framesInFlight) != framePacing.framesInFlight) {
+                tasks.emplace(std::in_place_type<task::ChangeFramesInFlight>, static_cast<std::uint32_t>(framesInFlight));
+            }
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "More frames in flight increase the throughput when CPU and GPU time are unbalanced, at the cost of the input latency.");
+
+            ImGui::Checkbox("Overlap animation sampling", &framePacing.overlapAnimationSampling);
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Sample the animations of the next frame in a worker thread while the current frame is being recorded and submitted.");
+
+            ImGui::SeparatorText("Statistics");
+            ImGui::Text("CPU time: %.2f ms", framePacing.cpuTime.count());
+            ImGui::Text("Frame interval: %.2f ms (%.1f FPS)", framePacing.frameInterval.count(), 1e3f / std::max(framePacing.frameInterval.count(), 1e-3f));
+            ImGui::Text("Input latency: %.2f ms", framePacing.latency.count());
+        }
+    }
+    ImGui::End();
+}
+
+void vk_gltf_viewer::control::ImGuiTaskCollector::dynamicResolution(AppState::DynamicResolution &dynamicResolution) {
+    // Appended to the renderer setting window.
+    if (ImGui::Begin("Renderer Setting")) {
+        if (ImGui::CollapsingHeader("Dynamic Resolution")) {
+            if (int mode = static_cast<int>(dynamicResolution.mode);
+                ImGui::Combo("Mode", &mode, "Disabled\0Dynamic\0Fixed\0")) {
+                dynamicResolution.mode = static_cast<AppState::DynamicResolution::Mode>(mode);
+            }
+
+            switch (dynamicResolution.mode) {
+                case AppState::DynamicResolution::Mode::Disabled:
+                    break;
+                case AppState::DynamicResolution::Mode::Dynamic: {
+                    float targetGpuTime = dynamicResolution.targetGpuTime.count();
+                    if (ImGui::DragFloat("Target GPU time", &targetGpuTime, 0.1f, 1.f, 100.f, "%.1f ms", ImGuiSliderFlags_AlwaysClamp)) {
+                        dynamicResolution.targetGpuTime = std::chrono::duration<float, std::milli> { targetGpuTime };
+                    }
+                    ImGui::SameLine();
+                    imgui::widget::HelperMarker("(?)", "Render scale is adjusted to make the scene rendering GPU time meet the target.");
+
+                    ImGui::SliderFloat("Minimum scale", &dynamicResolution.minScale, 0.25f, 1.f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+                    break;
+                }
+                case AppState::DynamicResolution::Mode::Fixed:
+                    // Use 0.05 steps, as same as the dynamic mode.
+                    if (ImGui::SliderFloat("Scale", &dynamicResolution.fixedScale, 0.25f, 1.f, "%.2f", ImGuiSliderFlags_AlwaysClamp)) {
+                        dynamicResolution.fixedScale = std::round(dynamicResolution.fixedScale * 20.f) / 20.f;
+                    }
+                    break;
+            }
+
+            ImGui::SeparatorText("Statistics");
+            ImGui::Text("Render scale: %.2f", dynamicResolution.scale);
+            ImGui::Text("Scene GPU time: %.2f ms", dynamicResolution.gpuTime.count());
+        }
+    }
+    ImGui::End();
+}
+
+void vk_gltf_viewer::control::ImGuiTaskCollector::meshOptimization(AppState::MeshOptimization &meshOptimization, const gltf::AssetExtended *assetExtended) {
+    // Appended to the renderer setting window.
+    if (ImGui::Begin("Renderer Setting")) {
+        if (ImGui::CollapsingHeader("Mesh Optimization")) {
+            ImGui::Checkbox("Optimize meshes on load", &meshOptimization.enabled);
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Reorder the primitives' indices and vertices for the vertex cache, overdraw and vertex fetch efficiency. Applied from the next loaded glTF asset, and the result is cached per asset.");
+
+            ImGui::Checkbox("Generate LODs on load", &meshOptimization.generateLevelOfDetails);
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Simplify the indexed triangle list primitives into the level of detail chains, which are selected by their screen space error (configured in the Camera section). Applied from the next loaded glTF asset.");
+
+            ImGui::Checkbox("Build meshlets on load", &meshOptimization.buildMeshlets);
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Partition the static indexed triangle list primitives into the meshlets, which are culled by their bounding sphere and normal cone in the compute shader (configured in the Camera section). Primitives with the level of details are excluded. Applied from the next loaded glTF asset.");
+
+            ImGui::Checkbox("Quantize vertex attributes on load", &meshOptimization.quantizeVertexAttributes);
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Quantize the FLOAT vertex attributes into the 16-bit streams: positions relative to their bounding box, octahedral mapped normals and tangents, and normalized texture coordinates (only if they are in [0, 1] range). Applied from the next loaded glTF asset.");
+
+            ImGui::Checkbox("Fast tangent generation", &meshOptimization.fastTangentGeneration);
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Generate the missing tangents by accumulating the adjacent triangles' texture space derivatives per vertex, instead of MikkTSpace algorithm. Much faster for large meshes, but normal maps may show seams at the mirrored texture coordinates. Applied from the next loaded glTF asset.");
+
+            if (assetExtended && assetExtended->meshOptimizationStatistics) {
+                const auto &statistics = *assetExtended->meshOptimizationStatistics;
+                ImGui::SeparatorText("Statistics");
+                ImGui::Text("Optimized primitives: %zu (skipped: %zu)", statistics.optimizedPrimitiveCount, statistics.skippedPrimitiveCount);
+                ImGui::Text("ACMR: %.3f -> %.3f", statistics.acmrBefore, statistics.acmrAfter);
+                ImGui::SameLine();
+                imgui::widget::HelperMarker("(?)", "Average cache miss ratio: transformed vertices per triangle with 16-entry FIFO cache. Lower is better.");
+                ImGui::Text("Position overfetch: %.3f -> %.3f", statistics.overfetchBefore, statistics.overfetchAfter);
+                ImGui::Text("Time: %.2f ms%s", statistics.time.count(), statistics.cacheHit ? " (cached)" : "");
+            }
+        }
+    }
+    ImGui::End();
+}
+
+void vk_gltf_viewer::control::ImGuiTaskCollector::profiler(AppState::Profiler &profiler, nfdwindowhandle_t windowHandle) {
+    if (ImGui::Begin("Profiler")) {
+        ImGui::SeparatorText("CPU Zones");
+        if constexpr (cpu_profiler::enabled) {
+            ImGui::Text("Heap allocations in frame: %llu", static_cast<unsigned long long>(profiler.frameAllocationCount));
+
+            imgui::widget::Table<false>(
+                "profiler-cpu-zones-table",
+                ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit,
+                profiler.zoneStatistics,
+                imgui::widget::TableColumnInfo { "Zone", [](const AppState::Profiler::ZoneStatistics &statistics) {
+                    imgui::widget::TextUnformatted(statistics.name);
+                }, ImGuiTableColumnFlags_WidthStretch },
+                imgui::widget::TableColumnInfo { "Calls", [](const AppState::Profiler::ZoneStatistics &statistics) {
+                    imgui::widget::TextUnformatted(tempStringBuffer.write(statistics.callCount));
+                } },
+                imgui::widget::TableColumnInfo { "Time (ms)", [](const AppState::Profiler::ZoneStatistics &statistics) {
+                    imgui::widget::TextUnformatted(tempStringBuffer.write("{:.3f}", statistics.totalTime.count()));
+                } },
+                imgui::widget::TableColumnInfo { "Allocations", [](const AppState::Profiler::ZoneStatistics &statistics) {
+                    imgui::widget::TextUnformatted(tempStringBuffer.write(statistics.allocationCount));
+                } });
+        }
+        else {
+            ImGui::TextDisabled("CPU profiler is disabled.");
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Configure the project with -DVK_GLTF_VIEWER_CPU_PROFILER=ON to record the instrumented CPU zones and the heap allocation counts.");
+        }
+
+        ImGui::SeparatorText("GPU");
+        if (profiler.gpuPasses.empty()) {
+            ImGui::TextDisabled("Timestamp query is not supported.");
+        }
+        else {
+            rangeTimeline("gpu-timeline", profiler.gpuPasses);
+            for (const AppState::Profiler::Range &pass : profiler.gpuPasses) {
+                ImGui::Text("%.*s: %.3f ms", static_cast<int>(pass.name.size()), pass.name.data(), (pass.end - pass.begin).count());
+            }
+        }
+
+        ImGui::SeparatorText("Pipeline Statistics");
+        imgui::WithDisabled([&] {
+            ImGui::Checkbox("Record pipeline statistics", &profiler.recordPipelineStatistics);
+        }, !profiler.supportPipelineStatistics);
+        if (!profiler.supportPipelineStatistics) {
+            ImGui::SameLine();
+            imgui::widget::HelperMarker("(?)", "Pipeline statistics query is not supported by the GPU.");
+        }
+        else if (const auto &statistics = profiler.pipelineStatistics) {
+            ImGui::Text("Vertex shader invocations: %llu", static_cast<unsigned long long>(statistics->vertexShaderInvocations));
+            ImGui::Text("Clipping primitives: %llu", static_cast<unsigned long long>(statistics->clippingPrimitives));
+            ImGui::Text("Fragment shader invocations: %llu", static_cast<unsigned long long>(statistics->fragmentShaderInvocations));
+        }
+
+        ImGui::SeparatorText("Draw Calls");
+        if (profiler.drawBuckets.empty()) {
+            ImGui::TextDisabled("No draw call.");
+        }
+        else {
+            ImGui::Text("Total: %zu multi-draws, %llu draws, %llu primitives",
+                profiler.drawBuckets.size(),
+                static_cast<unsigned long long>(std::ranges::fold_left(profiler.drawBuckets | std::views::transform(&AppState::Profiler::DrawBucket::drawCount), 0ULL, std::plus{})),
+                static_cast<unsigned long long>(std::ranges::fold_left(profiler.drawBuckets | std::views::transform(&AppState::Profiler::DrawBucket::primitiveCount), 0ULL, std::plus{})));
+
+            imgui::widget::Table<false>(
+                "profiler-draw-buckets-table",
+                ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit,
+                profiler.drawBuckets,
+                imgui::widget::TableColumnInfo { "State", [](const AppState::Profiler::DrawBucket &bucket) {
+                    imgui::widget::TextUnformatted(bucket.label);
+                }, ImGuiTableColumnFlags_WidthStretch },
+                imgui::widget::TableColumnInfo { "Draws", [](const AppState::Profiler::DrawBucket &bucket) {
+                    imgui::widget::TextUnformatted(tempStringBuffer.write(bucket.drawCount));
+                } },
+                imgui::widget::TableColumnInfo { "Primitives", [](const AppState::Profiler::DrawBucket &bucket) {
+                    imgui::widget::TextUnformatted(tempStringBuffer.write(bucket.primitiveCount));
+                } });
+        }
+
+        ImGui::SeparatorText("Pipelines");
+        {
+            const AppState::Profiler::PipelineCounts &counts = profiler.pipelineCounts;
+            ImGui::Text("Primitive: %zu (%zu with material extensions)", counts.primitive, counts.primitiveWithMaterialExtension);
+            ImGui::Text("Unlit primitive: %zu", counts.unlitPrimitive);
+            if (counts.primitive + counts.unlitPrimitive > AppState::Profiler::pipelineCountWarningThreshold) {
+                ImGui::TextColored(ImVec4 { 1.f, 0.6f, 0.f, 1.f }, "Pipeline count exceeds %zu. Check the permutation of the shader variants and the specialization constants.", AppState::Profiler::pipelineCountWarningThreshold);
+            }
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Export Chrome Trace...")) {
+            constexpr std::array filterItems {
+                nfdfilteritem_t { "JSON File", "json" },
+            };
+
+            if (auto filename = processSaveFileDialog(filterItems, "trace.json", windowHandle)) {
+                tasks.emplace(std::in_place_type<task::ExportChromeTrace>, *filename);
+            }
+        }
+        ImGui::SameLine();
+        imgui::widget::HelperMarker("(?)", "Save the recent CPU zones (including the instrumented zones of each thread) and GPU passes, which can be opened by chrome://tracing or Perfetto. GPU passes are placed from their frame submission time, as the GPU clock is not calibrated with the CPU clock.");
+    }
+    ImGui::End();
+}
+
 void vk_gltf_viewer::control::ImGuiTaskCollector::imguizmo(Renderer &renderer, std::size_t viewIndex) {
     // Set ImGuizmo rect.
     ImGuizmo::BeginFrame();
@@ -9,6 +9,7 @@ module vk_gltf_viewer.vulkan.Frame;
 
 import imgui.vulkan;
 
+import vk_gltf_viewer.cpu_profiler;
 import vk_gltf_viewer.helpers.concepts;
 import vk_gltf_viewer.helpers.fastgltf;
 import vk_gltf_viewer.helpers.functional;
@@ -16,12 +17,35 @@ import vk_gltf_viewer.helpers.Lazy;
 import vk_gltf_viewer.helpers.optional;
 import vk_gltf_viewer.helpers.ranges;
 import vk_gltf_viewer.math.bit;
+import vk_gltf_viewer.vulkan.AccessTracker;
 
-#define INDEX_SEQ(Is, N, ...) [&]<auto ...Is>(std::index_sequence<Is...>) __VA_ARGS__ (std::make_index_sequence<N>{})
 #define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
 #define LIFT(...) [&](auto &&...xs) { return __VA_ARGS__(FWD(xs)...); }
 
+using namespace std::string_view_literals;
+
 constexpr auto NO_INDEX = std::numeric_limits<std::uint16_t>::max();
+
+/**
+ * @brief Minimum number of the criteria buckets to be recorded in a secondary command buffer.
+ *
+ * Recording a secondary command buffer has its own overhead (begin/end, rebinding the descriptor sets), therefore a
+ * subpass with few buckets is not split into many command buffers.
+ */
+constexpr std::size_t MIN_CRITERIA_COUNT_PER_SECONDARY_COMMAND_BUFFER = 16;
+constexpr std::array gpuPassNames {
+    "Scene prepass"sv,
+    "Jump flood"sv,
+    "Scene"sv,
+    "Bloom"sv,
+    "Composition"sv,
+};
+
+constexpr vk::QueryPipelineStatisticFlags pipelineStatisticFlags
+    = vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations
+    | vk::QueryPipelineStatisticFlagBits::eClippingPrimitives
+    | vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
 constexpr auto emulatedPrimitiveTopologies = {
     fastgltf::PrimitiveType::LineLoop, // -> LineStrip
 #if __APPLE__
@@ -29,6 +53,27 @@ constexpr auto emulatedPrimitiveTopologies = {
 #endif
 };
 
+/**
+ * @brief Get the number of primitives assembled from \p vertexCount vertices with \p topology.
+ */
+[[nodiscard]] std::uint64_t getPrimitiveCount(vk::PrimitiveTopology topology, std::uint64_t vertexCount) noexcept {
+    switch (topology) {
+        case vk::PrimitiveTopology::ePointList:
+            return vertexCount;
+        case vk::PrimitiveTopology::eLineList:
+            return vertexCount / 2;
+        case vk::PrimitiveTopology::eLineStrip:
+            return vertexCount < 2 ? 0 : vertexCount - 1;
+        case vk::PrimitiveTopology::eTriangleList:
+            return vertexCount / 3;
+        case vk::PrimitiveTopology::eTriangleStrip:
+        case vk::PrimitiveTopology::eTriangleFan:
+            return vertexCount < 3 ? 0 : vertexCount - 2;
+        default:
+            return 0;
+    }
+}
+
 vk_gltf_viewer::vulkan::Frame::GltfAsset::GltfAsset(const SharedData &sharedData)
     : assetExtended { sharedData.assetExtended }
     , nodeBuffer {
@@ -79,8 +124,9 @@ void vk_gltf_viewer::vulkan::Frame::GltfAsset::updateNodeTargetWeights(std::size
     nodeBuffer.getAllocation().copyFromMemory(weights.data(), nodeBuffer.getTargetWeightsDataOffset(nodeIndex) + sizeof(float) * startIndex, weights.size_bytes());
 }
 
-vk_gltf_viewer::vulkan::Frame::Frame(std::shared_ptr<const Renderer> _renderer, const SharedData &sharedData)
+vk_gltf_viewer::vulkan::Frame::Frame(std::shared_ptr<const Renderer> _renderer, const SharedData &sharedData, QueueTimelines &timelines)
     : sharedData { sharedData }
+    , timelines { timelines }
     , renderer { std::move(_renderer) }
     , cameraBuffer {
         sharedData.gpu.allocator,
@@ -94,30 +140,72 @@ vk_gltf_viewer::vulkan::Frame::Frame(std::shared_ptr<const Renderer> _renderer,
             vma::MemoryUsage::eAutoPreferDevice,
         },
     }
+    , bloomCounterBuffer {
+        sharedData.gpu.allocator,
+        vk::BufferCreateInfo {
+            {},
+            sizeof(std::uint32_t) * 4,
+            bloom::BloomComputePipeline::requiredCounterBufferUsageFlags,
+        },
+        vma::AllocationCreateInfo {
+            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+            vma::MemoryUsage::eAutoPreferDevice,
+        },
+    }
+    , transmissionCounterBuffer {
+        sharedData.gpu.allocator,
+        vk::BufferCreateInfo {
+            {},
+            sizeof(std::uint32_t) * 4,
+            bloom::BloomComputePipeline::requiredCounterBufferUsageFlags,
+        },
+        vma::AllocationCreateInfo {
+            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+            vma::MemoryUsage::eAutoPreferDevice,
+        },
+    }
     , descriptorPool { createDescriptorPool() }
     , computeCommandPool { sharedData.gpu.device, vk::CommandPoolCreateInfo { {}, sharedData.gpu.queueFamilies.compute } }
     , graphicsCommandPool { sharedData.gpu.device, vk::CommandPoolCreateInfo { {}, sharedData.gpu.queueFamilies.graphicsPresent } }
-    , scenePrepassFinishSema { sharedData.gpu.device, vk::SemaphoreCreateInfo{} }
-    , sceneRenderingFinishSema { sharedData.gpu.device, vk::SemaphoreCreateInfo{} }
-    , jumpFloodFinishSema { sharedData.gpu.device, vk::SemaphoreCreateInfo{} }
-    , swapchainImageAcquireSema { sharedData.gpu.device, vk::SemaphoreCreateInfo{} }
-    , inFlightFence { sharedData.gpu.device, vk::FenceCreateInfo{} } {
+    , swapchainImageAcquireSema { sharedData.gpu.device, vk::SemaphoreCreateInfo{} } {
+    if (sharedData.gpu.supportGraphicsQueueTimestamp) {
+        timestampQueryPool.emplace(sharedData.gpu.device, vk::QueryPoolCreateInfo { {}, vk::QueryType::eTimestamp, 2 * gpuPassCount });
+    }
+    if (sharedData.gpu.supportPipelineStatisticsQuery) {
+        pipelineStatisticsQueryPool.emplace(sharedData.gpu.device, vk::QueryPoolCreateInfo {
+            {},
+            vk::QueryType::ePipelineStatistics,
+            1,
+            pipelineStatisticFlags,
+        });
+    }
+
     // Allocate descriptor sets.
     vku::DescriptorSetAllocationBuilder{}
         .add(sharedData.rendererDescriptorSetLayout, rendererSet)
+        .add(sharedData.imageBasedLightingDescriptorSetLayout, imageBasedLightingSet)
+        .add(sharedData.skyboxDescriptorSetLayout, skyboxSet)
         .add(sharedData.mousePickingDescriptorSetLayout, mousePickingSet)
-        .add(sharedData.jumpFloodComputePipeline.descriptorSetLayout, hoveringNodeJumpFloodSet, selectedNodeJumpFloodSet)
-        .add(sharedData.outlineDescriptorSetLayout, hoveringNodeOutlineSet, selectedNodeOutlineSet)
+        .add(sharedData.jumpFloodComputePipeline.descriptorSetLayout, jumpFloodSet)
+        .add(sharedData.outlineDescriptorSetLayout, outlineSet)
         .add(sharedData.weightedBlendedCompositionDescriptorSetLayout, weightedBlendedCompositionSet)
         .add(sharedData.inverseToneMappingDescriptorSetLayout, inverseToneMappingSet)
         .add(sharedData.bloomComputePipeline.descriptorSetLayout, bloomSet)
         .add(sharedData.bloomApplyDescriptorSetLayout, bloomApplySet)
+        .add(sharedData.bloomComputePipeline.descriptorSetLayout, transmissionSet)
         .allocate(sharedData.gpu.device, *descriptorPool);
 
+    // Bloom atomic counters must be zero-initialized.
+    constexpr std::array<std::uint32_t, 4> zeroCounters{};
+    bloomCounterBuffer.getAllocation().copyFromMemory(zeroCounters.data(), 0, sizeof(zeroCounters));
+    transmissionCounterBuffer.getAllocation().copyFromMemory(zeroCounters.data(), 0, sizeof(zeroCounters));
+
     // Update descriptor sets.
-    sharedData.gpu.device.updateDescriptorSets(
+    sharedData.gpu.device.updateDescriptorSets({
         rendererSet.getWrite<0>(0, vku::lvalue(vk::DescriptorBufferInfo { *cameraBuffer, 0, vk::WholeSize })),
-        {});
+        bloomSet.getWrite<2>(0, vku::lvalue(vk::DescriptorBufferInfo { *bloomCounterBuffer, 0, vk::WholeSize })),
+        transmissionSet.getWrite<2>(0, vku::lvalue(vk::DescriptorBufferInfo { *transmissionCounterBuffer, 0, vk::WholeSize })),
+    }, {});
 
     // Allocate per-frame command buffers.
     jumpFloodCommandBuffer = (*sharedData.gpu.device).allocateCommandBuffers({
@@ -133,9 +221,98 @@ vk_gltf_viewer::vulkan::Frame::Frame(std::shared_ptr<const Renderer> _renderer,
 }
 
 vk_gltf_viewer::vulkan::Frame::ExecutionResult vk_gltf_viewer::vulkan::Frame::getExecutionResult() {
-    std::ignore = sharedData.gpu.device.waitForFences(*inFlightFence, true, ~0ULL);
+    // Composition is the last submission of the frame, and it waits for all the other submissions.
+    timelines.graphicsPresent.wait(frameFinishValue);
 
     ExecutionResult result{};
+    if (timestampQueryWrittenPasses.any()) {
+        // Timestamps of the written passes, in GpuPass order.
+        std::array<std::optional<std::array<std::uint64_t, 2>>, gpuPassCount> timestamps;
+        for (std::size_t pass = 0; pass < gpuPassCount; ++pass) {
+            if (!timestampQueryWrittenPasses[pass]) continue;
+
+            const auto [queryResult, passTimestamps] = timestampQueryPool->getResults<std::uint64_t>(
+                2 * pass, 2, sizeof(std::uint64_t[2]), sizeof(std::uint64_t), vk::QueryResultFlagBits::e64);
+            if (queryResult == vk::Result::eSuccess && passTimestamps[1] >= passTimestamps[0]) {
+                timestamps[pass] = std::array { passTimestamps[0], passTimestamps[1] };
+            }
+        }
+        timestampQueryWrittenPasses.reset();
+
+        const auto toDuration = [&](std::uint64_t ticks) {
+            return std::chrono::duration<float, std::milli> { std::chrono::duration<float, std::nano> { ticks * sharedData.gpu.timestampPeriod } };
+        };
+
+        // Passes in the different queues share the same timestamp domain, therefore the earliest begin is used as the
+        // origin of the frame.
+        std::uint64_t frameBegin = std::numeric_limits<std::uint64_t>::max();
+        for (const auto &passTimestamps : timestamps) {
+            if (passTimestamps) {
+                frameBegin = std::min(frameBegin, (*passTimestamps)[0]);
+            }
+        }
+        for (std::size_t pass = 0; pass < gpuPassCount; ++pass) {
+            if (const auto &passTimestamps = timestamps[pass]) {
+                result.gpuPassTimes.emplace_back(
+                    gpuPassNames[pass],
+                    toDuration((*passTimestamps)[0] - frameBegin),
+                    toDuration((*passTimestamps)[1] - frameBegin));
+            }
+        }
+
+        // Scene rendering GPU time includes the bloom, as both are scaled by the render scale.
+        if (const auto &sceneTimestamps = timestamps[std::to_underlying(GpuPass::Scene)]) {
+            std::uint64_t end = (*sceneTimestamps)[1];
+            if (const auto &bloomTimestamps = timestamps[std::to_underlying(GpuPass::Bloom)]) {
+                end = (*bloomTimestamps)[1];
+            }
+            if (end > (*sceneTimestamps)[0]) {
+                result.sceneRenderingGpuTime.emplace(toDuration(end - (*sceneTimestamps)[0]));
+            }
+        }
+    }
+
+    if (pipelineStatisticsQueryWritten) {
+        // Results are in the order of the flag bits: vertex shader invocations, clipping primitives and fragment
+        // shader invocations.
+        const auto [queryResult, statistics] = pipelineStatisticsQueryPool->getResults<std::uint64_t>(
+            0, 1, sizeof(std::uint64_t[3]), sizeof(std::uint64_t[3]), vk::QueryResultFlagBits::e64);
+        if (queryResult == vk::Result::eSuccess) {
+            result.pipelineStatistics.emplace(statistics[0], statistics[1], statistics[2]);
+        }
+        pipelineStatisticsQueryWritten = false;
+    }
+
+    if (renderingNodes) {
+        result.drawStatistics.reserve(renderingNodes->indirectDrawCommandBuffers.size());
+        for (const auto &[criteria, indirectDrawCommandBuffer] : renderingNodes->indirectDrawCommandBuffers) {
+            const std::uint32_t drawCount = indirectDrawCommandBuffer.drawCount();
+            const std::uint64_t vertexCount = visit(multilambda {
+                [&](std::span<const vk::DrawIndirectCommand> commands) {
+                    return std::ranges::fold_left(commands.first(drawCount), std::uint64_t{}, [](std::uint64_t sum, const vk::DrawIndirectCommand &command) {
+                        return sum + static_cast<std::uint64_t>(command.vertexCount) * command.instanceCount;
+                    });
+                },
+                [&](std::span<const vk::DrawIndexedIndirectCommand> commands) {
+                    return std::ranges::fold_left(commands.first(drawCount), std::uint64_t{}, [](std::uint64_t sum, const vk::DrawIndexedIndirectCommand &command) {
+                        return sum + static_cast<std::uint64_t>(command.indexCount) * command.instanceCount;
+                    });
+                },
+            }, indirectDrawCommandBuffer.drawIndirectCommands());
+
+            result.drawStatistics.push_back({
+                .subpass = criteria.subpass,
+                .indexType = criteria.indexType,
+                .primitiveTopology = criteria.primitiveTopology,
+                .cullMode = criteria.cullMode,
+                .drawCount = drawCount,
+                .primitiveCount = getPrimitiveCount(criteria.primitiveTopology, vertexCount),
+            });
+        }
+    }
+
+    result.levelOfDetailMarkers = std::move(levelOfDetailMarkers);
+
     if (gltfAsset) {
         // Retrieve the mouse picking result from the buffer.
         if (gltfAsset->mousePickingInput) {
@@ -182,10 +359,84 @@ vk_gltf_viewer::vulkan::Frame::ExecutionResult vk_gltf_viewer::vulkan::Frame::ge
     return result;
 }
 
-void vk_gltf_viewer::vulkan::Frame::update(const ExecutionTask &task) {
+std::shared_future<void> vk_gltf_viewer::vulkan::Frame::update(const ExecutionTask &task, BS::thread_pool<> &threadPool) {
+    const cpu_profiler::Zone zone { "Frame::update" };
+
     passthruOffset = task.passthruOffset;
+    recordPipelineStatistics = task.recordPipelineStatistics;
+
+    if (task.gltf) {
+        // Mouse picking input is given in the viewport coordinates, but the scene is rendered in the scaled extent.
+        const auto mousePickingInput = task.gltf->mousePickingInput.transform([&](std::pair<std::uint32_t, vk::Rect2D> input) {
+            if (viewport && viewport->renderSubextent != viewport->subextent) {
+                auto &[offset, extent] = input.second;
+                const float scaleX = static_cast<float>(viewport->renderSubextent.width) / viewport->subextent.width;
+                const float scaleY = static_cast<float>(viewport->renderSubextent.height) / viewport->subextent.height;
+                offset = vk::Offset2D {
+                    static_cast<std::int32_t>(offset.x * scaleX),
+                    static_cast<std::int32_t>(offset.y * scaleY),
+                };
+                if (extent != vk::Extent2D { 1, 1 }) {
+                    // Rectangle selection must not be degenerated to the single pixel picking.
+                    extent = vk::Extent2D {
+                        std::max(2U, static_cast<std::uint32_t>(std::ceil(extent.width * scaleX))),
+                        std::max(1U, static_cast<std::uint32_t>(std::ceil(extent.height * scaleY))),
+                    };
+                    extent.width = std::min(extent.width, viewport->renderSubextent.width - offset.x);
+                    extent.height = std::min(extent.height, viewport->renderSubextent.height - offset.y);
+                }
+            }
+            return input;
+        });
+        gltfAsset->mousePickingInput = mousePickingInput;
+
+        // Primitive is rendered once for all views, therefore multiview meshlet culling is not supported. If meshlet
+        // culling is not applied, the primitives are drawn from the combined index buffer as usual.
+        const bool cullMeshlets = renderer->meshletCulling && renderer->cameras.size() == 1;
+
+        // Mutable asset state is copied, so that the preparation does not observe the changes made after this function
+        // returns (e.g. the animation sampling of the next frame).
+        const auto &assetExtended = *gltfAsset->assetExtended;
+        const std::span nodeWorldTransforms = assetExtended.sceneHierarchy.getWorldTransforms();
+        DrawCommandSnapshot snapshot {
+            .regenerateRenderingNodes = !renderingNodes || task.gltf->regenerateDrawCommands || renderingNodes->meshletCulling != cullMeshlets,
+            .regenerateOutlineNodes = task.gltf->regenerateDrawCommands,
+            .cullMeshlets = cullMeshlets,
+            .mousePickingInput = mousePickingInput,
+            .nodeWorldTransforms = { nodeWorldTransforms.begin(), nodeWorldTransforms.end() },
+        };
+        if (snapshot.regenerateRenderingNodes) {
+            for (std::size_t nodeIndex : ranges::views::upto(assetExtended.asset.nodes.size())) {
+                if (assetExtended.sceneHierarchy.getVisibility(nodeIndex)) {
+                    snapshot.visibleNodeIndices.push_back(nodeIndex);
+                }
+            }
+        }
+        if (renderer->selectedNodeOutline) {
+            snapshot.selectedNodes = assetExtended.selectedNodes;
+        }
+        if (const auto &hoveringNodeIndex = assetExtended.hoveringNode; hoveringNodeIndex && renderer->hoveringNodeOutline) {
+            // If the hovering node is the only selected node, its outline doesn't have to be drawn.
+            const auto &selectedNodes = assetExtended.selectedNodes;
+            if (selectedNodes.size() != 1 || *hoveringNodeIndex != *selectedNodes.begin()) {
+                snapshot.hoveringNode.emplace(*hoveringNodeIndex);
+            }
+        }
 
-    // Update camera buffer.
+        drawCommandPreparation = threadPool.submit_task([this, snapshot = std::move(snapshot)] {
+            prepareDrawCommands(snapshot);
+        }).share();
+    }
+    else {
+        renderingNodes.reset();
+        selectedNodes.reset();
+        hoveringNode.reset();
+        meshletCullingDrawCount = 0;
+        levelOfDetailMarkers.clear();
+        drawCommandPreparation = {};
+    }
+
+    // Update camera buffer, while the draw commands are being prepared.
     std::byte* const cameraBufferMapped = static_cast<std::byte*>(cameraBuffer.getAllocation().getInfo().pMappedData);
     std::ranges::transform(renderer->cameras, reinterpret_cast<glm::mat4*>(cameraBufferMapped), &control::Camera::getProjectionViewMatrix);
     std::ranges::transform(renderer->cameras, reinterpret_cast<glm::mat4*>(cameraBufferMapped + 4 * sizeof(glm::mat4)), [](const control::Camera &camera) {
@@ -196,11 +447,56 @@ void vk_gltf_viewer::vulkan::Frame::update(const ExecutionTask &task) {
     });
     cameraBuffer.getAllocation().flush(0, vk::WholeSize);
 
+    return drawCommandPreparation;
+}
+
+std::optional<std::uint32_t> vk_gltf_viewer::vulkan::Frame::acquireSwapchainImage() {
+    try {
+        vk::Result result [[maybe_unused]];
+        std::uint32_t swapchainImageIndex;
+        std::tie(result, swapchainImageIndex) = (*sharedData.gpu.device).acquireNextImageKHR(
+            *sharedData.swapchain.swapchain, ~0ULL, *swapchainImageAcquireSema);
+
+    #if __APPLE__
+        // MoltenVK does not allow presenting suboptimal swapchain image.
+        // Issue tracked: https://github.com/KhronosGroup/MoltenVK/issues/2542
+        if (result == vk::Result::eSuboptimalKHR) {
+            return std::nullopt;
+        }
+    #endif
+        return swapchainImageIndex;
+    }
+    catch (const vk::OutOfDateKHRError&) {
+        return std::nullopt;
+    }
+}
+
+void vk_gltf_viewer::vulkan::Frame::joinDrawCommandPreparation() {
+    if (drawCommandPreparation.valid()) {
+        const cpu_profiler::Zone zone { "Wait for draw command preparation" };
+        // Exception thrown by the preparation (e.g. too many nodes) is rethrown in here.
+        std::exchange(drawCommandPreparation, {}).get();
+    }
+}
+
+void vk_gltf_viewer::vulkan::Frame::prepareDrawCommands(const DrawCommandSnapshot &snapshot) {
+    const cpu_profiler::Zone zone { "Prepare draw commands" };
+
+    levelOfDetailMarkers.clear();
+
+    const bool cullMeshlets = snapshot.cullMeshlets;
+    const auto &mousePickingInput = snapshot.mousePickingInput;
+
     const auto criteriaGetter = [&](const fastgltf::Primitive &primitive) {
         const bool usePerFragmentEmissiveStencilExport = renderer->bloom.raw().mode == Renderer::Bloom::PerFragment;
+        const bool meshletCulling = cullMeshlets && gltfAsset->assetExtended->meshletBuffer && gltfAsset->assetExtended->meshletBuffer->getPrimitiveRange(primitive);
         CommandSeparationCriteria result {
             .subpass = 0U,
+            .transmission = false,
+            .meshletCulling = meshletCulling,
             .indexType = value_if(std::ranges::contains(emulatedPrimitiveTopologies, primitive.type) || primitive.indicesAccessor.has_value(), [&]() {
+                // Meshlet culled indices are always 32-bit.
+                if (meshletCulling) return vk::IndexType::eUint32;
                 return gltfAsset->assetExtended->combinedIndexBuffer.getIndexTypeAndFirstIndex(primitive).first;
             }),
             .primitiveTopology = gltf::getPrimitiveTopology(primitive.type),
@@ -228,6 +524,7 @@ void vk_gltf_viewer::vulkan::Frame::update(const ExecutionTask &task) {
                 result.stencilReference.reset();
             }
             else {
+                result.transmission = material.transmission != nullptr;
                 result.pipeline = *sharedData.getPrimitiveRenderPipeline(gltfAsset->assetExtended->getPrimitivePipelineConfig(primitive, usePerFragmentEmissiveStencilExport));
                 if (!usePerFragmentEmissiveStencilExport) {
                     result.stencilReference.emplace(material.emissiveStrength > 1.f ? 1U : 0U);
@@ -364,319 +661,630 @@ void vk_gltf_viewer::vulkan::Frame::update(const ExecutionTask &task) {
         }
     };
 
-    if (task.gltf) {
-        const auto isPrimitiveWithinFrustum = [&](std::size_t nodeIndex, std::size_t primitiveIndex, const math::Frustum &frustum) -> bool {
-            const fastgltf::Node &node = gltfAsset->assetExtended->asset.nodes[nodeIndex];
-            const auto [min, max] = getBoundingBoxMinMax(gltfAsset->assetExtended->primitiveBuffer.getPrimitive(primitiveIndex), node, gltfAsset->assetExtended->asset);
+    // Invoke pred with the world space bounding sphere (center, radius) of each instance of the node primitive, and
+    // return true if any of the invocation returns true.
+    const auto anyWorldBoundingSphere = [&](std::size_t nodeIndex, std::size_t primitiveIndex, const auto &pred) -> bool {
+        const fastgltf::Node &node = gltfAsset->assetExtended->asset.nodes[nodeIndex];
+        const fastgltf::Primitive &primitive = gltfAsset->assetExtended->primitiveBuffer.getPrimitive(primitiveIndex);
 
-            const auto pred = [&](const fastgltf::math::fmat4x4 &worldTransform) -> bool {
-                const fastgltf::math::fvec3 transformedMin { worldTransform * fastgltf::math::fvec4 { min.x(), min.y(), min.z(), 1.f } };
-                const fastgltf::math::fvec3 transformedMax { worldTransform * fastgltf::math::fvec4 { max.x(), max.y(), max.z(), 1.f } };
+        std::array<fastgltf::math::fvec3, 2> boundingBox;
+        fastgltf::math::fmat4x4 nodeTransform; // Identity if the primitive is skinned.
+        if (node.skinIndex && gltfAsset->assetExtended->jointBoundingBoxes.contains(primitive)) {
+            // Skinned primitive's bounding box is already in the world space, as node's world transform is not
+            // applied to the skinned vertices.
+            boundingBox = gltfAsset->assetExtended->jointBoundingBoxes.getWorldBoundingBoxMinMax(
+                primitive, node, snapshot.nodeWorldTransforms);
+        }
+        else {
+            boundingBox = getBoundingBoxMinMax(primitive, node, gltfAsset->assetExtended->asset);
+            nodeTransform = snapshot.nodeWorldTransforms[nodeIndex];
+        }
+        const auto &[min, max] = boundingBox;
 
-                const fastgltf::math::fvec3 halfDisplacement = (transformedMax - transformedMin) / 2.f;
-                const fastgltf::math::fvec3 center = transformedMin + halfDisplacement;
-                const float radius = length(halfDisplacement);
+        const auto transformedPred = [&](const fastgltf::math::fmat4x4 &worldTransform) -> bool {
+            const fastgltf::math::fvec3 transformedMin { worldTransform * fastgltf::math::fvec4 { min.x(), min.y(), min.z(), 1.f } };
+            const fastgltf::math::fvec3 transformedMax { worldTransform * fastgltf::math::fvec4 { max.x(), max.y(), max.z(), 1.f } };
 
-                return frustum.isOverlapApprox(glm::make_vec3(center.data()), radius);
-            };
+            const fastgltf::math::fvec3 halfDisplacement = (transformedMax - transformedMin) / 2.f;
+            const fastgltf::math::fvec3 center = transformedMin + halfDisplacement;
+            const float radius = length(halfDisplacement);
 
-            const fastgltf::math::fmat4x4 &worldTransform = sharedData.assetExtended->sceneHierarchy.getWorldTransform(nodeIndex);
-            if (node.instancingAttributes.empty()) {
-                return pred(worldTransform);
-            }
-            else {
-                // If node is instanced, the node primitive is regarded to be within the frustum if any of its instance
-                // is within the frustum.
-                std::vector instancedWorldTransforms = getInstanceTransforms(sharedData.assetExtended->asset, nodeIndex, sharedData.assetExtended->externalBuffers);
-                for (fastgltf::math::fmat4x4 &m : instancedWorldTransforms) {
-                    m = worldTransform * m;
-                }
-                return std::ranges::any_of(instancedWorldTransforms, pred);
-            }
+            return pred(glm::make_vec3(center.data()), radius);
         };
 
-        std::unordered_map<std::uint32_t /* firstInstance */, std::uint32_t /* instanceCount */> cachedInstanceCounts;
-        const auto commandBufferCullingFunc = [&](buffer::IndirectDrawCommands &indirectDrawCommands, const math::Frustum &frustum) -> bool {
-            // Partition the commands based on whether the bounding sphere of the primitive is within the frustum.
-            // - If the bounding sphere is overlapping with the frustum, partitioned left.
-            // - Otherwise, partitioned right.
-            // Then, draw count is set to the size of the left partition.
-            const std::uint32_t drawCount = visit([&]<concepts::one_of<vk::DrawIndirectCommand, vk::DrawIndexedIndirectCommand> T>(std::span<T> commands) -> std::size_t {
-                return std::distance(
-                    commands.begin(),
-                    std::ranges::partition(commands, [&](T &command) {
-                        const std::size_t nodeIndex = command.firstInstance >> 16U;
-                        const fastgltf::Node &node = gltfAsset->assetExtended->asset.nodes[nodeIndex];
-
-                        // Node is instanced and frustum culling is disabled for instanced nodes.
-                        if (!node.instancingAttributes.empty() && renderer->frustumCullingMode != Renderer::FrustumCullingMode::OnWithInstancing) {
-                            return true;
-                        }
+        if (node.instancingAttributes.empty()) {
+            return transformedPred(nodeTransform);
+        }
+        else {
+            std::vector instancedWorldTransforms = getInstanceTransforms(sharedData.assetExtended->asset, nodeIndex, sharedData.assetExtended->externalBuffers);
+            for (fastgltf::math::fmat4x4 &m : instancedWorldTransforms) {
+                m = nodeTransform * m;
+            }
+            return std::ranges::any_of(instancedWorldTransforms, transformedPred);
+        }
+    };
 
-                        if (node.skinIndex) {
-                            // As primitive POSITION accessor's min/max values are not sufficient to determine the bounding
-                            // volume of a skinned mesh, frustum culling which relies on this must be disabled.
-                            return true;
-                        }
+    const auto isPrimitiveWithinFrustum = [&](std::size_t nodeIndex, std::size_t primitiveIndex, const math::Frustum &frustum) -> bool {
+        // If node is instanced, the node primitive is regarded to be within the frustum if any of its instance is
+        // within the frustum.
+        return anyWorldBoundingSphere(nodeIndex, primitiveIndex, [&](const glm::vec3 &center, float radius) {
+            return frustum.isOverlapApprox(center, radius);
+        });
+    };
+
+    std::unordered_map<std::uint32_t /* firstInstance */, std::uint32_t /* instanceCount */> cachedInstanceCounts;
+    const auto commandBufferCullingFunc = [&](buffer::IndirectDrawCommands &indirectDrawCommands, const math::Frustum &frustum) -> bool {
+        // Partition the commands based on whether the bounding sphere of the primitive is within the frustum.
+        // - If the bounding sphere is overlapping with the frustum, partitioned left.
+        // - Otherwise, partitioned right.
+        // Then, draw count is set to the size of the left partition.
+        const std::uint32_t drawCount = visit([&]<concepts::one_of<vk::DrawIndirectCommand, vk::DrawIndexedIndirectCommand> T>(std::span<T> commands) -> std::size_t {
+            return std::distance(
+                commands.begin(),
+                std::ranges::partition(commands, [&](T &command) {
+                    const std::size_t nodeIndex = command.firstInstance >> 16U;
+                    const fastgltf::Node &node = gltfAsset->assetExtended->asset.nodes[nodeIndex];
+
+                    // Node is instanced and frustum culling is disabled for instanced nodes.
+                    if (!node.instancingAttributes.empty() && renderer->frustumCullingMode != Renderer::FrustumCullingMode::OnWithInstancing) {
+                        return true;
+                    }
 
-                        // First find the pre-calculated instance count.
-                        if (auto it = cachedInstanceCounts.find(command.firstInstance); it == cachedInstanceCounts.end()) {
-                            // No pre-calculated instance count, calculate and store it.
-                            const std::size_t primitiveIndex = command.firstInstance & 0xFFFFU;
-                            if (node.instancingAttributes.empty()) {
-                                command.instanceCount = isPrimitiveWithinFrustum(nodeIndex, primitiveIndex, frustum);
-                            }
-                            else {
-                                command.instanceCount = isPrimitiveWithinFrustum(nodeIndex, primitiveIndex, frustum)
-                                    ? gltfAsset->assetExtended->asset.accessors[node.instancingAttributes.front().accessorIndex].count : 0U;
-                            }
-                            cachedInstanceCounts.emplace_hint(it, command.firstInstance, command.instanceCount);
+                    // First find the pre-calculated instance count.
+                    if (auto it = cachedInstanceCounts.find(command.firstInstance); it == cachedInstanceCounts.end()) {
+                        // No pre-calculated instance count, calculate and store it.
+                        const std::size_t primitiveIndex = command.firstInstance & 0xFFFFU;
+                        if (node.instancingAttributes.empty()) {
+                            command.instanceCount = isPrimitiveWithinFrustum(nodeIndex, primitiveIndex, frustum);
                         }
                         else {
-                            command.instanceCount = it->second;
+                            command.instanceCount = isPrimitiveWithinFrustum(nodeIndex, primitiveIndex, frustum)
+                                ? gltfAsset->assetExtended->asset.accessors[node.instancingAttributes.front().accessorIndex].count : 0U;
                         }
+                        cachedInstanceCounts.emplace_hint(it, command.firstInstance, command.instanceCount);
+                    }
+                    else {
+                        command.instanceCount = it->second;
+                    }
 
-                        return command.instanceCount > 0U;
-                    }).begin());
-            }, indirectDrawCommands.drawIndirectCommands());
-            indirectDrawCommands.setDrawCount(drawCount);
-            return drawCount > 0U;
-        };
+                    return command.instanceCount > 0U;
+                }).begin());
+        }, indirectDrawCommands.drawIndirectCommands());
+        indirectDrawCommands.setDrawCount(drawCount);
+        return drawCount > 0U;
+    };
 
-        if (!renderingNodes || task.gltf->regenerateDrawCommands) {
-            std::vector<std::size_t> visibleNodeIndices;
-            for (std::size_t nodeIndex : ranges::views::upto(gltfAsset->assetExtended->asset.nodes.size())) {
-                if (gltfAsset->assetExtended->sceneHierarchy.getVisibility(nodeIndex)) {
-                    visibleNodeIndices.push_back(nodeIndex);
-                }
+    const auto selectLevelOfDetail = [&](std::uint32_t firstInstance, std::span<const float> errors) -> std::uint32_t {
+        // Primitive is rendered once for all views, therefore multiview level of detail selection is not supported.
+        if (!renderer->levelOfDetail || renderer->cameras.size() != 1) {
+            return 0;
+        }
+
+        const control::Camera &camera = renderer->cameras[0];
+        // Pixel error is measured in the rendered extent, which is scaled by the dynamic resolution.
+        const float renderHeight = static_cast<float>(viewport->renderSubextent.height);
+        const float projectionScale = renderHeight / (2.f * std::tan(camera.fov / 2.f));
+
+        // If node is instanced, the largest projected bounding sphere among the instances determines the level.
+        glm::vec3 projectedCenter;
+        float projectedRadius = 0.f;
+        anyWorldBoundingSphere(firstInstance >> 16U, firstInstance & 0xFFFFU, [&](const glm::vec3 &center, float radius) {
+            const float distance = glm::distance(center, camera.position);
+            const float instanceProjectedRadius = distance > radius
+                ? radius / distance * projectionScale
+                : std::numeric_limits<float>::infinity(); // Camera is inside the bounding sphere.
+            if (instanceProjectedRadius > projectedRadius) {
+                projectedCenter = center;
+                projectedRadius = instanceProjectedRadius;
             }
+            return false; // Visit all instances.
+        });
+
+        // Errors are relative to the bounding sphere radius and increasing by the level, therefore the coarsest
+        // level within the pixel error is the last one whose error is not greater than it. The first level is
+        // selected at least, as its error is 0.
+        const auto getLevel = [&](float pixelError) -> std::uint32_t {
+            return std::ranges::upper_bound(errors, pixelError / projectedRadius) - errors.begin() - 1;
+        };
 
-            renderingNodes.emplace(
-                buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, criteriaGetter, visibleNodeIndices, drawCommandGetter),
-                buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, mousePickingCriteriaGetter, visibleNodeIndices, drawCommandGetter),
-                buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, multiNodeMousePickingCriteriaGetter, visibleNodeIndices, drawCommandGetter));
+        std::uint32_t &previousLevel = gltfAsset->assetExtended->levelOfDetailHistory[firstInstance];
+        std::uint32_t level = getLevel(renderer->levelOfDetail->pixelError);
+        if (level > previousLevel) {
+            // Coarsening is delayed until the error is sufficiently below the threshold, to avoid the level being
+            // flipped by a tiny camera movement.
+            level = std::max(previousLevel, getLevel(renderer->levelOfDetail->pixelError * (1.f - renderer->levelOfDetail->hysteresis)));
+        }
+        previousLevel = level;
+
+        if (renderer->levelOfDetail->visualize && std::isfinite(projectedRadius)) {
+            const glm::vec4 clipPosition = camera.getProjectionViewMatrix() * glm::vec4 { projectedCenter, 1.f };
+            if (clipPosition.w > 0.f) {
+                // Viewport is flipped, therefore NDC +Y is the top of the viewport.
+                const glm::vec2 ndc = glm::vec2 { clipPosition } / clipPosition.w;
+                levelOfDetailMarkers.emplace_back(
+                    glm::vec2 { ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f },
+                    projectedRadius / renderHeight,
+                    level);
+            }
         }
 
+        return level;
+    };
 
-        if (renderer->frustumCullingMode != Renderer::FrustumCullingMode::Off) {
-            assert(renderer->cameras.size() == 1 && "Multiview frustum culling is not supported yet");
+    std::unordered_map<std::uint32_t /* firstInstance */, std::uint32_t /* level */> cachedLevelOfDetails;
+    const auto commandBufferLevelOfDetailFunc = [&](buffer::IndirectDrawCommands &indirectDrawCommands) -> void {
+        const auto drawIndirectCommands = indirectDrawCommands.drawIndirectCommands();
+        const auto *commands = get_if<std::span<vk::DrawIndexedIndirectCommand>>(&drawIndirectCommands);
+        if (!commands) {
+            // Level of details are only generated for the indexed primitives.
+            return;
+        }
 
-            const math::Frustum frustum = renderer->cameras[0].getFrustum();
-            for (buffer::IndirectDrawCommands &buffer : renderingNodes->indirectDrawCommandBuffers | std::views::values) {
-                commandBufferCullingFunc(buffer, frustum);
+        // Only the commands that survived from the frustum culling are considered.
+        for (vk::DrawIndexedIndirectCommand &command : commands->first(indirectDrawCommands.drawCount())) {
+            const fastgltf::Primitive &primitive = gltfAsset->assetExtended->primitiveBuffer.getPrimitive(command.firstInstance & 0xFFFFU);
+            const auto errorsIt = gltfAsset->assetExtended->levelOfDetailErrors.find(&primitive);
+            if (errorsIt == gltfAsset->assetExtended->levelOfDetailErrors.end()) {
+                continue;
+            }
+
+            // The same node primitive in the different buffers (e.g. mouse picking) must use the same level.
+            auto it = cachedLevelOfDetails.find(command.firstInstance);
+            if (it == cachedLevelOfDetails.end()) {
+                it = cachedLevelOfDetails.emplace_hint(it, command.firstInstance, selectLevelOfDetail(command.firstInstance, errorsIt->second));
             }
+            std::tie(command.firstIndex, command.indexCount) = gltfAsset->assetExtended->combinedIndexBuffer.getLevelOfDetailFirstIndexAndCounts(primitive)[it->second];
+        }
+    };
+
+    const auto applyLevelOfDetails = [&](auto &indirectDrawCommandBuffers) {
+        if (gltfAsset->assetExtended->levelOfDetailErrors.empty()) {
+            return;
+        }
+
+        const cpu_profiler::Zone levelOfDetailZone { "Level of detail selection" };
+        for (buffer::IndirectDrawCommands &buffer : indirectDrawCommandBuffers | std::views::values) {
+            commandBufferLevelOfDetailFunc(buffer);
+        }
+    };
+
+    if (snapshot.regenerateRenderingNodes) {
+        const cpu_profiler::Zone drawCommandGenerationZone { "Generate draw commands" };
+
+        renderingNodes.emplace(
+            buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, criteriaGetter, snapshot.visibleNodeIndices, drawCommandGetter),
+            buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, mousePickingCriteriaGetter, snapshot.visibleNodeIndices, drawCommandGetter),
+            buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, multiNodeMousePickingCriteriaGetter, snapshot.visibleNodeIndices, drawCommandGetter));
+        renderingNodes->meshletCulling = cullMeshlets;
+    }
+
+    if (renderer->frustumCullingMode != Renderer::FrustumCullingMode::Off) {
+        assert(renderer->cameras.size() == 1 && "Multiview frustum culling is not supported yet");
+        const cpu_profiler::Zone cullingZone { "Frustum culling" };
+
+        const math::Frustum frustum = renderer->cameras[0].getFrustum();
+        for (buffer::IndirectDrawCommands &buffer : renderingNodes->indirectDrawCommandBuffers | std::views::values) {
+            commandBufferCullingFunc(buffer, frustum);
+        }
+
+        // Do frustum culling and do mouse picking only if there's any mesh primitive inside the frustum.
+        renderingNodes->startMousePickingRenderPass = false;
+        if (viewport && mousePickingInput) {
+            const auto &rect = mousePickingInput->second;
+            // TODO: use ray-sphere intersection test instead of frustum overlap test when extent is 1x1.
+            const float xmin = static_cast<float>(rect.offset.x) / viewport->renderSubextent.width;
+            const float xmax = static_cast<float>(rect.offset.x + rect.extent.width) / viewport->renderSubextent.width;
+            const float ymin = 1.f - static_cast<float>(rect.offset.y + rect.extent.height) / viewport->renderSubextent.height;
+            const float ymax = 1.f - static_cast<float>(rect.offset.y) / viewport->renderSubextent.height;
+            const math::Frustum frustum = renderer->cameras[0].getFrustum(xmin, xmax, ymin, ymax);
+
+            auto &map = (rect.extent.width == 1 && rect.extent.height == 1)
+                ? renderingNodes->mousePickingIndirectDrawCommandBuffers
+                : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers;
 
-            // Do frustum culling and do mouse picking only if there's any mesh primitive inside the frustum.
             renderingNodes->startMousePickingRenderPass = false;
-            if (viewport && task.gltf->mousePickingInput) {
-                const auto &rect = task.gltf->mousePickingInput->second;
-                // TODO: use ray-sphere intersection test instead of frustum overlap test when extent is 1x1.
-                const float xmin = static_cast<float>(rect.offset.x) / viewport->extent.width;
-                const float xmax = static_cast<float>(rect.offset.x + rect.extent.width) / viewport->extent.width;
-                const float ymin = 1.f - static_cast<float>(rect.offset.y + rect.extent.height) / viewport->extent.height;
-                const float ymax = 1.f - static_cast<float>(rect.offset.y) / viewport->extent.height;
-                const math::Frustum frustum = renderer->cameras[0].getFrustum(xmin, xmax, ymin, ymax);
-
-                auto &map = (rect.extent.width == 1 && rect.extent.height == 1)
-                    ? renderingNodes->mousePickingIndirectDrawCommandBuffers
-                    : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers;
-
-                renderingNodes->startMousePickingRenderPass = false;
-                for (buffer::IndirectDrawCommands &buffer : map | std::views::values) {
-                    renderingNodes->startMousePickingRenderPass |= commandBufferCullingFunc(buffer, frustum);
-                }
+            for (buffer::IndirectDrawCommands &buffer : map | std::views::values) {
+                renderingNodes->startMousePickingRenderPass |= commandBufferCullingFunc(buffer, frustum);
             }
         }
-        else {
-            for (buffer::IndirectDrawCommands &buffer : renderingNodes->indirectDrawCommandBuffers | std::views::values) {
+    }
+    else {
+        for (buffer::IndirectDrawCommands &buffer : renderingNodes->indirectDrawCommandBuffers | std::views::values) {
+            buffer.resetDrawCount();
+        }
+
+        if (mousePickingInput) {
+            const auto &rect = mousePickingInput->second;
+            auto &map = (rect.extent.width == 1 && rect.extent.height == 1)
+                ? renderingNodes->mousePickingIndirectDrawCommandBuffers
+                : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers;
+            for (buffer::IndirectDrawCommands &buffer : map | std::views::values) {
                 buffer.resetDrawCount();
             }
+        }
+    }
+
+    // Level of details are selected after the frustum culling, as the culled commands don't need to be selected.
+    applyLevelOfDetails(renderingNodes->indirectDrawCommandBuffers);
+    if (mousePickingInput) {
+        const auto &rect = mousePickingInput->second;
+        applyLevelOfDetails((rect.extent.width == 1 && rect.extent.height == 1)
+            ? renderingNodes->mousePickingIndirectDrawCommandBuffers
+            : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers);
+    }
+
+    // Meshlet culled draws are also prepared after the frustum culling, and the visible meshlets are compacted into
+    // meshletCulledIndexBuffer by the compute shader at the start of the scene prepass.
+    meshletCullingDrawCount = 0;
+    if (const auto &meshletBuffer = gltfAsset->assetExtended->meshletBuffer; meshletBuffer && cullMeshlets) {
+        const cpu_profiler::Zone meshletCullingZone { "Meshlet culling preparation" };
+
+        std::vector<MeshletCullingComputePipeline::Draw> draws;
+        std::uint32_t culledIndexCount = 0;
+        for (auto &[criteria, indirectDrawCommandBuffer] : renderingNodes->indirectDrawCommandBuffers) {
+            if (!criteria.meshletCulling) {
+                continue;
+            }
 
-            if (task.gltf->mousePickingInput) {
-                const auto &rect = task.gltf->mousePickingInput->second;
-                auto &map = (rect.extent.width == 1 && rect.extent.height == 1)
-                    ? renderingNodes->mousePickingIndirectDrawCommandBuffers
-                    : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers;
-                for (buffer::IndirectDrawCommands &buffer : map | std::views::values) {
-                    buffer.resetDrawCount();
+            const vk::DeviceAddress commandsAddress
+                = sharedData.gpu.device.getBufferAddress({ static_cast<vk::Buffer>(indirectDrawCommandBuffer) })
+                + sizeof(std::uint32_t) /* draw count */;
+            const auto commands = get<std::span<vk::DrawIndexedIndirectCommand>>(indirectDrawCommandBuffer.drawIndirectCommands());
+            for (auto &&[commandIndex, command] : commands.first(indirectDrawCommandBuffer.drawCount()) | ranges::views::enumerate) {
+                const std::size_t nodeIndex = command.firstInstance >> 16U;
+                const fastgltf::Primitive &primitive = gltfAsset->assetExtended->primitiveBuffer.getPrimitive(command.firstInstance & 0xFFFFU);
+                const buffer::Meshlets::PrimitiveRange &range = *meshletBuffer->getPrimitiveRange(primitive);
+
+                MeshletCullingComputePipeline::Draw &draw = draws.emplace_back();
+                // indexCount is the first field of vk::DrawIndexedIndirectCommand.
+                draw.indexCountAddress = commandsAddress + sizeof(vk::DrawIndexedIndirectCommand) * commandIndex;
+                draw.firstMeshlet = range.firstMeshlet;
+                draw.meshletCount = range.meshletCount;
+                draw.firstIndex = culledIndexCount;
+                draw.flags = 0;
+
+                // Instanced node's meshlets cannot be culled by a single world transform, therefore all of them are
+                // regarded as visible.
+                if (gltfAsset->assetExtended->asset.nodes[nodeIndex].instancingAttributes.empty()) {
+                    draw.worldTransform = glm::make_mat4(snapshot.nodeWorldTransforms[nodeIndex].data());
+
+                    const glm::mat3 linearTransform { draw.worldTransform };
+                    const glm::vec3 axisScales { length(linearTransform[0]), length(linearTransform[1]), length(linearTransform[2]) };
+                    const float maxAxisScale = std::max({ axisScales.x, axisScales.y, axisScales.z });
+                    const float minAxisScale = std::min({ axisScales.x, axisScales.y, axisScales.z });
+                    draw.radiusScale = maxAxisScale;
+                    draw.flags = MeshletCullingComputePipeline::FrustumCulling;
+
+                    // Normal cone is only meaningful for the single-sided material, and it is preserved only by the
+                    // non-mirroring uniform scale.
+                    if (criteria.cullMode != vk::CullModeFlagBits::eNone &&
+                        determinant(linearTransform) > 0.f &&
+                        maxAxisScale - minAxisScale <= 1e-3f * maxAxisScale) {
+                        draw.flags |= MeshletCullingComputePipeline::ConeCulling;
+                    }
                 }
+
+                // Draw command's indexCount is accumulated by the visible meshlets in the compute shader.
+                command.firstIndex = culledIndexCount;
+                command.indexCount = 0;
+                culledIndexCount += range.indexCount;
             }
         }
 
-        if (!gltfAsset->assetExtended->selectedNodes.empty() && renderer->selectedNodeOutline) {
-            const auto getSelectionHash = [&] {
-                return boost::hash_unordered_range(gltfAsset->assetExtended->selectedNodes.begin(), gltfAsset->assetExtended->selectedNodes.end());
-            };
-
-            std::size_t indexHash;
-            if (!selectedNodes /* asset has selected nodes but frame doesn't */ ||
-                task.gltf->regenerateDrawCommands /* draw call regeneration explicitly requested */ ||
-                (indexHash = getSelectionHash()) != selectedNodes->indexHash /* asset node selection has been changed */ ) {
-                selectedNodes.emplace(
-                    indexHash,
-                    buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, jumpFloodSeedCriteriaGetter, gltfAsset->assetExtended->selectedNodes, drawCommandGetter));
+        if (!draws.empty()) {
+            const vk::DeviceSize inputBufferSize = sizeof(MeshletCullingComputePipeline::Header) + sizeof(MeshletCullingComputePipeline::Draw) * draws.size();
+            if (!meshletCullingInputBuffer || meshletCullingInputBuffer->size < inputBufferSize) {
+                meshletCullingInputBuffer.emplace(
+                    sharedData.gpu.allocator,
+                    vk::BufferCreateInfo {
+                        {},
+                        std::bit_ceil(inputBufferSize),
+                        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+                    },
+                    vma::AllocationCreateInfo {
+                        vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+                        vma::MemoryUsage::eAutoPreferDevice,
+                    });
             }
 
-            if (renderer->frustumCullingMode != Renderer::FrustumCullingMode::Off) {
-                assert(renderer->cameras.size() == 1 && "Multiview frustum culling is not supported yet");
+            MeshletCullingComputePipeline::Header header {
+                .cameraPosition = renderer->cameras[0].position,
+                .drawCount = static_cast<std::uint32_t>(draws.size()),
+            };
+            std::ranges::transform(renderer->cameras[0].getFrustum().planes, header.frustumPlanes.begin(), [](const math::Plane &plane) {
+                return glm::vec4 { plane.normal, plane.distance };
+            });
 
-                const math::Frustum frustum = renderer->cameras[0].getFrustum();
-                for (buffer::IndirectDrawCommands &buffer : selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
-                    commandBufferCullingFunc(buffer, frustum);
-                }
-            }
-            else {
-                for (auto &buffer : selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
-                    buffer.resetDrawCount();
-                }
+            meshletCullingInputBuffer->getAllocation().copyFromMemory(&header, 0, sizeof(header));
+            meshletCullingInputBuffer->getAllocation().copyFromMemory(draws.data(), sizeof(header), sizeof(MeshletCullingComputePipeline::Draw) * draws.size());
+
+            const vk::DeviceSize culledIndexBufferSize = sizeof(std::uint32_t) * culledIndexCount;
+            if (!meshletCulledIndexBuffer || meshletCulledIndexBuffer->size < culledIndexBufferSize) {
+                meshletCulledIndexBuffer.emplace(
+                    sharedData.gpu.allocator,
+                    vk::BufferCreateInfo {
+                        {},
+                        std::bit_ceil(culledIndexBufferSize),
+                        vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+                    },
+                    vma::AllocationCreateInfo {
+                        {},
+                        vma::MemoryUsage::eAutoPreferDevice,
+                    });
             }
+
+            meshletCullingDrawCount = static_cast<std::uint32_t>(draws.size());
         }
-        else {
-            selectedNodes.reset();
-        }
+    }
 
-        const auto isHoveringNodeAndSelectedNodeEqual = [&] {
-            const auto &selectedNodes = gltfAsset->assetExtended->selectedNodes;
-            return selectedNodes.size() == 1 && *gltfAsset->assetExtended->hoveringNode == *selectedNodes.begin();
+    if (!snapshot.selectedNodes.empty()) {
+        const auto getSelectionHash = [&] {
+            return boost::hash_unordered_range(snapshot.selectedNodes.begin(), snapshot.selectedNodes.end());
         };
 
-        if (gltfAsset->assetExtended->hoveringNode &&
-            renderer->hoveringNodeOutline &&
-            !isHoveringNodeAndSelectedNodeEqual() /* in this case, hovering node outline doesn't have to be drawn */) {
-            if (!hoveringNode /* asset has hovering node but frame doesn't */ ||
-                task.gltf->regenerateDrawCommands /* draw call regeneration explicitly requested */ ||
-                *gltfAsset->assetExtended->hoveringNode != hoveringNode->index /* asset hovering node has been changed */) {
-                hoveringNode.emplace(
-                    *gltfAsset->assetExtended->hoveringNode,
-                    buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, jumpFloodSeedCriteriaGetter, std::views::single(*gltfAsset->assetExtended->hoveringNode), drawCommandGetter));
-            }
+        std::size_t indexHash;
+        if (!selectedNodes /* asset has selected nodes but frame doesn't */ ||
+            snapshot.regenerateOutlineNodes /* draw call regeneration explicitly requested */ ||
+            (indexHash = getSelectionHash()) != selectedNodes->indexHash /* asset node selection has been changed */ ) {
+            selectedNodes.emplace(
+                indexHash,
+                buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, jumpFloodSeedCriteriaGetter, snapshot.selectedNodes, drawCommandGetter));
+        }
 
-            if (renderer->frustumCullingMode != Renderer::FrustumCullingMode::Off) {
-                assert(renderer->cameras.size() == 1 && "Multiview frustum culling is not supported yet");
+        if (renderer->frustumCullingMode != Renderer::FrustumCullingMode::Off) {
+            assert(renderer->cameras.size() == 1 && "Multiview frustum culling is not supported yet");
 
-                const math::Frustum frustum = renderer->cameras[0].getFrustum();
-                for (buffer::IndirectDrawCommands &buffer : hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
-                    commandBufferCullingFunc(buffer, frustum);
-                }
-            }
-            else {
-                for (buffer::IndirectDrawCommands &buffer : hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
-                    buffer.resetDrawCount();
-                }
+            const math::Frustum frustum = renderer->cameras[0].getFrustum();
+            for (buffer::IndirectDrawCommands &buffer : selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
+                commandBufferCullingFunc(buffer, frustum);
             }
         }
         else {
-            hoveringNode.reset();
+            for (auto &buffer : selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
+                buffer.resetDrawCount();
+            }
         }
-
-        gltfAsset->mousePickingInput = task.gltf->mousePickingInput;
+        applyLevelOfDetails(selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers);
     }
     else {
-        renderingNodes.reset();
         selectedNodes.reset();
-        hoveringNode.reset();
     }
-}
 
-void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
-    // Acquire the next swapchain image.
-    std::uint32_t swapchainImageIndex;
-    try {
-        vk::Result result [[maybe_unused]];
-        std::tie(result, swapchainImageIndex) = (*sharedData.gpu.device).acquireNextImageKHR(
-            *sharedData.swapchain.swapchain, ~0ULL, *swapchainImageAcquireSema);
+    if (snapshot.hoveringNode) {
+        if (!hoveringNode /* asset has hovering node but frame doesn't */ ||
+            snapshot.regenerateOutlineNodes /* draw call regeneration explicitly requested */ ||
+            *snapshot.hoveringNode != hoveringNode->index /* asset hovering node has been changed */) {
+            hoveringNode.emplace(
+                *snapshot.hoveringNode,
+                buffer::createIndirectDrawCommandBuffers(gltfAsset->assetExtended->asset, sharedData.gpu.allocator, jumpFloodSeedCriteriaGetter, std::views::single(*snapshot.hoveringNode), drawCommandGetter));
+        }
 
-    #if __APPLE__
-        // MoltenVK does not allow presenting suboptimal swapchain image.
-        // Issue tracked: https://github.com/KhronosGroup/MoltenVK/issues/2542
-        if (result == vk::Result::eSuboptimalKHR) {
-            return;
+        if (renderer->frustumCullingMode != Renderer::FrustumCullingMode::Off) {
+            assert(renderer->cameras.size() == 1 && "Multiview frustum culling is not supported yet");
+
+            const math::Frustum frustum = renderer->cameras[0].getFrustum();
+            for (buffer::IndirectDrawCommands &buffer : hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
+                commandBufferCullingFunc(buffer, frustum);
+            }
         }
-    #endif
+        else {
+            for (buffer::IndirectDrawCommands &buffer : hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers | std::views::values) {
+                buffer.resetDrawCount();
+            }
+        }
+        applyLevelOfDetails(hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers);
     }
-    catch (const vk::OutOfDateKHRError&) {
+    else {
+        hoveringNode.reset();
+    }
+}
+
+void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit(BS::thread_pool<> &threadPool) {
+    // Acquire the next swapchain image. Draw commands are being prepared by the worker thread meanwhile.
+    const std::optional<std::uint32_t> acquiredSwapchainImageIndex = acquireSwapchainImage();
+    if (!acquiredSwapchainImageIndex) {
+        joinDrawCommandPreparation();
         return;
     }
+    const std::uint32_t swapchainImageIndex = *acquiredSwapchainImageIndex;
 
     // Record commands.
+    const cpu_profiler::Zone zone { "Record and submit commands" };
     graphicsCommandPool.reset();
     computeCommandPool.reset();
 
-    // Jump flood image seeding & mouse picking pass.
-    {
-        scenePrepassCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
-        recordScenePrepassCommands(scenePrepassCommandBuffer);
-        scenePrepassCommandBuffer.end();
+    if (secondaryCommandBufferAllocators.empty()) {
+        secondaryCommandBufferAllocators.reserve(threadPool.get_thread_count());
+        for (std::size_t i = 0; i < threadPool.get_thread_count(); ++i) {
+            secondaryCommandBufferAllocators.emplace_back(sharedData.gpu.device, sharedData.gpu.queueFamilies.graphicsPresent);
+        }
+    }
+    assert(secondaryCommandBufferAllocators.size() == threadPool.get_thread_count() && "Thread pool is changed");
 
-        sharedData.gpu.queues.graphicsPresent.submit(vk::SubmitInfo {
-            {},
-            {},
-            scenePrepassCommandBuffer,
-            *scenePrepassFinishSema,
-        });
+    for (SecondaryCommandBufferAllocator &allocator : secondaryCommandBufferAllocators) {
+        allocator.reset();
     }
 
-    // Jump flood calculation pass.
-    // TODO: If there are multiple compute queues, distribute the tasks to avoid the compute pipeline stalling.
-    std::optional<bool> hoveringNodeJumpFloodForward{}, selectedNodeJumpFloodForward{};
-    {
-        jumpFloodCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
-        if (hoveringNode) {
-            hoveringNodeJumpFloodForward = recordJumpFloodComputeCommands(
-                jumpFloodCommandBuffer,
-                viewport->hoveringNodeOutlineJumpFloodResources.image,
-                hoveringNodeJumpFloodSet,
-                std::bit_ceil(static_cast<std::uint32_t>(renderer->hoveringNodeOutline->thickness)));
-            sharedData.gpu.device.updateDescriptorSets(
-                hoveringNodeOutlineSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-                    {},
-                    *viewport->hoveringNodeOutlineJumpFloodResources.pingPongImageViews[*hoveringNodeJumpFloodForward],
-                    vk::ImageLayout::eShaderReadOnlyOptimal,
-                })),
-                {});
-        }
-        if (selectedNodes) {
-            selectedNodeJumpFloodForward = recordJumpFloodComputeCommands(
-                jumpFloodCommandBuffer,
-                viewport->selectedNodeOutlineJumpFloodResources.image,
-                selectedNodeJumpFloodSet,
-                std::bit_ceil(static_cast<std::uint32_t>(renderer->selectedNodeOutline->thickness)));
-            sharedData.gpu.device.updateDescriptorSets(
-                selectedNodeOutlineSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-                    {},
-                    *viewport->selectedNodeOutlineJumpFloodResources.pingPongImageViews[*selectedNodeJumpFloodForward],
-                    vk::ImageLayout::eShaderReadOnlyOptimal,
-                })),
-                {});
-        }
-        jumpFloodCommandBuffer.end();
+    // Record a secondary command buffer in a thread of threadPool, using the thread's own command pool.
+    const auto recordSecondaryCommandBuffer = [&](const vk::CommandBufferInheritanceInfo &inheritanceInfo, auto &&recorder) {
+        return threadPool.submit_task([this, inheritanceInfo, recorder = FWD(recorder)] {
+            const cpu_profiler::Zone zone { "Record secondary command buffer" };
+            const vk::CommandBuffer cb = secondaryCommandBufferAllocators[*BS::this_thread::get_index()].allocate(sharedData.gpu.device);
+
+            vk::CommandBufferUsageFlags usage = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+            if (inheritanceInfo.renderPass) {
+                usage |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+            }
+            cb.begin({ usage, &inheritanceInfo });
+            recorder(cb);
+            cb.end();
 
-        sharedData.gpu.queues.compute.submit(vk::SubmitInfo {
-            *scenePrepassFinishSema,
-            vku::lvalue(vk::Flags { vk::PipelineStageFlagBits::eComputeShader }),
-            jumpFloodCommandBuffer,
-            *jumpFloodFinishSema,
+            return cb;
         });
+    };
+
+    // Pipeline statistics query is active during the scene render pass, therefore the secondary command buffers
+    // executed in it must inherit the query.
+    const bool queryPipelineStatistics = pipelineStatisticsQueryPool && recordPipelineStatistics;
+    const vk::QueryPipelineStatisticFlags inheritedPipelineStatistics = queryPipelineStatistics ? pipelineStatisticFlags : vk::QueryPipelineStatisticFlags{};
+
+    // Record the criteria buckets [first, last) of a subpass of the scene rendering into multiple secondary command
+    // buffers, by splitting them into contiguous chunks.
+    const auto recordSceneSubpass = [&](std::uint32_t subpass, IndirectDrawCommandBufferIterator first, IndirectDrawCommandBufferIterator last, auto recordFunction) {
+        const std::size_t criteriaCount = std::distance(first, last);
+        const std::size_t chunkCount = std::min(
+            vku::divCeil(criteriaCount, MIN_CRITERIA_COUNT_PER_SECONDARY_COMMAND_BUFFER),
+            secondaryCommandBufferAllocators.size());
+
+        std::vector<std::future<vk::CommandBuffer>> result;
+        result.reserve(chunkCount);
+        IndirectDrawCommandBufferIterator chunkFirst = first;
+        for (std::size_t i = 0; i < chunkCount; ++i) {
+            const IndirectDrawCommandBufferIterator chunkLast = std::next(chunkFirst, criteriaCount * (i + 1) / chunkCount - criteriaCount * i / chunkCount);
+            result.push_back(recordSecondaryCommandBuffer(
+                vk::CommandBufferInheritanceInfo { *sharedData.getSceneRenderPass(), subpass, *viewport->sceneAttachmentGroup.sceneFramebuffer, {}, {}, inheritedPipelineStatistics },
+                [this, recordFunction, chunkFirst, chunkLast](vk::CommandBuffer cb) {
+                    (this->*recordFunction)(cb, chunkFirst, chunkLast);
+                }));
+            chunkFirst = chunkLast;
+        }
+        return result;
+    };
+
+    // Draw commands are used from here.
+    joinDrawCommandPreparation();
+
+    // Jump flood image seeding & mouse picking pass.
+    std::vector<std::future<vk::CommandBuffer>> scenePrepassCommandBuffers;
+    if (hoveringNode) {
+        scenePrepassCommandBuffers.push_back(recordSecondaryCommandBuffer({}, [this](vk::CommandBuffer cb) {
+            recordJumpFloodSeedCommands(
+                cb,
+                0,
+                viewport->hoveringNodeJumpFloodSeedAttachmentGroup,
+                hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers);
+        }));
+    }
+    if (selectedNodes) {
+        scenePrepassCommandBuffers.push_back(recordSecondaryCommandBuffer({}, [this](vk::CommandBuffer cb) {
+            recordJumpFloodSeedCommands(
+                cb,
+                viewport->viewCount,
+                viewport->selectedNodeJumpFloodSeedAttachmentGroup,
+                selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers);
+        }));
+    }
+    if (renderingNodes && gltfAsset->mousePickingInput) {
+        scenePrepassCommandBuffers.push_back(recordSecondaryCommandBuffer({}, [this](vk::CommandBuffer cb) {
+            recordMousePickingCommands(cb);
+        }));
+    }
+
+    // glTF scene rendering pass (opaque and blend subpasses).
+    // Transmissive meshes are ordered after the other opaque meshes in the opaque subpass, and recorded separately as
+    // they are drawn in another render pass instance after the opaque scene color is copied.
+    std::vector<std::future<vk::CommandBuffer>> sceneOpaqueCommandBuffers, sceneTransmissionCommandBuffers, sceneBlendCommandBuffers;
+    bool hasTransmissionMesh = false;
+    if (renderingNodes) {
+        const auto [opaqueFirst, opaqueLast] = renderingNodes->indirectDrawCommandBuffers.equal_range(0U);
+        const auto transmissionFirst = std::partition_point(opaqueFirst, opaqueLast, [](const auto &pair) {
+            return !pair.first.transmission;
+        });
+        hasTransmissionMesh = std::any_of(transmissionFirst, opaqueLast, [](const auto &pair) {
+            return pair.second.drawCount() > 0;
+        });
+
+        sceneOpaqueCommandBuffers = recordSceneSubpass(0U, opaqueFirst, transmissionFirst, &Frame::recordSceneOpaqueMeshDrawCommands);
+        if (hasTransmissionMesh) {
+            sceneTransmissionCommandBuffers = recordSceneSubpass(0U, transmissionFirst, opaqueLast, &Frame::recordSceneOpaqueMeshDrawCommands);
+        }
+
+        const auto [blendFirst, blendLast] = renderingNodes->indirectDrawCommandBuffers.equal_range(1U);
+        sceneBlendCommandBuffers = recordSceneSubpass(1U, blendFirst, blendLast, &Frame::recordSceneBlendMeshDrawCommands);
+    }
+    const bool hasBlendMesh = !sceneBlendCommandBuffers.empty();
+    if (!renderer->solidBackground || renderer->grid) {
+        // Background must be drawn after the opaque meshes, to make the early depth test effective.
+        sceneOpaqueCommandBuffers.push_back(recordSecondaryCommandBuffer(
+            vk::CommandBufferInheritanceInfo { *sharedData.getSceneRenderPass(), 0, *viewport->sceneAttachmentGroup.sceneFramebuffer, {}, {}, inheritedPipelineStatistics },
+            [this](vk::CommandBuffer cb) {
+                recordSceneBackgroundCommands(cb);
+            }));
+    }
+
+    const auto executeCommands = [](vk::CommandBuffer primary, std::vector<std::future<vk::CommandBuffer>> &secondaryFutures) {
+        if (secondaryFutures.empty()) return;
+
+        const auto secondaries = secondaryFutures
+            | std::views::transform([](std::future<vk::CommandBuffer> &future) { return future.get(); })
+            | std::ranges::to<std::vector>();
+        primary.executeCommands(secondaries);
+    };
+
+    std::uint64_t scenePrepassFinishValue;
+    {
+        scenePrepassCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        beginGpuPass(scenePrepassCommandBuffer, GpuPass::ScenePrepass);
+        if (meshletCullingDrawCount > 0) {
+            recordMeshletCullingCommands(scenePrepassCommandBuffer);
+        }
+        executeCommands(scenePrepassCommandBuffer, scenePrepassCommandBuffers);
+        endGpuPass(scenePrepassCommandBuffer, GpuPass::ScenePrepass);
+        scenePrepassCommandBuffer.end();
+
+        scenePrepassFinishValue = timelines.graphicsPresent.submit({}, vk::CommandBufferSubmitInfo { scenePrepassCommandBuffer });
+    }
+
+    // Jump flood calculation pass.
+    // TODO: If there are multiple compute queues, distribute the tasks to avoid the compute pipeline stalling.
+    bool jumpFloodForward = false;
+    std::uint64_t jumpFloodFinishValue;
+    {
+        jumpFloodCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        if (hoveringNode || selectedNodes) {
+            beginGpuPass(jumpFloodCommandBuffer, GpuPass::JumpFlood);
+            jumpFloodForward = recordJumpFloodComputeCommands(jumpFloodCommandBuffer);
+            endGpuPass(jumpFloodCommandBuffer, GpuPass::JumpFlood);
+        }
+        jumpFloodCommandBuffer.end();
+
+        jumpFloodFinishValue = timelines.compute.submit(
+            timelines.graphicsPresent.getWaitInfo(scenePrepassFinishValue, vk::PipelineStageFlagBits2::eComputeShader),
+            vk::CommandBufferSubmitInfo { jumpFloodCommandBuffer });
+    }
+
+    // Node outline composition, which can be recorded after the jump flood direction is determined.
+    std::vector<std::future<vk::CommandBuffer>> nodeOutlineCompositionCommandBuffers;
+    if (selectedNodes || hoveringNode) {
+        nodeOutlineCompositionCommandBuffers.push_back(recordSecondaryCommandBuffer({}, [=, this](vk::CommandBuffer cb) {
+            recordNodeOutlineCompositionCommands(cb, jumpFloodForward);
+        }));
     }
 
     // glTF scene rendering pass.
     {
         sceneRenderingCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
+        beginGpuPass(sceneRenderingCommandBuffer, GpuPass::Scene);
+
+        // Barriers are derived from the accesses of the passes. Contents of the bloom and transmission images from
+        // the previous frame are discarded.
+        AccessTracker accessTracker;
+        accessTracker.track(viewport->bloomImage, vk::ImageAspectFlagBits::eColor, viewport->bloomImage.mipLevels, viewport->bloomImage.arrayLayers, {
+            vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+        });
+        accessTracker.track(viewport->transmissionImage, vk::ImageAspectFlagBits::eColor, viewport->transmissionImage.mipLevels, viewport->transmissionImage.arrayLayers, {
+            vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+        });
+
         if (renderer->bloom) {
             // Clear the first mip level of bloomImage as black to initialize the bloom calculation.
             // As the image is written by storage in InverseToneMappingRenderPipeline, it cannot be cleared by the
             // render pass loadOp=CLEAR. Therefore, it must be manually cleared by vkCmdClearColorImage().
-
-            sceneRenderingCommandBuffer.pipelineBarrier(
-                vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
-                {}, {}, {},
-                vk::ImageMemoryBarrier {
-                    {}, vk::AccessFlagBits::eTransferWrite,
-                    {}, vk::ImageLayout::eTransferDstOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->bloomImage, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, vk::RemainingArrayLayers },
-                });
+            accessTracker.access(viewport->bloomImage, 0, 1, {
+                vk::PipelineStageFlagBits2::eClear, vk::AccessFlagBits2::eTransferWrite, vk::ImageLayout::eTransferDstOptimal,
+            });
+            accessTracker.flush(sceneRenderingCommandBuffer);
 
             sceneRenderingCommandBuffer.clearColorImage(
                 viewport->bloomImage,
@@ -684,96 +1292,172 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
                 vk::ClearColorValue{},
                 vku::lvalue(vk::ImageSubresourceRange { vk::ImageAspectFlagBits::eColor, 0, 1, 0, vk::RemainingArrayLayers }));
 
-            sceneRenderingCommandBuffer.pipelineBarrier(
-                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
-                {}, {}, {},
-                vk::ImageMemoryBarrier {
-                    vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderWrite,
-                    vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eGeneral,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->bloomImage, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, vk::RemainingArrayLayers },
-                });
+            accessTracker.access(viewport->bloomImage, 0, 1, {
+                vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral,
+            });
+            accessTracker.flush(sceneRenderingCommandBuffer);
         }
 
-        const vk::Rect2D renderArea { { 0, 0 }, viewport->extent };
+        const vk::Rect2D renderArea = viewport->getRenderArea();
         vk::ClearColorValue backgroundColor { 0.f, 0.f, 0.f, 0.f };
         if (renderer->solidBackground) {
             backgroundColor.setFloat32({ renderer->solidBackground->x, renderer->solidBackground->y, renderer->solidBackground->z, 1.f });
         }
-        sceneRenderingCommandBuffer.beginRenderPass({
-            *sharedData.getSceneRenderPass(),
-            *viewport->sceneAttachmentGroup.sceneFramebuffer,
-            renderArea,
-            vku::lvalue([&] -> boost::container::static_vector<vk::ClearValue, 8> {
-                if (sharedData.getSceneRenderPass().sampleCount == vk::SampleCountFlagBits::e1) {
-                    return {
-                        backgroundColor,
-                        vk::ClearDepthStencilValue { 0.f, 0 },
-                        vk::ClearColorValue { 0.f, 0.f, 0.f, 0.f },
-                        vk::ClearColorValue { 1.f, 0.f, 0.f, 0.f },
-                    };
-                }
-                else {
-                    return {
-                        backgroundColor,
-                        vk::ClearColorValue{},
-                        vk::ClearDepthStencilValue { 0.f, 0 },
-                        vk::ClearDepthStencilValue{},
-                        vk::ClearColorValue { 0.f, 0.f, 0.f, 0.f },
-                        vk::ClearColorValue{},
-                        vk::ClearColorValue { 1.f, 0.f, 0.f, 0.f },
-                        vk::ClearColorValue{},
-                    };
-                }
-            }()),
-        }, vk::SubpassContents::eInline);
-
-        if (renderingNodes) {
-            recordSceneOpaqueMeshDrawCommands(sceneRenderingCommandBuffer);
-        }
-
-        if (!renderer->solidBackground || renderer->grid) {
-            // Both SkyboxRenderPipeline and GridRenderPipeline uses dynamic viewport/scissor with count states.
-            const auto scissors = viewport->getSubrects();
-            const auto viewports = scissors
-                | std::views::transform([](const vk::Rect2D &rect) {
-                    return vku::toViewport(rect, true);
-                })
-                | std::ranges::to<boost::container::static_vector<vk::Viewport, 4>>();
-            sceneRenderingCommandBuffer.setViewportWithCountEXT(viewports);
-            sceneRenderingCommandBuffer.setScissorWithCountEXT(scissors);
-
-            // Draw skybox.
-            if (!renderer->solidBackground) {
-                sceneRenderingCommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.getSkyboxRenderPipeline());
-                sceneRenderingCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.skyboxPipelineLayout, 0, { rendererSet, sharedData.skyboxDescriptorSet }, {});
-                sceneRenderingCommandBuffer.draw(36, viewport->viewCount, 0, 0);
+
+        const auto clearValues = [&] -> boost::container::static_vector<vk::ClearValue, 8> {
+            if (sharedData.getSceneRenderPass().sampleCount == vk::SampleCountFlagBits::e1) {
+                return {
+                    backgroundColor,
+                    vk::ClearDepthStencilValue { 0.f, 0 },
+                    vk::ClearColorValue { 0.f, 0.f, 0.f, 0.f },
+                    vk::ClearColorValue { 1.f, 0.f, 0.f, 0.f },
+                };
             }
+            else {
+                return {
+                    backgroundColor,
+                    vk::ClearColorValue{},
+                    vk::ClearDepthStencilValue { 0.f, 0 },
+                    vk::ClearDepthStencilValue{},
+                    vk::ClearColorValue { 0.f, 0.f, 0.f, 0.f },
+                    vk::ClearColorValue{},
+                    vk::ClearColorValue { 1.f, 0.f, 0.f, 0.f },
+                    vk::ClearColorValue{},
+                };
+            }
+        }();
 
-            // Draw grid.
-            if (renderer->grid) {
-                sceneRenderingCommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.getGridRenderPipeline().pipeline);
-                sceneRenderingCommandBuffer.bindDescriptorSets(
-                    vk::PipelineBindPoint::eGraphics, *sharedData.getGridRenderPipeline().pipelineLayout,
-                    0, rendererSet, {});
-                sceneRenderingCommandBuffer.pushConstants<GridRenderPipeline::PushConstant>(
-                    *sharedData.getGridRenderPipeline().pipelineLayout, GridRenderPipeline::PushConstant::range.stageFlags,
-                    0, GridRenderPipeline::PushConstant {
-                        .color = renderer->grid->color,
-                        .showMinorAxes = renderer->grid->showMinorAxes,
-                        .size = renderer->grid->size,
-                    });
-                sceneRenderingCommandBuffer.draw(6, viewport->viewCount, 0, 0);
+        if (queryPipelineStatistics) {
+            sceneRenderingCommandBuffer.resetQueryPool(**pipelineStatisticsQueryPool, 0, 1);
+            sceneRenderingCommandBuffer.beginQuery(**pipelineStatisticsQueryPool, 0, {});
+        }
+
+        if (hasTransmissionMesh) {
+            // Render the opaque meshes and the background, and store the color and depth/stencil attachments. Remaining
+            // subpasses have nothing to draw.
+            sceneRenderingCommandBuffer.beginRenderPass({
+                *sharedData.getSceneRenderPass().opaqueRenderPass,
+                *viewport->sceneAttachmentGroup.sceneFramebuffer,
+                renderArea,
+                clearValues,
+            }, vk::SubpassContents::eSecondaryCommandBuffers);
+            executeCommands(sceneRenderingCommandBuffer, sceneOpaqueCommandBuffers);
+            for (std::uint32_t subpass = 1; subpass < 4; ++subpass) {
+                sceneRenderingCommandBuffer.nextSubpass(vk::SubpassContents::eInline);
+            }
+            sceneRenderingCommandBuffer.endRenderPass();
+
+            // Copy the scene color of each view to the corresponding array layer of transmissionImage[mipLevel=0], and
+            // generate its mip chain, which is sampled with the roughness dependent LOD by the transmissive meshes.
+            // Attachments are stored by the opaque render pass.
+            accessTracker.track(viewport->sceneAttachmentGroup.colorImage, vk::ImageAspectFlagBits::eColor, 1, viewport->sceneAttachmentGroup.colorImage.arrayLayers, {
+                vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+            });
+            accessTracker.track(viewport->sceneAttachmentGroup.depthStencilImage, vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil, 1, viewport->sceneAttachmentGroup.depthStencilImage.arrayLayers, {
+                vk::PipelineStageFlagBits2::eLateFragmentTests,
+                vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                sharedData.getSceneRenderPass().sampleCount == vk::SampleCountFlagBits::e1
+                    ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                    : vk::ImageLayout::eDepthReadOnlyStencilAttachmentOptimal,
+            });
+            if (const auto &multisample = viewport->sceneAttachmentGroup.multisample) {
+                accessTracker.track(multisample->colorImage, vk::ImageAspectFlagBits::eColor, 1, multisample->colorImage.arrayLayers, {
+                    vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+                });
+            }
+
+            accessTracker.access(viewport->sceneAttachmentGroup.colorImage, {
+                vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eTransferSrcOptimal,
+            });
+            accessTracker.access(viewport->transmissionImage, 0, 1, {
+                vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferWrite, vk::ImageLayout::eTransferDstOptimal,
+            });
+            accessTracker.flush(sceneRenderingCommandBuffer);
+
+            // Blit is used instead of copy, for the sRGB to floating point format conversion.
+            for (const auto &[viewIndex, subrect] : viewport->getSubrects() | ranges::views::enumerate) {
+                sceneRenderingCommandBuffer.blitImage(
+                    viewport->sceneAttachmentGroup.colorImage, vk::ImageLayout::eTransferSrcOptimal,
+                    viewport->transmissionImage, vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageBlit {
+                        { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                        { vk::Offset3D { subrect.offset, 0 }, vk::Offset3D { subrect.offset.x + static_cast<std::int32_t>(subrect.extent.width), subrect.offset.y + static_cast<std::int32_t>(subrect.extent.height), 1 } },
+                        { vk::ImageAspectFlagBits::eColor, 0, static_cast<std::uint32_t>(viewIndex), 1 },
+                        { vk::Offset3D{}, vk::Offset3D { static_cast<std::int32_t>(viewport->subextent.width), static_cast<std::int32_t>(viewport->subextent.height), 1 } },
+                    },
+                    vk::Filter::eLinear);
+            }
+
+            // Mip level 0 is sampled, and the remaining mip levels are written by the downsampling.
+            accessTracker.access(viewport->transmissionImage, 0, 1, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eGeneral,
+            });
+            accessTracker.access(viewport->transmissionImage, 1, vk::RemainingMipLevels, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral,
+            });
+            accessTracker.flush(sceneRenderingCommandBuffer);
+
+            sharedData.bloomComputePipeline.downsample(sceneRenderingCommandBuffer, transmissionSet, viewport->subextent, viewport->transmissionImage.mipLevels, viewport->viewCount);
+
+            // Prepare the attachments to be loaded by the transmission render pass.
+            accessTracker.access(viewport->transmissionImage, {
+                vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eShaderReadOnlyOptimal,
+            });
+            accessTracker.access(viewport->sceneAttachmentGroup.colorImage, {
+                vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+            });
+            accessTracker.access(viewport->sceneAttachmentGroup.depthStencilImage, {
+                vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                sharedData.getSceneRenderPass().sampleCount == vk::SampleCountFlagBits::e1
+                    ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                    : vk::ImageLayout::eDepthReadOnlyStencilAttachmentOptimal,
+            });
+            if (const auto &multisample = viewport->sceneAttachmentGroup.multisample) {
+                accessTracker.access(multisample->colorImage, {
+                    vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+                });
             }
+            accessTracker.flush(sceneRenderingCommandBuffer);
+
+            sceneRenderingCommandBuffer.beginRenderPass({
+                *sharedData.getSceneRenderPass().transmissionRenderPass,
+                *viewport->sceneAttachmentGroup.sceneFramebuffer,
+                renderArea,
+                clearValues,
+            }, vk::SubpassContents::eSecondaryCommandBuffers);
+
+            // Render the transmissive meshes whose AlphaMode=Opaque|Mask.
+            executeCommands(sceneRenderingCommandBuffer, sceneTransmissionCommandBuffers);
+
+            viewport->transmissionImageLayoutInitialized = true;
         }
+        else {
+            if (!viewport->transmissionImageLayoutInitialized) {
+                // transmissionImage is not written, but bound to the descriptor set that is statically used by the
+                // scene rendering.
+                accessTracker.access(viewport->transmissionImage, {
+                    vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eShaderReadOnlyOptimal,
+                });
+                accessTracker.flush(sceneRenderingCommandBuffer);
+                viewport->transmissionImageLayoutInitialized = true;
+            }
 
-        // Render meshes whose AlphaMode=Blend.
-        sceneRenderingCommandBuffer.nextSubpass(vk::SubpassContents::eInline);
-        bool hasBlendMesh = false;
-        if (renderingNodes) {
-            hasBlendMesh = recordSceneBlendMeshDrawCommands(sceneRenderingCommandBuffer);
+            sceneRenderingCommandBuffer.beginRenderPass({
+                *sharedData.getSceneRenderPass(),
+                *viewport->sceneAttachmentGroup.sceneFramebuffer,
+                renderArea,
+                clearValues,
+            }, vk::SubpassContents::eSecondaryCommandBuffers);
+
+            // Render meshes whose AlphaMode=Opaque|Mask, and the background.
+            executeCommands(sceneRenderingCommandBuffer, sceneOpaqueCommandBuffers);
         }
 
+        // Render meshes whose AlphaMode=Blend.
+        sceneRenderingCommandBuffer.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
+        executeCommands(sceneRenderingCommandBuffer, sceneBlendCommandBuffers);
+
         sceneRenderingCommandBuffer.nextSubpass(vk::SubpassContents::eInline);
 
         sceneRenderingCommandBuffer.setViewport(0, vku::toViewport(renderArea, true));
@@ -802,39 +1486,40 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
 
         sceneRenderingCommandBuffer.endRenderPass();
 
+        if (queryPipelineStatistics) {
+            sceneRenderingCommandBuffer.endQuery(**pipelineStatisticsQueryPool, 0);
+            pipelineStatisticsQueryWritten = true;
+        }
+
+        endGpuPass(sceneRenderingCommandBuffer, GpuPass::Scene);
+
         if (renderer->bloom) {
-            sceneRenderingCommandBuffer.pipelineBarrier2KHR({
-                {},
-                vku::lvalue(vk::MemoryBarrier2 {
-                    vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite,
-                    vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
-                }),
-                {},
-                vku::lvalue(vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
-                    {}, vk::ImageLayout::eGeneral,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->bloomImage, vk::ImageSubresourceRange { vk::ImageAspectFlagBits::eColor, 1, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers },
-                }),
+            beginGpuPass(sceneRenderingCommandBuffer, GpuPass::Bloom);
+
+            // Mip level 0 is sampled (and written by the last upsampling), and the remaining mip levels are read and
+            // written by the bloom compute pipeline.
+            accessTracker.access(viewport->bloomImage, 0, 1, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral,
+            });
+            accessTracker.access(viewport->bloomImage, 1, vk::RemainingMipLevels, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral,
             });
+            accessTracker.flush(sceneRenderingCommandBuffer);
 
-            sharedData.bloomComputePipeline.compute(sceneRenderingCommandBuffer, bloomSet, viewport->subextent, viewport->bloomImage.mipLevels, renderer->cameras.size());
+            // When half resolution bloom is enabled, the last upsampling to the mip level 0 is fused into
+            // BloomApplyRenderPipeline, which saves the full resolution storage image write and read.
+            const bool halfResolutionBloom = renderer->bloom->halfResolution && viewport->bloomImage.mipLevels > 1;
+            sharedData.bloomComputePipeline.compute(sceneRenderingCommandBuffer, bloomSet, viewport->subextent, viewport->bloomImage.mipLevels, renderer->cameras.size(), halfResolutionBloom ? 1U : 0U);
 
-            sceneRenderingCommandBuffer.pipelineBarrier(
-                vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                {}, {}, {},
-                vk::ImageMemoryBarrier {
-                    vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eInputAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite,
-                    vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->bloomImage, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, vk::RemainingArrayLayers },
-                });
+            accessTracker.access(viewport->bloomImage, {
+                vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eShaderReadOnlyOptimal,
+            });
+            accessTracker.flush(sceneRenderingCommandBuffer);
 
             sceneRenderingCommandBuffer.beginRenderPass({
                 *sharedData.bloomApplyRenderPass,
                 *viewport->sceneAttachmentGroup.bloomApplyFramebuffer,
-                vk::Rect2D { { 0, 0 }, viewport->extent },
+                viewport->getRenderArea(),
                 vku::lvalue<vk::ClearValue>(vk::ClearColorValue{}),
             }, vk::SubpassContents::eInline);
 
@@ -843,10 +1528,15 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
             sceneRenderingCommandBuffer.pushConstants<pl::BloomApply::PushConstant>(
                 *sharedData.bloomApplyPipelineLayout,
                 vk::ShaderStageFlagBits::eFragment,
-                0, pl::BloomApply::PushConstant { .factor = renderer->bloom->intensity });
+                0, pl::BloomApply::PushConstant {
+                    .factor = renderer->bloom->intensity,
+                    .upsampleHalfResolution = halfResolutionBloom,
+                });
             sceneRenderingCommandBuffer.draw(3, 1, 0, 0);
 
             sceneRenderingCommandBuffer.endRenderPass();
+
+            endGpuPass(sceneRenderingCommandBuffer, GpuPass::Bloom);
         }
 
         sceneRenderingCommandBuffer.end();
@@ -855,64 +1545,96 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
     // Post-composition pass.
     {
         compositionCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        beginGpuPass(compositionCommandBuffer, GpuPass::Composition);
+
+        // Composited image is written by the scene/bloom apply render passes and the outline composition, and the
+        // swapchain image contents are discarded. Its layout transition must be chained to the acquire semaphore wait
+        // at the transfer stage.
+        AccessTracker accessTracker;
+        accessTracker.track(viewport->sceneAttachmentGroup.colorImage, vk::ImageAspectFlagBits::eColor, 1, viewport->sceneAttachmentGroup.colorImage.arrayLayers, {
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+        });
+        accessTracker.track(sharedData.swapchain.images[swapchainImageIndex], vk::ImageAspectFlagBits::eColor, 1, 1, {
+            vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+        });
 
-        if (selectedNodes || hoveringNode) {
-            recordNodeOutlineCompositionCommands(compositionCommandBuffer, hoveringNodeJumpFloodForward, selectedNodeJumpFloodForward);
+        if (!nodeOutlineCompositionCommandBuffers.empty()) {
+            // Jump flood image is written by the jump flood calculation pass in the compute queue, whose submission is
+            // waited at the fragment shader stage.
+            accessTracker.track(viewport->outlineJumpFloodResources.image, vk::ImageAspectFlagBits::eColor, 1, viewport->outlineJumpFloodResources.image.arrayLayers, {
+                vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eNone, vk::ImageLayout::eGeneral,
+            });
 
-            // Make sure the outline composition is done before rendering ImGui.
-            compositionCommandBuffer.pipelineBarrier(
-                vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                {},
-                vk::MemoryBarrier {
-                    vk::AccessFlagBits::eColorAttachmentWrite,
-                    vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite,
-                },
-                {}, {});
-        }
+            // Outlines are sampled from the jump flood image and drawn over the composited image.
+            accessTracker.access(viewport->outlineJumpFloodResources.image, {
+                vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eShaderReadOnlyOptimal,
+            });
+            accessTracker.access(viewport->sceneAttachmentGroup.colorImage, {
+                vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+            });
+            accessTracker.flush(compositionCommandBuffer);
 
-        compositionCommandBuffer.pipelineBarrier(
-            vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eTransfer,
-            {}, {}, {},
-            vku::lvalue({
-                // Change composited image layout from ColorAttachmentOptimal to TransferSrcOptimal.
-                vk::ImageMemoryBarrier {
-                    vk::AccessFlagBits::eColorAttachmentWrite, vk::AccessFlagBits::eTransferRead,
-                    vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::eTransferSrcOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->sceneAttachmentGroup.colorImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-                },
-                // Change the swapchain image layout to TransferDstOptimal.
-                vk::ImageMemoryBarrier {
-                    {}, vk::AccessFlagBits::eTransferWrite,
-                    {}, vk::ImageLayout::eTransferDstOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    sharedData.swapchain.images[swapchainImageIndex], vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-                },
-            }));
+            executeCommands(compositionCommandBuffer, nodeOutlineCompositionCommandBuffers);
+        }
 
-        // Copy from composited image to swapchain image.
-        compositionCommandBuffer.copyImage(
-            viewport->sceneAttachmentGroup.colorImage, vk::ImageLayout::eTransferSrcOptimal,
-            sharedData.swapchain.images[swapchainImageIndex], vk::ImageLayout::eTransferDstOptimal,
-            vk::ImageCopy {
-                { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
-                { 0, 0, 0 },
-                { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
-                vk::Offset3D { passthruOffset, 0 }, viewport->sceneAttachmentGroup.colorImage.extent,
-            });
+        // Copy or blit the composited image to the swapchain image.
+        accessTracker.access(viewport->sceneAttachmentGroup.colorImage, {
+            vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eTransferSrcOptimal,
+        });
+        accessTracker.access(sharedData.swapchain.images[swapchainImageIndex], {
+            vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite, vk::ImageLayout::eTransferDstOptimal,
+        });
+        accessTracker.flush(compositionCommandBuffer);
+
+        if (viewport->renderSubextent == viewport->subextent) {
+            // Copy from composited image to swapchain image.
+            compositionCommandBuffer.copyImage(
+                viewport->sceneAttachmentGroup.colorImage, vk::ImageLayout::eTransferSrcOptimal,
+                sharedData.swapchain.images[swapchainImageIndex], vk::ImageLayout::eTransferDstOptimal,
+                vk::ImageCopy {
+                    { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                    { 0, 0, 0 },
+                    { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                    vk::Offset3D { passthruOffset, 0 }, viewport->sceneAttachmentGroup.colorImage.extent,
+                });
+        }
+        else {
+            // Upscale the rendered region of each view to its full region in the swapchain image.
+            const auto regions = viewport->getSubrects() | std::views::transform([&](const vk::Rect2D &subrect) {
+                const vk::Offset2D dstOffset { passthruOffset.x + subrect.offset.x, passthruOffset.y + subrect.offset.y };
+                return vk::ImageBlit {
+                    { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                    {
+                        vk::Offset3D { subrect.offset, 0 },
+                        vk::Offset3D {
+                            subrect.offset.x + static_cast<std::int32_t>(subrect.extent.width),
+                            subrect.offset.y + static_cast<std::int32_t>(subrect.extent.height),
+                            1,
+                        },
+                    },
+                    { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+                    {
+                        vk::Offset3D { dstOffset, 0 },
+                        vk::Offset3D {
+                            dstOffset.x + static_cast<std::int32_t>(viewport->subextent.width),
+                            dstOffset.y + static_cast<std::int32_t>(viewport->subextent.height),
+                            1,
+                        },
+                    },
+                };
+            }) | std::ranges::to<boost::container::static_vector<vk::ImageBlit, 4>>();
+            compositionCommandBuffer.blitImage(
+                viewport->sceneAttachmentGroup.colorImage, vk::ImageLayout::eTransferSrcOptimal,
+                sharedData.swapchain.images[swapchainImageIndex], vk::ImageLayout::eTransferDstOptimal,
+                regions, vk::Filter::eLinear);
+        }
 
-        // Change swapchain image layout from TransferDstOptimal to ColorAttachmentOptimal.
-        compositionCommandBuffer.pipelineBarrier(
-            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eColorAttachmentOutput,
-            {}, {}, {},
-            vk::ImageMemoryBarrier {
-                vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite,
-                vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eColorAttachmentOptimal,
-                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                sharedData.swapchain.images[swapchainImageIndex], vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-            });
+        // Draw ImGui over the swapchain image.
+        accessTracker.access(sharedData.swapchain.images[swapchainImageIndex], {
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+        });
+        accessTracker.flush(compositionCommandBuffer);
 
-        // Draw ImGui.
         compositionCommandBuffer.beginRenderingKHR({
             {},
             { {}, sharedData.swapchain.extent },
@@ -927,39 +1649,25 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
         ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), compositionCommandBuffer);
         compositionCommandBuffer.endRenderingKHR();
 
-        // Change swapchain image layout from ColorAttachmentOptimal to PresentSrcKHR.
-        compositionCommandBuffer.pipelineBarrier(
-            vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eBottomOfPipe,
-            {}, {}, {},
-            vk::ImageMemoryBarrier {
-                vk::AccessFlagBits::eColorAttachmentWrite, {},
-                vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::ePresentSrcKHR,
-                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                sharedData.swapchain.images[swapchainImageIndex], vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-            });
+        // Present the swapchain image.
+        accessTracker.access(sharedData.swapchain.images[swapchainImageIndex], {
+            vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::ePresentSrcKHR,
+        });
+        accessTracker.flush(compositionCommandBuffer);
 
+        endGpuPass(compositionCommandBuffer, GpuPass::Composition);
         compositionCommandBuffer.end();
     }
 
-    sharedData.gpu.device.resetFences(*inFlightFence);
-    sharedData.gpu.queues.graphicsPresent.submit({
-        vk::SubmitInfo {
-            {},
-            {},
-            sceneRenderingCommandBuffer,
-            *sceneRenderingFinishSema,
-        },
-        vk::SubmitInfo {
-            vku::lvalue({ *swapchainImageAcquireSema, *sceneRenderingFinishSema, *jumpFloodFinishSema }),
-            vku::lvalue<vk::PipelineStageFlags>({
-                vk::PipelineStageFlagBits::eTransfer,
-                vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                vk::PipelineStageFlagBits::eFragmentShader,
-            }),
-            compositionCommandBuffer,
-            *sharedData.swapchain.imageReadySemaphores[swapchainImageIndex],
+    const std::uint64_t sceneRenderingFinishValue = timelines.graphicsPresent.submit({}, vk::CommandBufferSubmitInfo { sceneRenderingCommandBuffer });
+    frameFinishValue = timelines.graphicsPresent.submit(
+        {
+            vk::SemaphoreSubmitInfo { *swapchainImageAcquireSema, 0, vk::PipelineStageFlagBits2::eTransfer },
+            timelines.graphicsPresent.getWaitInfo(sceneRenderingFinishValue, vk::PipelineStageFlagBits2::eColorAttachmentOutput),
+            timelines.compute.getWaitInfo(jumpFloodFinishValue, vk::PipelineStageFlagBits2::eFragmentShader),
         },
-    }, *inFlightFence);
+        vk::CommandBufferSubmitInfo { compositionCommandBuffer },
+        vk::SemaphoreSubmitInfo { *sharedData.swapchain.imageReadySemaphores[swapchainImageIndex], 0, vk::PipelineStageFlagBits2::eAllCommands });
 
     // Present the rendered swapchain image to swapchain.
     try {
@@ -972,41 +1680,31 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmit() const {
     catch (const vk::OutOfDateKHRError&) { }
 }
 
-void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmitFirstFrame() const {
-    // Acquire the next swapchain image.
-    std::uint32_t swapchainImageIndex;
-    try {
-        vk::Result result [[maybe_unused]];
-        std::tie(result, swapchainImageIndex) = (*sharedData.gpu.device).acquireNextImageKHR(
-            *sharedData.swapchain.swapchain, ~0ULL, *swapchainImageAcquireSema);
-
-#if __APPLE__
-        // MoltenVK does not allow presenting suboptimal swapchain image.
-        // Issue tracked: https://github.com/KhronosGroup/MoltenVK/issues/2542
-        if (result == vk::Result::eSuboptimalKHR) {
-            return;
-        }
-#endif
-    }
-    catch (const vk::OutOfDateKHRError&) {
+void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmitFirstFrame() {
+    // Acquire the next swapchain image. Draw commands are not used in the first frame, but the preparation must be
+    // joined before the frame is updated again.
+    const std::optional<std::uint32_t> acquiredSwapchainImageIndex = acquireSwapchainImage();
+    joinDrawCommandPreparation();
+    if (!acquiredSwapchainImageIndex) {
         return;
     }
+    const std::uint32_t swapchainImageIndex = *acquiredSwapchainImageIndex;
 
     // Record commands.
     graphicsCommandPool.reset();
 
     compositionCommandBuffer.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
-    // Change swapchain image layout to ColorAttachmentOptimal.
-    compositionCommandBuffer.pipelineBarrier(
-        vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eColorAttachmentOutput,
-        {}, {}, {},
-        vk::ImageMemoryBarrier {
-            {}, vk::AccessFlagBits::eColorAttachmentWrite,
-            {}, vk::ImageLayout::eColorAttachmentOptimal,
-            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-            sharedData.swapchain.images[swapchainImageIndex], vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-        });
+    // Swapchain image contents are discarded, and its layout transition must be chained to the acquire semaphore wait
+    // at the color attachment output stage.
+    AccessTracker accessTracker;
+    accessTracker.track(sharedData.swapchain.images[swapchainImageIndex], vk::ImageAspectFlagBits::eColor, 1, 1, {
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+    });
+    accessTracker.access(sharedData.swapchain.images[swapchainImageIndex], {
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+    });
+    accessTracker.flush(compositionCommandBuffer);
 
     // Draw ImGui.
     // Note: unlike viewport.has_value() == true, here the loadOp must be CLEAR as the viewport image is not copied
@@ -1025,26 +1723,18 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmitFirstFrame() const {
     ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), compositionCommandBuffer);
     compositionCommandBuffer.endRenderingKHR();
 
-    // Change swapchain image layout from ColorAttachmentOptimal to PresentSrcKHR.
-    compositionCommandBuffer.pipelineBarrier(
-        vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eBottomOfPipe,
-        {}, {}, {},
-        vk::ImageMemoryBarrier {
-            vk::AccessFlagBits::eColorAttachmentWrite, {},
-            vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::ePresentSrcKHR,
-            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-            sharedData.swapchain.images[swapchainImageIndex], vku::fullSubresourceRange(vk::ImageAspectFlagBits::eColor),
-        });
+    // Present the swapchain image.
+    accessTracker.access(sharedData.swapchain.images[swapchainImageIndex], {
+        vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::ePresentSrcKHR,
+    });
+    accessTracker.flush(compositionCommandBuffer);
 
     compositionCommandBuffer.end();
 
-    sharedData.gpu.device.resetFences(*inFlightFence);
-    sharedData.gpu.queues.graphicsPresent.submit(vk::SubmitInfo {
-        *swapchainImageAcquireSema,
-        vku::lvalue<vk::PipelineStageFlags>(vk::PipelineStageFlagBits::eColorAttachmentOutput),
-        compositionCommandBuffer,
-        *sharedData.swapchain.imageReadySemaphores[swapchainImageIndex],
-    }, *inFlightFence);
+    frameFinishValue = timelines.graphicsPresent.submit(
+        vk::SemaphoreSubmitInfo { *swapchainImageAcquireSema, 0, vk::PipelineStageFlagBits2::eColorAttachmentOutput },
+        vk::CommandBufferSubmitInfo { compositionCommandBuffer },
+        vk::SemaphoreSubmitInfo { *sharedData.swapchain.imageReadySemaphores[swapchainImageIndex], 0, vk::PipelineStageFlagBits2::eAllCommands });
 
     // Present the rendered swapchain image to swapchain.
     try {
@@ -1059,7 +1749,7 @@ void vk_gltf_viewer::vulkan::Frame::recordCommandsAndSubmitFirstFrame() const {
 
 void vk_gltf_viewer::vulkan::Frame::setViewportExtent(const vk::Extent2D &extent) {
     const std::uint32_t viewCount = static_cast<std::uint32_t>(renderer->cameras.size());
-    viewport.emplace(sharedData.gpu, extent, viewCount, sharedData.getSceneRenderPass(), sharedData.bloomApplyRenderPass);
+    viewport.emplace(sharedData.gpu, extent, viewCount, renderScale, renderer->halfResolutionOutline ? 1U : 0U, sharedData.getSceneRenderPass(), sharedData.bloomApplyRenderPass);
 
     sharedData.gpu.device.updateDescriptorSets({
         weightedBlendedCompositionSet.getWrite<0>(0, vku::lvalue({
@@ -1076,16 +1766,6 @@ void vk_gltf_viewer::vulkan::Frame::setViewportExtent(const vk::Extent2D &extent
             *viewport->sceneAttachmentGroup.colorImageView,
             vk::ImageLayout::eGeneral,
         })),
-        hoveringNodeJumpFloodSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *viewport->hoveringNodeOutlineJumpFloodResources.imageView,
-            vk::ImageLayout::eGeneral,
-        })),
-        selectedNodeJumpFloodSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *viewport->selectedNodeOutlineJumpFloodResources.imageView,
-            vk::ImageLayout::eGeneral,
-        })),
         inverseToneMappingSet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
             {},
             *viewport->bloomMipImageViews[0],
@@ -1110,10 +1790,20 @@ void vk_gltf_viewer::vulkan::Frame::setViewportExtent(const vk::Extent2D &extent
         }())),
         bloomApplySet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
             {},
-            *viewport->bloomMipImageViews[0],
+            *viewport->bloomImageView,
             vk::ImageLayout::eShaderReadOnlyOptimal,
         })),
     }, {});
+
+    updateJumpFloodDescriptorSets();
+    updateTransmissionDescriptorSets();
+}
+
+void vk_gltf_viewer::vulkan::Frame::setRenderScale(float renderScale) {
+    this->renderScale = renderScale;
+    if (viewport) {
+        viewport->setRenderScale(renderScale);
+    }
 }
 
 void vk_gltf_viewer::vulkan::Frame::updateSampleCount() {
@@ -1142,16 +1832,6 @@ void vk_gltf_viewer::vulkan::Frame::updateViewCount() {
     viewport->setViewCount(viewCount);
 
     sharedData.gpu.device.updateDescriptorSets({
-        hoveringNodeJumpFloodSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *viewport->hoveringNodeOutlineJumpFloodResources.imageView,
-            vk::ImageLayout::eGeneral,
-        })),
-        selectedNodeJumpFloodSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
-            {},
-            *viewport->selectedNodeOutlineJumpFloodResources.imageView,
-            vk::ImageLayout::eGeneral,
-        })),
         inverseToneMappingSet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
             {},
             *viewport->bloomMipImageViews[0],
@@ -1176,10 +1856,18 @@ void vk_gltf_viewer::vulkan::Frame::updateViewCount() {
         }())),
         bloomApplySet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
             {},
-            *viewport->bloomMipImageViews[0],
+            *viewport->bloomImageView,
             vk::ImageLayout::eShaderReadOnlyOptimal,
         })),
     }, {});
+
+    updateJumpFloodDescriptorSets();
+    updateTransmissionDescriptorSets();
+}
+
+void vk_gltf_viewer::vulkan::Frame::updateJumpFloodResolution() {
+    viewport->setJumpFloodResolutionShift(renderer->halfResolutionOutline ? 1U : 0U);
+    updateJumpFloodDescriptorSets();
 }
 
 void vk_gltf_viewer::vulkan::Frame::updateAsset() {
@@ -1215,7 +1903,8 @@ void vk_gltf_viewer::vulkan::Frame::updateAsset() {
         mousePickingSet.getWrite<0>(0, vku::lvalue(vk::DescriptorBufferInfo { *inner.mousePickingResultBuffer, 0, vk::WholeSize })),
         assetDescriptorSet.getWrite<0>(0, vku::lvalue(vk::DescriptorBufferInfo { *inner.assetExtended->primitiveBuffer, 0, vk::WholeSize })),
         assetDescriptorSet.getWrite<1>(0, vku::lvalue(vk::DescriptorBufferInfo { *inner.nodeBuffer, 0, vk::WholeSize })),
-        assetDescriptorSet.getWrite<2>(0, vku::lvalue(vk::DescriptorBufferInfo { *inner.assetExtended->materialBuffer, 0, vk::WholeSize })),
+        assetDescriptorSet.getWrite<2>(0, inner.assetExtended->materials.descriptorInfo),
+        assetDescriptorSet.getWrite<3>(0, inner.assetExtended->materials.extensionDescriptorInfo),
     }, {});
 
 #if __APPLE__
@@ -1230,7 +1919,7 @@ void vk_gltf_viewer::vulkan::Frame::updateAsset() {
     if (assetDescriptorSetReallocated) {
         // Write fallback texture sampler and image.
         samplerInfos.emplace_back(*sharedData.fallbackTexture.sampler);
-        descriptorWrites.push_back(assetDescriptorSet.getWrite<4>(0, fallbackImageInfo));
+        descriptorWrites.push_back(assetDescriptorSet.getWrite<5>(0, fallbackImageInfo));
     }
 
     for (vk::Sampler sampler : inner.assetExtended->textures.samplers) {
@@ -1238,7 +1927,7 @@ void vk_gltf_viewer::vulkan::Frame::updateAsset() {
     }
 
     if (!samplerInfos.empty()) {
-        descriptorWrites.push_back(assetDescriptorSet.getWrite<3>(assetDescriptorSetReallocated ? 0 : 1, samplerInfos));
+        descriptorWrites.push_back(assetDescriptorSet.getWrite<4>(assetDescriptorSetReallocated ? 0 : 1, samplerInfos));
     }
 
     std::vector<std::vector<vk::DescriptorImageInfo>> chunkedImageInfos;
@@ -1263,7 +1952,7 @@ void vk_gltf_viewer::vulkan::Frame::updateAsset() {
                 chunk | std::views::transform([&](std::size_t imageIndex) {
                     return vk::DescriptorImageInfo { {}, *inner.assetExtended->textures.images.at(imageIndex).view, vk::ImageLayout::eShaderReadOnlyOptimal };
                 }));
-            descriptorWrites.push_back(assetDescriptorSet.getWrite<4>(1 + chunk.front(), infos));
+            descriptorWrites.push_back(assetDescriptorSet.getWrite<5>(1 + chunk.front(), infos));
         }
     }
 
@@ -1286,12 +1975,36 @@ void vk_gltf_viewer::vulkan::Frame::updateAsset() {
         textureInfos.append_range(inner.assetExtended->textures.descriptorInfos);
 
         sharedData.gpu.device.updateDescriptorSets(
-            assetDescriptorSet.getWrite<3>(dstArrayElement, textureInfos),
+            assetDescriptorSet.getWrite<4>(dstArrayElement, textureInfos),
             {});
     }
 #endif
 }
 
+void vk_gltf_viewer::vulkan::Frame::updateMaterialBuffer() {
+    sharedData.gpu.device.updateDescriptorSets(
+        assetDescriptorSet.getWrite<2>(0, gltfAsset->assetExtended->materials.descriptorInfo),
+        {});
+}
+
+void vk_gltf_viewer::vulkan::Frame::updateImageBasedLighting(
+    const vk::DescriptorBufferInfo &sphericalHarmonicsBufferInfo,
+    vk::ImageView prefilteredmapImageView,
+    vk::ImageView brdfmapImageView
+) {
+    sharedData.gpu.device.updateDescriptorSets({
+        imageBasedLightingSet.getWrite<0>(0, sphericalHarmonicsBufferInfo),
+        imageBasedLightingSet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo { {}, prefilteredmapImageView, vk::ImageLayout::eShaderReadOnlyOptimal })),
+        imageBasedLightingSet.getWrite<2>(0, vku::lvalue(vk::DescriptorImageInfo { {}, brdfmapImageView, vk::ImageLayout::eShaderReadOnlyOptimal })),
+    }, {});
+}
+
+void vk_gltf_viewer::vulkan::Frame::updateSkybox(vk::ImageView cubemapImageView) {
+    sharedData.gpu.device.updateDescriptorSets(
+        skyboxSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo { {}, cubemapImageView, vk::ImageLayout::eShaderReadOnlyOptimal })),
+        {});
+}
+
 vk_gltf_viewer::vulkan::Frame::Viewport::JumpFloodResources::JumpFloodResources(
     const Gpu &gpu,
     const vk::Extent2D &extent,
@@ -1303,7 +2016,7 @@ vk_gltf_viewer::vulkan::Frame::Viewport::JumpFloodResources::JumpFloodResources(
             vk::ImageType::e2D,
             vk::Format::eR16G16Uint,
             vk::Extent3D { extent, 1 },
-            1, 2 * viewCount, // arrayLevels=0..viewCount for ping image, arrayLevels=viewCount.. for pong image.
+            1, 4 * viewCount, // arrayLevels=0..2*viewCount for ping image, arrayLevels=2*viewCount.. for pong image.
             vk::SampleCountFlagBits::e1,
             vk::ImageTiling::eOptimal,
             vk::ImageUsageFlagBits::eColorAttachment /* write from JumpFloodSeedRenderPipeline */
@@ -1317,15 +2030,14 @@ vk_gltf_viewer::vulkan::Frame::Viewport::JumpFloodResources::JumpFloodResources(
             vma::MemoryUsage::eAutoPreferDevice,
         }
     },
-    imageView { gpu.device, image.getViewCreateInfo(vk::ImageViewType::e2DArray) },
-    pingPongImageViews { INDEX_SEQ(Is, 2, {
-        return std::array { vk::raii::ImageView { gpu.device, image.getViewCreateInfo(vk::ImageViewType::e2DArray, { vk::ImageAspectFlagBits::eColor, 0, 1, static_cast<std::uint32_t>(Is * viewCount), viewCount }) }... };
-    }) } { }
+    imageView { gpu.device, image.getViewCreateInfo(vk::ImageViewType::e2DArray) } { }
 
 vk_gltf_viewer::vulkan::Frame::Viewport::Viewport(
     const Gpu &gpu,
     const vk::Extent2D &extent,
     std::uint32_t viewCount,
+    float renderScale,
+    std::uint32_t jumpFloodResolutionShift,
     const rp::Scene &sceneRenderPass,
     const rp::BloomApply &bloomApplyRenderPass
 ) : gpu { gpu },
@@ -1342,13 +2054,18 @@ vk_gltf_viewer::vulkan::Frame::Viewport::Viewport(
         return result;
     }() },
     viewCount { viewCount },
-    hoveringNodeOutlineJumpFloodResources { gpu, subextent, viewCount },
-    hoveringNodeJumpFloodSeedAttachmentGroup { gpu, hoveringNodeOutlineJumpFloodResources.image, viewCount },
-    selectedNodeOutlineJumpFloodResources { gpu, subextent, viewCount },
-    selectedNodeJumpFloodSeedAttachmentGroup { gpu, selectedNodeOutlineJumpFloodResources.image, viewCount },
+    renderScale { renderScale },
+    renderSubextent { getRenderSubextent() },
+    jumpFloodResolutionShift { jumpFloodResolutionShift },
+    outlineJumpFloodResources { gpu, getJumpFloodExtent(), viewCount },
+    hoveringNodeJumpFloodSeedAttachmentGroup { gpu, outlineJumpFloodResources.image, 0, viewCount },
+    selectedNodeJumpFloodSeedAttachmentGroup { gpu, outlineJumpFloodResources.image, viewCount, viewCount },
     bloomImage { createBloomImage() },
     bloomImageView { gpu.device, bloomImage.getViewCreateInfo(vk::ImageViewType::e2DArray) },
-    bloomMipImageViews { createBloomMipImageViews() } {
+    bloomMipImageViews { createMipImageViews(bloomImage) },
+    transmissionImage { createTransmissionImage() },
+    transmissionImageView { gpu.device, transmissionImage.getViewCreateInfo(vk::ImageViewType::e2DArray) },
+    transmissionMipImageViews { createMipImageViews(transmissionImage) } {
     assert(extent.width % 2 == 0 && extent.height % 2 == 0 && "Viewport extent must be even.");
     assert(ranges::one_of(viewCount, { 1, 2, 4 }) && "viewCount must be 1, 2 or 4.");
 
@@ -1360,24 +2077,36 @@ vk_gltf_viewer::vulkan::Frame::Viewport::Viewport(
 boost::container::static_vector<vk::Rect2D, 4> vk_gltf_viewer::vulkan::Frame::Viewport::getSubrects() const noexcept {
     switch (viewCount) {
         case 1:
-            return { vk::Rect2D { { 0, 0 }, extent } };
+            return { vk::Rect2D { { 0, 0 }, renderSubextent } };
         case 2:
             return {
-                vk::Rect2D { { 0, 0 }, subextent },
-                vk::Rect2D { { static_cast<int32_t>(subextent.width), 0 }, subextent },
+                vk::Rect2D { { 0, 0 }, renderSubextent },
+                vk::Rect2D { { static_cast<int32_t>(subextent.width), 0 }, renderSubextent },
             };
         case 4:
             return {
-                vk::Rect2D { { 0, 0 }, subextent },
-                vk::Rect2D { { static_cast<int32_t>(subextent.width), 0 }, subextent },
-                vk::Rect2D { { 0, static_cast<int32_t>(subextent.height) }, subextent },
-                vk::Rect2D { vku::toOffset2D(subextent), subextent },
+                vk::Rect2D { { 0, 0 }, renderSubextent },
+                vk::Rect2D { { static_cast<int32_t>(subextent.width), 0 }, renderSubextent },
+                vk::Rect2D { { 0, static_cast<int32_t>(subextent.height) }, renderSubextent },
+                vk::Rect2D { vku::toOffset2D(subextent), renderSubextent },
             };
         default:
             std::unreachable();
     }
 }
 
+vk::Rect2D vk_gltf_viewer::vulkan::Frame::Viewport::getRenderArea() const noexcept {
+    // The last view's region is at the bottom-right of the others.
+    const vk::Rect2D lastSubrect = getSubrects().back();
+    return {
+        { 0, 0 },
+        {
+            static_cast<std::uint32_t>(lastSubrect.offset.x) + lastSubrect.extent.width,
+            static_cast<std::uint32_t>(lastSubrect.offset.y) + lastSubrect.extent.height,
+        },
+    };
+}
+
 void vk_gltf_viewer::vulkan::Frame::Viewport::setSceneRenderPass(const rp::Scene &sceneRenderPass) {
     sceneAttachmentGroup = { gpu, extent, sceneRenderPass, bloomApplyRenderPass };
 }
@@ -1396,18 +2125,50 @@ void vk_gltf_viewer::vulkan::Frame::Viewport::setViewCount(std::uint32_t count)
     }
 
     viewCount = count;
+    renderSubextent = getRenderSubextent();
 
     if (gpu.get().workaround.attachmentLessRenderPass) {
         mousePickingAttachmentGroup.emplace(gpu, subextent);
     }
 
-    hoveringNodeOutlineJumpFloodResources = { gpu, subextent, viewCount };
-    hoveringNodeJumpFloodSeedAttachmentGroup = { gpu, hoveringNodeOutlineJumpFloodResources.image, viewCount };
-    selectedNodeOutlineJumpFloodResources = { gpu, subextent, viewCount };
-    selectedNodeJumpFloodSeedAttachmentGroup = { gpu, selectedNodeOutlineJumpFloodResources.image, viewCount };
+    outlineJumpFloodResources = { gpu, getJumpFloodExtent(), viewCount };
+    hoveringNodeJumpFloodSeedAttachmentGroup = { gpu, outlineJumpFloodResources.image, 0, viewCount };
+    selectedNodeJumpFloodSeedAttachmentGroup = { gpu, outlineJumpFloodResources.image, viewCount, viewCount };
     bloomImage = createBloomImage();
     bloomImageView = { gpu.get().device, bloomImage.getViewCreateInfo(vk::ImageViewType::e2DArray) };
-    bloomMipImageViews = createBloomMipImageViews();
+    bloomMipImageViews = createMipImageViews(bloomImage);
+    transmissionImage = createTransmissionImage();
+    transmissionImageView = { gpu.get().device, transmissionImage.getViewCreateInfo(vk::ImageViewType::e2DArray) };
+    transmissionMipImageViews = createMipImageViews(transmissionImage);
+    transmissionImageLayoutInitialized = false;
+}
+
+void vk_gltf_viewer::vulkan::Frame::Viewport::setRenderScale(float scale) {
+    renderScale = scale;
+    renderSubextent = getRenderSubextent();
+}
+
+void vk_gltf_viewer::vulkan::Frame::Viewport::setJumpFloodResolutionShift(std::uint32_t shift) {
+    jumpFloodResolutionShift = shift;
+
+    outlineJumpFloodResources = { gpu, getJumpFloodExtent(), viewCount };
+    hoveringNodeJumpFloodSeedAttachmentGroup = { gpu, outlineJumpFloodResources.image, 0, viewCount };
+    selectedNodeJumpFloodSeedAttachmentGroup = { gpu, outlineJumpFloodResources.image, viewCount, viewCount };
+}
+
+vk::Extent2D vk_gltf_viewer::vulkan::Frame::Viewport::getRenderSubextent() const noexcept {
+    return {
+        std::max(1U, static_cast<std::uint32_t>(std::round(subextent.width * renderScale))),
+        std::max(1U, static_cast<std::uint32_t>(std::round(subextent.height * renderScale))),
+    };
+}
+
+vk::Extent2D vk_gltf_viewer::vulkan::Frame::Viewport::getJumpFloodExtent() const noexcept {
+    // Round up to cover the whole subextent.
+    return {
+        vku::divCeil(subextent.width, 1U << jumpFloodResolutionShift),
+        vku::divCeil(subextent.height, 1U << jumpFloodResolutionShift),
+    };
 }
 
 vku::raii::AllocatedImage vk_gltf_viewer::vulkan::Frame::Viewport::createBloomImage() const {
@@ -1416,7 +2177,7 @@ vku::raii::AllocatedImage vk_gltf_viewer::vulkan::Frame::Viewport::createBloomIm
         vk::ImageCreateInfo {
             {},
             vk::ImageType::e2D,
-            vk::Format::eR16G16B16A16Sfloat,
+            bloom::BloomComputePipeline::requiredImageFormat,
             vk::Extent3D { subextent, 1 },
             vku::maxMipLevels(subextent), viewCount,
             vk::SampleCountFlagBits::e1,
@@ -1433,13 +2194,35 @@ vku::raii::AllocatedImage vk_gltf_viewer::vulkan::Frame::Viewport::createBloomIm
     };
 }
 
-std::vector<vk::raii::ImageView> vk_gltf_viewer::vulkan::Frame::Viewport::createBloomMipImageViews() const {
+vku::raii::AllocatedImage vk_gltf_viewer::vulkan::Frame::Viewport::createTransmissionImage() const {
+    return {
+        gpu.get().allocator,
+        vk::ImageCreateInfo {
+            {},
+            vk::ImageType::e2D,
+            bloom::BloomComputePipeline::requiredImageFormat,
+            vk::Extent3D { subextent, 1 },
+            vku::maxMipLevels(subextent), viewCount,
+            vk::SampleCountFlagBits::e1,
+            vk::ImageTiling::eOptimal,
+            vk::ImageUsageFlagBits::eTransferDst // blitted from the opaque scene color
+                | bloom::BloomComputePipeline::requiredImageUsageFlags
+                | vk::ImageUsageFlagBits::eSampled /* read in PrimitiveRenderPipeline */,
+        },
+        vma::AllocationCreateInfo {
+            {},
+            vma::MemoryUsage::eAutoPreferDevice,
+        }
+    };
+}
+
+std::vector<vk::raii::ImageView> vk_gltf_viewer::vulkan::Frame::Viewport::createMipImageViews(const vku::raii::AllocatedImage &image) const {
     std::vector<vk::raii::ImageView> result;
-    result.emplace_back(gpu.get().device, bloomImage.getViewCreateInfo(vk::ImageViewType::e2DArray, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, vk::RemainingArrayLayers }));
+    result.emplace_back(gpu.get().device, image.getViewCreateInfo(vk::ImageViewType::e2DArray, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, vk::RemainingArrayLayers }));
 
     if (!gpu.get().supportShaderImageLoadStoreLod) {
         result.append_range(
-            bloomImage.getPerMipLevelViewCreateInfos(vk::ImageViewType::e2DArray)
+            image.getPerMipLevelViewCreateInfos(vk::ImageViewType::e2DArray)
             | std::views::drop(1)
             | std::views::transform([&](const vk::ImageViewCreateInfo& createInfo) {
                 return vk::raii::ImageView{ gpu.get().device, createInfo };
@@ -1449,16 +2232,40 @@ std::vector<vk::raii::ImageView> vk_gltf_viewer::vulkan::Frame::Viewport::create
     return result;
 }
 
+vk_gltf_viewer::vulkan::Frame::SecondaryCommandBufferAllocator::SecondaryCommandBufferAllocator(
+    const vk::raii::Device &device,
+    std::uint32_t queueFamilyIndex
+) : commandPool { device, vk::CommandPoolCreateInfo { {}, queueFamilyIndex } } { }
+
+vk::CommandBuffer vk_gltf_viewer::vulkan::Frame::SecondaryCommandBufferAllocator::allocate(const vk::raii::Device &device) {
+    if (usedCount == commandBuffers.size()) {
+        commandBuffers.push_back((*device).allocateCommandBuffers({
+            *commandPool,
+            vk::CommandBufferLevel::eSecondary,
+            1,
+        })[0]);
+    }
+    return commandBuffers[usedCount++];
+}
+
+void vk_gltf_viewer::vulkan::Frame::SecondaryCommandBufferAllocator::reset() {
+    commandPool.reset();
+    usedCount = 0;
+}
+
 vk::raii::DescriptorPool vk_gltf_viewer::vulkan::Frame::createDescriptorPool() const {
     const auto [maxSets, poolSizes] = vku::DescriptorPoolSizeBuilder{}
         .add(sharedData.rendererDescriptorSetLayout)
+        .add(sharedData.imageBasedLightingDescriptorSetLayout)
+        .add(sharedData.skyboxDescriptorSetLayout)
         .add(sharedData.mousePickingDescriptorSetLayout)
-        .add(sharedData.jumpFloodComputePipeline.descriptorSetLayout, 2)
-        .add(sharedData.outlineDescriptorSetLayout, 2)
+        .add(sharedData.jumpFloodComputePipeline.descriptorSetLayout)
+        .add(sharedData.outlineDescriptorSetLayout)
         .add(sharedData.weightedBlendedCompositionDescriptorSetLayout)
         .add(sharedData.inverseToneMappingDescriptorSetLayout)
         .add(sharedData.bloomComputePipeline.descriptorSetLayout)
         .add(sharedData.bloomApplyDescriptorSetLayout)
+        .add(sharedData.bloomComputePipeline.descriptorSetLayout) // transmissionSet
         .add(sharedData.assetDescriptorSetLayout)
         .build();
 
@@ -1469,10 +2276,115 @@ vk::raii::DescriptorPool vk_gltf_viewer::vulkan::Frame::createDescriptorPool() c
     } };
 }
 
-void vk_gltf_viewer::vulkan::Frame::recordScenePrepassCommands(vk::CommandBuffer cb) const {
-    const vk::Rect2D rect { { 0, 0 }, viewport->subextent };
-    cb.setViewport(0, vku::toViewport(rect, true));
-    cb.setScissor(0, rect);
+void vk_gltf_viewer::vulkan::Frame::beginGpuPass(vk::CommandBuffer cb, GpuPass pass) const {
+    if (!timestampQueryPool || (pass == GpuPass::JumpFlood && !sharedData.gpu.supportComputeQueueTimestamp)) return;
+
+    const auto firstQuery = static_cast<std::uint32_t>(2 * std::to_underlying(pass));
+    cb.resetQueryPool(**timestampQueryPool, firstQuery, 2);
+    cb.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, **timestampQueryPool, firstQuery);
+}
+
+void vk_gltf_viewer::vulkan::Frame::endGpuPass(vk::CommandBuffer cb, GpuPass pass) {
+    if (!timestampQueryPool || (pass == GpuPass::JumpFlood && !sharedData.gpu.supportComputeQueueTimestamp)) return;
+
+    cb.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, **timestampQueryPool, static_cast<std::uint32_t>(2 * std::to_underlying(pass) + 1));
+    timestampQueryWrittenPasses.set(std::to_underlying(pass));
+}
+
+void vk_gltf_viewer::vulkan::Frame::updateJumpFloodDescriptorSets() {
+    sharedData.gpu.device.updateDescriptorSets({
+        jumpFloodSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
+            {},
+            *viewport->outlineJumpFloodResources.imageView,
+            vk::ImageLayout::eGeneral,
+        })),
+        outlineSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
+            {},
+            *viewport->outlineJumpFloodResources.imageView,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+        })),
+    }, {});
+}
+
+void vk_gltf_viewer::vulkan::Frame::updateTransmissionDescriptorSets() {
+    sharedData.gpu.device.updateDescriptorSets({
+        rendererSet.getWrite<1>(0, vku::lvalue(vk::DescriptorImageInfo {
+            {},
+            *viewport->transmissionImageView,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+        })),
+        transmissionSet.getWrite<0>(0, vku::lvalue(vk::DescriptorImageInfo {
+            {},
+            *viewport->transmissionImageView,
+            vk::ImageLayout::eGeneral,
+        })),
+        transmissionSet.getWrite<1>(0, vku::lvalue([this] {
+            std::vector<vk::DescriptorImageInfo> result;
+            if (sharedData.gpu.supportShaderImageLoadStoreLod) {
+                result.push_back({ {}, *viewport->transmissionImageView, vk::ImageLayout::eGeneral });
+            }
+            else {
+                result.append_range(viewport->transmissionMipImageViews | std::views::transform([this](vk::ImageView imageView) {
+                    return vk::DescriptorImageInfo{ {}, imageView, vk::ImageLayout::eGeneral };
+                }));
+            }
+            return result;
+        }())),
+    }, {});
+}
+
+void vk_gltf_viewer::vulkan::Frame::recordJumpFloodSeedCommands(
+    vk::CommandBuffer cb,
+    std::uint32_t baseLayer,
+    const ag::JumpFloodSeed &attachmentGroup,
+    const std::map<CommandSeparationCriteriaNoShading, buffer::IndirectDrawCommands> &indirectDrawCommandBuffers
+) const {
+    // If the jump flood image is downsampled, seeds are rasterized in the downsampled resolution. The whole image is
+    // cleared not to flood the stale seeds, but only the rendered region of the view is rasterized.
+    const vk::Rect2D rect { { 0, 0 }, vku::toExtent2D(viewport->outlineJumpFloodResources.image.extent) };
+    const vk::Rect2D seedRect { { 0, 0 }, {
+        vku::divCeil(viewport->renderSubextent.width, 1U << viewport->jumpFloodResolutionShift),
+        vku::divCeil(viewport->renderSubextent.height, 1U << viewport->jumpFloodResolutionShift),
+    } };
+    cb.setViewport(0, vku::toViewport(seedRect, true));
+    cb.setScissor(0, seedRect);
+
+    // Both attachments are cleared, therefore their contents are discarded. The other layers of the jump flood image
+    // are seeded by the other pass, and not accessed by this.
+    AccessTracker accessTracker;
+    accessTracker.track(viewport->outlineJumpFloodResources.image, vk::ImageAspectFlagBits::eColor, 1, viewport->outlineJumpFloodResources.image.arrayLayers, {
+        vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+    });
+    accessTracker.track(attachmentGroup.depthImage, vk::ImageAspectFlagBits::eDepth, 1, attachmentGroup.depthImage.arrayLayers, {
+        vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+    });
+
+    accessTracker.access(viewport->outlineJumpFloodResources.image, 0, 1, baseLayer, viewport->viewCount, {
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal,
+    });
+    accessTracker.access(attachmentGroup.depthImage, {
+        vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+        vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+        vk::ImageLayout::eDepthStencilAttachmentOptimal,
+    });
+    accessTracker.flush(cb);
+
+    cb.beginRenderingKHR({
+        {},
+        rect,
+        static_cast<std::uint32_t>(renderer->cameras.size()),
+        math::bit::ones(renderer->cameras.size()),
+        vku::lvalue(vk::RenderingAttachmentInfo {
+            *attachmentGroup.seedImageView, vk::ImageLayout::eColorAttachmentOptimal,
+            {}, {}, {},
+            vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, vk::ClearColorValue { 65535U, 65535U, 0U, 0U },
+        }),
+        &vku::lvalue(vk::RenderingAttachmentInfo {
+            *attachmentGroup.depthImageView, vk::ImageLayout::eDepthStencilAttachmentOptimal,
+            {}, {}, {},
+            vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
+        })
+    });
 
     struct ResourceBindingState {
         vk::Pipeline pipeline;
@@ -1485,23 +2397,137 @@ void vk_gltf_viewer::vulkan::Frame::recordScenePrepassCommands(vk::CommandBuffer
         bool descriptorSetBound = false;
     } resourceBindingState{};
 
-    auto drawPrimitives = [&](const auto &indirectDrawCommandBuffers) {
-        for (const auto &[criteria, indirectDrawCommandBuffer] : indirectDrawCommandBuffers) {
+    for (const auto &[criteria, indirectDrawCommandBuffer] : indirectDrawCommandBuffers) {
+        if (resourceBindingState.pipeline != criteria.pipeline) {
+            cb.bindPipeline(vk::PipelineBindPoint::eGraphics, resourceBindingState.pipeline = criteria.pipeline);
+        }
+
+        if (!resourceBindingState.descriptorSetBound) {
+            cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.primitiveNoShadingPipelineLayout,
+                0, { rendererSet, assetDescriptorSet }, {});
+            resourceBindingState.descriptorSetBound = true;
+        }
+
+        if (resourceBindingState.primitiveTopology != criteria.primitiveTopology) {
+            cb.setPrimitiveTopologyEXT(resourceBindingState.primitiveTopology.emplace(criteria.primitiveTopology));
+        }
+
+        if (resourceBindingState.cullMode != criteria.cullMode) {
+            cb.setCullModeEXT(resourceBindingState.cullMode.emplace(criteria.cullMode));
+        }
+
+        if (criteria.indexType && resourceBindingState.indexType != *criteria.indexType) {
+            resourceBindingState.indexType.emplace(*criteria.indexType);
+            cb.bindIndexBuffer(
+                gltfAsset->assetExtended->combinedIndexBuffer,
+                gltfAsset->assetExtended->combinedIndexBuffer.getIndexOffsetAndSize(*resourceBindingState.indexType).first,
+                *resourceBindingState.indexType);
+        }
+        indirectDrawCommandBuffer.recordDrawCommand(cb, sharedData.gpu.supportDrawIndirectCount);
+    }
+
+    cb.endRenderingKHR();
+}
+
+void vk_gltf_viewer::vulkan::Frame::recordMousePickingCommands(vk::CommandBuffer cb) const {
+    assert(renderingNodes && gltfAsset->mousePickingInput && "Mouse picking is not requested.");
+
+    const auto &[viewIndex, rect] = *gltfAsset->mousePickingInput;
+    const bool singlePixel = rect.extent.width == 1 && rect.extent.height == 1;
+
+    // mousePickingResultBuffer is not accessed by the device since its initial value is written by the host.
+    AccessTracker accessTracker;
+    accessTracker.track(gltfAsset->mousePickingResultBuffer, { vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone });
+
+    if (singlePixel) {
+        if (sharedData.gpu.supportShaderBufferInt64Atomics) {
+            constexpr std::uint64_t initialValue = NO_INDEX;
+            gltfAsset->mousePickingResultBuffer.getAllocation().copyFromMemory(&initialValue, 0, sizeof(initialValue));
+        }
+        else {
+            constexpr std::uint32_t initialValue = NO_INDEX;
+            gltfAsset->mousePickingResultBuffer.getAllocation().copyFromMemory(&initialValue, 0, sizeof(initialValue));
+        }
+    }
+    else {
+        // Clear mousePickingResultBuffer as zeros.
+    #if __APPLE__
+        // Filling buffer with a value needs MTLBlitCommandEncoder in Metal, and it breaks the render pass.
+        // It is better to use host memset for this purpose.
+        std::memset(
+            gltfAsset->mousePickingResultBuffer.getAllocation().getInfo().pMappedData,
+            0, gltfAsset->mousePickingResultBuffer.size);
+    #else
+        accessTracker.access(gltfAsset->mousePickingResultBuffer, { vk::PipelineStageFlagBits2::eClear, vk::AccessFlagBits2::eTransferWrite });
+        accessTracker.flush(cb);
+
+        cb.fillBuffer(gltfAsset->mousePickingResultBuffer, 0, gltfAsset->mousePickingResultBuffer.size, 0U);
+    #endif
+    }
+
+    if (renderingNodes->startMousePickingRenderPass) {
+        // Node indices are collected by the fragment shader atomic operations.
+        accessTracker.access(gltfAsset->mousePickingResultBuffer, {
+            vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+        });
+
+        std::optional<vk::RenderingAttachmentInfo> depthStencilAttachmentInfo;
+        if (sharedData.gpu.workaround.attachmentLessRenderPass) {
+            // Dummy depth attachment, whose contents are never used.
+            const vku::Image &depthImage = viewport->mousePickingAttachmentGroup->depthImage;
+            accessTracker.track(depthImage, vk::ImageAspectFlagBits::eDepth, 1, depthImage.arrayLayers, {
+                vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+            });
+            accessTracker.access(depthImage, {
+                vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                vk::ImageLayout::eDepthAttachmentOptimal,
+            });
+            depthStencilAttachmentInfo.emplace(vk::RenderingAttachmentInfo {
+                *viewport->mousePickingAttachmentGroup->depthImageView, vk::ImageLayout::eDepthAttachmentOptimal,
+                {}, {}, {},
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+            });
+        }
+        accessTracker.flush(cb);
+
+        cb.beginRenderingKHR(vk::RenderingInfo {
+            {},
+            rect,
+            1,
+            0,
+            vk::ArrayProxyNoTemporaries<const vk::RenderingAttachmentInfo>{},
+            value_address(depthStencilAttachmentInfo),
+        });
+
+        cb.setViewport(0, vku::toViewport({ {}, viewport->renderSubextent }, true));
+        cb.setScissor(0, rect);
+
+        cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.mousePickingPipelineLayout,
+            0, { rendererSet, assetDescriptorSet, mousePickingSet }, {});
+        cb.pushConstants<pl::MousePicking::PushConstant>(*sharedData.mousePickingPipelineLayout, vk::ShaderStageFlagBits::eVertex,
+            0, pl::MousePicking::PushConstant { viewIndex });
+
+        struct ResourceBindingState {
+            vk::Pipeline pipeline;
+            std::optional<vk::PrimitiveTopology> primitiveTopology;
+            std::optional<vk::CullModeFlagBits> cullMode;
+            std::optional<vk::IndexType> indexType;
+        } resourceBindingState{};
+
+        const auto &map = singlePixel
+            ? renderingNodes->mousePickingIndirectDrawCommandBuffers
+            : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers;
+        for (const auto &[criteria, indirectDrawCommandBuffer] : map) {
             if (resourceBindingState.pipeline != criteria.pipeline) {
                 cb.bindPipeline(vk::PipelineBindPoint::eGraphics, resourceBindingState.pipeline = criteria.pipeline);
             }
 
-            if (!resourceBindingState.descriptorSetBound) {
-                cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.primitiveNoShadingPipelineLayout,
-                    0, { rendererSet, assetDescriptorSet }, {});
-                resourceBindingState.descriptorSetBound = true;
-            }
-
             if (resourceBindingState.primitiveTopology != criteria.primitiveTopology) {
                 cb.setPrimitiveTopologyEXT(resourceBindingState.primitiveTopology.emplace(criteria.primitiveTopology));
             }
 
-            if (resourceBindingState.cullMode != criteria.cullMode) {
+            if (singlePixel && resourceBindingState.cullMode != criteria.cullMode) {
                 cb.setCullModeEXT(resourceBindingState.cullMode.emplace(criteria.cullMode));
             }
 
@@ -1514,239 +2540,99 @@ void vk_gltf_viewer::vulkan::Frame::recordScenePrepassCommands(vk::CommandBuffer
             }
             indirectDrawCommandBuffer.recordDrawCommand(cb, sharedData.gpu.supportDrawIndirectCount);
         }
-    };
 
-    // Seeding jump flood initial image for hovering node.
-    if (hoveringNode) {
-        cb.pipelineBarrier2KHR({
-            {}, {}, {},
-            vku::lvalue({
-                vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite,
-                    {}, vk::ImageLayout::eColorAttachmentOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->hoveringNodeOutlineJumpFloodResources.image, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, viewport->viewCount },
-                },
-                vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eEarlyFragmentTests, vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-                    {}, vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->hoveringNodeJumpFloodSeedAttachmentGroup.depthImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eDepth),
-                },
-            }),
-        });
-
-        cb.beginRenderingKHR({
-            {},
-            { {}, viewport->subextent },
-            static_cast<std::uint32_t>(renderer->cameras.size()),
-            math::bit::ones(renderer->cameras.size()),
-            vku::lvalue(vk::RenderingAttachmentInfo {
-                *viewport->hoveringNodeJumpFloodSeedAttachmentGroup.seedImageView, vk::ImageLayout::eColorAttachmentOptimal,
-                {}, {}, {},
-                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, vk::ClearColorValue { 65535U, 65535U, 0U, 0U },
-            }),
-            &vku::lvalue(vk::RenderingAttachmentInfo {
-                *viewport->hoveringNodeJumpFloodSeedAttachmentGroup.depthImageView, vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                {}, {}, {},
-                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
-            })
-        });
-        drawPrimitives(hoveringNode->jumpFloodSeedIndirectDrawCommandBuffers);
-        cb.endRenderingKHR();
-    }
-
-    // Seeding jump flood initial image for selected node.
-    if (selectedNodes) {
-        cb.pipelineBarrier2KHR({
-            {}, {}, {},
-            vku::lvalue({
-                vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite,
-                    {}, vk::ImageLayout::eColorAttachmentOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->selectedNodeOutlineJumpFloodResources.image, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, viewport->viewCount },
-                },
-                vk::ImageMemoryBarrier2 {
-                    {}, {},
-                    vk::PipelineStageFlagBits2::eEarlyFragmentTests, vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-                    {}, vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                    viewport->selectedNodeJumpFloodSeedAttachmentGroup.depthImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eDepth),
-                },
-            }),
-        });
-
-        cb.beginRenderingKHR({
-            {},
-            { {}, viewport->subextent },
-            static_cast<std::uint32_t>(renderer->cameras.size()),
-            math::bit::ones(renderer->cameras.size()),
-            vku::lvalue(vk::RenderingAttachmentInfo {
-                *viewport->selectedNodeJumpFloodSeedAttachmentGroup.seedImageView, vk::ImageLayout::eColorAttachmentOptimal,
-                {}, {}, {},
-                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, vk::ClearColorValue { 65535U, 65535U, 0U, 0U },
-            }),
-            &vku::lvalue(vk::RenderingAttachmentInfo {
-                *viewport->selectedNodeJumpFloodSeedAttachmentGroup.depthImageView, vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                {}, {}, {},
-                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
-            })
-        });
-        drawPrimitives(selectedNodes->jumpFloodSeedIndirectDrawCommandBuffers);
         cb.endRenderingKHR();
     }
 
-    // Mouse picking.
-    if (renderingNodes && gltfAsset->mousePickingInput) {
-        const auto &[viewIndex, rect] = *gltfAsset->mousePickingInput;
-        const bool singlePixel = rect.extent.width == 1 && rect.extent.height == 1;
-        if (singlePixel) {
-            if (sharedData.gpu.supportShaderBufferInt64Atomics) {
-                constexpr std::uint64_t initialValue = NO_INDEX;
-                gltfAsset->mousePickingResultBuffer.getAllocation().copyFromMemory(&initialValue, 0, sizeof(initialValue));
-            }
-            else {
-                constexpr std::uint32_t initialValue = NO_INDEX;
-                gltfAsset->mousePickingResultBuffer.getAllocation().copyFromMemory(&initialValue, 0, sizeof(initialValue));
-            }
-        }
-        else {
-            // Clear mousePickingResultBuffer as zeros.
-        #if __APPLE__
-            // Filling buffer with a value needs MTLBlitCommandEncoder in Metal, and it breaks the render pass.
-            // It is better to use host memset for this purpose.
-            std::memset(
-                gltfAsset->mousePickingResultBuffer.getAllocation().getInfo().pMappedData,
-                0, gltfAsset->mousePickingResultBuffer.size);
-        #else
-            cb.fillBuffer(gltfAsset->mousePickingResultBuffer, 0, gltfAsset->mousePickingResultBuffer.size, 0U);
-            cb.pipelineBarrier(
-                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
-                {}, vk::MemoryBarrier {
-                    vk::AccessFlagBits::eTransferWrite,
-                    vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
-                }, {}, {});
-        #endif
-        }
-
-        if (renderingNodes->startMousePickingRenderPass) {
-            std::optional<vk::RenderingAttachmentInfo> depthStencilAttachmentInfo;
-            if (sharedData.gpu.workaround.attachmentLessRenderPass) {
-                cb.pipelineBarrier(
-                    vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eEarlyFragmentTests,
-                    {}, {}, {},
-                    vk::ImageMemoryBarrier {
-                        {}, vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
-                        {}, vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                        vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                        viewport->mousePickingAttachmentGroup->depthImage, vku::fullSubresourceRange(vk::ImageAspectFlagBits::eDepth),
-                    });
-                depthStencilAttachmentInfo.emplace(vk::RenderingAttachmentInfo {
-                    *viewport->mousePickingAttachmentGroup->depthImageView, vk::ImageLayout::eDepthAttachmentOptimal,
-                    {}, {}, {},
-                    vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
-                });
-            }
-
-            cb.beginRenderingKHR(vk::RenderingInfo {
-                {},
-                rect,
-                1,
-                0,
-                vk::ArrayProxyNoTemporaries<const vk::RenderingAttachmentInfo>{},
-                value_address(depthStencilAttachmentInfo),
-            });
-
-            cb.setViewport(0, vku::toViewport({ {}, viewport->subextent }, true));
-            cb.setScissor(0, rect);
-
-            cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.mousePickingPipelineLayout,
-                0, { rendererSet, assetDescriptorSet, mousePickingSet }, {});
-            cb.pushConstants<pl::MousePicking::PushConstant>(*sharedData.mousePickingPipelineLayout, vk::ShaderStageFlagBits::eVertex,
-                0, pl::MousePicking::PushConstant { viewIndex });
-
-            struct ResourceBindingState {
-                vk::Pipeline pipeline;
-                std::optional<vk::PrimitiveTopology> primitiveTopology;
-                std::optional<vk::CullModeFlagBits> cullMode;
-                std::optional<vk::IndexType> indexType;
-            } resourceBindingState{};
-
-            const auto &map = singlePixel
-                ? renderingNodes->mousePickingIndirectDrawCommandBuffers
-                : renderingNodes->multiNodeMousePickingIndirectDrawCommandBuffers;
-            for (const auto &[criteria, indirectDrawCommandBuffer] : map) {
-                if (resourceBindingState.pipeline != criteria.pipeline) {
-                    cb.bindPipeline(vk::PipelineBindPoint::eGraphics, resourceBindingState.pipeline = criteria.pipeline);
-                }
+    // The collected node indices in mousePickingResultBuffer must be visible to the host.
+    accessTracker.access(gltfAsset->mousePickingResultBuffer, { vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead });
+    accessTracker.flush(cb);
+}
 
-                if (resourceBindingState.primitiveTopology != criteria.primitiveTopology) {
-                    cb.setPrimitiveTopologyEXT(resourceBindingState.primitiveTopology.emplace(criteria.primitiveTopology));
-                }
+void vk_gltf_viewer::vulkan::Frame::recordMeshletCullingCommands(vk::CommandBuffer cb) const {
+    // The culling outputs are per-frame resources, whose previous consumers are completed before the frame is reused.
+    AccessTracker accessTracker;
+    accessTracker.access({ vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite });
+    accessTracker.flush(cb);
+
+    const buffer::Meshlets &meshletBuffer = *gltfAsset->assetExtended->meshletBuffer;
+    sharedData.meshletCullingComputePipeline.compute(
+        cb,
+        sharedData.gpu.device.getBufferAddress({ static_cast<vk::Buffer>(*meshletCullingInputBuffer) }),
+        meshletBuffer.meshletBufferAddress,
+        meshletBuffer.indexBufferAddress,
+        sharedData.gpu.device.getBufferAddress({ static_cast<vk::Buffer>(*meshletCulledIndexBuffer) }),
+        meshletCullingDrawCount);
+
+    // Culled indices and draw commands' indexCount are consumed by the scene rendering, and the draw statistics are
+    // read by the host in getExecutionResult().
+    accessTracker.access({
+        vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eIndexInput,
+        vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eIndexRead,
+    });
+    accessTracker.access({ vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead });
+    accessTracker.flush(cb);
+}
 
-                if (singlePixel && resourceBindingState.cullMode != criteria.cullMode) {
-                    cb.setCullModeEXT(resourceBindingState.cullMode.emplace(criteria.cullMode));
-                }
+bool vk_gltf_viewer::vulkan::Frame::recordJumpFloodComputeCommands(vk::CommandBuffer cb) const {
+    const std::uint32_t viewCount = viewport->viewCount;
+    const vku::Image &image = viewport->outlineJumpFloodResources.image;
 
-                if (criteria.indexType && resourceBindingState.indexType != *criteria.indexType) {
-                    resourceBindingState.indexType.emplace(*criteria.indexType);
-                    cb.bindIndexBuffer(
-                        gltfAsset->assetExtended->combinedIndexBuffer,
-                        gltfAsset->assetExtended->combinedIndexBuffer.getIndexOffsetAndSize(*resourceBindingState.indexType).first,
-                        *resourceBindingState.indexType);
-                }
-                indirectDrawCommandBuffer.recordDrawCommand(cb, sharedData.gpu.supportDrawIndirectCount);
-            }
+    // Outline is drawn where the distance from the nearest seed is less than (thickness + 1), and the jump flood with
+    // the initial sample offset k can propagate seeds up to (2k - 1) texels. Starting from the smallest sufficient
+    // sample offset avoids flooding the seeds across the entire image.
+    const auto getInitialSampleOffset = [&](const Renderer::Outline &outline) {
+        const float thickness = outline.thickness * renderScale / static_cast<float>(1U << viewport->jumpFloodResolutionShift);
+        return std::bit_ceil(static_cast<std::uint32_t>(std::ceil((thickness + 2.f) / 2.f)));
+    };
 
-            cb.endRenderingKHR();
+    // Contents of the layers that are not seeded (including the pong layers) are discarded.
+    AccessTracker accessTracker;
+    accessTracker.track(image, vk::ImageAspectFlagBits::eColor, 1, image.arrayLayers, {
+        vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined,
+    });
 
-            // The collected node indices in mousePickingResultBuffer must be visible to the host.
-            cb.pipelineBarrier(
-                vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eHost,
-                {}, vk::MemoryBarrier {
-                    vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eHostRead,
-                }, {}, {});
+    std::uint32_t initialSampleOffset = 0;
+    for (auto [baseLayer, seeded, outline] : {
+        std::tuple { 0U, hoveringNode.has_value(), &renderer->hoveringNodeOutline },
+        std::tuple { viewCount, selectedNodes.has_value(), &renderer->selectedNodeOutline },
+    }) {
+        if (seeded) {
+            initialSampleOffset = std::max(initialSampleOffset, getInitialSampleOffset(**outline));
+
+            // Seeds are written by the scene prepass, whose submission is waited at the compute shader stage.
+            accessTracker.assume(image, 0, 1, baseLayer, viewCount, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eNone, vk::ImageLayout::eColorAttachmentOptimal,
+            });
+            accessTracker.access(image, 0, 1, baseLayer, viewCount, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead, vk::ImageLayout::eGeneral,
+            });
+        }
+        else {
+            // Not flooded, but the whole image has to be in the same layout for the outline composition.
+            accessTracker.access(image, 0, 1, baseLayer, viewCount, {
+                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eNone, vk::ImageLayout::eGeneral,
+            });
         }
     }
-}
-
-bool vk_gltf_viewer::vulkan::Frame::recordJumpFloodComputeCommands(
-    vk::CommandBuffer cb,
-    const vku::Image &image,
-    vku::DescriptorSet<JumpFloodComputePipeline::DescriptorSetLayout> descriptorSet,
-    std::uint32_t initialSampleOffset
-) const {
-    cb.pipelineBarrier2KHR({
-        {}, {}, {},
-        vku::lvalue({
-            vk::ImageMemoryBarrier2 {
-                // Dependency chain: this srcStageMask must match to the cb's submission waitDstStageMask.
-                vk::PipelineStageFlagBits2::eComputeShader, {},
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead,
-                vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::eGeneral,
-                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                image, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, static_cast<std::uint32_t>(renderer->cameras.size()) },
-            },
-            vk::ImageMemoryBarrier2 {
-                {}, {},
-                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
-                {}, vk::ImageLayout::eGeneral,
-                vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-                image, { vk::ImageAspectFlagBits::eColor, 0, 1, static_cast<std::uint32_t>(renderer->cameras.size()), vk::RemainingArrayLayers },
-            }
-        }),
+    accessTracker.access(image, 0, 1, 2 * viewCount, vk::RemainingArrayLayers, {
+        vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral,
     });
+    accessTracker.flush(cb);
+
+    // Hovering node and selected nodes are flooded at once if both exist, otherwise only the seeded layers are flooded.
+    const std::uint32_t baseLayer = hoveringNode ? 0U : viewCount;
+    const std::uint32_t layerCount = (hoveringNode && selectedNodes) ? 2 * viewCount : viewCount;
 
     // Compute jump flood and get the last execution direction.
-    return sharedData.jumpFloodComputePipeline.compute(cb, descriptorSet, initialSampleOffset, vku::toExtent2D(image.extent), renderer->cameras.size());
+    return sharedData.jumpFloodComputePipeline.compute(cb, jumpFloodSet, initialSampleOffset, vku::toExtent2D(image.extent), baseLayer, layerCount);
 }
 
-void vk_gltf_viewer::vulkan::Frame::recordSceneOpaqueMeshDrawCommands(vk::CommandBuffer cb) const {
-    assert(renderingNodes && "No nodes have to be rendered.");
+void vk_gltf_viewer::vulkan::Frame::recordSceneOpaqueMeshDrawCommands(
+    vk::CommandBuffer cb,
+    IndirectDrawCommandBufferIterator first,
+    IndirectDrawCommandBufferIterator last
+) const {
 
     struct {
         vk::Pipeline pipeline{};
@@ -1754,6 +2640,7 @@ void vk_gltf_viewer::vulkan::Frame::recordSceneOpaqueMeshDrawCommands(vk::Comman
         std::optional<std::uint32_t> stencilReference{};
         std::optional<vk::CullModeFlagBits> cullMode{};
         std::optional<vk::IndexType> indexType;
+        bool meshletCulling = false;
 
         // (Unlit)PrimitiveRenderPipeline variants have the same pipeline layout, therefore the descriptor sets should
         // be bound only once.
@@ -1761,13 +2648,19 @@ void vk_gltf_viewer::vulkan::Frame::recordSceneOpaqueMeshDrawCommands(vk::Comman
     } resourceBindingState{};
 
     // Render alphaMode=Opaque | Mask meshes.
-    for (const auto &[criteria, indirectDrawCommandBuffer] : ranges::make_subrange(renderingNodes->indirectDrawCommandBuffers.equal_range(0U))) {
+    for (const auto &[criteria, indirectDrawCommandBuffer] : std::ranges::subrange(first, last)) {
+        if (criteria.meshletCulling && meshletCullingDrawCount == 0) {
+            // Every draw command in the bucket is culled by the frustum culling, and there's no culled index buffer
+            // to be bound.
+            continue;
+        }
+
         if (resourceBindingState.pipeline != criteria.pipeline) {
             cb.bindPipeline(vk::PipelineBindPoint::eGraphics, resourceBindingState.pipeline = criteria.pipeline);
         }
         if (!resourceBindingState.descriptorBound) {
             cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.primitivePipelineLayout, 0,
-                { rendererSet, sharedData.imageBasedLightingDescriptorSet, assetDescriptorSet }, {});
+                { rendererSet, imageBasedLightingSet, assetDescriptorSet }, {});
             resourceBindingState.descriptorBound = true;
         }
 
@@ -1790,12 +2683,18 @@ void vk_gltf_viewer::vulkan::Frame::recordSceneOpaqueMeshDrawCommands(vk::Comman
             cb.setCullModeEXT(resourceBindingState.cullMode.emplace(criteria.cullMode));
         }
 
-        if (criteria.indexType && resourceBindingState.indexType != *criteria.indexType) {
+        if (criteria.indexType && (resourceBindingState.indexType != *criteria.indexType || resourceBindingState.meshletCulling != criteria.meshletCulling)) {
             resourceBindingState.indexType.emplace(*criteria.indexType);
-            cb.bindIndexBuffer(
-                gltfAsset->assetExtended->combinedIndexBuffer,
-                gltfAsset->assetExtended->combinedIndexBuffer.getIndexOffsetAndSize(*resourceBindingState.indexType).first,
-                *resourceBindingState.indexType);
+            resourceBindingState.meshletCulling = criteria.meshletCulling;
+            if (criteria.meshletCulling) {
+                cb.bindIndexBuffer(*meshletCulledIndexBuffer, 0, vk::IndexType::eUint32);
+            }
+            else {
+                cb.bindIndexBuffer(
+                    gltfAsset->assetExtended->combinedIndexBuffer,
+                    gltfAsset->assetExtended->combinedIndexBuffer.getIndexOffsetAndSize(*resourceBindingState.indexType).first,
+                    *resourceBindingState.indexType);
+            }
         }
 
         for (const auto &[viewIndex, subrect] : viewport->getSubrects() | ranges::views::enumerate) {
@@ -1811,14 +2710,18 @@ void vk_gltf_viewer::vulkan::Frame::recordSceneOpaqueMeshDrawCommands(vk::Comman
     }
 }
 
-bool vk_gltf_viewer::vulkan::Frame::recordSceneBlendMeshDrawCommands(vk::CommandBuffer cb) const {
-    assert(renderingNodes && "No nodes have to be rendered.");
+void vk_gltf_viewer::vulkan::Frame::recordSceneBlendMeshDrawCommands(
+    vk::CommandBuffer cb,
+    IndirectDrawCommandBufferIterator first,
+    IndirectDrawCommandBufferIterator last
+) const {
 
     struct {
         vk::Pipeline pipeline{};
         std::optional<vk::PrimitiveTopology> primitiveTopology{};
         std::optional<std::uint32_t> stencilReference{};
         std::optional<vk::IndexType> indexType;
+        bool meshletCulling = false;
 
         // (Unlit)PrimitiveRenderPipeline variants have the same pipeline layout, therefore the descriptor sets should
         // be bound only once.
@@ -1826,8 +2729,13 @@ bool vk_gltf_viewer::vulkan::Frame::recordSceneBlendMeshDrawCommands(vk::Command
     } resourceBindingState{};
 
     // Render alphaMode=Blend meshes.
-    bool hasBlendMesh = false;
-    for (const auto &[criteria, indirectDrawCommandBuffer] : ranges::make_subrange(renderingNodes->indirectDrawCommandBuffers.equal_range(1U))) {
+    for (const auto &[criteria, indirectDrawCommandBuffer] : std::ranges::subrange(first, last)) {
+        if (criteria.meshletCulling && meshletCullingDrawCount == 0) {
+            // Every draw command in the bucket is culled by the frustum culling, and there's no culled index buffer
+            // to be bound.
+            continue;
+        }
+
         if (resourceBindingState.pipeline != criteria.pipeline) {
             resourceBindingState.pipeline = criteria.pipeline;
             cb.bindPipeline(vk::PipelineBindPoint::eGraphics, resourceBindingState.pipeline);
@@ -1850,16 +2758,22 @@ bool vk_gltf_viewer::vulkan::Frame::recordSceneBlendMeshDrawCommands(vk::Command
 
         if (!resourceBindingState.descriptorBound) {
             cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.primitivePipelineLayout, 0,
-                { rendererSet, sharedData.imageBasedLightingDescriptorSet, assetDescriptorSet }, {});
+                { rendererSet, imageBasedLightingSet, assetDescriptorSet }, {});
             resourceBindingState.descriptorBound = true;
         }
 
-        if (criteria.indexType && resourceBindingState.indexType != *criteria.indexType) {
+        if (criteria.indexType && (resourceBindingState.indexType != *criteria.indexType || resourceBindingState.meshletCulling != criteria.meshletCulling)) {
             resourceBindingState.indexType.emplace(*criteria.indexType);
-            cb.bindIndexBuffer(
-                gltfAsset->assetExtended->combinedIndexBuffer,
-                gltfAsset->assetExtended->combinedIndexBuffer.getIndexOffsetAndSize(*resourceBindingState.indexType).first,
-                *resourceBindingState.indexType);
+            resourceBindingState.meshletCulling = criteria.meshletCulling;
+            if (criteria.meshletCulling) {
+                cb.bindIndexBuffer(*meshletCulledIndexBuffer, 0, vk::IndexType::eUint32);
+            }
+            else {
+                cb.bindIndexBuffer(
+                    gltfAsset->assetExtended->combinedIndexBuffer,
+                    gltfAsset->assetExtended->combinedIndexBuffer.getIndexOffsetAndSize(*resourceBindingState.indexType).first,
+                    *resourceBindingState.indexType);
+            }
         }
 
         for (const auto &[viewIndex, subrect] : viewport->getSubrects() | ranges::views::enumerate) {
@@ -1872,52 +2786,53 @@ bool vk_gltf_viewer::vulkan::Frame::recordSceneBlendMeshDrawCommands(vk::Command
 
             indirectDrawCommandBuffer.recordDrawCommand(cb, sharedData.gpu.supportDrawIndirectCount);
         }
-
-        hasBlendMesh = true;
     }
-
-    return hasBlendMesh;
 }
 
-void vk_gltf_viewer::vulkan::Frame::recordNodeOutlineCompositionCommands(
-    vk::CommandBuffer cb,
-    std::optional<bool> hoveringNodeJumpFloodForward,
-    std::optional<bool> selectedNodeJumpFloodForward
-) const {
-    boost::container::static_vector<vk::ImageMemoryBarrier, 2> memoryBarriers;
-    // Change jump flood image layouts to ShaderReadOnlyOptimal.
-    if (hoveringNodeJumpFloodForward) {
-        memoryBarriers.push_back({
-            {}, vk::AccessFlagBits::eShaderRead,
-            vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
-            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-            viewport->hoveringNodeOutlineJumpFloodResources.image,
-            { vk::ImageAspectFlagBits::eColor, 0, 1, static_cast<std::uint32_t>(*hoveringNodeJumpFloodForward ? renderer->cameras.size() : 0U), static_cast<std::uint32_t>(renderer->cameras.size()) },
-        });
-    }
-    if (selectedNodeJumpFloodForward) {
-        memoryBarriers.push_back({
-            {}, vk::AccessFlagBits::eShaderRead,
-            vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
-            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
-            viewport->selectedNodeOutlineJumpFloodResources.image,
-            { vk::ImageAspectFlagBits::eColor, 0, 1, static_cast<std::uint32_t>(*selectedNodeJumpFloodForward ? renderer->cameras.size() : 0U), static_cast<std::uint32_t>(renderer->cameras.size()) },
-        });
+void vk_gltf_viewer::vulkan::Frame::recordSceneBackgroundCommands(vk::CommandBuffer cb) const {
+    // Both SkyboxRenderPipeline and GridRenderPipeline uses dynamic viewport/scissor with count states.
+    const auto scissors = viewport->getSubrects();
+    const auto viewports = scissors
+        | std::views::transform([](const vk::Rect2D &rect) {
+            return vku::toViewport(rect, true);
+        })
+        | std::ranges::to<boost::container::static_vector<vk::Viewport, 4>>();
+    cb.setViewportWithCountEXT(viewports);
+    cb.setScissorWithCountEXT(scissors);
+
+    // Draw skybox.
+    if (!renderer->solidBackground) {
+        cb.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.getSkyboxRenderPipeline());
+        cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.skyboxPipelineLayout, 0, { rendererSet, skyboxSet }, {});
+        cb.draw(36, viewport->viewCount, 0, 0);
     }
-    if (!memoryBarriers.empty()) {
-        cb.pipelineBarrier(
-            vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eFragmentShader,
-            {}, {}, {}, memoryBarriers);
+
+    // Draw grid.
+    if (renderer->grid) {
+        cb.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.getGridRenderPipeline().pipeline);
+        cb.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics, *sharedData.getGridRenderPipeline().pipelineLayout,
+            0, rendererSet, {});
+        cb.pushConstants<GridRenderPipeline::PushConstant>(
+            *sharedData.getGridRenderPipeline().pipelineLayout, GridRenderPipeline::PushConstant::range.stageFlags,
+            0, GridRenderPipeline::PushConstant {
+                .color = renderer->grid->color,
+                .showMinorAxes = renderer->grid->showMinorAxes,
+                .size = renderer->grid->size,
+            });
+        cb.draw(6, viewport->viewCount, 0, 0);
     }
+}
 
+void vk_gltf_viewer::vulkan::Frame::recordNodeOutlineCompositionCommands(vk::CommandBuffer cb, bool jumpFloodForward) const {
     // Set viewport and scissor.
-    const vk::Rect2D rect { { 0, 0 }, viewport->extent };
+    const vk::Rect2D rect = viewport->getRenderArea();
     cb.setViewport(0, vku::toViewport(rect));
     cb.setScissor(0, rect);
 
     cb.beginRenderingKHR(vk::RenderingInfo {
         {},
-        { { 0, 0 }, viewport->extent },
+        rect,
         1,
         {},
         vku::lvalue(vk::RenderingAttachmentInfo {
@@ -1929,15 +2844,20 @@ void vk_gltf_viewer::vulkan::Frame::recordNodeOutlineCompositionCommands(
     });
 
     // Draw hovering/selected node outline if exists.
+    cb.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.outlineRenderPipeline);
+    cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.outlinePipelineLayout, 0, outlineSet, {});
+
+    // Flooded result is in the pong layers if the last jump flood direction is forward.
+    const std::uint32_t resultLayerOffset = jumpFloodForward ? 2 * viewport->viewCount : 0U;
     if (selectedNodes) {
-        cb.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.outlineRenderPipeline);
-        cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.outlinePipelineLayout, 0,
-            selectedNodeOutlineSet, {});
         cb.pushConstants<pl::Outline::PushConstant>(
             *sharedData.outlinePipelineLayout, vk::ShaderStageFlagBits::eFragment,
             0, pl::Outline::PushConstant {
                 .outlineColor = renderer->selectedNodeOutline->color,
-                .outlineThickness = renderer->selectedNodeOutline->thickness,
+                .outlineThickness = renderer->selectedNodeOutline->thickness * renderScale,
+                .layerOffset = resultLayerOffset + viewport->viewCount,
+                .viewExtent = { viewport->subextent.width, viewport->subextent.height },
+                .resolutionShift = viewport->jumpFloodResolutionShift,
             });
         cb.draw(3, 1, 0, 0);
     }
@@ -1945,17 +2865,15 @@ void vk_gltf_viewer::vulkan::Frame::recordNodeOutlineCompositionCommands(
         if (selectedNodes) {
             // TODO: pipeline barrier required.
         }
-        else {
-            cb.bindPipeline(vk::PipelineBindPoint::eGraphics, *sharedData.outlineRenderPipeline);
-        }
 
-        cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *sharedData.outlinePipelineLayout, 0,
-            hoveringNodeOutlineSet, {});
         cb.pushConstants<pl::Outline::PushConstant>(
             *sharedData.outlinePipelineLayout, vk::ShaderStageFlagBits::eFragment,
             0, pl::Outline::PushConstant {
                 .outlineColor = renderer->hoveringNodeOutline->color,
-                .outlineThickness = renderer->hoveringNodeOutline->thickness,
+                .outlineThickness = renderer->hoveringNodeOutline->thickness * renderScale,
+                .layerOffset = resultLayerOffset,
+                .viewExtent = { viewport->subextent.width, viewport->subextent.height },
+                .resolutionShift = viewport->jumpFloodResolutionShift,
             });
         cb.draw(3, 1, 0, 0);
     }
@@ -114,6 +114,9 @@ vk_gltf_viewer::vulkan::Gpu::Gpu(const vk::raii::Instance &instance, vk::Surface
     subgroupSize = subgroupProps.subgroupSize;
     maxPerStageDescriptorUpdateAfterBindSamplers = descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSamplers;
     maxPerStageDescriptorUpdateAfterBindSampledImages = descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages;
+    timestampPeriod = props2.properties.limits.timestampPeriod;
+    supportComputeQueueTimestamp = physicalDevice.getQueueFamilyProperties()[queueFamilies.compute].timestampValidBits != 0;
+    supportGraphicsQueueTimestamp = physicalDevice.getQueueFamilyProperties()[queueFamilies.graphicsPresent].timestampValidBits != 0;
 
 	// Retrieve physical device memory properties.
 	const vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
@@ -267,6 +270,12 @@ vk::raii::Device vk_gltf_viewer::vulkan::Gpu::createDevice() {
     const vk::PhysicalDeviceIndexTypeUint8FeaturesKHR &indexTypeUint8Features = features2.get<vk::PhysicalDeviceIndexTypeUint8FeaturesKHR>();
 
     supportShaderBufferInt64Atomics = vulkan12Features.shaderBufferInt64Atomics;
+    supportVulkanMemoryModel = vulkan12Features.vulkanMemoryModel;
+    // Pipeline statistics query is begun in the primary command buffer and inherited by the secondary command buffers
+    // that record the scene subpasses.
+    supportPipelineStatisticsQuery
+        = features2.get<vk::PhysicalDeviceFeatures2>().features.pipelineStatisticsQuery
+        && features2.get<vk::PhysicalDeviceFeatures2>().features.inheritedQueries;
     supportDrawIndirectCount = vulkan12Features.drawIndirectCount;
 #if __APPLE__
     // MoltenVK supports VK_KHR_index_type_uint8 from v1.3.0 by dynamically generating 16-bit indices from 8-bit indices
@@ -315,7 +324,9 @@ vk::raii::Device vk_gltf_viewer::vulkan::Gpu::createDevice() {
         },
         vk::PhysicalDeviceFeatures2 {
             vk::PhysicalDeviceFeatures { requiredFeatures }
-                .setShaderInt64(supportShaderBufferInt64Atomics),
+                .setShaderInt64(supportShaderBufferInt64Atomics)
+                .setPipelineStatisticsQuery(supportPipelineStatisticsQuery)
+                .setInheritedQueries(supportPipelineStatisticsQuery),
         },
         vk::PhysicalDeviceVulkan11Features{}
             .setShaderDrawParameters(true)
@@ -335,6 +346,7 @@ vk::raii::Device vk_gltf_viewer::vulkan::Gpu::createDevice() {
             .setScalarBlockLayout(true)
             .setTimelineSemaphore(true)
             .setShaderInt8(true)
+            .setVulkanMemoryModel(supportVulkanMemoryModel)
             .setDrawIndirectCount(supportDrawIndirectCount)
             .setShaderBufferInt64Atomics(supportShaderBufferInt64Atomics),
         vk::PhysicalDeviceDynamicRenderingFeatures { true },
@@ -20,12 +20,241 @@ namespace vk_gltf_viewer {
             } diffuseIrradiance;
 
             struct Prefilteredmap {
+                /**
+                 * @brief Quality/speed preset of the prefilteredmap generation.
+                 */
+                enum class Quality : std::uint8_t {
+                    Fast,      /// Adaptive sample count, up to 256 samples.
+                    Balanced,  /// Adaptive sample count, up to 1024 samples.
+                    Reference, /// 1024 samples for every roughness level.
+                };
+
                 std::uint32_t size;
                 std::uint32_t roughnessLevels;
+                Quality quality;
+
+                /**
+                 * @brief Sample count of the roughest level.
+                 */
                 std::uint32_t sampleCount;
+
+                /**
+                 * @brief Progress of the full quality prefilteredmap generation in [0, 1], or <tt>std::nullopt</tt>
+                 * if the current prefilteredmap is already in full quality.
+                 */
+                std::optional<float> refinementProgress;
             } prefilteredmap;
         };
 
+        struct FramePacing {
+            static constexpr std::uint32_t maxFramesInFlight = 4;
+
+            /**
+             * @brief Number of frames that CPU can record ahead of GPU execution.
+             */
+            std::uint32_t framesInFlight = 2;
+
+            /**
+             * @brief Sample animations of the next frame in a worker thread while the current frame is being recorded
+             * and submitted.
+             */
+            bool overlapAnimationSampling = true;
+
+            // Below statistics are exponential moving averages, updated every frame.
+
+            /**
+             * @brief CPU time spent in a frame, excluding waiting for the frame fence.
+             */
+            std::chrono::duration<float, std::milli> cpuTime{};
+
+            /**
+             * @brief Time between the consecutive frame starts. Its reciprocal is the throughput (frames per second).
+             */
+            std::chrono::duration<float, std::milli> frameInterval{};
+
+            /**
+             * @brief Time from the input sampling of a frame to the CPU observing its GPU execution completion.
+             */
+            std::chrono::duration<float, std::milli> latency{};
+        };
+
+        struct DynamicResolution {
+            enum class Mode : std::uint8_t {
+                Disabled, /// Render the scene at the viewport resolution.
+                Dynamic,  /// Adjust the render scale to make the scene rendering GPU time meet the target.
+                Fixed,    /// Render the scene at the fixed render scale, e.g. for deterministic captures.
+            };
+
+            Mode mode = Mode::Disabled;
+
+            /**
+             * @brief Target GPU time of the scene rendering, used by <tt>Mode::Dynamic</tt>.
+             */
+            std::chrono::duration<float, std::milli> targetGpuTime { 1e3f / 60.f };
+
+            /**
+             * @brief Lower bound of the render scale, used by <tt>Mode::Dynamic</tt>.
+             */
+            float minScale = 0.5f;
+
+            /**
+             * @brief Render scale used by <tt>Mode::Fixed</tt>.
+             */
+            float fixedScale = 1.f;
+
+            /**
+             * @brief Current render scale of the viewport width and height. Scene is rendered in the scaled extent and
+             * upscaled to the viewport.
+             */
+            float scale = 1.f;
+
+            /**
+             * @brief Exponential moving average of the scene rendering GPU time at the current render scale.
+             */
+            std::chrono::duration<float, std::milli> gpuTime{};
+        };
+
+        struct MeshOptimization {
+            /**
+             * @brief Reorder the primitives' indices and vertices for the vertex cache, overdraw and vertex fetch
+             * efficiency when a glTF asset is loaded. Change is applied from the next loaded asset.
+             */
+            bool enabled = false;
+
+            /**
+             * @brief Generate the level of detail chains of the primitives when a glTF asset is loaded, which are
+             * selected by <tt>Renderer::levelOfDetail</tt>. Change is applied from the next loaded asset.
+             */
+            bool generateLevelOfDetails = false;
+
+            /**
+             * @brief Partition the static primitives into the meshlets when a glTF asset is loaded, which are culled by
+             * <tt>Renderer::meshletCulling</tt>. Change is applied from the next loaded asset.
+             */
+            bool buildMeshlets = false;
+
+            /**
+             * @brief Quantize the <tt>FLOAT</tt> vertex attributes into the 16-bit streams (bounding box relative
+             * positions, octahedral normals and tangents, normalized texture coordinates) when a glTF asset is loaded.
+             * Change is applied from the next loaded asset.
+             */
+            bool quantizeVertexAttributes = false;
+
+            /**
+             * @brief Generate the missing tangents by the non-welded per-vertex accumulation instead of MikkTSpace
+             * algorithm when a glTF asset is loaded, which is much faster but not MikkTSpace compliant. Change is
+             * applied from the next loaded asset.
+             */
+            bool fastTangentGeneration = false;
+        };
+
+        struct Profiler {
+            /**
+             * @brief Execution range of a CPU zone or GPU pass, relative to the begin of its frame.
+             */
+            struct Range {
+                std::string_view name;
+
+                // Below are exponential moving averages, reset when the ranges of a frame are changed.
+                std::chrono::duration<float, std::milli> begin;
+                std::chrono::duration<float, std::milli> end;
+            };
+
+            struct PipelineStatistics {
+                std::uint64_t vertexShaderInvocations;
+                std::uint64_t clippingPrimitives;
+                std::uint64_t fragmentShaderInvocations;
+            };
+
+            /**
+             * @brief Draw statistics of a multi-draw-indirect call of the scene rendering.
+             */
+            struct DrawBucket {
+                std::string label;
+                std::uint32_t drawCount;
+                std::uint64_t primitiveCount;
+            };
+
+            /**
+             * @brief Number of the created scene rendering pipelines for the current sample count.
+             */
+            struct PipelineCounts {
+                std::size_t primitive;
+                std::size_t primitiveWithMaterialExtension;
+                std::size_t unlitPrimitive;
+            };
+
+            /**
+             * @brief If the number of the scene rendering pipelines exceeds it, the permutation is likely to be exploded.
+             */
+            static constexpr std::size_t pipelineCountWarningThreshold = 64;
+
+            /**
+             * @brief Aggregated statistics of the instrumented CPU zones that have the same name in a frame.
+             */
+            struct ZoneStatistics {
+                std::string_view name;
+                std::uint32_t callCount;
+                std::chrono::duration<float, std::milli> totalTime;
+                std::uint64_t allocationCount;
+            };
+
+            /**
+             * @brief An event of the Chrome trace (complete event, <tt>"ph": "X"</tt>).
+             *
+             * GPU pass events are placed from the CPU time of the frame submission, as the GPU timestamps are not
+             * calibrated with the CPU clock. Therefore, they show the relative ranges of the passes, not the absolute
+             * time.
+             */
+            struct TraceEvent {
+                /**
+                 * @brief Track of the event. <tt>Gpu</tt> is the GPU pass, and <tt>Zone</tt> is the instrumented CPU
+                 * zone of the thread <tt>threadIndex</tt>.
+                 */
+                enum class Track : std::uint8_t { Gpu, Zone };
+
+                std::string_view name;
+                Track track;
+                std::chrono::steady_clock::time_point begin;
+                std::chrono::steady_clock::duration duration;
+                std::uint32_t threadIndex = 0;
+            };
+
+            static constexpr std::size_t maxTraceEventCount = 8192;
+
+            bool supportPipelineStatistics = false;
+
+            /**
+             * @brief Query the pipeline statistics of the scene rendering, which may have a small GPU overhead.
+             */
+            bool recordPipelineStatistics = false;
+
+            std::vector<Range> gpuPasses;
+            std::optional<PipelineStatistics> pipelineStatistics;
+            std::vector<DrawBucket> drawBuckets;
+            PipelineCounts pipelineCounts{};
+
+            /**
+             * @brief Statistics of the CPU zones finished in the last frame, sorted by the total time in descending
+             * order. Always empty if the CPU profiler is not enabled by <tt>VK_GLTF_VIEWER_CPU_PROFILER</tt>.
+             */
+            std::vector<ZoneStatistics> zoneStatistics;
+
+            /**
+             * @brief Number of the heap allocations made by all threads in the last frame.
+             */
+            std::uint64_t frameAllocationCount = 0;
+
+            /**
+             * @brief Recent trace events, up to <tt>maxTraceEventCount</tt>.
+             */
+            std::deque<TraceEvent> traceEvents;
+        };
+
         std::optional<ImageBasedLighting> imageBasedLightingProperties;
+        FramePacing framePacing;
+        DynamicResolution dynamicResolution;
+        MeshOptimization meshOptimization;
+        Profiler profiler;
     };
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 export module vk_gltf_viewer.MainApp;
 
 import std;
+import BS.thread_pool;
+import ibl;
 
 import vk_gltf_viewer.AppState;
 import vk_gltf_viewer.gltf.AssetExtended;
@@ -8,6 +10,7 @@ import vk_gltf_viewer.control.AppWindow;
 import vk_gltf_viewer.imgui;
 import vk_gltf_viewer.Renderer;
 import vk_gltf_viewer.vulkan.Frame;
+import vk_gltf_viewer.vulkan.FrameDeferredTask;
 
 namespace vk_gltf_viewer {
     export class MainApp {
@@ -17,7 +20,22 @@ namespace vk_gltf_viewer {
         void run();
 
     private:
-        static constexpr std::uint32_t FRAMES_IN_FLIGHT = 2;
+        static constexpr std::uint32_t PREVIEW_PREFILTEREDMAP_SAMPLE_COUNT = 64;
+
+        /**
+         * @brief Number of rows in a band, which is the unit of the parallel HDR eqmap decoding.
+         */
+        static constexpr std::uint32_t EQMAP_DECODE_BAND_ROW_COUNT = 64;
+
+        /**
+         * @brief If RGBA16F staging buffer for the HDR eqmap exceeds this size, B10G11R11 is used instead.
+         */
+        static constexpr vk::DeviceSize MAX_EQMAP_STAGING_BUFFER_SIZE_RGBA16F = 512ULL << 20;
+
+        /**
+         * @brief Expected GPU execution time of a prefilteredmap refinement batch submitted in a frame.
+         */
+        static constexpr std::chrono::microseconds PREFILTEREDMAP_REFINEMENT_BUDGET { 2000 };
 
         struct ImGuiContext {
             imgui::UserData userData;
@@ -44,6 +62,87 @@ namespace vk_gltf_viewer {
             vk::raii::ImageView prefilteredmapImageView;
         };
 
+        /**
+         * @brief In-progress image based lighting resources generation from an equirectangular map.
+         *
+         * The generation does not block the frame loop. The GPU work is submitted in the following order, and its
+         * progress is tracked by the queue timeline values:
+         * 1. Initial pass: eqmap upload, cubemap generation, spherical harmonics reduction, skybox tonemapping and
+         *    (if progressive generation is enabled) the low sample count preview prefilteredmap. When the graphics
+         *    queue timeline reaches \p initialPassFinishValue, the results can be used.
+         * 2. Refinement: full sample count prefilteredmap generation, split into multiple batches, each of which is
+         *    submitted to the compute queue at most once per frame and has an estimated execution time within the
+         *    budget. The compute queue timeline value of the last batch is \p lastRefinementFinishValue.
+         *
+         * The current resources in <tt>skyboxResources</tt> and <tt>imageBasedLightingResources</tt> are retained until
+         * the new resources are ready.
+         */
+        struct ImageBasedLightingGeneration {
+            struct InitialPassResult {
+                vku::raii::AllocatedImage reducedEqmapImage;
+                vku::raii::AllocatedImage tonemappedCubemapImage;
+                vku::raii::AllocatedBuffer sphericalHarmonicsBuffer;
+
+                /**
+                 * @brief Low sample count prefilteredmap, or <tt>std::nullopt</tt> if progressive generation is
+                 * disabled.
+                 */
+                std::optional<vku::raii::AllocatedImage> previewPrefilteredmapImage;
+            };
+
+            AppState::ImageBasedLighting properties;
+
+            /**
+             * @brief Graphics queue timeline value which is reached when the initial pass is finished.
+             */
+            std::uint64_t initialPassFinishValue;
+
+            /**
+             * @brief Type erased resources that are used by the initial pass and have to be alive until its completion.
+             */
+            std::shared_ptr<void> initialPassResources;
+
+            /**
+             * @brief Results of the initial pass, or <tt>std::nullopt</tt> if they are already moved into the
+             * application resources.
+             */
+            std::optional<InitialPassResult> initialPassResult;
+
+            vku::raii::AllocatedImage cubemapImage;
+            vku::raii::AllocatedImage prefilteredmapImage;
+
+            // Below fields are initialized after the struct is emplaced, as they refer to the above fields.
+
+            std::optional<ibl::PrefilteredmapComputePipeline> prefilteredmapComputePipeline{};
+
+            /**
+             * @brief Regions of \p prefilteredmapImage to be processed by refinement, in the submission order.
+             */
+            std::vector<ibl::PrefilteredmapComputePipeline::DispatchRegion> prefilteredmapRegions{};
+
+            std::optional<vk::raii::CommandPool> computeCommandPool{};
+            vk::CommandBuffer computeCommandBuffer{};
+            std::optional<vk::raii::QueryPool> timestampQueryPool{};
+
+            /**
+             * @brief Compute queue timeline value of the last submitted refinement batch, or <tt>0</tt> if no batch is
+             * submitted.
+             */
+            std::uint64_t lastRefinementFinishValue = 0;
+            std::size_t nextRegionIndex = 0;
+
+            /**
+             * @brief Estimated number of samples that GPU can process in a nanosecond, updated after each refinement
+             * batch is finished if timestamp query is available.
+             */
+            double samplesPerNanosecond = 1.0;
+
+            /**
+             * @brief Number of samples processed in the last submitted refinement batch.
+             */
+            std::uint64_t lastBatchSampleCount = 0;
+        };
+
         AppState appState;
 
         vk::raii::Context context;
@@ -59,6 +158,13 @@ namespace vk_gltf_viewer {
 
         ImGuiContext imGuiContext { window, *instance, gpu };
 
+        // Retired resources may refer the ImGui context, therefore they must be destroyed before it.
+        vulkan::QueueTimelines timelines { gpu };
+
+        // Worker threads for the CPU-side parallel jobs issued from the main thread, e.g. glTF asset processing and HDR
+        // eqmap decoding. It must outlive the assets.
+        BS::thread_pool<> threadPool;
+
         std::shared_ptr<gltf::AssetExtended> assetExtended;
 
         // --------------------
@@ -66,7 +172,9 @@ namespace vk_gltf_viewer {
         // --------------------
 
         ImageBasedLightingResources imageBasedLightingResources = createDefaultImageBasedLightingResources();
-        std::optional<SkyboxResources> skyboxResources{};
+        // They are heap allocated to be retired to the queue timelines, as they are not movable.
+        std::unique_ptr<SkyboxResources> skyboxResources;
+        std::unique_ptr<ImageBasedLightingGeneration> imageBasedLightingGeneration;
         vku::raii::AllocatedImage brdfmapImage = createBrdfmapImage();
         vk::raii::ImageView brdfmapImageView { gpu.device, brdfmapImage.getViewCreateInfo(vk::ImageViewType::e2D) };
         vk::raii::Sampler reducedEqmapSampler = createEqmapSampler();
@@ -76,16 +184,27 @@ namespace vk_gltf_viewer {
         // --------------------
 
         vulkan::SharedData sharedData;
-        std::array<vulkan::Frame, FRAMES_IN_FLIGHT> frames;
-        
+        std::vector<vulkan::Frame> frames = createFrames(appState.framePacing.framesInFlight);
+
         [[nodiscard]] vk::raii::Instance createInstance() const;
 
         [[nodiscard]] ImageBasedLightingResources createDefaultImageBasedLightingResources() const;
         [[nodiscard]] vk::raii::Sampler createEqmapSampler() const;
         [[nodiscard]] vku::raii::AllocatedImage createBrdfmapImage() const;
+        [[nodiscard]] std::vector<vulkan::Frame> createFrames(std::uint32_t count);
 
         void loadGltf(const std::filesystem::path &path);
         void closeGltf();
-        void loadEqmap(const std::filesystem::path &eqmapPath);
+        void loadEqmap(const std::filesystem::path &eqmapPath, AppState::ImageBasedLighting::Prefilteredmap::Quality prefilteredmapQuality);
+
+        /**
+         * @brief Advance the in-progress image based lighting generation without blocking, and replace the current
+         * resources with the generated ones when they are ready.
+         *
+         * This must be called once per frame, before any ImGui function call as it may replace the ImGui texture of
+         * the equirectangular map, and before the current frame's deferred task is executed, as the replaced resources
+         * are bound to the frames by \p frameDeferredTasks.
+         */
+        void updateImageBasedLightingGeneration(std::span<vulkan::FrameDeferredTask> frameDeferredTasks);
     };
 }
\ No newline at end of file
@@ -57,6 +57,10 @@ namespace vk_gltf_viewer::control {
         void nodeInspector(gltf::AssetExtended &assetExtended);
         void imageBasedLighting(const AppState::ImageBasedLighting &info, ImTextureRef eqmapTextureImGuiDescriptorSet);
         void rendererSetting(Renderer &renderer);
+        void framePacing(AppState::FramePacing &framePacing);
+        void dynamicResolution(AppState::DynamicResolution &dynamicResolution);
+        void meshOptimization(AppState::MeshOptimization &meshOptimization, const gltf::AssetExtended *assetExtended);
+        void profiler(AppState::Profiler &profiler, nfdwindowhandle_t windowHandle);
         void imguizmo(Renderer &renderer, std::size_t viewIndex);
         void imguizmo(Renderer &renderer, std::size_t viewIndex, gltf::AssetExtended &assetExtended);
 
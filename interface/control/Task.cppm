@@ -2,6 +2,7 @@ export module vk_gltf_viewer.control.Task;
 
 import std;
 export import fastgltf;
+export import vk_gltf_viewer.AppState;
 export import glm;
 export import imgui.internal;
 
@@ -20,9 +21,11 @@ namespace vk_gltf_viewer::control {
         struct ChangePassthruRect { ImRect newRect; };
         struct ChangeSampleCount { std::uint8_t sampleCount; };
         struct ChangeViewCount { std::size_t viewCount; };
+        struct ChangeFramesInFlight { std::uint32_t framesInFlight; };
         struct LoadGltf { std::filesystem::path path; };
         struct CloseGltf { };
         struct LoadEqmap { std::filesystem::path path; };
+        struct ChangePrefilteredmapQuality { AppState::ImageBasedLighting::Prefilteredmap::Quality quality; };
         struct ChangeScene { std::size_t newSceneIndex; };
         struct NodeVisibilityChanged { std::size_t nodeIndex; };
         struct NodeSelectionChanged { };
@@ -64,6 +67,8 @@ namespace vk_gltf_viewer::control {
         struct PrimitiveMaterialChanged { const fastgltf::Primitive *primitive; };
         struct MorphTargetWeightChanged { std::size_t nodeIndex; std::size_t targetWeightStartIndex; std::size_t targetWeightCount; };
         struct BloomModeChanged{};
+        struct OutlineResolutionChanged{};
+        struct ExportChromeTrace { std::filesystem::path path; };
     }
 
     export using Task = std::variant<
@@ -79,9 +84,11 @@ namespace vk_gltf_viewer::control {
         task::ChangePassthruRect,
         task::ChangeSampleCount,
         task::ChangeViewCount,
+        task::ChangeFramesInFlight,
         task::LoadGltf,
         task::CloseGltf,
         task::LoadEqmap,
+        task::ChangePrefilteredmapQuality,
         task::ChangeScene,
         task::NodeVisibilityChanged,
         task::NodeSelectionChanged,
@@ -92,5 +99,7 @@ namespace vk_gltf_viewer::control {
         task::MaterialPropertyChanged,
         task::PrimitiveMaterialChanged,
         task::MorphTargetWeightChanged,
-        task::BloomModeChanged>;
+        task::BloomModeChanged,
+        task::OutlineResolutionChanged,
+        task::ExportChromeTrace>;
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+export module vk_gltf_viewer.cpu_profiler;
+
+import std;
+
+/**
+ * @brief Lightweight CPU zone profiler.
+ *
+ * A zone is a scoped region of code, whose execution range is recorded by constructing a <tt>Zone</tt> object at the
+ * beginning of the scope. Recorded zones are gathered by calling <tt>collect()</tt> once per frame.
+ *
+ * The profiler is enabled only if <tt>ENABLE_CPU_PROFILER</tt> is defined (configured by CMake option
+ * <tt>VK_GLTF_VIEWER_CPU_PROFILER</tt>). Otherwise, <tt>Zone</tt> is an empty type whose constructor does nothing,
+ * and it is completely optimized out.
+ */
+namespace vk_gltf_viewer::cpu_profiler {
+    export constexpr bool enabled =
+#ifdef ENABLE_CPU_PROFILER
+        true;
+#else
+        false;
+#endif
+
+    export struct ZoneEvent {
+        /// Name of the zone. It must have static storage duration.
+        std::string_view name;
+
+        /// Index of the thread that recorded the zone, assigned by the order of the first zone of each thread.
+        std::uint32_t threadIndex;
+
+        std::chrono::steady_clock::time_point begin;
+        std::chrono::steady_clock::duration duration;
+
+        /// Number of the heap allocations made by the thread during the zone, including its nested zones.
+        std::uint64_t allocationCount;
+    };
+
+    /**
+     * @brief Record the execution range of the enclosing scope as a zone.
+     * @code{.cpp}
+     * void Frame::update(const ExecutionTask &task) {
+     *     const cpu_profiler::Zone zone { "Frame::update" };
+     *     ...
+     * }
+     * @endcode
+     */
+    export class Zone {
+    public:
+#ifdef ENABLE_CPU_PROFILER
+        explicit Zone(std::string_view name) noexcept;
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone &operator=(const Zone&) = delete;
+
+    private:
+        std::string_view name;
+        std::chrono::steady_clock::time_point begin;
+        std::uint64_t beginAllocationCount;
+#else
+        explicit constexpr Zone(std::string_view) noexcept { }
+#endif
+    };
+
+    /**
+     * @brief Invoke \p f inside a zone named \p name, and return its result.
+     *
+     * It is useful for measuring the member initializers, e.g. <tt>asset { zoned("Parse glTF", [&] { return ...; }) }</tt>.
+     */
+    export template <std::invocable F>
+    decltype(auto) zoned(std::string_view name, F &&f) {
+        const Zone zone { name };
+        return std::invoke(std::forward<F>(f));
+    }
+
+    /**
+     * @brief Take the zones that are finished since the last call.
+     * @return Zone events of all threads, sorted by the begin time point. Always empty if the profiler is disabled.
+     */
+    export [[nodiscard]] std::vector<ZoneEvent> collect();
+
+    /**
+     * @brief Count a heap allocation. Called by the replaced global <tt>operator new</tt>.
+     *
+     * Allocations made by the profiler itself are not counted.
+     */
+    export void countAllocation() noexcept;
+
+    /**
+     * @brief Get the number of the heap allocations made by all threads since the program started.
+     * @return Allocation count. Always 0 if the profiler is disabled.
+     */
+    export [[nodiscard]] std::uint64_t getAllocationCount() noexcept;
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+#ifdef ENABLE_CPU_PROFILER
+namespace vk_gltf_viewer::cpu_profiler {
+    std::atomic<std::uint64_t> totalAllocationCount;
+    thread_local std::uint64_t threadAllocationCount;
+
+    // If true, the thread is inside the profiler and its allocations are not counted.
+    thread_local bool insideProfiler;
+
+    /**
+     * @brief Exclude the allocations made by the profiler itself (e.g. event recording) from the counts during the
+     * scope.
+     */
+    class ProfilerScope {
+    public:
+        ProfilerScope() noexcept : wasInsideProfiler { std::exchange(insideProfiler, true) } { }
+        ~ProfilerScope() { insideProfiler = wasInsideProfiler; }
+
+        ProfilerScope(const ProfilerScope&) = delete;
+        ProfilerScope &operator=(const ProfilerScope&) = delete;
+
+    private:
+        bool wasInsideProfiler;
+    };
+
+    /**
+     * @brief Zone events of a thread.
+     *
+     * Events are appended by the owner thread and taken by <tt>collect()</tt>, therefore the mutex is almost always
+     * uncontended.
+     */
+    struct ThreadEvents {
+        std::uint32_t threadIndex;
+        std::mutex mutex;
+        std::vector<ZoneEvent> events;
+    };
+
+    std::mutex registryMutex;
+
+    // ThreadEvents must not be destroyed when its thread exits, as collect() may access it later.
+    std::list<ThreadEvents> registry;
+
+    [[nodiscard]] ThreadEvents &getThreadEvents() {
+        thread_local ThreadEvents &threadEvents = [] -> ThreadEvents& {
+            std::scoped_lock lock { registryMutex };
+            ThreadEvents &result = registry.emplace_back();
+            result.threadIndex = static_cast<std::uint32_t>(registry.size() - 1);
+            return result;
+        }();
+        return threadEvents;
+    }
+}
+
+vk_gltf_viewer::cpu_profiler::Zone::Zone(std::string_view name) noexcept
+    : name { name }
+    , begin { std::chrono::steady_clock::now() }
+    , beginAllocationCount { threadAllocationCount } { }
+
+vk_gltf_viewer::cpu_profiler::Zone::~Zone() {
+    const auto end = std::chrono::steady_clock::now();
+    const std::uint64_t allocationCount = threadAllocationCount - beginAllocationCount;
+
+    const ProfilerScope profilerScope;
+    ThreadEvents &threadEvents = getThreadEvents();
+    std::scoped_lock lock { threadEvents.mutex };
+    threadEvents.events.emplace_back(name, threadEvents.threadIndex, begin, end - begin, allocationCount);
+}
+
+std::vector<vk_gltf_viewer::cpu_profiler::ZoneEvent> vk_gltf_viewer::cpu_profiler::collect() {
+    const ProfilerScope profilerScope;
+
+    std::vector<ZoneEvent> result;
+    {
+        std::scoped_lock registryLock { registryMutex };
+        for (ThreadEvents &threadEvents : registry) {
+            std::scoped_lock lock { threadEvents.mutex };
+            result.append_range(threadEvents.events);
+            threadEvents.events.clear();
+        }
+    }
+
+    std::ranges::sort(result, {}, &ZoneEvent::begin);
+    return result;
+}
+
+void vk_gltf_viewer::cpu_profiler::countAllocation() noexcept {
+    if (insideProfiler) return;
+
+    totalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    ++threadAllocationCount;
+}
+
+std::uint64_t vk_gltf_viewer::cpu_profiler::getAllocationCount() noexcept {
+    return totalAllocationCount.load(std::memory_order_relaxed);
+}
+#else
+std::vector<vk_gltf_viewer::cpu_profiler::ZoneEvent> vk_gltf_viewer::cpu_profiler::collect() {
+    return {};
+}
+
+void vk_gltf_viewer::cpu_profiler::countAllocation() noexcept { }
+
+std::uint64_t vk_gltf_viewer::cpu_profiler::getAllocationCount() noexcept {
+    return 0;
+}
+#endif
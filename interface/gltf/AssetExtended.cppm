@@ -4,11 +4,15 @@ import std;
 export import fastgltf;
 
 export import vk_gltf_viewer.gltf.Animation;
+export import vk_gltf_viewer.gltf.algorithm.meshOptimization;
 import vk_gltf_viewer.gltf.algorithm.miniball;
 export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+export import vk_gltf_viewer.gltf.JointBoundingBoxes;
 export import vk_gltf_viewer.gltf.SceneHierarchy;
+export import vk_gltf_viewer.gltf.SubtreeBoundingBoxes;
 import vk_gltf_viewer.gltf.util;
 export import vk_gltf_viewer.imgui.ColorSpaceAndUsageCorrectedTextures;
+import vk_gltf_viewer.cpu_profiler;
 import vk_gltf_viewer.helpers.fastgltf;
 import vk_gltf_viewer.helpers.functional;
 import vk_gltf_viewer.helpers.ranges;
@@ -53,10 +57,22 @@ namespace vk_gltf_viewer::gltf {
          */
         std::unordered_set<std::size_t> bloomMaterials;
 
+        /**
+         * @brief Statistics of the load-time mesh optimization, or <tt>std::nullopt</tt> if it is not requested.
+         */
+        std::optional<algorithm::MeshOptimizationStatistics> meshOptimizationStatistics;
+
         /**
 		 * @brief External buffers that are not embedded in the glTF file, such like .bin files.
+         *
+         * If mesh optimization is requested, the optimized primitives' data are also stored in it.
          */
-        AssetExternalBuffers externalBuffers { asset, directory };
+        AssetExternalBuffers externalBuffers;
+
+        /**
+         * @brief Per-joint bounding boxes of skinned primitives, for calculating their bounding boxes at the current pose.
+         */
+        JointBoundingBoxes jointBoundingBoxes { asset, externalBuffers };
 
 		/**
 		 * @brief Pairs of (animation, enabled) that are currently loaded in the asset.
@@ -94,6 +110,17 @@ namespace vk_gltf_viewer::gltf {
 
         SceneHierarchy sceneHierarchy;
 
+        /**
+         * @brief World space bounding boxes of the scene nodes' subtrees, which must be invalidated whenever a node's
+         * world transform or morph target weights are changed.
+         */
+        SubtreeBoundingBoxes subtreeBoundingBoxes;
+
+        /**
+         * @brief Thread pool for the asset processing, e.g. the bounding volume calculation. It must outlive the asset.
+         */
+        std::reference_wrapper<BS::thread_pool<>> threadPool;
+
         /**
          * @brief Indices of the nodes that are currently selected in the scene.
          */
@@ -112,7 +139,13 @@ namespace vk_gltf_viewer::gltf {
 		 */
         Lazy<std::tuple<fastgltf::math::fvec3, float, std::vector<fastgltf::math::fvec3>>> sceneMiniball;
 
-    	explicit AssetExtended(const std::filesystem::path &path);
+        /**
+         * @param path Path of the glTF file.
+         * @param threadPool Thread pool to run the asset processing. It must outlive the asset.
+         * @param optimizeMeshes If <tt>true</tt>, primitives' indices and vertices are reordered for the better GPU
+         * efficiency by <tt>algorithm::optimizeMeshes</tt>.
+         */
+    	explicit AssetExtended(const std::filesystem::path &path, BS::thread_pool<> &threadPool, bool optimizeMeshes = false);
 
         /**
          * @brief Return whether the data of the image at the given index is loaded or not.
@@ -149,10 +182,21 @@ module :private;
 using namespace std::string_view_literals;
 
 fastgltf::Parser parser {
-	fastgltf::Extensions::KHR_materials_emissive_strength
+	fastgltf::Extensions::KHR_materials_anisotropy
+	#ifdef SUPPORT_KHR_DRACO_MESH_COMPRESSION
+		| fastgltf::Extensions::KHR_draco_mesh_compression
+	#endif
+		| fastgltf::Extensions::KHR_materials_clearcoat
+		| fastgltf::Extensions::KHR_materials_diffuse_transmission
+		| fastgltf::Extensions::KHR_materials_emissive_strength
 		| fastgltf::Extensions::KHR_materials_ior
+		| fastgltf::Extensions::KHR_materials_iridescence
+		| fastgltf::Extensions::KHR_materials_sheen
+		| fastgltf::Extensions::KHR_materials_specular
+		| fastgltf::Extensions::KHR_materials_transmission
 		| fastgltf::Extensions::KHR_materials_unlit
 		| fastgltf::Extensions::KHR_materials_variants
+		| fastgltf::Extensions::KHR_materials_volume
 		| fastgltf::Extensions::KHR_mesh_quantization
 	#ifdef SUPPORT_KHR_TEXTURE_BASISU
 		| fastgltf::Extensions::KHR_texture_basisu
@@ -160,21 +204,40 @@ fastgltf::Parser parser {
 		| fastgltf::Extensions::KHR_texture_transform
 		| fastgltf::Extensions::EXT_meshopt_compression
 		| fastgltf::Extensions::EXT_mesh_gpu_instancing
+	#ifdef SUPPORT_EXT_TEXTURE_WEBP
+		| fastgltf::Extensions::EXT_texture_webp
+	#endif
+		| fastgltf::Extensions::MSFT_texture_dds
 };
 
-vk_gltf_viewer::gltf::AssetExtended::AssetExtended(const std::filesystem::path &path)
+vk_gltf_viewer::gltf::AssetExtended::AssetExtended(const std::filesystem::path &path, BS::thread_pool<> &threadPool, bool optimizeMeshes)
 	: dataBuffer { get_checked(fastgltf::GltfDataBuffer::FromPath(path)) }
     , directory { path.parent_path() }
-    , asset { get_checked(parser.loadGltf(dataBuffer, directory)) }
+    , asset { cpu_profiler::zoned("Parse glTF JSON", [&] { return get_checked(parser.loadGltf(dataBuffer, directory)); }) }
+    , externalBuffers { cpu_profiler::zoned("Load external buffers", [&] {
+        AssetExternalBuffers result { asset, directory, threadPool };
+        if (optimizeMeshes) {
+            std::error_code ec;
+            const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path(ec) / "vk-gltf-viewer" / "mesh-optimization";
+            meshOptimizationStatistics.emplace(cpu_profiler::zoned("Optimize meshes", [&] {
+                return algorithm::optimizeMeshes(asset, result, cacheDirectory, threadPool);
+            }));
+        }
+        return result;
+    }) }
     , sceneIndex { asset.defaultScene.value_or(0) }
     , sceneHierarchy { asset, sceneIndex }
+    , subtreeBoundingBoxes { asset, sceneHierarchy, jointBoundingBoxes, externalBuffers }
+    , threadPool { threadPool }
     , sceneMiniball { [this] {
-        return algorithm::getMiniball<true>(
-        	asset,
-        	asset.scenes[sceneIndex].nodeIndices,
-        	sceneHierarchy.getWorldTransforms(),
-        	externalBuffers,
-        	LIFT(sceneHierarchy.isObjectlessRecursive));
+        const auto [center, radius] = algorithm::getMiniball(asset, asset.scenes[sceneIndex].nodeIndices, subtreeBoundingBoxes, this->threadPool);
+
+        std::vector<fastgltf::math::fvec3> cameraOrLightPoints;
+        for (std::size_t nodeIndex : sceneHierarchy.getCameraOrLightNodeIndices()) {
+        	cameraOrLightPoints.emplace_back(sceneHierarchy.getWorldTransform(nodeIndex).col(3));
+        }
+
+        return std::tuple { center, radius, std::move(cameraOrLightPoints) };
     } } {
 	// originalMaterialIndexByPrimitive
 	for (fastgltf::Mesh &mesh: asset.meshes) {
@@ -235,6 +298,7 @@ void vk_gltf_viewer::gltf::AssetExtended::setScene(std::size_t _sceneIndex) {
 	nodeNameSearchTextOccurrencePosByNode.clear();
 
 	sceneHierarchy = { asset, sceneIndex };
+	subtreeBoundingBoxes = { asset, sceneHierarchy, jointBoundingBoxes, externalBuffers };
 
     selectedNodes.clear();
     hoveringNode.reset();
@@ -2,9 +2,14 @@ module;
 
 #include <meshoptimizer.h>
 
+#ifdef SUPPORT_KHR_DRACO_MESH_COMPRESSION
+#include <draco/compression/decode.h>
+#endif
+
 export module vk_gltf_viewer.gltf.AssetExternalBuffers;
 
 import std;
+import BS.thread_pool;
 export import fastgltf;
 
 export import vk_gltf_viewer.gltf.AssetProcessError;
@@ -17,6 +22,11 @@ namespace vk_gltf_viewer::gltf {
      * This loads the external and GLB buffers at construction, and organize them into <tt>std::span<const std::byte></tt> by their indices. Since this operation done in the initialization, you don't have to make branches for <tt>fastgltf::DataSource</tt> variant type.
      *
      * Also, this class implements <tt>const std::byte* operator(const fastgltf::Asset&, std::size_t) const</tt> for compatibility with <tt>fastgltf::DefaultBufferDataAdapter</tt>. You can directly pass the class instance as the fastgltf's buffer data adapter, such like <tt>fastgltf::iterateAccessor</tt>.
+     *
+     * Compressed data is decoded at construction, with each EXT_meshopt_compression buffer view and each
+     * KHR_draco_mesh_compression primitive as an independent thread pool task. Draco compressed primitives' accessors
+     * are redirected to the newly appended buffers (one per primitive) that contain the decoded data, therefore they
+     * can be accessed like the uncompressed accessors.
      */
     export class AssetExternalBuffers {
         std::unordered_map<std::size_t, std::vector<std::byte>> externalBufferBytes;
@@ -24,7 +34,25 @@ namespace vk_gltf_viewer::gltf {
         std::vector<std::span<const std::byte>> bufferViewBytes;
 
     public:
-        AssetExternalBuffers(const fastgltf::Asset &asset, const std::filesystem::path &directory);
+        /**
+         * @param asset Asset to load the buffers. If it has the Draco compressed primitives, their accessors and the
+         * asset's buffers/buffer views are modified.
+         * @param directory Directory of the asset, used for resolving the relative buffer URIs.
+         * @param threadPool Thread pool to run the decoding of the compressed data.
+         * @throw AssetProcessError::UnsupportedSourceDataType If the buffer data source is not supported.
+         * @throw std::runtime_error If the compressed data cannot be decoded.
+         */
+        AssetExternalBuffers(fastgltf::Asset &asset, const std::filesystem::path &directory, BS::thread_pool<> &threadPool);
+
+        /**
+         * @brief Register the buffer views that are appended to \p asset after the construction.
+         *
+         * Appended buffer views must not be compressed, and their buffers must be <tt>fastgltf::sources::Array</tt>.
+         *
+         * @param asset Asset that was passed at the construction.
+         * @throw AssetProcessError::UnsupportedSourceDataType If the appended buffer view does not satisfy the above.
+         */
+        void registerAppendedBufferViews(const fastgltf::Asset &asset);
 
         /**
          * Interface for <tt>fastgltf::BufferDataAdapter</tt>.
@@ -40,7 +68,134 @@ namespace vk_gltf_viewer::gltf {
 module :private;
 #endif
 
-vk_gltf_viewer::gltf::AssetExternalBuffers::AssetExternalBuffers(const fastgltf::Asset &asset, const std::filesystem::path &directory) {
+#ifdef SUPPORT_KHR_DRACO_MESH_COMPRESSION
+struct DracoDecodeTarget {
+    struct Attribute {
+        std::uint32_t dracoAttributeId;
+        std::size_t accessorIndex;
+    };
+
+    const fastgltf::Primitive *primitive;
+    std::size_t bufferIndex;
+    std::vector<Attribute> attributes;
+    bool decodeIndices;
+};
+
+/**
+ * @brief Copy the attribute values of the decoded Draco point cloud to the accessor-described memory.
+ * @tparam T Component type of the accessor.
+ * @param attribute Decoded Draco attribute.
+ * @param accessor Accessor that will read from \p dst.
+ * @param byteStride Byte stride between the elements in \p dst.
+ * @param dst Destination memory.
+ */
+template <typename T>
+void copyDracoAttribute(const draco::PointAttribute &attribute, const fastgltf::Accessor &accessor, std::size_t byteStride, std::byte *dst) {
+    const std::int8_t numComponents = fastgltf::getNumComponents(accessor.type);
+    for (std::size_t i = 0; i < accessor.count; ++i) {
+        T* const element = reinterpret_cast<T*>(dst + byteStride * i);
+        if (!attribute.ConvertValue(attribute.mapped_index(draco::PointIndex(i)), numComponents, element)) {
+            throw std::runtime_error { "Failed to convert KHR_draco_mesh_compression attribute value." };
+        }
+    }
+}
+
+void copyDracoAttribute(const draco::PointAttribute &attribute, const fastgltf::Accessor &accessor, std::size_t byteStride, std::byte *dst) {
+    switch (accessor.componentType) {
+        case fastgltf::ComponentType::Byte:
+            return copyDracoAttribute<std::int8_t>(attribute, accessor, byteStride, dst);
+        case fastgltf::ComponentType::UnsignedByte:
+            return copyDracoAttribute<std::uint8_t>(attribute, accessor, byteStride, dst);
+        case fastgltf::ComponentType::Short:
+            return copyDracoAttribute<std::int16_t>(attribute, accessor, byteStride, dst);
+        case fastgltf::ComponentType::UnsignedShort:
+            return copyDracoAttribute<std::uint16_t>(attribute, accessor, byteStride, dst);
+        case fastgltf::ComponentType::UnsignedInt:
+            return copyDracoAttribute<std::uint32_t>(attribute, accessor, byteStride, dst);
+        case fastgltf::ComponentType::Float:
+            return copyDracoAttribute<float>(attribute, accessor, byteStride, dst);
+        default:
+            throw std::runtime_error { "Unsupported KHR_draco_mesh_compression accessor component type." };
+    }
+}
+
+/**
+ * @brief Copy the face indices of the decoded Draco mesh to the memory with the given type.
+ * @tparam T Index type.
+ * @param mesh Decoded Draco mesh.
+ * @param dst Destination memory, must have at least <tt>3 * mesh.num_faces()</tt> elements.
+ */
+template <typename T>
+void copyDracoIndices(const draco::Mesh &mesh, std::byte *dst) {
+    T* const indices = reinterpret_cast<T*>(dst);
+    for (draco::FaceIndex i { 0 }; i < mesh.num_faces(); ++i) {
+        const draco::Mesh::Face &face = mesh.face(i);
+        for (std::size_t j = 0; j < 3; ++j) {
+            indices[3 * i.value() + j] = static_cast<T>(face[j].value());
+        }
+    }
+}
+#endif
+
+vk_gltf_viewer::gltf::AssetExternalBuffers::AssetExternalBuffers(
+    fastgltf::Asset &asset,
+    const std::filesystem::path &directory,
+    BS::thread_pool<> &threadPool
+) {
+#ifdef SUPPORT_KHR_DRACO_MESH_COMPRESSION
+    // Allocate the buffer, buffer views for each Draco compressed primitive, and redirect the primitive's accessors to
+    // them. As the accessors' counts and types are known, it can be done before the decoding, and decoded data can be
+    // directly written to the buffer in the decoding task.
+    std::vector<DracoDecodeTarget> dracoDecodeTargets;
+    std::unordered_set<std::size_t> redirectedAccessorIndices;
+    for (const fastgltf::Mesh &mesh : asset.meshes) {
+        for (const fastgltf::Primitive &primitive : mesh.primitives) {
+            if (!primitive.dracoCompression) continue;
+
+            DracoDecodeTarget &target = dracoDecodeTargets.emplace_back(DracoDecodeTarget {
+                .primitive = &primitive,
+                .bufferIndex = asset.buffers.size(),
+            });
+            std::size_t byteLength = 0;
+            const auto appendBufferView = [&](std::size_t accessorIndex, bool isVertexAttribute) {
+                // Accessor shared by multiple primitives is decoded only once.
+                if (!redirectedAccessorIndices.emplace(accessorIndex).second) return false;
+
+                fastgltf::Accessor &accessor = asset.accessors[accessorIndex];
+                const std::size_t elementByteSize = getElementByteSize(accessor.type, accessor.componentType);
+
+                fastgltf::BufferView &bufferView = asset.bufferViews.emplace_back();
+                bufferView.bufferIndex = target.bufferIndex;
+                bufferView.byteOffset = byteLength;
+                if (isVertexAttribute && elementByteSize % 4 != 0) {
+                    // Vertex attribute elements must be 4-byte aligned.
+                    bufferView.byteStride = (elementByteSize / 4 + 1) * 4;
+                }
+                bufferView.byteLength = bufferView.byteStride.value_or(elementByteSize) * accessor.count;
+
+                accessor.bufferViewIndex = asset.bufferViews.size() - 1;
+                accessor.byteOffset = 0;
+
+                byteLength += (bufferView.byteLength + 3) / 4 * 4;
+                return true;
+            };
+
+            for (const fastgltf::Attribute &attribute : primitive.dracoCompression->attributes) {
+                // Note: for Draco compressed primitive's attribute, accessorIndex is the Draco unique attribute id.
+                const std::size_t accessorIndex = primitive.findAttribute(attribute.name)->accessorIndex;
+                if (appendBufferView(accessorIndex, true)) {
+                    target.attributes.emplace_back(static_cast<std::uint32_t>(attribute.accessorIndex), accessorIndex);
+                }
+            }
+            target.decodeIndices = primitive.indicesAccessor && appendBufferView(*primitive.indicesAccessor, false);
+
+            fastgltf::Buffer &buffer = asset.buffers.emplace_back();
+            buffer.byteLength = byteLength;
+            buffer.data = fastgltf::sources::Array { decltype(fastgltf::sources::Array::bytes)(byteLength), fastgltf::MimeType::GltfBuffer };
+        }
+    }
+#endif
+
     const auto getBufferBytes = [&](std::size_t bufferIndex) -> std::span<const std::byte> {
         return visit(fastgltf::visitor {
             [](const fastgltf::sources::Array &array) -> std::span<const std::byte> {
@@ -66,6 +221,9 @@ vk_gltf_viewer::gltf::AssetExternalBuffers::AssetExternalBuffers(const fastgltf:
         }, asset.buffers[bufferIndex].data);
     };
 
+    // Load the buffers and allocate the meshopt decompression destinations in the constructing thread, as the buffer
+    // loading mutates externalBufferBytes.
+    std::vector<std::tuple<const fastgltf::MeshoptCompression*, const unsigned char*, std::byte*>> meshoptDecodeTargets;
     bufferViewBytes.reserve(asset.bufferViews.size());
     for (const fastgltf::BufferView &bufferView : asset.bufferViews) {
         if (const auto &mc = bufferView.meshoptCompression) {
@@ -73,44 +231,132 @@ vk_gltf_viewer::gltf::AssetExternalBuffers::AssetExternalBuffers(const fastgltf:
 
             const std::size_t decompressedBufferSize = mc->count * mc->byteStride;
             std::byte* const decompressed = meshoptDecompressedBytes.emplace_back(std::make_unique_for_overwrite<std::byte[]>(decompressedBufferSize)).get();
+            meshoptDecodeTargets.emplace_back(mc.get(), compressed, decompressed);
 
-            int rc = -1;
-            switch (mc->mode) {
-                case fastgltf::MeshoptCompressionMode::Attributes:
-                    rc = meshopt_decodeVertexBuffer(decompressed, mc->count, mc->byteStride, compressed, mc->byteLength);
-                    break;
-                case fastgltf::MeshoptCompressionMode::Triangles:
-                    rc = meshopt_decodeIndexBuffer(decompressed, mc->count, mc->byteStride, compressed, mc->byteLength);
-                    break;
-                case fastgltf::MeshoptCompressionMode::Indices:
-                    rc = meshopt_decodeIndexSequence(decompressed, mc->count, mc->byteStride, compressed, mc->byteLength);
-                    break;
+            bufferViewBytes.emplace_back(decompressed, decompressedBufferSize);
+        }
+        else {
+            const std::span<const std::byte> bufferBytes = getBufferBytes(bufferView.bufferIndex);
+            bufferViewBytes.push_back( bufferBytes.subspan(bufferView.byteOffset, bufferView.byteLength));
+        }
+    }
+
+#ifdef SUPPORT_KHR_DRACO_MESH_COMPRESSION
+    if (meshoptDecodeTargets.empty() && dracoDecodeTargets.empty()) return;
+#else
+    if (meshoptDecodeTargets.empty()) return;
+#endif
+
+    threadPool.submit_sequence(0, meshoptDecodeTargets.size(), [&](std::size_t i) {
+        const auto &[mc, compressed, decompressed] = meshoptDecodeTargets[i];
+
+        int rc = -1;
+        switch (mc->mode) {
+            case fastgltf::MeshoptCompressionMode::Attributes:
+                rc = meshopt_decodeVertexBuffer(decompressed, mc->count, mc->byteStride, compressed, mc->byteLength);
+                break;
+            case fastgltf::MeshoptCompressionMode::Triangles:
+                rc = meshopt_decodeIndexBuffer(decompressed, mc->count, mc->byteStride, compressed, mc->byteLength);
+                break;
+            case fastgltf::MeshoptCompressionMode::Indices:
+                rc = meshopt_decodeIndexSequence(decompressed, mc->count, mc->byteStride, compressed, mc->byteLength);
+                break;
+        }
+
+        if (rc != 0) {
+            throw std::runtime_error { "Failed to decompress EXT_meshopt_compression compressed buffer view." };
+        }
+
+        switch (mc->filter) {
+            case fastgltf::MeshoptCompressionFilter::None:
+                break;
+            case fastgltf::MeshoptCompressionFilter::Octahedral:
+                meshopt_decodeFilterOct(decompressed, mc->count, mc->byteStride);
+                break;
+            case fastgltf::MeshoptCompressionFilter::Quaternion:
+                meshopt_decodeFilterQuat(decompressed, mc->count, mc->byteStride);
+                break;
+            case fastgltf::MeshoptCompressionFilter::Exponential:
+                meshopt_decodeFilterExp(decompressed, mc->count, mc->byteStride);
+                break;
+        }
+    }).get();
+
+#ifdef SUPPORT_KHR_DRACO_MESH_COMPRESSION
+    // Draco bitstream may be in a meshopt compressed buffer view, therefore it must be decoded after the meshopt decoding.
+    threadPool.submit_sequence(0, dracoDecodeTargets.size(), [&](std::size_t i) {
+        const DracoDecodeTarget &target = dracoDecodeTargets[i];
+        const fastgltf::Primitive &primitive = *target.primitive;
+
+        const std::span<const std::byte> compressed = bufferViewBytes[primitive.dracoCompression->bufferView];
+        draco::DecoderBuffer decoderBuffer;
+        decoderBuffer.Init(reinterpret_cast<const char*>(compressed.data()), compressed.size_bytes());
+
+        draco::Decoder decoder;
+        auto decoded = decoder.DecodePointCloudFromBuffer(&decoderBuffer);
+        if (!decoded.ok()) {
+            throw std::runtime_error { std::format("Failed to decode KHR_draco_mesh_compression primitive: {}", decoded.status().error_msg_string()) };
+        }
+        const std::unique_ptr<draco::PointCloud> pointCloud = std::move(decoded).value();
+
+        // Decoded data is written to the buffer that is exclusively owned by this task.
+        auto &bufferBytes = get<fastgltf::sources::Array>(asset.buffers[target.bufferIndex].data).bytes;
+        const auto getDestination = [&](std::size_t accessorIndex) {
+            const fastgltf::Accessor &accessor = asset.accessors[accessorIndex];
+            const fastgltf::BufferView &bufferView = asset.bufferViews[*accessor.bufferViewIndex];
+            return std::pair {
+                reinterpret_cast<std::byte*>(bufferBytes.data()) + bufferView.byteOffset,
+                bufferView.byteStride.value_or(getElementByteSize(accessor.type, accessor.componentType)),
+            };
+        };
+
+        for (const auto &[dracoAttributeId, accessorIndex] : target.attributes) {
+            const draco::PointAttribute* const attribute = pointCloud->GetAttributeByUniqueId(dracoAttributeId);
+            const fastgltf::Accessor &accessor = asset.accessors[accessorIndex];
+            if (!attribute || accessor.count != pointCloud->num_points()) {
+                throw std::runtime_error { "KHR_draco_mesh_compression attribute mismatches to the accessor." };
             }
 
-            if (rc != 0) {
-                throw std::runtime_error { "Failed to decompress EXT_meshopt_compression compressed buffer view." };
+            const auto [dst, byteStride] = getDestination(accessorIndex);
+            copyDracoAttribute(*attribute, accessor, byteStride, dst);
+        }
+
+        if (target.decodeIndices) {
+            const auto *mesh = dynamic_cast<const draco::Mesh*>(pointCloud.get());
+            const fastgltf::Accessor &accessor = asset.accessors[*primitive.indicesAccessor];
+            if (!mesh || accessor.count != 3 * mesh->num_faces()) {
+                throw std::runtime_error { "KHR_draco_mesh_compression indices mismatches to the accessor." };
             }
 
-            switch (mc->filter) {
-                case fastgltf::MeshoptCompressionFilter::None:
+            std::byte* const dst = getDestination(*primitive.indicesAccessor).first;
+            switch (accessor.componentType) {
+                case fastgltf::ComponentType::UnsignedByte:
+                    copyDracoIndices<std::uint8_t>(*mesh, dst);
                     break;
-                case fastgltf::MeshoptCompressionFilter::Octahedral:
-                    meshopt_decodeFilterOct(decompressed, mc->count, mc->byteStride);
+                case fastgltf::ComponentType::UnsignedShort:
+                    copyDracoIndices<std::uint16_t>(*mesh, dst);
                     break;
-                case fastgltf::MeshoptCompressionFilter::Quaternion:
-                    meshopt_decodeFilterQuat(decompressed, mc->count, mc->byteStride);
-                    break;
-                case fastgltf::MeshoptCompressionFilter::Exponential:
-                    meshopt_decodeFilterExp(decompressed, mc->count, mc->byteStride);
+                case fastgltf::ComponentType::UnsignedInt:
+                    copyDracoIndices<std::uint32_t>(*mesh, dst);
                     break;
+                default:
+                    throw std::runtime_error { "Unsupported KHR_draco_mesh_compression indices component type." };
             }
-
-            bufferViewBytes.emplace_back(decompressed, decompressedBufferSize);
         }
-        else {
-            const std::span<const std::byte> bufferBytes = getBufferBytes(bufferView.bufferIndex);
-            bufferViewBytes.push_back( bufferBytes.subspan(bufferView.byteOffset, bufferView.byteLength));
+    }).get();
+#endif
+}
+
+void vk_gltf_viewer::gltf::AssetExternalBuffers::registerAppendedBufferViews(const fastgltf::Asset &asset) {
+    bufferViewBytes.reserve(asset.bufferViews.size());
+    for (std::size_t bufferViewIndex = bufferViewBytes.size(); bufferViewIndex < asset.bufferViews.size(); ++bufferViewIndex) {
+        const fastgltf::BufferView &bufferView = asset.bufferViews[bufferViewIndex];
+        const auto *array = get_if<fastgltf::sources::Array>(&asset.buffers[bufferView.bufferIndex].data);
+        if (!array || bufferView.meshoptCompression) {
+            throw AssetProcessError::UnsupportedSourceDataType;
         }
+
+        bufferViewBytes.push_back(as_bytes(std::span { array->bytes }).subspan(bufferView.byteOffset, bufferView.byteLength));
     }
 }
 
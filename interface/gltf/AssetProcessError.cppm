@@ -7,6 +7,7 @@ namespace vk_gltf_viewer::gltf {
     export enum class AssetProcessError : std::uint8_t {
         UnsupportedSourceDataType,  /// The source data type is not supported.
         TooManyTextureError,        /// The number of textures exceeds the system GPU limit.
+        InvalidSparseAccessor,      /// The sparse accessor has an invalid index component type or an out of range index.
     };
 
     export cpp_util::cstring_view format_as(AssetProcessError error) noexcept;
@@ -22,6 +23,8 @@ cpp_util::cstring_view vk_gltf_viewer::gltf::format_as(AssetProcessError error)
             return "The source data type is not supported.";
         case AssetProcessError::TooManyTextureError:
             return "The number of textures exceeds the system GPU limit.";
+        case AssetProcessError::InvalidSparseAccessor:
+            return "The sparse accessor has an invalid index component type or an out of range index.";
     }
     std::unreachable();
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+module;
+
+#include <lifetimebound.hpp>
+
+export module vk_gltf_viewer.gltf.JointBoundingBoxes;
+
+import std;
+export import fastgltf;
+
+export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+import vk_gltf_viewer.helpers.fastgltf;
+import vk_gltf_viewer.helpers.ranges;
+
+namespace vk_gltf_viewer::gltf {
+    /**
+     * @brief Per-joint bounding boxes of skinned primitives, which are used for calculating the bounding box of the
+     * skinned primitive at the current pose.
+     *
+     * For each primitive that is used by a skinned node, the bounding box of the vertices that are influenced by each
+     * joint (i.e. has non-zero weight for the joint) is calculated at the construction. As a skinned vertex position is
+     * a convex combination of the positions transformed by its joint matrices, it must be within the union of the
+     * joint bounding boxes transformed by the corresponding joint matrices.
+     */
+    export class JointBoundingBoxes {
+    public:
+        JointBoundingBoxes(const fastgltf::Asset &asset LIFETIMEBOUND, const AssetExternalBuffers &adapter);
+
+        /**
+         * @brief Check if the joint bounding boxes of \p primitive are calculated.
+         *
+         * It is <tt>false</tt> if \p primitive is not used by any skinned node or does not have <tt>JOINTS_n</tt> and
+         * <tt>WEIGHTS_n</tt> attributes. In this case, the primitive is not skinned and its bounding box can be
+         * determined by <tt>fastgltf::getBoundingBoxMinMax</tt>.
+         */
+        [[nodiscard]] bool contains(const fastgltf::Primitive &primitive) const noexcept;
+
+        /**
+         * @brief Get world space min/max points of \p primitive's bounding box at the current pose.
+         *
+         * Morph target displacement with the current target weights of \p node is also considered.
+         *
+         * @param primitive Primitive to get the bounding box.
+         * @param node Skinned node that owns \p primitive.
+         * @param nodeWorldTransforms Node world transforms, indexed by the node index.
+         * @return Array of (min, max) of the bounding box.
+         * @pre <tt>contains(primitive)</tt> must be <tt>true</tt>, and \p node must have a skin.
+         */
+        [[nodiscard]] std::array<fastgltf::math::fvec3, 2> getWorldBoundingBoxMinMax(
+            const fastgltf::Primitive &primitive,
+            const fastgltf::Node &node,
+            std::span<const fastgltf::math::fmat4x4> nodeWorldTransforms
+        ) const;
+
+    private:
+        struct JointBoundingBox {
+            /**
+             * @brief Index of the joint in <tt>fastgltf::Skin::joints</tt>.
+             */
+            std::uint32_t joint;
+            fastgltf::math::fvec3 min;
+            fastgltf::math::fvec3 max;
+        };
+
+        std::reference_wrapper<const fastgltf::Asset> asset;
+
+        /**
+         * @brief Inverse bind matrices of each skin, whose size is same as the skin's joint count.
+         */
+        std::vector<std::vector<fastgltf::math::fmat4x4>> inverseBindMatricesBySkin;
+
+        std::unordered_map<const fastgltf::Primitive*, std::vector<JointBoundingBox>> jointBoundingBoxesByPrimitive;
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+vk_gltf_viewer::gltf::JointBoundingBoxes::JointBoundingBoxes(const fastgltf::Asset &asset, const AssetExternalBuffers &adapter)
+    : asset { asset } {
+    // inverseBindMatricesBySkin
+    inverseBindMatricesBySkin.reserve(asset.skins.size());
+    for (const fastgltf::Skin &skin : asset.skins) {
+        std::vector<fastgltf::math::fmat4x4> &inverseBindMatrices = inverseBindMatricesBySkin.emplace_back();
+        if (skin.inverseBindMatrices) {
+            // Accessor count may be greater than the joint count.
+            const fastgltf::Accessor &accessor = asset.accessors[*skin.inverseBindMatrices];
+            inverseBindMatrices.resize(accessor.count);
+            fastgltf::copyFromAccessor<fastgltf::math::fmat4x4>(asset, accessor, inverseBindMatrices.data(), adapter);
+        }
+        inverseBindMatrices.resize(skin.joints.size()); // Identity matrices if inverseBindMatrices is undefined.
+    }
+
+    // Collect meshes that are used by skinned nodes.
+    std::unordered_set<std::size_t> skinnedMeshIndices;
+    for (const fastgltf::Node &node : asset.nodes) {
+        if (node.skinIndex && node.meshIndex) {
+            skinnedMeshIndices.emplace(*node.meshIndex);
+        }
+    }
+
+    // jointBoundingBoxesByPrimitive
+    std::vector<fastgltf::math::fvec3> positions;
+    std::vector<fastgltf::math::uvec4> joints;
+    std::vector<fastgltf::math::fvec4> weights;
+    std::vector<JointBoundingBox> jointBoundingBoxes;
+    for (std::size_t meshIndex : skinnedMeshIndices) {
+        for (const fastgltf::Primitive &primitive : asset.meshes[meshIndex].primitives) {
+            const fastgltf::Accessor &positionAccessor = asset.accessors[primitive.findAttribute("POSITION")->accessorIndex];
+            positions.resize(positionAccessor.count);
+            fastgltf::copyFromAccessor<fastgltf::math::fvec3>(asset, positionAccessor, positions.data(), adapter);
+
+            jointBoundingBoxes.clear();
+            for (std::size_t i = 0; ; ++i) {
+                const auto jointsIt = primitive.findAttribute(std::format("JOINTS_{}", i));
+                const auto weightsIt = primitive.findAttribute(std::format("WEIGHTS_{}", i));
+                if (jointsIt == primitive.attributes.end() || weightsIt == primitive.attributes.end()) {
+                    break;
+                }
+
+                const fastgltf::Accessor &jointsAccessor = asset.accessors[jointsIt->accessorIndex];
+                joints.resize(jointsAccessor.count);
+                fastgltf::copyFromAccessor<fastgltf::math::uvec4>(asset, jointsAccessor, joints.data(), adapter);
+
+                const fastgltf::Accessor &weightsAccessor = asset.accessors[weightsIt->accessorIndex];
+                weights.resize(weightsAccessor.count);
+                fastgltf::copyFromAccessor<fastgltf::math::fvec4>(asset, weightsAccessor, weights.data(), adapter);
+
+                for (const auto &[position, vertexJoints, vertexWeights] : std::views::zip(positions, joints, weights)) {
+                    for (std::size_t j = 0; j < 4; ++j) {
+                        if (vertexWeights[j] == 0.f) continue;
+
+                        if (vertexJoints[j] >= jointBoundingBoxes.size()) {
+                            jointBoundingBoxes.resize(vertexJoints[j] + 1, JointBoundingBox {
+                                .joint = 0,
+                                .min = fastgltf::math::fvec3(std::numeric_limits<float>::max()),
+                                .max = fastgltf::math::fvec3(std::numeric_limits<float>::lowest()),
+                            });
+                        }
+
+                        JointBoundingBox &jointBoundingBox = jointBoundingBoxes[vertexJoints[j]];
+                        jointBoundingBox.min = cwiseMin(jointBoundingBox.min, position);
+                        jointBoundingBox.max = cwiseMax(jointBoundingBox.max, position);
+                    }
+                }
+            }
+
+            if (jointBoundingBoxes.empty()) {
+                // Primitive is not skinned.
+                continue;
+            }
+
+            // Remove the joints that do not influence any vertex, and store the joint index instead.
+            std::vector<JointBoundingBox> &result = jointBoundingBoxesByPrimitive[&primitive];
+            for (const auto &[joint, jointBoundingBox] : jointBoundingBoxes | ranges::views::enumerate) {
+                if (jointBoundingBox.min.x() <= jointBoundingBox.max.x()) {
+                    result.push_back({ static_cast<std::uint32_t>(joint), jointBoundingBox.min, jointBoundingBox.max });
+                }
+            }
+        }
+    }
+}
+
+bool vk_gltf_viewer::gltf::JointBoundingBoxes::contains(const fastgltf::Primitive &primitive) const noexcept {
+    return jointBoundingBoxesByPrimitive.contains(&primitive);
+}
+
+std::array<fastgltf::math::fvec3, 2> vk_gltf_viewer::gltf::JointBoundingBoxes::getWorldBoundingBoxMinMax(
+    const fastgltf::Primitive &primitive,
+    const fastgltf::Node &node,
+    std::span<const fastgltf::math::fmat4x4> nodeWorldTransforms
+) const {
+    const fastgltf::Skin &skin = asset.get().skins[node.skinIndex.value()];
+    const std::vector<fastgltf::math::fmat4x4> &inverseBindMatrices = inverseBindMatricesBySkin[*node.skinIndex];
+
+    // Morph targets are applied before the skinning, therefore the joint bounding boxes are expanded by the
+    // displacement in the mesh space.
+    const auto [displacementMin, displacementMax] = getMorphTargetDisplacementMinMax(primitive, node, asset);
+
+    fastgltf::math::fvec3 min(std::numeric_limits<float>::max());
+    fastgltf::math::fvec3 max(std::numeric_limits<float>::lowest());
+    for (const JointBoundingBox &jointBoundingBox : jointBoundingBoxesByPrimitive.at(&primitive)) {
+        const fastgltf::math::fmat4x4 jointMatrix
+            = nodeWorldTransforms[skin.joints[jointBoundingBox.joint]] * inverseBindMatrices[jointBoundingBox.joint];
+        for (const fastgltf::math::fvec3 &point : fastgltf::getBoundingBoxCornerPoints(jointBoundingBox.min + displacementMin, jointBoundingBox.max + displacementMax)) {
+            const fastgltf::math::fvec3 transformedPoint { jointMatrix * fastgltf::math::fvec4 { point.x(), point.y(), point.z(), 1.f } };
+            min = cwiseMin(min, transformedPoint);
+            max = cwiseMax(max, transformedPoint);
+        }
+    }
+
+    return { min, max };
+}
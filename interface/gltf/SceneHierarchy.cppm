@@ -68,6 +68,11 @@ namespace vk_gltf_viewer::gltf {
                     // objectlessRecursive
                     objectlessRecursive[nodeIndex] = isObjectlessRecursive;
 
+                    // cameraOrLightNodeIndices
+                    if (node.cameraIndex || node.lightIndex) {
+                        cameraOrLightNodeIndices.push_back(nodeIndex);
+                    }
+
                     updateVisibilityState(nodeIndex);
                 }(nodeIndex, 0, getTransformMatrix(asset.nodes[nodeIndex]));
             }
@@ -107,6 +112,14 @@ namespace vk_gltf_viewer::gltf {
             return objectlessRecursive[nodeIndex];
         }
 
+        /**
+         * @brief Get the indices of the nodes that have a camera or light in the scene.
+         * @return Node indices, without any specific order.
+         */
+        [[nodiscard]] std::span<const std::size_t> getCameraOrLightNodeIndices() const noexcept {
+            return cameraOrLightNodeIndices;
+        }
+
         /**
          * @brief Get the visibility of the node at \p nodeIndex.
          * @param nodeIndex Index of the node to get the visibility of.
@@ -295,6 +308,9 @@ namespace vk_gltf_viewer::gltf {
         /// Cached booleans whether each node and its descendants are all objectless (i.e., have no mesh, camera, or light).
         std::vector<bool> objectlessRecursive;
 
+        /// Indices of the nodes that have a camera or light.
+        std::vector<std::size_t> cameraOrLightNodeIndices;
+
         /// Visibility of each node that has a mesh.
         std::vector<bool> visibilities;
 
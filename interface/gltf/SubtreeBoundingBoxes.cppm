@@ -0,0 +1,283 @@
+module;
+
+#include <lifetimebound.hpp>
+
+export module vk_gltf_viewer.gltf.SubtreeBoundingBoxes;
+
+import std;
+export import BS.thread_pool;
+export import fastgltf;
+
+export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+export import vk_gltf_viewer.gltf.JointBoundingBoxes;
+export import vk_gltf_viewer.gltf.SceneHierarchy;
+import vk_gltf_viewer.helpers.fastgltf;
+import vk_gltf_viewer.helpers.ranges;
+
+namespace vk_gltf_viewer::gltf {
+    /**
+     * @brief Cached world space axis aligned bounding boxes of the mesh primitives in each node's subtree.
+     *
+     * Each node has two bounding boxes: one for the node's own mesh primitives, and one for the subtree (the node and
+     * its descendants). The cache is invalidated by <tt>invalidate()</tt> and <tt>invalidateHierarchical()</tt>, which
+     * only mark the affected nodes and their ancestors as dirty. The dirty bounding boxes are lazily recalculated when
+     * they are requested, therefore querying the bounding box of a subtree whose nodes are not changed costs O(1).
+     *
+     * Invariant: if a node's subtree bounding box is dirty, its ancestors' subtree bounding boxes are also dirty.
+     * Therefore, dirty nodes can be found by traversing only the dirty nodes from the subtree root.
+     */
+    export class SubtreeBoundingBoxes {
+    public:
+        SubtreeBoundingBoxes(
+            const fastgltf::Asset &asset LIFETIMEBOUND,
+            const SceneHierarchy &sceneHierarchy LIFETIMEBOUND,
+            const JointBoundingBoxes &jointBoundingBoxes LIFETIMEBOUND,
+            const AssetExternalBuffers &adapter
+        );
+
+        /**
+         * @brief Invalidate the bounding box of the node at \p nodeIndex, without its descendants.
+         *
+         * You must call this method when the node's world transform is changed without propagation, or its morph
+         * target weights are changed.
+         *
+         * @param nodeIndex Index of the node to be invalidated.
+         */
+        void invalidate(std::size_t nodeIndex);
+
+        /**
+         * @brief Invalidate the bounding boxes of the node at \p nodeIndex and its descendants.
+         *
+         * You must call this method when the world transforms of the node and its descendants are changed.
+         *
+         * @param nodeIndex Index of the node to be invalidated.
+         */
+        void invalidateHierarchical(std::size_t nodeIndex);
+
+        /**
+         * @brief Get the union of the world space bounding boxes of the subtrees whose roots are \p nodeIndices.
+         *
+         * If there are dirty bounding boxes in the subtrees, they are recalculated. Bounding boxes of the nodes' own
+         * mesh primitives are recalculated in parallel using \p threadPool, if there are enough number of them.
+         *
+         * @param nodeIndices Indices of the subtree root nodes.
+         * @param threadPool Thread pool to be used for recalculating the bounding boxes.
+         * @return Array of (min, max) of the bounding box. If there is no mesh primitive in the subtrees, min is
+         * greater than max.
+         */
+        [[nodiscard]] std::array<fastgltf::math::fvec3, 2> get(std::span<const std::size_t> nodeIndices, BS::thread_pool<> &threadPool);
+
+        /**
+         * @brief Append the world space bounding box corner points of the node's own mesh primitives to \p points.
+         *
+         * This function is thread-safe.
+         *
+         * @param nodeIndex Index of the node.
+         * @param points Vector to which the corner points are appended.
+         */
+        void appendPrimitiveBoundingBoxCornerPoints(std::size_t nodeIndex, std::vector<fastgltf::math::fvec3> &points) const;
+
+    private:
+        /**
+         * @brief Minimum number of dirty nodes to recalculate their own bounding boxes in parallel.
+         */
+        static constexpr std::size_t MIN_PARALLEL_NODE_COUNT = 256;
+
+        std::reference_wrapper<const fastgltf::Asset> asset;
+        std::reference_wrapper<const SceneHierarchy> sceneHierarchy;
+        std::reference_wrapper<const JointBoundingBoxes> jointBoundingBoxes;
+
+        /// Instance transforms of the nodes that are instanced by <tt>EXT_mesh_gpu_instancing</tt>.
+        std::unordered_map<std::size_t, std::vector<fastgltf::math::fmat4x4>> instanceTransforms;
+
+        /// Indices of the nodes that have a skinned mesh. Their bounding boxes are changed when any joint is moved.
+        std::vector<std::size_t> skinnedNodeIndices;
+
+        std::vector<std::array<fastgltf::math::fvec3, 2>> ownBoundingBoxes;
+        std::vector<std::array<fastgltf::math::fvec3, 2>> subtreeBoundingBoxes;
+        std::vector<bool> ownDirty;
+        std::vector<bool> subtreeDirty;
+
+        void markOwnDirty(std::size_t nodeIndex);
+        void markSubtreeDirty(std::size_t nodeIndex);
+        void invalidateSkinnedNodes();
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+const std::array EMPTY_BOUNDING_BOX {
+    fastgltf::math::fvec3(std::numeric_limits<float>::max()),
+    fastgltf::math::fvec3(std::numeric_limits<float>::lowest()),
+};
+
+vk_gltf_viewer::gltf::SubtreeBoundingBoxes::SubtreeBoundingBoxes(
+    const fastgltf::Asset &asset,
+    const SceneHierarchy &sceneHierarchy,
+    const JointBoundingBoxes &jointBoundingBoxes,
+    const AssetExternalBuffers &adapter
+) : asset { asset },
+    sceneHierarchy { sceneHierarchy },
+    jointBoundingBoxes { jointBoundingBoxes },
+    ownBoundingBoxes(asset.nodes.size(), EMPTY_BOUNDING_BOX),
+    subtreeBoundingBoxes(asset.nodes.size(), EMPTY_BOUNDING_BOX),
+    ownDirty(asset.nodes.size(), true),
+    subtreeDirty(asset.nodes.size(), true) {
+    for (const auto &[nodeIndex, node] : asset.nodes | ranges::views::enumerate) {
+        if (!node.meshIndex) continue;
+
+        if (!node.instancingAttributes.empty()) {
+            instanceTransforms.emplace(nodeIndex, getInstanceTransforms(asset, nodeIndex, adapter));
+        }
+        if (node.skinIndex) {
+            skinnedNodeIndices.push_back(nodeIndex);
+        }
+    }
+}
+
+void vk_gltf_viewer::gltf::SubtreeBoundingBoxes::invalidate(std::size_t nodeIndex) {
+    markOwnDirty(nodeIndex);
+    invalidateSkinnedNodes();
+}
+
+void vk_gltf_viewer::gltf::SubtreeBoundingBoxes::invalidateHierarchical(std::size_t nodeIndex) {
+    traverseNode(asset, nodeIndex, [this](std::size_t nodeIndex) {
+        ownDirty[nodeIndex] = true;
+        subtreeDirty[nodeIndex] = true;
+    });
+
+    // Descendants are already marked, only ancestors need to be marked.
+    if (auto parentNodeIndex = sceneHierarchy.get().getParentNodeIndex(nodeIndex)) {
+        markSubtreeDirty(*parentNodeIndex);
+    }
+    invalidateSkinnedNodes();
+}
+
+std::array<fastgltf::math::fvec3, 2> vk_gltf_viewer::gltf::SubtreeBoundingBoxes::get(
+    std::span<const std::size_t> nodeIndices,
+    BS::thread_pool<> &threadPool
+) {
+    // Collect the dirty nodes in preorder. As a clean node's descendants are all clean, traversal doesn't need to go
+    // further from it.
+    std::vector<std::size_t> dirtyNodeIndices;
+    for (std::size_t nodeIndex : nodeIndices) {
+        traverseNode(asset, nodeIndex, [&](std::size_t nodeIndex) {
+            if (!subtreeDirty[nodeIndex]) return false;
+            dirtyNodeIndices.push_back(nodeIndex);
+            return true;
+        });
+    }
+
+    if (!dirtyNodeIndices.empty()) {
+        // Recalculate the nodes' own bounding boxes, which is the most expensive part.
+        std::vector<std::size_t> ownDirtyNodeIndices;
+        for (std::size_t nodeIndex : dirtyNodeIndices) {
+            if (ownDirty[nodeIndex]) {
+                ownDirtyNodeIndices.push_back(nodeIndex);
+                ownDirty[nodeIndex] = false;
+            }
+        }
+
+        const auto updateOwnBoundingBoxes = [&](std::size_t start, std::size_t end) {
+            std::vector<fastgltf::math::fvec3> points;
+            for (std::size_t nodeIndex : std::span { ownDirtyNodeIndices }.subspan(start, end - start)) {
+                points.clear();
+                appendPrimitiveBoundingBoxCornerPoints(nodeIndex, points);
+
+                auto &[min, max] = ownBoundingBoxes[nodeIndex] = EMPTY_BOUNDING_BOX;
+                for (const fastgltf::math::fvec3 &point : points) {
+                    min = cwiseMin(min, point);
+                    max = cwiseMax(max, point);
+                }
+            }
+        };
+        if (ownDirtyNodeIndices.size() >= MIN_PARALLEL_NODE_COUNT) {
+            threadPool.submit_blocks(0UZ, ownDirtyNodeIndices.size(), updateOwnBoundingBoxes).wait();
+        }
+        else {
+            updateOwnBoundingBoxes(0, ownDirtyNodeIndices.size());
+        }
+
+        // Merge the bounding boxes bottom-up. In the reversed preorder, a node is always visited after its children.
+        for (std::size_t nodeIndex : dirtyNodeIndices | std::views::reverse) {
+            auto &[min, max] = subtreeBoundingBoxes[nodeIndex] = ownBoundingBoxes[nodeIndex];
+            for (std::size_t childNodeIndex : asset.get().nodes[nodeIndex].children) {
+                const auto &[childMin, childMax] = subtreeBoundingBoxes[childNodeIndex];
+                min = cwiseMin(min, childMin);
+                max = cwiseMax(max, childMax);
+            }
+            subtreeDirty[nodeIndex] = false;
+        }
+    }
+
+    std::array result = EMPTY_BOUNDING_BOX;
+    for (std::size_t nodeIndex : nodeIndices) {
+        const auto &[min, max] = subtreeBoundingBoxes[nodeIndex];
+        get<0>(result) = cwiseMin(get<0>(result), min);
+        get<1>(result) = cwiseMax(get<1>(result), max);
+    }
+    return result;
+}
+
+void vk_gltf_viewer::gltf::SubtreeBoundingBoxes::appendPrimitiveBoundingBoxCornerPoints(
+    std::size_t nodeIndex,
+    std::vector<fastgltf::math::fvec3> &points
+) const {
+    const fastgltf::Node &node = asset.get().nodes[nodeIndex];
+    if (!node.meshIndex) return;
+
+    const fastgltf::math::fmat4x4 &worldTransform = sceneHierarchy.get().getWorldTransform(nodeIndex);
+    const auto appendTransformedBoundingBoxPoints = [&](const fastgltf::math::fmat4x4 &instanceTransform) {
+        for (const fastgltf::Primitive &primitive : asset.get().meshes[*node.meshIndex].primitives) {
+            std::array<fastgltf::math::fvec3, 8> cornerPoints;
+            fastgltf::math::fmat4x4 transform;
+            if (node.skinIndex && jointBoundingBoxes.get().contains(primitive)) {
+                // Skinned primitive's bounding box is already in the world space, therefore only the instance
+                // transform is applied.
+                const auto [min, max] = jointBoundingBoxes.get().getWorldBoundingBoxMinMax(primitive, node, sceneHierarchy.get().getWorldTransforms());
+                cornerPoints = fastgltf::getBoundingBoxCornerPoints(min, max);
+                transform = instanceTransform;
+            }
+            else {
+                cornerPoints = getBoundingBoxCornerPoints(primitive, node, asset);
+                transform = worldTransform * instanceTransform;
+            }
+
+            for (const fastgltf::math::fvec3 &point : cornerPoints) {
+                points.emplace_back(transform * fastgltf::math::fvec4 { point.x(), point.y(), point.z(), 1.f });
+            }
+        }
+    };
+
+    if (auto it = instanceTransforms.find(nodeIndex); it != instanceTransforms.end()) {
+        for (const fastgltf::math::fmat4x4 &instanceTransform : it->second) {
+            appendTransformedBoundingBoxPoints(instanceTransform);
+        }
+    }
+    else {
+        appendTransformedBoundingBoxPoints({});
+    }
+}
+
+void vk_gltf_viewer::gltf::SubtreeBoundingBoxes::markOwnDirty(std::size_t nodeIndex) {
+    ownDirty[nodeIndex] = true;
+    markSubtreeDirty(nodeIndex);
+}
+
+void vk_gltf_viewer::gltf::SubtreeBoundingBoxes::markSubtreeDirty(std::size_t nodeIndex) {
+    // Mark the node and its ancestors' subtree bounding boxes as dirty. If a node is already dirty, its ancestors are
+    // also dirty by the invariant.
+    for (std::optional<std::size_t> current = nodeIndex; current && !subtreeDirty[*current]; current = sceneHierarchy.get().getParentNodeIndex(*current)) {
+        subtreeDirty[*current] = true;
+    }
+}
+
+void vk_gltf_viewer::gltf::SubtreeBoundingBoxes::invalidateSkinnedNodes() {
+    // Skinned mesh bounding box depends on its joints' world transforms, not the node's. As finding the skinned nodes
+    // affected by the joint is not trivial, all of them are invalidated.
+    for (std::size_t nodeIndex : skinnedNodeIndices) {
+        markOwnDirty(nodeIndex);
+    }
+}
@@ -0,0 +1,171 @@
+module;
+
+#include <meshoptimizer.h>
+
+export module vk_gltf_viewer.gltf.algorithm.levelOfDetail;
+
+import std;
+import BS.thread_pool;
+export import fastgltf;
+
+export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+
+namespace vk_gltf_viewer::gltf::algorithm {
+    export struct LevelOfDetail {
+        /**
+         * @brief Triangle list indices that are referencing the primitive's vertices.
+         */
+        std::vector<std::uint32_t> indices;
+
+        /**
+         * @brief Simplification error (deviation from the original surface), relative to the radius of the primitive's
+         * bounding sphere.
+         *
+         * As the bounding sphere is scaled by the node transform together with the error, the screen space error can be
+         * calculated by multiplying it with the projected bounding sphere radius.
+         */
+        float error;
+    };
+
+    /**
+     * @brief Generate the level of detail (LOD) chains of the indexed triangle list primitives in \p asset.
+     *
+     * Each level targets the half of its previous level's index count, and is simplified from the previous level by
+     * <tt>meshopt_simplify</tt>, which preserves the attribute seams (vertices that share a position but have the
+     * distinct indices). The border of the skinned primitive is locked, as joint influences are not considered by the
+     * simplification. If the topology prevents the simplification of a non-skinned primitive,
+     * <tt>meshopt_simplifySloppy</tt> is used instead. Primitives with morph targets are skipped, as their error cannot
+     * be bounded by the base positions.
+     *
+     * Each primitive is simplified as an independent thread pool task.
+     *
+     * @param asset Asset whose primitives to be simplified.
+     * @param externalBuffers Buffer data adapter of \p asset.
+     * @param threadPool Thread pool to run the simplification.
+     * @return Map of primitive -> its level of details, ordered from the finest to the coarsest. The primitive's own
+     * indices are not included, and the primitive that is too small to be simplified is not contained.
+     */
+    export
+    [[nodiscard]] std::unordered_map<const fastgltf::Primitive*, std::vector<LevelOfDetail>> generateLevelOfDetails(
+        const fastgltf::Asset &asset,
+        const AssetExternalBuffers &externalBuffers,
+        BS::thread_pool<> &threadPool
+    );
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+/// Maximum number of the level of details per primitive, excluding the primitive's own indices.
+constexpr std::size_t maxLevelOfDetailCount = 7;
+
+/// Primitive whose index count is less than this is not simplified, as the draw call overhead dominates.
+constexpr std::size_t minSimplificationIndexCount = 3 * 1024;
+
+/// Simplification chain stops when the index count becomes less than this.
+constexpr std::size_t minLevelOfDetailIndexCount = 3 * 64;
+
+[[nodiscard]] std::vector<vk_gltf_viewer::gltf::algorithm::LevelOfDetail> generatePrimitiveLevelOfDetails(
+    const fastgltf::Asset &asset,
+    const fastgltf::Primitive &primitive,
+    const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers
+) {
+    const fastgltf::Accessor &positionAccessor = asset.accessors[primitive.findAttribute("POSITION")->accessorIndex];
+    std::vector<fastgltf::math::fvec3> positions(positionAccessor.count);
+    fastgltf::copyFromAccessor<fastgltf::math::fvec3>(asset, positionAccessor, positions.data(), externalBuffers);
+
+    const fastgltf::Accessor &indexAccessor = asset.accessors[*primitive.indicesAccessor];
+    std::vector<std::uint32_t> indices(indexAccessor.count);
+    fastgltf::copyFromAccessor<std::uint32_t>(asset, indexAccessor, indices.data(), externalBuffers);
+
+    // Radius of the bounding sphere that encloses the position AABB, which is same as the frustum culling.
+    constexpr float floatMax = std::numeric_limits<float>::max();
+    fastgltf::math::fvec3 min { floatMax, floatMax, floatMax }, max { -floatMax, -floatMax, -floatMax };
+    for (const fastgltf::math::fvec3 &position : positions) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            min[i] = std::min(min[i], position[i]);
+            max[i] = std::max(max[i], position[i]);
+        }
+    }
+    const float radius = length(max - min) / 2.f;
+    if (!(radius > 0.f)) {
+        return {};
+    }
+
+    // meshopt_simplify* reports the error relative to the mesh extent.
+    const float errorScale = meshopt_simplifyScale(positions.data()->data(), positions.size(), sizeof(fastgltf::math::fvec3)) / radius;
+    const bool skinned = primitive.findAttribute("JOINTS_0") != primitive.attributes.end();
+
+    std::vector<vk_gltf_viewer::gltf::algorithm::LevelOfDetail> result;
+    result.reserve(maxLevelOfDetailCount);
+
+    std::span<const std::uint32_t> sourceIndices = indices;
+    float accumulatedError = 0.f;
+    while (result.size() < maxLevelOfDetailCount) {
+        const std::size_t targetIndexCount = sourceIndices.size() / 6 * 3;
+        if (targetIndexCount < minLevelOfDetailIndexCount) break;
+
+        std::vector<std::uint32_t> simplifiedIndices(sourceIndices.size());
+        float error;
+        simplifiedIndices.resize(meshopt_simplify(
+            simplifiedIndices.data(), sourceIndices.data(), sourceIndices.size(),
+            positions.data()->data(), positions.size(), sizeof(fastgltf::math::fvec3),
+            targetIndexCount, 1.f /* error is bounded by the screen space selection */,
+            skinned ? meshopt_SimplifyLockBorder : 0U, &error));
+
+        if (!skinned && simplifiedIndices.size() > targetIndexCount * 3 / 2) {
+            // Topology (e.g. many disconnected parts) prevents the simplification. Sloppy simplification ignores it
+            // in exchange of the seam preservation.
+            simplifiedIndices.resize(sourceIndices.size());
+            simplifiedIndices.resize(meshopt_simplifySloppy(
+                simplifiedIndices.data(), sourceIndices.data(), sourceIndices.size(),
+                positions.data()->data(), positions.size(), sizeof(fastgltf::math::fvec3),
+                targetIndexCount, std::numeric_limits<float>::max(), &error));
+        }
+
+        // Stop if the level is not meaningfully coarser than the previous level.
+        if (simplifiedIndices.empty() || simplifiedIndices.size() > sourceIndices.size() * 9 / 10) break;
+
+        meshopt_optimizeVertexCache(simplifiedIndices.data(), simplifiedIndices.data(), simplifiedIndices.size(), positions.size());
+
+        // Each level is simplified from its previous level, therefore the error is accumulated.
+        accumulatedError += error;
+        sourceIndices = result.emplace_back(std::move(simplifiedIndices), accumulatedError * errorScale).indices;
+    }
+
+    return result;
+}
+
+std::unordered_map<const fastgltf::Primitive*, std::vector<vk_gltf_viewer::gltf::algorithm::LevelOfDetail>> vk_gltf_viewer::gltf::algorithm::generateLevelOfDetails(
+    const fastgltf::Asset &asset,
+    const AssetExternalBuffers &externalBuffers,
+    BS::thread_pool<> &threadPool
+) {
+    std::vector<const fastgltf::Primitive*> candidates;
+    for (const fastgltf::Mesh &mesh : asset.meshes) {
+        for (const fastgltf::Primitive &primitive : mesh.primitives) {
+            if (primitive.type != fastgltf::PrimitiveType::Triangles ||
+                !primitive.indicesAccessor ||
+                !primitive.targets.empty() ||
+                primitive.findAttribute("POSITION") == primitive.attributes.end() ||
+                asset.accessors[*primitive.indicesAccessor].count < minSimplificationIndexCount) {
+                continue;
+            }
+
+            candidates.push_back(&primitive);
+        }
+    }
+
+    std::vector levelOfDetails = threadPool.submit_sequence(0UZ, candidates.size(), [&](std::size_t i) {
+        return generatePrimitiveLevelOfDetails(asset, *candidates[i], externalBuffers);
+    }).get();
+
+    std::unordered_map<const fastgltf::Primitive*, std::vector<LevelOfDetail>> result;
+    for (auto &&[primitive, primitiveLevelOfDetails] : std::views::zip(candidates, levelOfDetails)) {
+        if (!primitiveLevelOfDetails.empty()) {
+            result.emplace(primitive, std::move(primitiveLevelOfDetails));
+        }
+    }
+    return result;
+}
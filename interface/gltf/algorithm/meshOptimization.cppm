@@ -0,0 +1,547 @@
+module;
+
+#include <meshoptimizer.h>
+
+export module vk_gltf_viewer.gltf.algorithm.meshOptimization;
+
+import std;
+import BS.thread_pool;
+export import fastgltf;
+
+export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+import vk_gltf_viewer.helpers.io;
+
+namespace vk_gltf_viewer::gltf::algorithm {
+    export struct MeshOptimizationStatistics {
+        std::size_t optimizedPrimitiveCount;
+
+        /**
+         * @brief Number of the primitives that are not optimized because they are not triangle lists, or their
+         * accessors are sparse or shared with the other primitives.
+         */
+        std::size_t skippedPrimitiveCount;
+
+        /**
+         * @brief Average cache miss ratio (transformed vertices per triangle) of the optimized primitives, before and
+         * after the optimization.
+         */
+        float acmrBefore, acmrAfter;
+
+        /**
+         * @brief Vertex fetch overfetch ratio (fetched bytes per vertex data bytes) of the optimized primitives'
+         * position streams, before and after the optimization.
+         */
+        float overfetchBefore, overfetchAfter;
+
+        /**
+         * @brief Whether the optimized orders are loaded from the cache.
+         */
+        bool cacheHit;
+
+        std::chrono::duration<float, std::milli> time;
+    };
+
+    /**
+     * @brief Reorder the indices and vertices of the triangle list primitives in \p asset for the better post-transform
+     * vertex cache, overdraw and vertex fetch efficiency.
+     *
+     * Each primitive is optimized as an independent thread pool task by <tt>meshopt_optimizeVertexCache</tt>,
+     * <tt>meshopt_optimizeOverdraw</tt> and <tt>meshopt_optimizeVertexFetchRemap</tt>. Non-indexed primitives are
+     * indexed by deduplicating their vertices first. The same vertex remap is applied to all attributes (including the
+     * morph targets), and the primitive's accessors are redirected to the newly appended buffer (one per primitive)
+     * that contains the reordered data.
+     *
+     * Optimized orders are cached in \p cacheDirectory, keyed by the hash of the primitives' geometry, therefore
+     * reloading the same asset only costs the data reordering.
+     *
+     * @param asset Asset to be optimized.
+     * @param externalBuffers Buffer data adapter of \p asset. Appended buffer views are registered to it.
+     * @param cacheDirectory Directory to read and write the cache. Failure to write the cache is ignored.
+     * @param threadPool Thread pool to run the optimization.
+     * @return Statistics of the optimization.
+     */
+    export
+    [[nodiscard]] MeshOptimizationStatistics optimizeMeshes(
+        fastgltf::Asset &asset,
+        AssetExternalBuffers &externalBuffers,
+        const std::filesystem::path &cacheDirectory,
+        BS::thread_pool<> &threadPool
+    );
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+struct MeshOptimizationCandidate {
+    struct VertexStream {
+        std::size_t accessorIndex;
+        std::span<const std::byte> data;
+        std::size_t elementByteSize;
+        std::size_t byteStride;
+    };
+
+    fastgltf::Primitive *primitive;
+    std::size_t positionAccessorIndex;
+    std::size_t vertexCount;
+    std::size_t indexCount;
+
+    /**
+     * @brief Vertex attribute and morph target attribute streams, which share the same vertex remap.
+     */
+    std::vector<VertexStream> vertexStreams;
+};
+
+/**
+ * @brief Optimized orders of a primitive, which are stored in the cache.
+ */
+struct MeshOptimizationOrder {
+    /**
+     * @brief Reordered indices that are referencing the remapped vertices.
+     */
+    std::vector<std::uint32_t> indices;
+
+    /**
+     * @brief Original vertex index -> remapped vertex index, or <tt>~0U</tt> if the vertex is not referenced.
+     */
+    std::vector<std::uint32_t> remap;
+
+    std::uint32_t vertexCount;
+};
+
+struct OptimizedPrimitive {
+    struct Region {
+        std::size_t byteOffset;
+        std::size_t byteLength;
+        std::optional<std::size_t> byteStride;
+    };
+
+    decltype(fastgltf::sources::Array::bytes) bytes;
+    std::vector<Region> vertexRegions;
+    Region indexRegion;
+    fastgltf::ComponentType indexComponentType;
+    std::uint32_t vertexCount;
+
+    // For the statistics.
+    std::size_t cacheMissesBefore, cacheMissesAfter;
+    std::size_t bytesFetchedBefore, bytesFetchedAfter;
+    std::size_t vertexBytesBefore, vertexBytesAfter;
+};
+
+constexpr std::uint32_t meshOptimizationCacheVersion = 2;
+
+[[nodiscard]] std::optional<MeshOptimizationCandidate> getMeshOptimizationCandidate(
+    const fastgltf::Asset &asset,
+    fastgltf::Primitive &primitive,
+    const std::unordered_map<std::size_t, std::size_t> &accessorReferenceCounts,
+    const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers
+) {
+    if (primitive.type != fastgltf::PrimitiveType::Triangles) return std::nullopt;
+
+    const auto positionIt = primitive.findAttribute("POSITION");
+    if (positionIt == primitive.attributes.end()) return std::nullopt;
+
+    const auto isExclusiveDenseAccessor = [&](std::size_t accessorIndex) {
+        const fastgltf::Accessor &accessor = asset.accessors[accessorIndex];
+        return accessorReferenceCounts.at(accessorIndex) == 1 && accessor.bufferViewIndex && !accessor.sparse;
+    };
+
+    MeshOptimizationCandidate result {
+        .primitive = &primitive,
+        .positionAccessorIndex = positionIt->accessorIndex,
+        .vertexCount = asset.accessors[positionIt->accessorIndex].count,
+    };
+
+    const auto appendVertexStream = [&](std::size_t accessorIndex) {
+        if (!isExclusiveDenseAccessor(accessorIndex)) return false;
+
+        const fastgltf::Accessor &accessor = asset.accessors[accessorIndex];
+        if (accessor.count != result.vertexCount) return false;
+
+        const std::size_t elementByteSize = getElementByteSize(accessor.type, accessor.componentType);
+        const std::size_t byteStride = asset.bufferViews[*accessor.bufferViewIndex].byteStride.value_or(elementByteSize);
+        if (byteStride > 256) return false; // meshopt_Stream limitation.
+
+        result.vertexStreams.emplace_back(
+            accessorIndex,
+            externalBuffers(asset, *accessor.bufferViewIndex).subspan(accessor.byteOffset),
+            elementByteSize,
+            byteStride);
+        return true;
+    };
+
+    for (const fastgltf::Attribute &attribute : primitive.attributes) {
+        if (!appendVertexStream(attribute.accessorIndex)) return std::nullopt;
+    }
+    for (const auto &target : primitive.targets) {
+        for (const fastgltf::Attribute &attribute : target) {
+            if (!appendVertexStream(attribute.accessorIndex)) return std::nullopt;
+        }
+    }
+
+    if (primitive.indicesAccessor) {
+        if (!isExclusiveDenseAccessor(*primitive.indicesAccessor)) return std::nullopt;
+        result.indexCount = asset.accessors[*primitive.indicesAccessor].count;
+    }
+    else {
+        result.indexCount = result.vertexCount;
+    }
+
+    if (result.vertexCount == 0 || result.vertexCount > std::numeric_limits<std::uint32_t>::max() ||
+        result.indexCount == 0 || result.indexCount % 3 != 0) {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Hash the geometry of \p candidates by 64-bit FNV-1a.
+ *
+ * As the hash is persisted as the cache file name, it must be stable across the runs, standard library
+ * implementations and platforms, unlike <tt>std::hash</tt>.
+ */
+[[nodiscard]] std::uint64_t hashMeshOptimizationCandidates(const fastgltf::Asset &asset, std::span<const MeshOptimizationCandidate> candidates, const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL; // FNV offset basis.
+    const auto hashBytes = [&](std::span<const std::byte> bytes) {
+        for (std::byte byte : bytes) {
+            hash ^= static_cast<std::uint64_t>(byte);
+            hash *= 0x100000001B3ULL; // FNV prime.
+        }
+    };
+    const auto hashInteger = [&](std::uint64_t value) {
+        // Little endian representation, regardless of the platform.
+        std::array<std::byte, 8> bytes;
+        for (std::size_t i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<std::byte>(value >> (8 * i));
+        }
+        hashBytes(bytes);
+    };
+
+    hashInteger(meshOptimizationCacheVersion);
+    for (const MeshOptimizationCandidate &candidate : candidates) {
+        hashInteger(candidate.vertexCount);
+        hashInteger(candidate.indexCount);
+
+        // Only the positions and indices affect the optimized orders, except the vertex deduplication of the
+        // non-indexed primitive.
+        for (const auto &stream : candidate.vertexStreams) {
+            if (stream.accessorIndex == candidate.positionAccessorIndex || !candidate.primitive->indicesAccessor) {
+                hashBytes(stream.data.first(stream.byteStride * (candidate.vertexCount - 1) + stream.elementByteSize));
+            }
+        }
+        if (const auto &indicesAccessor = candidate.primitive->indicesAccessor) {
+            const fastgltf::Accessor &accessor = asset.accessors[*indicesAccessor];
+            hashBytes(externalBuffers(asset, *accessor.bufferViewIndex).subspan(accessor.byteOffset, getElementByteSize(accessor.type, accessor.componentType) * accessor.count));
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Read the cached orders of \p candidates.
+ * @return Cached orders, or empty vector if the cache does not exist, mismatches to \p candidates or has the out of
+ * range indices (e.g. corrupted or hash collided).
+ */
+[[nodiscard]] std::vector<MeshOptimizationOrder> readMeshOptimizationCache(const std::filesystem::path &path, std::span<const MeshOptimizationCandidate> candidates) try {
+    if (!std::filesystem::exists(path)) return {};
+
+    const std::vector<std::byte> bytes = loadFileAsBinary(path);
+    std::size_t offset = 0;
+    const auto read = [&](void *dst, std::size_t size) {
+        if (offset + size > bytes.size()) throw std::out_of_range { "Truncated mesh optimization cache" };
+        std::memcpy(dst, bytes.data() + offset, size);
+        offset += size;
+    };
+
+    std::uint64_t candidateCount;
+    read(&candidateCount, sizeof(candidateCount));
+    if (candidateCount != candidates.size()) return {};
+
+    std::vector<MeshOptimizationOrder> result;
+    result.reserve(candidates.size());
+    for (const MeshOptimizationCandidate &candidate : candidates) {
+        MeshOptimizationOrder &order = result.emplace_back();
+        order.indices.resize(candidate.indexCount);
+        order.remap.resize(candidate.vertexCount);
+        read(&order.vertexCount, sizeof(order.vertexCount));
+        read(order.indices.data(), sizeof(std::uint32_t) * order.indices.size());
+        read(order.remap.data(), sizeof(std::uint32_t) * order.remap.size());
+
+        // The orders are used for indexing without the bound check, therefore they must be validated.
+        if (order.vertexCount > candidate.vertexCount ||
+            std::ranges::any_of(order.remap, [&](std::uint32_t index) { return index >= order.vertexCount && index != ~0U; }) ||
+            std::ranges::any_of(order.indices, [&](std::uint32_t index) { return index >= order.vertexCount; })) {
+            return {};
+        }
+    }
+    if (offset != bytes.size()) return {};
+
+    return result;
+}
+catch (const std::exception&) {
+    // Unreadable cache is regarded as cache miss.
+    return {};
+}
+
+void writeMeshOptimizationCache(const std::filesystem::path &path, std::span<const MeshOptimizationOrder> orders) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec) return;
+
+    std::ofstream file { path, std::ios::binary };
+    const auto write = [&](const void *src, std::size_t size) {
+        file.write(static_cast<const char*>(src), size);
+    };
+
+    const std::uint64_t candidateCount = orders.size();
+    write(&candidateCount, sizeof(candidateCount));
+    for (const MeshOptimizationOrder &order : orders) {
+        write(&order.vertexCount, sizeof(order.vertexCount));
+        write(order.indices.data(), sizeof(std::uint32_t) * order.indices.size());
+        write(order.remap.data(), sizeof(std::uint32_t) * order.remap.size());
+    }
+}
+
+[[nodiscard]] std::vector<std::uint32_t> getOriginalIndices(const fastgltf::Asset &asset, const MeshOptimizationCandidate &candidate, const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers) {
+    std::vector<std::uint32_t> result(candidate.indexCount);
+    if (const auto &indicesAccessor = candidate.primitive->indicesAccessor) {
+        fastgltf::copyFromAccessor<std::uint32_t>(asset, asset.accessors[*indicesAccessor], result.data(), externalBuffers);
+        if (std::ranges::any_of(result, [&](std::uint32_t index) { return index >= candidate.vertexCount; })) {
+            throw std::runtime_error { "Primitive index exceeds the vertex count." };
+        }
+    }
+    else {
+        std::iota(result.begin(), result.end(), 0U);
+    }
+    return result;
+}
+
+[[nodiscard]] MeshOptimizationOrder getMeshOptimizationOrder(const fastgltf::Asset &asset, const MeshOptimizationCandidate &candidate, std::vector<std::uint32_t> indices, const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers) {
+    MeshOptimizationOrder result {
+        .indices = std::move(indices),
+        .remap = std::vector<std::uint32_t>(candidate.vertexCount),
+    };
+
+    // Deduplicate the vertices of the non-indexed primitive by all vertex streams, so that the vertex cache can be
+    // utilized.
+    std::size_t uniqueVertexCount = candidate.vertexCount;
+    if (!candidate.primitive->indicesAccessor) {
+        const std::vector streams
+            = candidate.vertexStreams
+            | std::views::transform([](const MeshOptimizationCandidate::VertexStream &stream) {
+                return meshopt_Stream { stream.data.data(), stream.elementByteSize, stream.byteStride };
+            })
+            | std::ranges::to<std::vector>();
+        uniqueVertexCount = meshopt_generateVertexRemapMulti(result.remap.data(), nullptr, candidate.vertexCount, candidate.vertexCount, streams.data(), streams.size());
+        result.indices = result.remap;
+    }
+    else {
+        std::iota(result.remap.begin(), result.remap.end(), 0U);
+    }
+
+    std::vector<fastgltf::math::fvec3> positions(uniqueVertexCount);
+    fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(asset, asset.accessors[candidate.positionAccessorIndex], [&](const fastgltf::math::fvec3 &position, std::size_t i) {
+        positions[result.remap[i]] = position;
+    }, externalBuffers);
+
+    meshopt_optimizeVertexCache(result.indices.data(), result.indices.data(), result.indices.size(), uniqueVertexCount);
+    meshopt_optimizeOverdraw(result.indices.data(), result.indices.data(), result.indices.size(), positions.data()->data(), uniqueVertexCount, sizeof(fastgltf::math::fvec3), 1.05f);
+
+    std::vector<std::uint32_t> fetchRemap(uniqueVertexCount);
+    result.vertexCount = meshopt_optimizeVertexFetchRemap(fetchRemap.data(), result.indices.data(), result.indices.size(), uniqueVertexCount);
+    meshopt_remapIndexBuffer(result.indices.data(), result.indices.data(), result.indices.size(), fetchRemap.data());
+    for (std::uint32_t &index : result.remap) {
+        index = fetchRemap[index];
+    }
+
+    return result;
+}
+
+[[nodiscard]] OptimizedPrimitive getOptimizedPrimitive(const MeshOptimizationCandidate &candidate, const std::vector<std::uint32_t> &originalIndices, const MeshOptimizationOrder &order) {
+    OptimizedPrimitive result {
+        .indexComponentType = order.vertexCount <= std::numeric_limits<std::uint16_t>::max() + 1U
+            ? fastgltf::ComponentType::UnsignedShort : fastgltf::ComponentType::UnsignedInt,
+        .vertexCount = order.vertexCount,
+    };
+
+    // Layout the vertex streams and indices in the buffer.
+    std::size_t byteLength = 0;
+    for (const auto &stream : candidate.vertexStreams) {
+        // glTF 2.0 specification:
+        //   For performance and compatibility reasons, each element of a vertex attribute MUST be aligned to 4-byte
+        //   boundaries inside a bufferView (i.e., accessor.byteOffset and bufferView.byteStride MUST be multiples
+        //   of 4).
+        //   https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#data-alignment
+        std::optional<std::size_t> byteStride;
+        if (stream.elementByteSize % 4 != 0) {
+            byteStride.emplace((stream.elementByteSize / 4 + 1) * 4);
+        }
+
+        auto &region = result.vertexRegions.emplace_back(byteLength, byteStride.value_or(stream.elementByteSize) * order.vertexCount, byteStride);
+        byteLength += region.byteLength;
+    }
+
+    const std::size_t indexByteSize = result.indexComponentType == fastgltf::ComponentType::UnsignedShort ? 2 : 4;
+    result.indexRegion = { byteLength, indexByteSize * order.indices.size(), std::nullopt };
+    byteLength += result.indexRegion.byteLength;
+
+    // Write the remapped vertex streams and indices.
+    result.bytes = decltype(result.bytes)(byteLength);
+    std::byte* const bytes = reinterpret_cast<std::byte*>(result.bytes.data());
+    for (const auto &[stream, region] : std::views::zip(candidate.vertexStreams, result.vertexRegions)) {
+        const std::size_t dstByteStride = region.byteStride.value_or(stream.elementByteSize);
+        for (std::size_t i = 0; i < candidate.vertexCount; ++i) {
+            if (order.remap[i] == ~0U) continue; // Unreferenced vertex.
+            std::memcpy(bytes + region.byteOffset + dstByteStride * order.remap[i], stream.data.data() + stream.byteStride * i, stream.elementByteSize);
+        }
+    }
+    if (result.indexComponentType == fastgltf::ComponentType::UnsignedShort) {
+        std::ranges::copy(
+            order.indices | std::views::transform([](std::uint32_t index) { return static_cast<std::uint16_t>(index); }),
+            reinterpret_cast<std::uint16_t*>(bytes + result.indexRegion.byteOffset));
+    }
+    else {
+        std::ranges::copy(order.indices, reinterpret_cast<std::uint32_t*>(bytes + result.indexRegion.byteOffset));
+    }
+
+    // Statistics, with the common GPU's parameters (16-entry FIFO cache). Vertex fetch is analyzed for the position
+    // stream, as it is fetched by every pass.
+    const std::size_t positionByteSize = std::ranges::find(candidate.vertexStreams, candidate.positionAccessorIndex, &MeshOptimizationCandidate::VertexStream::accessorIndex)->elementByteSize;
+    const meshopt_VertexCacheStatistics cacheBefore = meshopt_analyzeVertexCache(originalIndices.data(), originalIndices.size(), candidate.vertexCount, 16, 0, 0);
+    const meshopt_VertexCacheStatistics cacheAfter = meshopt_analyzeVertexCache(order.indices.data(), order.indices.size(), order.vertexCount, 16, 0, 0);
+    const meshopt_VertexFetchStatistics fetchBefore = meshopt_analyzeVertexFetch(originalIndices.data(), originalIndices.size(), candidate.vertexCount, positionByteSize);
+    const meshopt_VertexFetchStatistics fetchAfter = meshopt_analyzeVertexFetch(order.indices.data(), order.indices.size(), order.vertexCount, positionByteSize);
+    result.cacheMissesBefore = cacheBefore.vertices_transformed;
+    result.cacheMissesAfter = cacheAfter.vertices_transformed;
+    result.bytesFetchedBefore = fetchBefore.bytes_fetched;
+    result.bytesFetchedAfter = fetchAfter.bytes_fetched;
+    result.vertexBytesBefore = positionByteSize * candidate.vertexCount;
+    result.vertexBytesAfter = positionByteSize * order.vertexCount;
+
+    return result;
+}
+
+vk_gltf_viewer::gltf::algorithm::MeshOptimizationStatistics vk_gltf_viewer::gltf::algorithm::optimizeMeshes(
+    fastgltf::Asset &asset,
+    AssetExternalBuffers &externalBuffers,
+    const std::filesystem::path &cacheDirectory,
+    BS::thread_pool<> &threadPool
+) {
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Vertex remap can only be applied if the accessors are exclusively used by the primitive.
+    std::unordered_map<std::size_t, std::size_t> accessorReferenceCounts;
+    std::size_t primitiveCount = 0;
+    for (const fastgltf::Mesh &mesh : asset.meshes) {
+        for (const fastgltf::Primitive &primitive : mesh.primitives) {
+            ++primitiveCount;
+            for (const fastgltf::Attribute &attribute : primitive.attributes) {
+                ++accessorReferenceCounts[attribute.accessorIndex];
+            }
+            for (const auto &target : primitive.targets) {
+                for (const fastgltf::Attribute &attribute : target) {
+                    ++accessorReferenceCounts[attribute.accessorIndex];
+                }
+            }
+            if (primitive.indicesAccessor) {
+                ++accessorReferenceCounts[*primitive.indicesAccessor];
+            }
+        }
+    }
+
+    std::vector<MeshOptimizationCandidate> candidates;
+    for (fastgltf::Mesh &mesh : asset.meshes) {
+        for (fastgltf::Primitive &primitive : mesh.primitives) {
+            if (auto candidate = getMeshOptimizationCandidate(asset, primitive, accessorReferenceCounts, externalBuffers)) {
+                candidates.push_back(std::move(*candidate));
+            }
+        }
+    }
+
+    MeshOptimizationStatistics result {
+        .optimizedPrimitiveCount = candidates.size(),
+        .skippedPrimitiveCount = primitiveCount - candidates.size(),
+    };
+    if (candidates.empty()) {
+        result.time = std::chrono::steady_clock::now() - startTime;
+        return result;
+    }
+
+    const std::filesystem::path cachePath = cacheDirectory / std::format("{:016x}.meshopt", hashMeshOptimizationCandidates(asset, candidates, externalBuffers));
+    std::vector<MeshOptimizationOrder> orders = readMeshOptimizationCache(cachePath, candidates);
+    result.cacheHit = !orders.empty();
+    if (!result.cacheHit) {
+        orders.resize(candidates.size());
+    }
+
+    std::vector optimizedPrimitives = threadPool.submit_sequence(0UZ, candidates.size(), [&](std::size_t i) {
+        std::vector<std::uint32_t> originalIndices = getOriginalIndices(asset, candidates[i], externalBuffers);
+        if (!result.cacheHit) {
+            orders[i] = getMeshOptimizationOrder(asset, candidates[i], originalIndices, externalBuffers);
+        }
+        return getOptimizedPrimitive(candidates[i], originalIndices, orders[i]);
+    }).get();
+
+    if (!result.cacheHit) {
+        writeMeshOptimizationCache(cachePath, orders);
+    }
+
+    // Append the buffers and buffer views, and redirect the accessors to them.
+    std::size_t triangleCount = 0, cacheMissesBefore = 0, cacheMissesAfter = 0;
+    std::size_t bytesFetchedBefore = 0, bytesFetchedAfter = 0, vertexBytesBefore = 0, vertexBytesAfter = 0;
+    for (auto &&[candidate, optimizedPrimitive] : std::views::zip(candidates, optimizedPrimitives)) {
+        const std::size_t bufferIndex = asset.buffers.size();
+        fastgltf::Buffer &buffer = asset.buffers.emplace_back();
+        buffer.byteLength = optimizedPrimitive.bytes.size();
+        buffer.data = fastgltf::sources::Array { std::move(optimizedPrimitive.bytes), fastgltf::MimeType::GltfBuffer };
+
+        const auto appendBufferView = [&](const OptimizedPrimitive::Region &region) {
+            fastgltf::BufferView &bufferView = asset.bufferViews.emplace_back();
+            bufferView.bufferIndex = bufferIndex;
+            bufferView.byteOffset = region.byteOffset;
+            bufferView.byteLength = region.byteLength;
+            if (region.byteStride) {
+                bufferView.byteStride = *region.byteStride;
+            }
+            return asset.bufferViews.size() - 1;
+        };
+
+        for (const auto &[stream, region] : std::views::zip(candidate.vertexStreams, optimizedPrimitive.vertexRegions)) {
+            fastgltf::Accessor &accessor = asset.accessors[stream.accessorIndex];
+            accessor.bufferViewIndex = appendBufferView(region);
+            accessor.byteOffset = 0;
+            accessor.count = optimizedPrimitive.vertexCount;
+        }
+
+        fastgltf::Accessor *indexAccessor;
+        if (candidate.primitive->indicesAccessor) {
+            indexAccessor = &asset.accessors[*candidate.primitive->indicesAccessor];
+        }
+        else {
+            indexAccessor = &asset.accessors.emplace_back();
+            indexAccessor->type = fastgltf::AccessorType::Scalar;
+            indexAccessor->count = candidate.indexCount;
+            candidate.primitive->indicesAccessor = asset.accessors.size() - 1;
+        }
+        indexAccessor->componentType = optimizedPrimitive.indexComponentType;
+        indexAccessor->bufferViewIndex = appendBufferView(optimizedPrimitive.indexRegion);
+        indexAccessor->byteOffset = 0;
+
+        triangleCount += candidate.indexCount / 3;
+        cacheMissesBefore += optimizedPrimitive.cacheMissesBefore;
+        cacheMissesAfter += optimizedPrimitive.cacheMissesAfter;
+        bytesFetchedBefore += optimizedPrimitive.bytesFetchedBefore;
+        bytesFetchedAfter += optimizedPrimitive.bytesFetchedAfter;
+        vertexBytesBefore += optimizedPrimitive.vertexBytesBefore;
+        vertexBytesAfter += optimizedPrimitive.vertexBytesAfter;
+    }
+    externalBuffers.registerAppendedBufferViews(asset);
+
+    result.acmrBefore = static_cast<float>(cacheMissesBefore) / triangleCount;
+    result.acmrAfter = static_cast<float>(cacheMissesAfter) / triangleCount;
+    result.overfetchBefore = static_cast<float>(bytesFetchedBefore) / vertexBytesBefore;
+    result.overfetchAfter = static_cast<float>(bytesFetchedAfter) / vertexBytesAfter;
+    result.time = std::chrono::steady_clock::now() - startTime;
+    return result;
+}
@@ -0,0 +1,181 @@
+module;
+
+#include <meshoptimizer.h>
+
+export module vk_gltf_viewer.gltf.algorithm.meshlet;
+
+import std;
+import BS.thread_pool;
+export import fastgltf;
+
+export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+
+namespace vk_gltf_viewer::gltf::algorithm {
+    /**
+     * @brief Cluster of the adjacent triangles in a primitive, with its bounds for the visibility culling.
+     *
+     * Bounds are in the primitive's local space, i.e. they have to be transformed by the node world transform.
+     */
+    export struct Meshlet {
+        /// Center of the bounding sphere.
+        fastgltf::math::fvec3 center;
+
+        /// Radius of the bounding sphere.
+        float radius;
+
+        /// Apex of the normal cone. Meshlet is entirely backfacing if <tt>dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff</tt>.
+        fastgltf::math::fvec3 coneApex;
+
+        /// Cosine of the normal cone's half angle, or 1 if the meshlet cannot be culled by the normal cone.
+        float coneCutoff;
+
+        /// Normalized axis of the normal cone.
+        fastgltf::math::fvec3 coneAxis;
+
+        /// First index of the meshlet in <tt>PrimitiveMeshlets::indices</tt>.
+        std::uint32_t firstIndex;
+
+        /// Number of the indices of the meshlet, which is multiple of 3.
+        std::uint32_t indexCount;
+    };
+
+    export struct PrimitiveMeshlets {
+        std::vector<Meshlet> meshlets;
+
+        /**
+         * @brief Triangle list indices of the meshlets, which are referencing the primitive's vertices.
+         *
+         * The meshlet local vertex indices are expanded, therefore the meshlets can be drawn by the regular indexed
+         * draw without any vertex deduplication in the shader.
+         */
+        std::vector<std::uint32_t> indices;
+    };
+
+    /**
+     * @brief Partition the indexed triangle list primitives in \p asset into the meshlets by <tt>meshopt_buildMeshlets</tt>,
+     * and calculate their bounding sphere and normal cone by <tt>meshopt_computeMeshletBounds</tt>.
+     *
+     * Skinned primitives and the primitives with morph targets are skipped, as their vertices are deformed in the vertex
+     * shader and therefore the bounds cannot be calculated from the base positions.
+     *
+     * Each primitive is partitioned as an independent thread pool task.
+     *
+     * @param asset Asset whose primitives to be partitioned.
+     * @param externalBuffers Buffer data adapter of \p asset.
+     * @param threadPool Thread pool to run the partitioning.
+     * @param filter Predicate to select the primitive to be partitioned, in addition to the above conditions.
+     * @return Map of primitive -> its meshlets. The primitive that has a single meshlet is not contained, as it cannot be
+     * culled better than the per-primitive culling.
+     */
+    export
+    [[nodiscard]] std::unordered_map<const fastgltf::Primitive*, PrimitiveMeshlets> buildMeshlets(
+        const fastgltf::Asset &asset,
+        const AssetExternalBuffers &externalBuffers,
+        BS::thread_pool<> &threadPool,
+        const std::function<bool(const fastgltf::Primitive&)> &filter
+    );
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+/// Maximum number of the distinct vertices in a meshlet, as recommended by meshoptimizer for the NVIDIA hardware.
+constexpr std::size_t maxMeshletVertexCount = 64;
+
+/// Maximum number of the triangles in a meshlet. Must be multiple of 4.
+constexpr std::size_t maxMeshletTriangleCount = 124;
+
+/// Weight of the normal cone tightness in the meshlet partitioning, in [0, 1]. Higher value produces the meshlets that
+/// are more likely to be culled by the normal cone, in exchange of the bounding sphere tightness.
+constexpr float meshletConeWeight = 0.25f;
+
+[[nodiscard]] vk_gltf_viewer::gltf::algorithm::PrimitiveMeshlets buildPrimitiveMeshlets(
+    const fastgltf::Asset &asset,
+    const fastgltf::Primitive &primitive,
+    const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers
+) {
+    const fastgltf::Accessor &positionAccessor = asset.accessors[primitive.findAttribute("POSITION")->accessorIndex];
+    std::vector<fastgltf::math::fvec3> positions(positionAccessor.count);
+    fastgltf::copyFromAccessor<fastgltf::math::fvec3>(asset, positionAccessor, positions.data(), externalBuffers);
+
+    const fastgltf::Accessor &indexAccessor = asset.accessors[*primitive.indicesAccessor];
+    std::vector<std::uint32_t> indices(indexAccessor.count);
+    fastgltf::copyFromAccessor<std::uint32_t>(asset, indexAccessor, indices.data(), externalBuffers);
+
+    const std::size_t maxMeshletCount = meshopt_buildMeshletsBound(indices.size(), maxMeshletVertexCount, maxMeshletTriangleCount);
+    std::vector<meshopt_Meshlet> meshlets(maxMeshletCount);
+    std::vector<unsigned int> meshletVertices(maxMeshletCount * maxMeshletVertexCount);
+    std::vector<unsigned char> meshletTriangles(maxMeshletCount * maxMeshletTriangleCount * 3);
+    meshlets.resize(meshopt_buildMeshlets(
+        meshlets.data(), meshletVertices.data(), meshletTriangles.data(),
+        indices.data(), indices.size(),
+        positions.data()->data(), positions.size(), sizeof(fastgltf::math::fvec3),
+        maxMeshletVertexCount, maxMeshletTriangleCount, meshletConeWeight));
+    if (meshlets.size() < 2) {
+        return {};
+    }
+
+    vk_gltf_viewer::gltf::algorithm::PrimitiveMeshlets result;
+    result.meshlets.reserve(meshlets.size());
+    result.indices.reserve(indices.size());
+    for (const meshopt_Meshlet &meshlet : meshlets) {
+        const std::span localVertices { &meshletVertices[meshlet.vertex_offset], meshlet.vertex_count };
+        const std::span localTriangles { &meshletTriangles[meshlet.triangle_offset], 3 * meshlet.triangle_count };
+
+        const meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+            localVertices.data(), localTriangles.data(), meshlet.triangle_count,
+            positions.data()->data(), positions.size(), sizeof(fastgltf::math::fvec3));
+
+        result.meshlets.push_back({
+            .center = { bounds.center[0], bounds.center[1], bounds.center[2] },
+            .radius = bounds.radius,
+            .coneApex = { bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2] },
+            .coneCutoff = bounds.cone_cutoff,
+            .coneAxis = { bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2] },
+            .firstIndex = static_cast<std::uint32_t>(result.indices.size()),
+            .indexCount = static_cast<std::uint32_t>(localTriangles.size()),
+        });
+        result.indices.append_range(localTriangles | std::views::transform([&](unsigned char localIndex) {
+            return static_cast<std::uint32_t>(localVertices[localIndex]);
+        }));
+    }
+
+    return result;
+}
+
+std::unordered_map<const fastgltf::Primitive*, vk_gltf_viewer::gltf::algorithm::PrimitiveMeshlets> vk_gltf_viewer::gltf::algorithm::buildMeshlets(
+    const fastgltf::Asset &asset,
+    const AssetExternalBuffers &externalBuffers,
+    BS::thread_pool<> &threadPool,
+    const std::function<bool(const fastgltf::Primitive&)> &filter
+) {
+    std::vector<const fastgltf::Primitive*> candidates;
+    for (const fastgltf::Mesh &mesh : asset.meshes) {
+        for (const fastgltf::Primitive &primitive : mesh.primitives) {
+            if (primitive.type != fastgltf::PrimitiveType::Triangles ||
+                !primitive.indicesAccessor ||
+                !primitive.targets.empty() ||
+                primitive.findAttribute("POSITION") == primitive.attributes.end() ||
+                primitive.findAttribute("JOINTS_0") != primitive.attributes.end() ||
+                asset.accessors[*primitive.indicesAccessor].count <= 3 * maxMeshletTriangleCount ||
+                !filter(primitive)) {
+                continue;
+            }
+
+            candidates.push_back(&primitive);
+        }
+    }
+
+    std::vector primitiveMeshlets = threadPool.submit_sequence(0UZ, candidates.size(), [&](std::size_t i) {
+        return buildPrimitiveMeshlets(asset, *candidates[i], externalBuffers);
+    }).get();
+
+    std::unordered_map<const fastgltf::Primitive*, PrimitiveMeshlets> result;
+    for (auto &&[primitive, meshlets] : std::views::zip(candidates, primitiveMeshlets)) {
+        if (!meshlets.meshlets.empty()) {
+            result.emplace(primitive, std::move(meshlets));
+        }
+    }
+    return result;
+}
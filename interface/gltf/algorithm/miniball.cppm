@@ -9,98 +9,74 @@ module;
 export module vk_gltf_viewer.gltf.algorithm.miniball;
 
 import std;
+export import BS.thread_pool;
 export import fastgltf;
 
-export import vk_gltf_viewer.gltf.AssetExternalBuffers;
+export import vk_gltf_viewer.gltf.SubtreeBoundingBoxes;
 import vk_gltf_viewer.helpers.fastgltf;
 
-#define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
-
 namespace vk_gltf_viewer::gltf::algorithm {
-    export template <
-        bool IncludeCameraOrLightNodePositions,
-        std::predicate<std::size_t> EarlyExitHintFn = decltype([](std::size_t) noexcept { return false; })>
-    [[nodiscard]] auto getMiniball(
+    /**
+     * @brief Get the miniball (minimum enclosing sphere) of the mesh primitives in the subtrees whose roots are
+     * \p nodeIndices.
+     *
+     * If <tt>EXACT_BOUNDING_VOLUME_USING_CGAL</tt> is defined, the exact miniball of the primitives' bounding box
+     * corner points is calculated, where the points are collected in parallel over the flattened subtree nodes.
+     * Otherwise, the miniball is approximated by the bounding sphere of the cached subtree bounding boxes, which is
+     * cheap if the nodes are not changed since the last calculation.
+     *
+     * @param asset Asset that owns the nodes.
+     * @param nodeIndices Indices of the subtree root nodes.
+     * @param subtreeBoundingBoxes Subtree bounding boxes of the scene that contains the nodes.
+     * @param threadPool Thread pool to be used for the parallel calculation.
+     * @return Pair of the miniball center and radius.
+     */
+    export
+    [[nodiscard]] std::pair<fastgltf::math::fvec3, float> getMiniball(
         const fastgltf::Asset &asset,
         std::span<const std::size_t> nodeIndices,
-        std::span<const fastgltf::math::fmat4x4> nodeWorldTransforms,
-        const AssetExternalBuffers &adapter,
-        EarlyExitHintFn &&earlyExitHintFn = {}
+        SubtreeBoundingBoxes &subtreeBoundingBoxes,
+        BS::thread_pool<> &threadPool
     ) {
+        fastgltf::math::fvec3 center;
+        float radius;
     #ifdef EXACT_BOUNDING_VOLUME_USING_CGAL
-        // See https://doc.cgal.org/latest/Bounding_volumes/index.html for the original code.
-        using Traits = CGAL::Min_sphere_of_points_d_traits_3<CGAL::Simple_cartesian<float>, float>;
-        std::vector<Traits::Point> scenePoints;
-    #else
-        fastgltf::math::fvec3 min(std::numeric_limits<float>::max());
-        fastgltf::math::fvec3 max(std::numeric_limits<float>::lowest());
-    #endif
-        std::vector<fastgltf::math::fvec3> cameraOrLightPoints;
-
+        std::vector<std::size_t> flattenedNodeIndices;
         for (std::size_t nodeIndex : nodeIndices) {
             traverseNode(asset, nodeIndex, [&](std::size_t nodeIndex) {
-                if (earlyExitHintFn(nodeIndex)) return false;
-
-                const fastgltf::Node &node = asset.nodes[nodeIndex];
-                const fastgltf::math::fmat4x4 &worldTransform = nodeWorldTransforms[nodeIndex];
-
-                // Currently bounding box calculation is performed for both skinned and non-skinned meshes. The result of
-                // the former is not exact, completely ignore it will likely lead to a wrong bounding volume.
-                // TODO: use skinned mesh bounding volume calculation if available.
-                if (node.meshIndex) {
-                    const fastgltf::Mesh &mesh = asset.meshes[*node.meshIndex];
-                    const auto collectTransformedBoundingBoxPoints = [&](const fastgltf::math::fmat4x4 &worldTransform) {
-                        for (const fastgltf::Primitive &primitive : mesh.primitives) {
-                            for (const fastgltf::math::fvec3 &point : getBoundingBoxCornerPoints(primitive, node, asset)) {
-                                const fastgltf::math::fvec3 transformedPoint { worldTransform * fastgltf::math::fvec4 { point.x(), point.y(), point.z(), 1.0 } };
-
-                            #ifdef EXACT_BOUNDING_VOLUME_USING_CGAL
-                                scenePoints.emplace_back(transformedPoint.x(), transformedPoint.y(), transformedPoint.z());
-                            #else
-                                min = cwiseMin(min, transformedPoint);
-                                max = cwiseMax(max, transformedPoint);
-                            #endif
-                            }
-                        }
-                    };
-
-                    if (node.instancingAttributes.empty()) {
-                        collectTransformedBoundingBoxPoints(worldTransform);
-                    }
-                    else {
-                        for (const fastgltf::math::fmat4x4 &instanceTransform : getInstanceTransforms(asset, nodeIndex, adapter)) {
-                            collectTransformedBoundingBoxPoints(worldTransform * instanceTransform);
-                        }
-                    }
-                }
+                flattenedNodeIndices.push_back(nodeIndex);
+            });
+        }
 
-                if constexpr (IncludeCameraOrLightNodePositions) {
-                    if (node.lightIndex || node.cameraIndex) {
-                        cameraOrLightPoints.emplace_back(worldTransform.col(3));
-                    }
-                }
+        const std::vector pointsByBlock = threadPool.submit_blocks(0UZ, flattenedNodeIndices.size(), [&](std::size_t start, std::size_t end) {
+            std::vector<fastgltf::math::fvec3> points;
+            for (std::size_t nodeIndex : std::span { flattenedNodeIndices }.subspan(start, end - start)) {
+                subtreeBoundingBoxes.appendPrimitiveBoundingBoxCornerPoints(nodeIndex, points);
+            }
+            return points;
+        }).get();
 
-                return true;
-            });
+        // See https://doc.cgal.org/latest/Bounding_volumes/index.html for the original code.
+        using Traits = CGAL::Min_sphere_of_points_d_traits_3<CGAL::Simple_cartesian<float>, float>;
+        std::vector<Traits::Point> scenePoints;
+        for (const std::vector<fastgltf::math::fvec3> &points : pointsByBlock) {
+            for (const fastgltf::math::fvec3 &point : points) {
+                scenePoints.emplace_back(point.x(), point.y(), point.z());
+            }
         }
 
-        fastgltf::math::fvec3 center;
-        float radius;
-    #ifdef EXACT_BOUNDING_VOLUME_USING_CGAL
         CGAL::Min_sphere_of_spheres_d<Traits> ms { scenePoints.begin(), scenePoints.end() };
         std::copy(ms.center_cartesian_begin(), ms.center_cartesian_end(), center.data());
         radius = ms.radius();
     #else
+        std::ignore = asset;
+
+        const auto [min, max] = subtreeBoundingBoxes.get(nodeIndices, threadPool);
         const fastgltf::math::fvec3 halfDisplacement = (max - min) / 2.f;
         center = min + halfDisplacement;
         radius = fastgltf::math::length(halfDisplacement);
     #endif
 
-        if constexpr (IncludeCameraOrLightNodePositions) {
-            return std::tuple { center, radius, std::move(cameraOrLightPoints) };
-        }
-        else {
-            return std::pair { center, radius };
-        }
+        return { center, radius };
     }
-}
\ No newline at end of file
+}
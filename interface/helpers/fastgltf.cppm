@@ -242,6 +242,9 @@ namespace fastgltf {
     /**
      * Get image index from \p texture with preference of GPU compressed texture.
      *
+     * The preference order is DDS (MSFT_texture_dds), KTX2 (KHR_texture_basisu), WebP (EXT_texture_webp) and the
+     * regular image. Image index for an extension is only available if the parser enabled it.
+     *
      * You should use this function to get the image index from a texture, rather than directly access such like
      * <tt>texture.imageIndex</tt> or <tt>texture.basisuImageIndex</tt>.
      *
@@ -420,11 +423,23 @@ namespace fastgltf {
      * @param node Node that owns \p primitive.
      * @param asset Asset that owns \p node.
      * @return Array of (min, max) of the bounding box.
-     * @note Skinned meshes are not supported, as the bounding box of skinned meshes cannot be determined by the primitive's <tt>POSITION</tt> accessor min/max values.
+     * @note Skinned meshes are not supported, as the bounding box of skinned meshes cannot be determined by the primitive's <tt>POSITION</tt> accessor min/max values. Use <tt>vk_gltf_viewer::gltf::JointBoundingBoxes</tt> for them.
      */
     export
     [[nodiscard]] std::array<math::fvec3, 2> getBoundingBoxMinMax(const Primitive &primitive, const Node &node, const Asset &asset);
 
+    /**
+     * @brief Get min/max displacement of \p primitive's <tt>POSITION</tt> by its morph targets, with respecting the
+     * current target weights of \p node.
+     *
+     * @param primitive Primitive to get the displacement.
+     * @param node Node that owns \p primitive.
+     * @param asset Asset that owns \p node.
+     * @return Array of (min, max) of the displacement. If \p primitive has no morph target, both are zero vectors.
+     */
+    export
+    [[nodiscard]] std::array<math::fvec3, 2> getMorphTargetDisplacementMinMax(const Primitive &primitive, const Node &node, const Asset &asset);
+
     /**
      * @brief Get 8 corner points of \p primitive's bounding box, which are ordered by:
      * - (minX, minY, minZ)
@@ -440,11 +455,18 @@ namespace fastgltf {
      * @param node Node that owns \p primitive.
      * @param asset Asset that owns \p node.
      * @return Array of 8 corner points of the bounding box.
-     * @note Skinned meshes are not supported, as the bounding box of skinned meshes cannot be determined by the primitive's <tt>POSITION</tt> accessor min/max values.
+     * @note Skinned meshes are not supported, as the bounding box of skinned meshes cannot be determined by the primitive's <tt>POSITION</tt> accessor min/max values. Use <tt>vk_gltf_viewer::gltf::JointBoundingBoxes</tt> for them.
      */
     export
     [[nodiscard]] std::array<math::fvec3, 8> getBoundingBoxCornerPoints(const Primitive &primitive, const Node &node, const Asset &asset);
 
+    /**
+     * @brief Get 8 corner points of the bounding box whose min/max points are \p min and \p max, with the same order of
+     * <tt>getBoundingBoxCornerPoints(const Primitive&, const Node&, const Asset&)</tt>.
+     */
+    export
+    [[nodiscard]] std::array<math::fvec3, 8> getBoundingBoxCornerPoints(const math::fvec3 &min, const math::fvec3 &max) noexcept;
+
     /**
      * @brief Find all <tt>fastgltf::TextureInfo</tt> (or its derivatives like <tt>fastgltf::NormalTextureInfo</tt>) in \p material and invoke \p f with them.
      * @tparam F Function type that can be invoked with <tt>const fastgltf::TextureInfo&</tt> or its derivatives like <tt>const fastgltf::NormalTextureInfo&</tt>, and optional <tt>fastgltf::TextureUsage</tt>.
@@ -794,8 +816,14 @@ std::size_t fastgltf::getTexcoordIndex(const TextureInfo &textureInfo) noexcept
 }
 
 std::size_t fastgltf::getPreferredImageIndex(const Texture &texture) {
+    if (texture.ddsImageIndex) {
+        return *texture.ddsImageIndex; // Prefer DDS image if exists, as it can be uploaded without transcoding.
+    }
     if (texture.basisuImageIndex) {
-        return *texture.basisuImageIndex; // Prefer BasisU compressed image if exists.
+        return *texture.basisuImageIndex; // Then BasisU compressed image.
+    }
+    if (texture.webpImageIndex) {
+        return *texture.webpImageIndex; // WebP image is smaller than the regular image to load.
     }
 
     // Otherwise, use regular image.
@@ -826,53 +854,61 @@ std::size_t fastgltf::getTargetWeightCount(const Node &node, const Asset &asset)
     return count;
 }
 
-std::array<fastgltf::math::fvec3, 2> fastgltf::getBoundingBoxMinMax(const Primitive &primitive, const Node &node, const Asset &asset) {
-    constexpr auto getAccessorMinMax = [](const Accessor &accessor) {
-        constexpr auto copyAccessorData = [](const AccessorBoundsArray &accessor, math::fvec3 &out) {
-            assert(accessor.size() == 3);
-            switch (accessor.type()) {
-                case AccessorBoundsArray::BoundsType::float64:
-                    INDEX_SEQ(Is, 3, { std::ignore = ((out[Is] = static_cast<float>(accessor.get<double>(Is))), ...); });
-                    return;
-                case AccessorBoundsArray::BoundsType::int64:
-                    INDEX_SEQ(Is, 3, { std::ignore = ((out[Is] = static_cast<float>(accessor.get<std::int64_t>(Is))), ...); });
-                    return;
-            }
-            std::unreachable();
-        };
-
-        std::array<math::fvec3, 2> result;
-        copyAccessorData(accessor.min.value(), get<0>(result));
-        copyAccessorData(accessor.max.value(), get<1>(result));
-
-        if (accessor.normalized) {
-            switch (accessor.componentType) {
-            case ComponentType::Byte:
-                get<0>(result) = cwiseMax(get<0>(result) / 127, math::fvec3(-1));
-                get<1>(result) = cwiseMax(get<1>(result) / 127, math::fvec3(-1));
-                break;
-            case ComponentType::UnsignedByte:
-                get<0>(result) /= 255;
-                get<1>(result) /= 255;
-                break;
-            case ComponentType::Short:
-                get<0>(result) = cwiseMax(get<0>(result) / 32767, math::fvec3(-1));
-                get<1>(result) = cwiseMax(get<1>(result) / 32767, math::fvec3(-1));
-                break;
-            case ComponentType::UnsignedShort:
-                get<0>(result) /= 65535;
-                get<1>(result) /= 65535;
-                break;
-            default:
-                throw std::logic_error { "Normalized accessor must be either BYTE, UNSIGNED_BYTE, SHORT, or UNSIGNED_SHORT" };
-            }
+[[nodiscard]] std::array<fastgltf::math::fvec3, 2> getAccessorMinMax(const fastgltf::Accessor &accessor) {
+    constexpr auto copyAccessorData = [](const fastgltf::AccessorBoundsArray &accessor, fastgltf::math::fvec3 &out) {
+        assert(accessor.size() == 3);
+        switch (accessor.type()) {
+            case fastgltf::AccessorBoundsArray::BoundsType::float64:
+                INDEX_SEQ(Is, 3, { std::ignore = ((out[Is] = static_cast<float>(accessor.get<double>(Is))), ...); });
+                return;
+            case fastgltf::AccessorBoundsArray::BoundsType::int64:
+                INDEX_SEQ(Is, 3, { std::ignore = ((out[Is] = static_cast<float>(accessor.get<std::int64_t>(Is))), ...); });
+                return;
         }
-        return result;
+        std::unreachable();
     };
 
-    const Accessor &accessor = asset.accessors[primitive.findAttribute("POSITION")->accessorIndex];
-    std::array bound = getAccessorMinMax(accessor);
+    std::array<fastgltf::math::fvec3, 2> result;
+    copyAccessorData(accessor.min.value(), get<0>(result));
+    copyAccessorData(accessor.max.value(), get<1>(result));
+
+    if (accessor.normalized) {
+        switch (accessor.componentType) {
+        case fastgltf::ComponentType::Byte:
+            get<0>(result) = cwiseMax(get<0>(result) / 127, fastgltf::math::fvec3(-1));
+            get<1>(result) = cwiseMax(get<1>(result) / 127, fastgltf::math::fvec3(-1));
+            break;
+        case fastgltf::ComponentType::UnsignedByte:
+            get<0>(result) /= 255;
+            get<1>(result) /= 255;
+            break;
+        case fastgltf::ComponentType::Short:
+            get<0>(result) = cwiseMax(get<0>(result) / 32767, fastgltf::math::fvec3(-1));
+            get<1>(result) = cwiseMax(get<1>(result) / 32767, fastgltf::math::fvec3(-1));
+            break;
+        case fastgltf::ComponentType::UnsignedShort:
+            get<0>(result) /= 65535;
+            get<1>(result) /= 65535;
+            break;
+        default:
+            throw std::logic_error { "Normalized accessor must be either BYTE, UNSIGNED_BYTE, SHORT, or UNSIGNED_SHORT" };
+        }
+    }
+    return result;
+}
+
+std::array<fastgltf::math::fvec3, 2> fastgltf::getBoundingBoxMinMax(const Primitive &primitive, const Node &node, const Asset &asset) {
+    std::array bound = getAccessorMinMax(asset.accessors[primitive.findAttribute("POSITION")->accessorIndex]);
+
+    const auto [displacementMin, displacementMax] = getMorphTargetDisplacementMinMax(primitive, node, asset);
+    get<0>(bound) += displacementMin;
+    get<1>(bound) += displacementMax;
 
+    return bound;
+}
+
+std::array<fastgltf::math::fvec3, 2> fastgltf::getMorphTargetDisplacementMinMax(const Primitive &primitive, const Node &node, const Asset &asset) {
+    std::array displacement { math::fvec3(0.f), math::fvec3(0.f) };
     for (const auto &[weight, attributes] : std::views::zip(getTargetWeights(node, asset), primitive.targets)) {
         for (const auto &[attributeName, accessorIndex] : attributes) {
             using namespace std::string_view_literals;
@@ -884,19 +920,23 @@ std::array<fastgltf::math::fvec3, 2> fastgltf::getBoundingBoxMinMax(const Primit
                 if (weight < 0) {
                     std::swap(get<0>(offset), get<1>(offset));
                 }
-                get<0>(bound) += get<0>(offset) * weight;
-                get<1>(bound) += get<1>(offset) * weight;
+                get<0>(displacement) += get<0>(offset) * weight;
+                get<1>(displacement) += get<1>(offset) * weight;
 
                 break;
             }
         }
     }
 
-    return bound;
+    return displacement;
 }
 
 std::array<fastgltf::math::fvec3, 8> fastgltf::getBoundingBoxCornerPoints(const Primitive &primitive, const Node &node, const Asset &asset) {
     const auto [min, max] = getBoundingBoxMinMax(primitive, node, asset);
+    return getBoundingBoxCornerPoints(min, max);
+}
+
+std::array<fastgltf::math::fvec3, 8> fastgltf::getBoundingBoxCornerPoints(const math::fvec3 &min, const math::fvec3 &max) noexcept {
     return {
         min,
         { min[0], min[1], max[2] },
@@ -0,0 +1,214 @@
+module;
+
+#include <cassert>
+
+export module vk_gltf_viewer.image.RadianceHdr;
+
+import std;
+import fmt;
+
+import vk_gltf_viewer.helpers.io;
+
+namespace vk_gltf_viewer::image {
+    /**
+     * @brief Radiance RGBE (<tt>.hdr</tt>) image whose scanlines can be decoded independently.
+     *
+     * Unlike <tt>stbi_loadf</tt> that decodes the whole image into a single RGBA32F buffer, this class only locates the
+     * scanlines at construction, therefore the scanlines can be decoded from multiple threads and converted into the
+     * desired format without the intermediate buffer.
+     *
+     * Supported files are same as <tt>stb_image</tt>: <tt>32-bit_rle_rgbe</tt> format with <tt>-Y height +X width</tt>
+     * orientation, either flat or new-style run length encoded.
+     */
+    export class RadianceHdr {
+    public:
+        using Texel = std::array<std::uint8_t, 4>;
+
+        std::uint32_t width;
+        std::uint32_t height;
+
+        /**
+         * @brief Load the file and locate its scanlines.
+         * @param path Path of the <tt>.hdr</tt> file.
+         * @throw std::runtime_error If the file is not a valid or supported Radiance RGBE image.
+         */
+        explicit RadianceHdr(const std::filesystem::path &path);
+
+        /**
+         * @brief Decode a scanline into RGBE texels.
+         *
+         * This function is thread-safe.
+         *
+         * @param y Row index, from the top of the image.
+         * @param texels Destination, whose size must be \p width.
+         * @throw std::runtime_error If the scanline data is corrupted.
+         */
+        void decodeScanline(std::uint32_t y, std::span<Texel> texels) const;
+
+        /**
+         * @brief Convert RGBE texel to linear RGB, in the same way as <tt>stb_image</tt>.
+         */
+        [[nodiscard]] static std::array<float, 3> toRgb(const Texel &texel) noexcept;
+
+    private:
+        std::vector<std::byte> data;
+        bool runLengthEncoded;
+
+        /**
+         * @brief Byte offsets of each scanline in \p data, with the end of the data as the last element.
+         */
+        std::vector<std::size_t> scanlineOffsets;
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+vk_gltf_viewer::image::RadianceHdr::RadianceHdr(const std::filesystem::path &path)
+    : data { loadFileAsBinary(path) } {
+    const std::string_view text { reinterpret_cast<const char*>(data.data()), data.size() };
+
+    // ----- Header -----
+
+    if (!text.starts_with("#?RADIANCE\n") && !text.starts_with("#?RGBE\n")) {
+        throw std::runtime_error { "Not a Radiance HDR file" };
+    }
+
+    std::size_t pos = 0;
+    bool validFormat = false;
+    while (true) {
+        const std::size_t lineEnd = text.find('\n', pos);
+        if (lineEnd == std::string_view::npos) {
+            throw std::runtime_error { "Unexpected end of the HDR header" };
+        }
+
+        const std::string_view line = text.substr(pos, lineEnd - pos);
+        pos = lineEnd + 1;
+        if (line.empty()) break;
+        if (line == "FORMAT=32-bit_rle_rgbe") validFormat = true;
+    }
+    if (!validFormat) {
+        throw std::runtime_error { "Unsupported HDR format" };
+    }
+
+    const std::size_t resolutionLineEnd = text.find('\n', pos);
+    if (resolutionLineEnd == std::string_view::npos ||
+        std::sscanf(std::string { text.substr(pos, resolutionLineEnd - pos) }.c_str(), "-Y %u +X %u", &height, &width) != 2) {
+        throw std::runtime_error { "Unsupported HDR orientation" };
+    }
+    pos = resolutionLineEnd + 1;
+
+    if (width == 0 || height == 0) {
+        throw std::runtime_error { "Invalid HDR image size" };
+    }
+
+    // Every scanline takes at least 4 bytes (a texel or a run length encoding header), therefore the height must be
+    // bounded by the remaining data size before allocating the scanline offsets.
+    const std::size_t remainingSize = data.size() - pos;
+    if (height > remainingSize / sizeof(Texel)) {
+        throw std::runtime_error { "Unexpected end of the HDR data" };
+    }
+
+    // ----- Locate scanlines -----
+
+    const auto bytes = std::span { reinterpret_cast<const std::uint8_t*>(data.data()), data.size() };
+    const auto isRunLengthEncoded = [&](std::size_t offset) {
+        return width >= 8 && width < 32768 && offset + 4 <= bytes.size()
+            && bytes[offset] == 2 && bytes[offset + 1] == 2 && (bytes[offset + 2] & 0x80) == 0;
+    };
+
+    scanlineOffsets.reserve(static_cast<std::size_t>(height) + 1);
+    runLengthEncoded = isRunLengthEncoded(pos);
+    if (runLengthEncoded) {
+        for (std::uint32_t y = 0; y < height; ++y) {
+            if (!isRunLengthEncoded(pos) || ((bytes[pos + 2] << 8) | bytes[pos + 3]) != width) {
+                throw std::runtime_error { fmt::format("Invalid HDR scanline header at row {}", y) };
+            }
+            scanlineOffsets.push_back(pos);
+            pos += 4;
+
+            // Skip the runs of 4 channels, without decoding them.
+            for (int channel = 0; channel < 4; ++channel) {
+                for (std::uint32_t x = 0; x < width;) {
+                    if (pos >= bytes.size()) {
+                        throw std::runtime_error { "Unexpected end of the HDR data" };
+                    }
+
+                    if (const std::uint8_t count = bytes[pos]; count > 128) {
+                        x += count - 128;
+                        pos += 2;
+                    }
+                    else {
+                        x += count;
+                        pos += 1 + count;
+                    }
+                }
+            }
+        }
+    }
+    else {
+        // Flat scanlines. Their total size is known, therefore checked before locating them.
+        if (width > remainingSize / sizeof(Texel) / height) {
+            throw std::runtime_error { "Unexpected end of the HDR data" };
+        }
+
+        for (std::uint32_t y = 0; y < height; ++y) {
+            scanlineOffsets.push_back(pos);
+            pos += sizeof(Texel) * width;
+        }
+    }
+
+    if (pos > bytes.size()) {
+        throw std::runtime_error { "Unexpected end of the HDR data" };
+    }
+    scanlineOffsets.push_back(pos);
+}
+
+void vk_gltf_viewer::image::RadianceHdr::decodeScanline(std::uint32_t y, std::span<Texel> texels) const {
+    assert(texels.size() == width && "texels size mismatch");
+
+    const auto bytes = std::span { reinterpret_cast<const std::uint8_t*>(data.data()), data.size() }
+        .subspan(scanlineOffsets[y], scanlineOffsets[y + 1] - scanlineOffsets[y]);
+
+    if (!runLengthEncoded) {
+        std::memcpy(texels.data(), bytes.data(), bytes.size());
+        return;
+    }
+
+    auto it = bytes.begin() + 4;
+    for (std::size_t channel = 0; channel < 4; ++channel) {
+        for (std::uint32_t x = 0; x < width;) {
+            std::uint8_t count = *it++;
+            if (count > 128) {
+                count -= 128;
+                if (x + count > width) {
+                    throw std::runtime_error { fmt::format("Corrupted HDR scanline at row {}", y) };
+                }
+
+                const std::uint8_t value = *it++;
+                for (; count > 0; --count) {
+                    texels[x++][channel] = value;
+                }
+            }
+            else {
+                if (count == 0 || x + count > width) {
+                    throw std::runtime_error { fmt::format("Corrupted HDR scanline at row {}", y) };
+                }
+
+                for (; count > 0; --count) {
+                    texels[x++][channel] = *it++;
+                }
+            }
+        }
+    }
+}
+
+std::array<float, 3> vk_gltf_viewer::image::RadianceHdr::toRgb(const Texel &texel) noexcept {
+    if (texel[3] == 0) {
+        return { 0.f, 0.f, 0.f };
+    }
+
+    const float f = std::ldexp(1.f, texel[3] - (128 + 8));
+    return { texel[0] * f, texel[1] * f, texel[2] * f };
+}
@@ -11,6 +11,7 @@ namespace vk_gltf_viewer::imgui {
     export class UserData final {
     public:
         bool resolveAnimationCollisionAutomatically = false;
+        bool progressiveImageBasedLighting = true;
 
         std::list<std::u8string> recentAssetPaths;
         std::list<std::u8string> recentSkyboxPaths;
@@ -40,6 +41,9 @@ namespace vk_gltf_viewer::imgui {
                         if (int value; std::sscanf(line, "ResolveAnimationCollisionAutomatically=%d", &value) == 1) {
                             static_cast<UserData*>(handler->UserData)->resolveAnimationCollisionAutomatically = value == 1;
                         }
+                        else if (std::sscanf(line, "ProgressiveImageBasedLighting=%d", &value) == 1) {
+                            static_cast<UserData*>(handler->UserData)->progressiveImageBasedLighting = value == 1;
+                        }
                         break;
                     case Section::RecentAssets:
                         if (line[0] != '\0') {
@@ -58,6 +62,7 @@ namespace vk_gltf_viewer::imgui {
             result.WriteAllFn = [](ImGuiContext*, ImGuiSettingsHandler *handler, ImGuiTextBuffer* out_buf) {
                 out_buf->appendf("[%s][Settings]\n", handler->TypeName);
                 out_buf->appendf("ResolveAnimationCollisionAutomatically=%d\n", static_cast<UserData*>(handler->UserData)->resolveAnimationCollisionAutomatically ? 1 : 0);
+                out_buf->appendf("ProgressiveImageBasedLighting=%d\n", static_cast<UserData*>(handler->UserData)->progressiveImageBasedLighting ? 1 : 0);
                 out_buf->appendf("\n");
 
                 out_buf->appendf("[%s][RecentAssets]\n", handler->TypeName);
@@ -0,0 +1,55 @@
+export module vk_gltf_viewer.math.pack;
+
+import std;
+
+namespace vk_gltf_viewer::math::pack {
+    /**
+     * @brief Convert 32-bit float to IEEE 754 half precision float, with rounding to nearest.
+     *
+     * Denormalized values are flushed to zero, values out of range become infinity, and all NaNs become quiet NaN.
+     *
+     * @param v Value to convert.
+     * @return Bit pattern of the half precision float.
+     */
+    export
+    [[nodiscard]] constexpr std::uint16_t packHalf1x16(float v) noexcept {
+        const auto ui = std::bit_cast<std::uint32_t>(v);
+        const std::uint32_t s = (ui >> 16) & 0x8000U;
+        const std::uint32_t em = ui & 0x7FFFFFFFU;
+
+        // Bias exponent (127 - 15 = 112) and round to nearest.
+        std::uint32_t h = (em - (112U << 23) + (1U << 12)) >> 13;
+        // Underflow: flush to zero (113 encodes exponent -14).
+        if (em < (113U << 23)) h = 0;
+        // Overflow: infinity (143 encodes exponent 16).
+        if (em >= (143U << 23)) h = 0x7C00U;
+        // NaN.
+        if (em > (255U << 23)) h = 0x7E00U;
+
+        return static_cast<std::uint16_t>(s | h);
+    }
+
+    /**
+     * @brief Pack RGB color to <tt>vk::Format::eB10G11R11UfloatPack32</tt> texel.
+     *
+     * Negative and NaN values are clamped to zero, and values exceed the maximum representable value are clamped to
+     * the maximum finite value.
+     *
+     * @param r Red channel.
+     * @param g Green channel.
+     * @param b Blue channel.
+     * @return Packed texel.
+     */
+    export
+    [[nodiscard]] constexpr std::uint32_t packB10G11R11Ufloat(float r, float g, float b) noexcept {
+        // 11-bit and 10-bit unsigned float have the same exponent bits with half, and their mantissa are truncated
+        // from the half's.
+        const auto toUfloat = [](float v, std::uint32_t droppedMantissaBits, std::uint32_t maxFinite) {
+            if (!(v > 0.f)) return 0U;
+            const std::uint32_t h = packHalf1x16(std::min(v, 65504.f));
+            return std::min((h + (1U << (droppedMantissaBits - 1))) >> droppedMantissaBits, maxFinite);
+        };
+
+        return toUfloat(r, 4, 0x7BF) | (toUfloat(g, 4, 0x7BF) << 11) | (toUfloat(b, 5, 0x3DF) << 22);
+    }
+}
@@ -7,14 +7,14 @@ import vk_gltf_viewer.shader.primitive_frag;
 
 namespace vk_gltf_viewer::shader_selector {
     export
-    [[nodiscard]] std::span<const unsigned int> primitive_frag(int TEXCOORD_COUNT, int HAS_COLOR_0_ATTRIBUTE, int FRAGMENT_SHADER_GENERATED_TBN, int ALPHA_MODE, int EXT_SHADER_STENCIL_EXPORT);
+    [[nodiscard]] std::span<const unsigned int> primitive_frag(int TEXCOORD_COUNT, int HAS_COLOR_0_ATTRIBUTE, int FRAGMENT_SHADER_GENERATED_TBN, int ALPHA_MODE, int EXT_SHADER_STENCIL_EXPORT, int HAS_MATERIAL_EXTENSION);
 }
 
 #if !defined(__GNUC__) || defined(__clang__)
 module :private;
 #endif
 
-std::span<const unsigned int> vk_gltf_viewer::shader_selector::primitive_frag(int TEXCOORD_COUNT, int HAS_COLOR_0_ATTRIBUTE, int FRAGMENT_SHADER_GENERATED_TBN, int ALPHA_MODE, int EXT_SHADER_STENCIL_EXPORT) {
+std::span<const unsigned int> vk_gltf_viewer::shader_selector::primitive_frag(int TEXCOORD_COUNT, int HAS_COLOR_0_ATTRIBUTE, int FRAGMENT_SHADER_GENERATED_TBN, int ALPHA_MODE, int EXT_SHADER_STENCIL_EXPORT, int HAS_MATERIAL_EXTENSION) {
     return std::visit(
         [](auto ...Is) -> std::span<const unsigned int> {
             return shader::primitive_frag<Is...>;
@@ -23,5 +23,6 @@ std::span<const unsigned int> vk_gltf_viewer::shader_selector::primitive_frag(in
         iota_map<2>::get_variant(HAS_COLOR_0_ATTRIBUTE),
         iota_map<2>::get_variant(FRAGMENT_SHADER_GENERATED_TBN),
         iota_map<3>::get_variant(ALPHA_MODE),
-        iota_map<2>::get_variant(EXT_SHADER_STENCIL_EXPORT));
+        iota_map<2>::get_variant(EXT_SHADER_STENCIL_EXPORT),
+        iota_map<2>::get_variant(HAS_MATERIAL_EXTENSION));
 }
\ No newline at end of file
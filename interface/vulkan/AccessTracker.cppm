@@ -0,0 +1,378 @@
+module;
+
+#include <cassert>
+
+export module vk_gltf_viewer.vulkan.AccessTracker;
+
+import std;
+export import vulkan;
+
+namespace vk_gltf_viewer::vulkan {
+    /**
+     * @brief Pipeline stages and access types of a memory access.
+     */
+    export struct MemoryAccess {
+        vk::PipelineStageFlags2 stageMask;
+        vk::AccessFlags2 accessMask;
+
+        /**
+         * @brief Check if the access writes the memory.
+         */
+        [[nodiscard]] bool isWrite() const noexcept;
+    };
+
+    /**
+     * @brief Pipeline stages, access types and image layout of an image access.
+     */
+    export struct ImageAccess : MemoryAccess {
+        vk::ImageLayout layout;
+    };
+
+    /**
+     * @brief Derives memory barriers from the resource accesses declared by the passes.
+     *
+     * Register resources with their last access before the first pass by <tt>track()</tt>. Then, before recording each
+     * pass, declare the resources that the pass will access by <tt>access()</tt>, and record the derived barriers as a
+     * single <tt>vkCmdPipelineBarrier2</tt> by <tt>flush()</tt>.
+     *
+     * A barrier is derived only if there is a hazard: layout transition, write after read/write, or read after write
+     * whose stages/accesses are not made visible yet. Read after read with the same layout does not emit a barrier,
+     * but its stages are accumulated so that the next write waits for all of them.
+     *
+     * Images are tracked per mip level and array layer, buffers are tracked as a whole, and the resources that cannot
+     * be enumerated (e.g. accessed by the buffer device address) are tracked as the global memory. A tracker is meant
+     * to be used for a single command buffer. The resources accessed by the other command buffers or queues must be
+     * tracked with the state established by their synchronization (e.g. the stage mask of the semaphore wait).
+     * Queue family ownership transfers are not tracked.
+     */
+    export class AccessTracker {
+    public:
+        /**
+         * @brief Start tracking \p image, whose all subresources are last accessed by \p initialAccess.
+         * @param image Image to be tracked.
+         * @param aspectFlags Aspect of the image, used for the barrier subresource range.
+         * @param mipLevels Mip level count of the image.
+         * @param arrayLayers Array layer count of the image.
+         * @param initialAccess Last access of the image before the first pass. Use
+         * <tt>{ vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined }</tt> if
+         * its contents can be discarded.
+         */
+        void track(vk::Image image, vk::ImageAspectFlags aspectFlags, std::uint32_t mipLevels, std::uint32_t arrayLayers, const ImageAccess &initialAccess);
+
+        /**
+         * @brief Start tracking \p buffer, which is last accessed by \p initialAccess.
+         * @param buffer Buffer to be tracked.
+         * @param initialAccess Last access of the buffer before the first pass. Use
+         * <tt>{ vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone }</tt> if it is not accessed by the
+         * device since the last host write.
+         */
+        void track(vk::Buffer buffer, const MemoryAccess &initialAccess);
+
+        /**
+         * @brief Declare the mip levels <tt>[baseMipLevel, baseMipLevel + levelCount)</tt> of the array layers
+         * <tt>[baseArrayLayer, baseArrayLayer + layerCount)</tt> of \p image are last accessed by \p access outside of
+         * the tracked commands, without deriving any barrier.
+         *
+         * It is used when the subresources have the different initial state than the one passed to <tt>track()</tt>,
+         * e.g. only some array layers are written by the other queue.
+         */
+        void assume(vk::Image image, std::uint32_t baseMipLevel, std::uint32_t levelCount, std::uint32_t baseArrayLayer, std::uint32_t layerCount, const ImageAccess &access);
+
+        /**
+         * @brief Declare the mip levels <tt>[baseMipLevel, baseMipLevel + levelCount)</tt> of the array layers
+         * <tt>[baseArrayLayer, baseArrayLayer + layerCount)</tt> of \p image are accessed by \p access in the next pass.
+         * @param image Image to be accessed. It must be tracked by <tt>track()</tt>.
+         * @param baseMipLevel Base mip level of the access.
+         * @param levelCount Mip level count of the access. <tt>vk::RemainingMipLevels</tt> is allowed.
+         * @param baseArrayLayer Base array layer of the access.
+         * @param layerCount Array layer count of the access. <tt>vk::RemainingArrayLayers</tt> is allowed.
+         * @param access Access of the next pass.
+         */
+        void access(vk::Image image, std::uint32_t baseMipLevel, std::uint32_t levelCount, std::uint32_t baseArrayLayer, std::uint32_t layerCount, const ImageAccess &access);
+
+        /**
+         * @brief Declare the mip levels <tt>[baseMipLevel, baseMipLevel + levelCount)</tt> of all array layers of
+         * \p image are accessed by \p access in the next pass.
+         */
+        void access(vk::Image image, std::uint32_t baseMipLevel, std::uint32_t levelCount, const ImageAccess &access);
+
+        /**
+         * @brief Declare the whole subresources of \p image are accessed by \p access in the next pass.
+         */
+        void access(vk::Image image, const ImageAccess &access);
+
+        /**
+         * @brief Declare \p buffer is accessed by \p access in the next pass.
+         * @param buffer Buffer to be accessed. It must be tracked by <tt>track()</tt>.
+         * @param access Access of the next pass.
+         */
+        void access(vk::Buffer buffer, const MemoryAccess &access);
+
+        /**
+         * @brief Declare the global memory is accessed by \p access in the next pass.
+         *
+         * Use this for the resources that are not tracked by <tt>track()</tt>, e.g. the buffers accessed by their
+         * device addresses. The global memory is not accessed before the first pass.
+         */
+        void access(const MemoryAccess &access);
+
+        /**
+         * @brief Record the barriers derived since the last flush to \p cb. If there is no barrier, nothing is recorded.
+         * @param cb Command buffer to record the barriers. <tt>VK_KHR_synchronization2</tt> must be enabled.
+         */
+        void flush(vk::CommandBuffer cb);
+
+    private:
+        struct State {
+            /// Layout of the image subresource. Always <tt>vk::ImageLayout::eUndefined</tt> for the buffers.
+            vk::ImageLayout layout;
+
+            /// Stages and accesses of the last write (including the layout transition).
+            vk::PipelineStageFlags2 writeStageMask;
+            vk::AccessFlags2 writeAccessMask;
+
+            /// Stages and accesses that read the resource since the last write, which are already made visible.
+            vk::PipelineStageFlags2 readStageMask;
+            vk::AccessFlags2 readAccessMask;
+
+            [[nodiscard]] static State from(const MemoryAccess &access, vk::ImageLayout layout) noexcept;
+
+            [[nodiscard]] bool operator==(const State&) const noexcept = default;
+        };
+
+        struct TrackedImage {
+            vk::Image image;
+            vk::ImageAspectFlags aspectFlags;
+            std::uint32_t mipLevels;
+            std::uint32_t arrayLayers;
+
+            /// State of each subresource, indexed by <tt>arrayLayer * mipLevels + mipLevel</tt>.
+            std::vector<State> states;
+        };
+
+        struct TrackedBuffer {
+            vk::Buffer buffer;
+            State state;
+        };
+
+        std::vector<TrackedImage> trackedImages;
+        std::vector<TrackedBuffer> trackedBuffers;
+        State globalState{};
+
+        std::vector<vk::MemoryBarrier2> pendingMemoryBarriers;
+        std::vector<vk::BufferMemoryBarrier2> pendingBufferBarriers;
+        std::vector<vk::ImageMemoryBarrier2> pendingImageBarriers;
+
+        /**
+         * @brief Update \p state to be accessed by \p access with \p layout.
+         * @return Source stages and accesses of the barrier that must be executed before \p access, or
+         * <tt>std::nullopt</tt> if there is no hazard.
+         */
+        [[nodiscard]] static std::optional<MemoryAccess> transit(State &state, const MemoryAccess &access, vk::ImageLayout layout) noexcept;
+
+        [[nodiscard]] TrackedImage &getTrackedImage(vk::Image image);
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+bool vk_gltf_viewer::vulkan::MemoryAccess::isWrite() const noexcept {
+    constexpr vk::AccessFlags2 writeAccessMask
+        = vk::AccessFlagBits2::eShaderWrite
+        | vk::AccessFlagBits2::eShaderStorageWrite
+        | vk::AccessFlagBits2::eColorAttachmentWrite
+        | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+        | vk::AccessFlagBits2::eTransferWrite
+        | vk::AccessFlagBits2::eHostWrite
+        | vk::AccessFlagBits2::eMemoryWrite;
+    return static_cast<bool>(accessMask & writeAccessMask);
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::track(
+    vk::Image image,
+    vk::ImageAspectFlags aspectFlags,
+    std::uint32_t mipLevels,
+    std::uint32_t arrayLayers,
+    const ImageAccess &initialAccess
+) {
+    assert(std::ranges::find(trackedImages, image, &TrackedImage::image) == trackedImages.end() && "Image is already tracked");
+    trackedImages.emplace_back(
+        image, aspectFlags, mipLevels, arrayLayers,
+        std::vector(mipLevels * arrayLayers, State::from(initialAccess, initialAccess.layout)));
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::track(vk::Buffer buffer, const MemoryAccess &initialAccess) {
+    assert(std::ranges::find(trackedBuffers, buffer, &TrackedBuffer::buffer) == trackedBuffers.end() && "Buffer is already tracked");
+    trackedBuffers.emplace_back(buffer, State::from(initialAccess, vk::ImageLayout::eUndefined));
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::assume(
+    vk::Image image,
+    std::uint32_t baseMipLevel,
+    std::uint32_t levelCount,
+    std::uint32_t baseArrayLayer,
+    std::uint32_t layerCount,
+    const ImageAccess &access
+) {
+    TrackedImage &trackedImage = getTrackedImage(image);
+    if (levelCount == vk::RemainingMipLevels) levelCount = trackedImage.mipLevels - baseMipLevel;
+    if (layerCount == vk::RemainingArrayLayers) layerCount = trackedImage.arrayLayers - baseArrayLayer;
+
+    for (std::uint32_t arrayLayer = baseArrayLayer; arrayLayer < baseArrayLayer + layerCount; ++arrayLayer) {
+        std::ranges::fill(
+            std::span { trackedImage.states }.subspan(arrayLayer * trackedImage.mipLevels + baseMipLevel, levelCount),
+            State::from(access, access.layout));
+    }
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::access(
+    vk::Image image,
+    std::uint32_t baseMipLevel,
+    std::uint32_t levelCount,
+    std::uint32_t baseArrayLayer,
+    std::uint32_t layerCount,
+    const ImageAccess &access
+) {
+    TrackedImage &trackedImage = getTrackedImage(image);
+    if (levelCount == vk::RemainingMipLevels) levelCount = trackedImage.mipLevels - baseMipLevel;
+    if (layerCount == vk::RemainingArrayLayers) layerCount = trackedImage.arrayLayers - baseArrayLayer;
+
+    // Barriers derived by this access. Barriers of the adjacent array layers are merged if they only differ by the
+    // array layer.
+    const std::size_t firstBarrierIndex = pendingImageBarriers.size();
+
+    for (std::uint32_t arrayLayer = baseArrayLayer; arrayLayer < baseArrayLayer + layerCount; ++arrayLayer) {
+        const std::span states = std::span { trackedImage.states }.subspan(arrayLayer * trackedImage.mipLevels + baseMipLevel, levelCount);
+
+        // Emit a barrier for each run of the contiguous mip levels that have the same state.
+        for (auto first = states.begin(); first != states.end();) {
+            const auto last = std::ranges::find_if(first, states.end(), [&](const State &state) { return state != *first; });
+
+            const vk::ImageLayout oldLayout = first->layout;
+            State newState = *first;
+            if (const std::optional src = transit(newState, access, access.layout)) {
+                const vk::ImageMemoryBarrier2 barrier {
+                    src->stageMask, src->accessMask,
+                    access.stageMask, access.accessMask,
+                    oldLayout, access.layout,
+                    vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+                    image,
+                    {
+                        trackedImage.aspectFlags,
+                        baseMipLevel + static_cast<std::uint32_t>(std::distance(states.begin(), first)),
+                        static_cast<std::uint32_t>(std::distance(first, last)),
+                        arrayLayer, 1,
+                    },
+                };
+
+                const auto mergeable = std::ranges::find_if(
+                    pendingImageBarriers.begin() + firstBarrierIndex, pendingImageBarriers.end(),
+                    [&](const vk::ImageMemoryBarrier2 &pending) {
+                        const vk::ImageSubresourceRange &range = pending.subresourceRange;
+                        return range.baseArrayLayer + range.layerCount == arrayLayer
+                            && range.baseMipLevel == barrier.subresourceRange.baseMipLevel
+                            && range.levelCount == barrier.subresourceRange.levelCount
+                            && vk::ImageMemoryBarrier2 { pending }.setSubresourceRange(barrier.subresourceRange) == barrier;
+                    });
+                if (mergeable == pendingImageBarriers.end()) {
+                    pendingImageBarriers.push_back(barrier);
+                }
+                else {
+                    ++mergeable->subresourceRange.layerCount;
+                }
+            }
+
+            std::fill(first, last, newState);
+            first = last;
+        }
+    }
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::access(vk::Image image, std::uint32_t baseMipLevel, std::uint32_t levelCount, const ImageAccess &access) {
+    this->access(image, baseMipLevel, levelCount, 0, vk::RemainingArrayLayers, access);
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::access(vk::Image image, const ImageAccess &access) {
+    this->access(image, 0, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers, access);
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::access(vk::Buffer buffer, const MemoryAccess &access) {
+    const auto it = std::ranges::find(trackedBuffers, buffer, &TrackedBuffer::buffer);
+    assert(it != trackedBuffers.end() && "Buffer is not tracked");
+
+    if (const std::optional src = transit(it->state, access, vk::ImageLayout::eUndefined)) {
+        pendingBufferBarriers.push_back({
+            src->stageMask, src->accessMask,
+            access.stageMask, access.accessMask,
+            vk::QueueFamilyIgnored, vk::QueueFamilyIgnored,
+            buffer, 0, vk::WholeSize,
+        });
+    }
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::access(const MemoryAccess &access) {
+    if (const std::optional src = transit(globalState, access, vk::ImageLayout::eUndefined)) {
+        pendingMemoryBarriers.push_back({ src->stageMask, src->accessMask, access.stageMask, access.accessMask });
+    }
+}
+
+void vk_gltf_viewer::vulkan::AccessTracker::flush(vk::CommandBuffer cb) {
+    if (pendingMemoryBarriers.empty() && pendingBufferBarriers.empty() && pendingImageBarriers.empty()) return;
+
+    cb.pipelineBarrier2KHR({ {}, pendingMemoryBarriers, pendingBufferBarriers, pendingImageBarriers });
+    pendingMemoryBarriers.clear();
+    pendingBufferBarriers.clear();
+    pendingImageBarriers.clear();
+}
+
+vk_gltf_viewer::vulkan::AccessTracker::State vk_gltf_viewer::vulkan::AccessTracker::State::from(const MemoryAccess &access, vk::ImageLayout layout) noexcept {
+    if (access.isWrite()) {
+        return { layout, access.stageMask, access.accessMask, {}, {} };
+    }
+    else {
+        return { layout, {}, {}, access.stageMask, access.accessMask };
+    }
+}
+
+std::optional<vk_gltf_viewer::vulkan::MemoryAccess> vk_gltf_viewer::vulkan::AccessTracker::transit(
+    State &state,
+    const MemoryAccess &access,
+    vk::ImageLayout layout
+) noexcept {
+    const bool layoutTransition = state.layout != layout;
+    std::optional<MemoryAccess> src;
+    if (layoutTransition || access.isWrite()) {
+        // Write-after-read/write hazard, or the layout transition that behaves as a write.
+        if (layoutTransition || state.writeStageMask || state.readStageMask) {
+            src.emplace(state.writeStageMask | state.readStageMask, state.writeAccessMask);
+        }
+    }
+    else if (state.writeStageMask
+        && ((access.stageMask & ~state.readStageMask) || (access.accessMask & ~state.readAccessMask))) {
+        // Read-after-write hazard, for the stages or accesses that are not made visible yet.
+        src.emplace(state.writeStageMask, state.writeAccessMask);
+    }
+
+    if (access.isWrite()) {
+        state = { layout, access.stageMask, access.accessMask, {}, {} };
+    }
+    else if (layoutTransition) {
+        // Subsequent reads in the other stages must wait for the layout transition, which is ordered before
+        // access.stageMask.
+        state = { layout, access.stageMask, {}, access.stageMask, access.accessMask };
+    }
+    else {
+        state.readStageMask |= access.stageMask;
+        state.readAccessMask |= access.accessMask;
+    }
+
+    return src;
+}
+
+vk_gltf_viewer::vulkan::AccessTracker::TrackedImage &vk_gltf_viewer::vulkan::AccessTracker::getTrackedImage(vk::Image image) {
+    const auto it = std::ranges::find(trackedImages, image, &TrackedImage::image);
+    assert(it != trackedImages.end() && "Image is not tracked");
+    return *it;
+}
@@ -10,6 +10,7 @@ module;
 export module vk_gltf_viewer.vulkan.Frame;
 
 import std;
+export import BS.thread_pool;
 export import fastgltf;
 export import glm;
 export import vkgltf;
@@ -20,6 +21,7 @@ import vk_gltf_viewer.vulkan.ag.MousePicking;
 import vk_gltf_viewer.vulkan.ag.Scene;
 import vk_gltf_viewer.vulkan.buffer.IndirectDrawCommands;
 export import vk_gltf_viewer.Renderer;
+export import vk_gltf_viewer.vulkan.QueueTimelines;
 export import vk_gltf_viewer.vulkan.SharedData;
 
 /**
@@ -33,7 +35,17 @@ export import vk_gltf_viewer.vulkan.SharedData;
  */
 struct CommandSeparationCriteria {
     std::uint32_t subpass;
+
+    /// Whether the primitives sample the opaque scene color for KHR_materials_transmission. In the opaque subpass,
+    /// they must be drawn after the scene color is copied, therefore ordered after the non-transmissive ones.
+    bool transmission;
+
     vk::Pipeline pipeline;
+
+    /// Whether the primitives are drawn by the meshlet culled indices, which are bound from the frame's culled index
+    /// buffer instead of the asset's combined index buffer.
+    bool meshletCulling;
+
     std::optional<vk::IndexType> indexType;
     vk::PrimitiveTopology primitiveTopology;
     std::optional<std::uint32_t> stencilReference;
@@ -63,6 +75,7 @@ struct CommandSeparationCriteriaNoShading {
 namespace vk_gltf_viewer::vulkan {
     export class Frame {
         const SharedData &sharedData;
+        QueueTimelines &timelines;
 
     public:
         struct GltfAsset {
@@ -126,6 +139,12 @@ namespace vk_gltf_viewer::vulkan {
              * @brief Information of glTF to be rendered. <tt>std::nullopt</tt> if no glTF scene to be rendered.
              */
             std::optional<Gltf> gltf;
+
+            /**
+             * @brief Whether to query the pipeline statistics of the scene rendering. Ignored if
+             * <tt>Gpu::supportPipelineStatisticsQuery</tt> is <tt>false</tt>.
+             */
+            bool recordPipelineStatistics;
         };
 
         struct ExecutionResult {
@@ -133,6 +152,79 @@ namespace vk_gltf_viewer::vulkan {
              * @brief Node index of the current pointing mesh. <tt>std::nullopt</tt> if there is no mesh under the cursor.
              */
             std::variant<std::monostate, std::size_t, std::vector<std::size_t>> mousePickingResult;
+
+            /**
+             * @brief GPU time of the scene rendering, measured by the timestamp queries. <tt>std::nullopt</tt> if the
+             * scene was not rendered or the timestamp query is not supported.
+             */
+            std::optional<std::chrono::duration<float, std::milli>> sceneRenderingGpuTime;
+
+            /**
+             * @brief GPU execution range of a pass, measured by the timestamp queries.
+             */
+            struct GpuPassTime {
+                std::string_view name;
+
+                /// Begin and end of the pass, relative to the earliest begin of the frame's passes.
+                std::chrono::duration<float, std::milli> begin, end;
+            };
+
+            /**
+             * @brief GPU execution ranges of the passes that were recorded in the frame, in the recording order. Empty
+             * if the timestamp query is not supported.
+             */
+            std::vector<GpuPassTime> gpuPassTimes;
+
+            struct PipelineStatistics {
+                std::uint64_t vertexShaderInvocations;
+                std::uint64_t clippingPrimitives;
+                std::uint64_t fragmentShaderInvocations;
+            };
+
+            /**
+             * @brief Pipeline statistics of the scene render pass. <tt>std::nullopt</tt> if it was not requested by
+             * <tt>ExecutionTask::recordPipelineStatistics</tt> or not supported.
+             */
+            std::optional<PipelineStatistics> pipelineStatistics;
+
+            /**
+             * @brief Draw statistics of a multi-draw-indirect call, i.e. a bucket of the scene rendering draw calls
+             * grouped by their required state.
+             */
+            struct DrawStatistics {
+                std::uint32_t subpass;
+                std::optional<vk::IndexType> indexType;
+                vk::PrimitiveTopology primitiveTopology;
+                vk::CullModeFlagBits cullMode;
+                std::uint32_t drawCount;
+
+                /// Number of the primitives (points, lines or triangles) of the draw calls, including instances.
+                std::uint64_t primitiveCount;
+            };
+
+            /**
+             * @brief Draw statistics of the scene rendering, for each multi-draw-indirect call.
+             */
+            std::vector<DrawStatistics> drawStatistics;
+
+            /**
+             * @brief Selected level of detail of a rendered node primitive, for the visualization.
+             */
+            struct LevelOfDetailMarker {
+                /// Center of the projected bounding sphere, in the normalized viewport coordinates (top-left is origin).
+                glm::vec2 position;
+
+                /// Radius of the projected bounding sphere, relative to the viewport height.
+                float radius;
+
+                std::uint32_t level;
+            };
+
+            /**
+             * @brief Selected level of details of the rendered node primitives. Empty if visualization is not
+             * requested by <tt>Renderer::LevelOfDetail::visualize</tt>.
+             */
+            std::vector<LevelOfDetailMarker> levelOfDetailMarkers;
         };
 
         std::shared_ptr<const Renderer> renderer;
@@ -144,31 +236,97 @@ namespace vk_gltf_viewer::vulkan {
         std::optional<GltfAsset> gltfAsset;
         vku::DescriptorSet<dsl::Asset> assetDescriptorSet;
 
-        Frame(std::shared_ptr<const Renderer> renderer, const SharedData &sharedData LIFETIMEBOUND);
+        Frame(std::shared_ptr<const Renderer> renderer, const SharedData &sharedData LIFETIMEBOUND, QueueTimelines &timelines LIFETIMEBOUND);
 
         [[nodiscard]] ExecutionResult getExecutionResult();
-        void update(const ExecutionTask &task);
-
-        void recordCommandsAndSubmit() const;
-        void recordCommandsAndSubmitFirstFrame() const;
 
+        /**
+         * @brief Update the frame for \p task, and start preparing the draw commands in \p threadPool.
+         *
+         * Frustum culling, level of detail selection, meshlet culling preparation and draw command generation are
+         * done by the worker thread, from a snapshot of the node world transforms, visibilities, selection and hovering
+         * node taken by this function. Therefore, the caller may modify them after this function returns. The other
+         * asset data (e.g. materials, morph target weights) is still read by the worker thread until the returned
+         * future is ready.
+         *
+         * @param task Execution task of the frame.
+         * @param threadPool Thread pool for the draw command preparation.
+         * @return Shared future of the draw command preparation. It is joined by <tt>recordCommandsAndSubmit()</tt> and
+         * <tt>recordCommandsAndSubmitFirstFrame()</tt>.
+         */
+        std::shared_future<void> update(const ExecutionTask &task, BS::thread_pool<> &threadPool);
+
+        /**
+         * @brief Record the frame commands and submit them.
+         *
+         * Scene prepass, opaque/blend mesh drawing and node outline composition are recorded into the secondary command
+         * buffers in parallel using \p threadPool, and executed by the primary command buffers in order.
+         *
+         * @param threadPool Thread pool for the secondary command buffer recording. It must not be changed during the
+         * frame's lifetime, as the per-thread command pools are indexed by its thread index.
+         */
+        void recordCommandsAndSubmit(BS::thread_pool<> &threadPool);
+        void recordCommandsAndSubmitFirstFrame();
+
+        /**
+         * @brief Recreate the viewport resources.
+         * @param extent Viewport extent in the swapchain image. Its width and height must be even.
+         */
         void setViewportExtent(const vk::Extent2D &extent);
+
+        /**
+         * @brief Change the scale factor of the scene rendering extent.
+         *
+         * The scene is rendered in the viewport extent scaled by \p renderScale, and upscaled to the viewport extent
+         * when it is copied to the swapchain image. Only the render area, viewport and scissor are changed, and the
+         * viewport resources are not recreated.
+         *
+         * @param renderScale Scale factor of the scene rendering extent, in (0, 1].
+         */
+        void setRenderScale(float renderScale);
         void updateSampleCount();
         void updateViewCount();
+        void updateJumpFloodResolution();
 
         void updateAsset();
 
+        /**
+         * @brief Update the asset descriptor set to point the current material buffer, which may be replaced by
+         * enlarging.
+         */
+        void updateMaterialBuffer();
+
+        /**
+         * @brief Update the image based lighting descriptor set to point the given resources.
+         *
+         * As the descriptor set is owned by the frame, the resources can be replaced while the other frames are in
+         * flight.
+         */
+        void updateImageBasedLighting(const vk::DescriptorBufferInfo &sphericalHarmonicsBufferInfo, vk::ImageView prefilteredmapImageView, vk::ImageView brdfmapImageView);
+
+        /**
+         * @brief Update the skybox descriptor set to point the given cubemap.
+         */
+        void updateSkybox(vk::ImageView cubemapImageView);
+
     private:
         class Viewport {
             std::reference_wrapper<const Gpu> gpu;
             std::reference_wrapper<const rp::BloomApply> bloomApplyRenderPass;
 
         public:
+            /**
+             * @brief Ping-pong image for flooding the hovering node and selected nodes outlines at once.
+             *
+             * Image has <tt>4 * viewCount</tt> array layers, consisted of:
+             * - <tt>[0, viewCount)</tt>: hovering node ping layers (seeded by <tt>hoveringNodeJumpFloodSeedAttachmentGroup</tt>),
+             * - <tt>[viewCount, 2 * viewCount)</tt>: selected nodes ping layers (seeded by <tt>selectedNodeJumpFloodSeedAttachmentGroup</tt>),
+             * - <tt>[2 * viewCount, 4 * viewCount)</tt>: pong layers of the above, in the same order.
+             */
             class JumpFloodResources {
             public:
                 vku::raii::AllocatedImage image;
                 vk::raii::ImageView imageView;
-                std::array<vk::raii::ImageView, 2> pingPongImageViews;
 
             private:
                 friend class Viewport; // This class can only be constructed by a Viewport instance.
@@ -192,13 +350,24 @@ namespace vk_gltf_viewer::vulkan {
             /// Number of views in the viewport. It must be 1, 2 or 4.
             std::uint32_t viewCount;
 
+            /// Scale factor of the scene rendering extent, in (0, 1].
+            float renderScale;
+
+            /// Extent of the rendered region of each view, which is <tt>subextent</tt> scaled by <tt>renderScale</tt>.
+            /// The attachments are allocated in the full extent and each view is rendered at the top-left corner of its
+            /// <tt>subextent</tt> sized region, therefore changing the render scale does not recreate them.
+            vk::Extent2D renderSubextent;
+
             // Mouse picking.
             std::optional<ag::MousePicking> mousePickingAttachmentGroup; // has value only if Gpu::attachmentLessRenderPass == true.
 
+            /// Binary logarithm of the ratio of <tt>subextent</tt> to the jump flood image extent. 1 if the outlines are
+            /// calculated in the half resolution, otherwise 0.
+            std::uint32_t jumpFloodResolutionShift;
+
             // Outline calculation using JFA.
-            JumpFloodResources hoveringNodeOutlineJumpFloodResources;
+            JumpFloodResources outlineJumpFloodResources;
             ag::JumpFloodSeed hoveringNodeJumpFloodSeedAttachmentGroup;
-            JumpFloodResources selectedNodeOutlineJumpFloodResources;
             ag::JumpFloodSeed selectedNodeJumpFloodSeedAttachmentGroup;
 
             // Bloom.
@@ -206,29 +375,73 @@ namespace vk_gltf_viewer::vulkan {
             vk::raii::ImageView bloomImageView;
             std::vector<vk::raii::ImageView> bloomMipImageViews;
 
+            /// Opaque scene color copied before the transmissive meshes are rendered, with the same extent, array
+            /// layers and mip levels as <tt>bloomImage</tt>. Its mip chain is generated by the bloom downsampling.
+            vku::raii::AllocatedImage transmissionImage;
+            vk::raii::ImageView transmissionImageView;
+            std::vector<vk::raii::ImageView> transmissionMipImageViews;
+
+            /// Whether <tt>transmissionImage</tt> is in <tt>vk::ImageLayout::eShaderReadOnlyOptimal</tt>. As it is statically
+            /// used by every PrimitiveRenderPipeline, it must be in the layout even if there is no transmissive mesh.
+            bool transmissionImageLayoutInitialized = false;
+
             Viewport(
                 const Gpu &gpu LIFETIMEBOUND,
                 const vk::Extent2D &extent,
                 std::uint32_t viewCount,
+                float renderScale,
+                std::uint32_t jumpFloodResolutionShift,
                 const rp::Scene &sceneRenderPass LIFETIMEBOUND,
                 const rp::BloomApply &bloomApplyRenderPass LIFETIMEBOUND
             );
 
+            /// Rendered regions of the views, whose extents are <tt>renderSubextent</tt>.
             [[nodiscard]] boost::container::static_vector<vk::Rect2D, 4> getSubrects() const noexcept;
 
+            /// Smallest rectangle that covers all rendered regions of the views.
+            [[nodiscard]] vk::Rect2D getRenderArea() const noexcept;
+
             void setSceneRenderPass(const rp::Scene &sceneRenderPass);
             void setViewCount(std::uint32_t count);
+            void setRenderScale(float scale);
+            void setJumpFloodResolutionShift(std::uint32_t shift);
 
         private:
+            [[nodiscard]] vk::Extent2D getRenderSubextent() const noexcept;
+            [[nodiscard]] vk::Extent2D getJumpFloodExtent() const noexcept;
             [[nodiscard]] vku::raii::AllocatedImage createBloomImage() const;
-            [[nodiscard]] std::vector<vk::raii::ImageView> createBloomMipImageViews() const;
+            [[nodiscard]] vku::raii::AllocatedImage createTransmissionImage() const;
+            [[nodiscard]] std::vector<vk::raii::ImageView> createMipImageViews(const vku::raii::AllocatedImage &image) const;
         };
 
+        /**
+         * @brief Command pool and its allocated secondary command buffers, used by a single thread.
+         *
+         * As a command pool must be externally synchronized, each thread of the recording thread pool has its own one.
+         * Allocated command buffers are reused across the executions of the frame, by resetting the command pool.
+         */
+        struct SecondaryCommandBufferAllocator {
+            vk::raii::CommandPool commandPool;
+            std::vector<vk::CommandBuffer> commandBuffers;
+            std::size_t usedCount = 0;
+
+            SecondaryCommandBufferAllocator(const vk::raii::Device &device LIFETIMEBOUND, std::uint32_t queueFamilyIndex);
+
+            [[nodiscard]] vk::CommandBuffer allocate(const vk::raii::Device &device);
+            void reset();
+        };
+
+        using IndirectDrawCommandBufferIterator = std::map<CommandSeparationCriteria, buffer::IndirectDrawCommands>::const_iterator;
+
         struct RenderingNodes {
             std::map<CommandSeparationCriteria, buffer::IndirectDrawCommands> indirectDrawCommandBuffers;
             std::map<CommandSeparationCriteriaNoShading, buffer::IndirectDrawCommands> mousePickingIndirectDrawCommandBuffers;
             std::map<CommandSeparationCriteriaNoShading, buffer::IndirectDrawCommands> multiNodeMousePickingIndirectDrawCommandBuffers;
             bool startMousePickingRenderPass = true;
+
+            /// Whether the meshlet culling was applied when the draw commands were generated. If it is changed, the
+            /// draw commands must be regenerated to use the combined index buffer or the meshlet culled index buffer.
+            bool meshletCulling = false;
         };
 
         struct SelectedNodes {
@@ -241,26 +454,65 @@ namespace vk_gltf_viewer::vulkan {
             std::map<CommandSeparationCriteriaNoShading, buffer::IndirectDrawCommands> jumpFloodSeedIndirectDrawCommandBuffers;
         };
 
+        /**
+         * @brief Host asset state that the draw commands are prepared from, copied by <tt>update()</tt>.
+         *
+         * It is owned by the draw command preparation task, so that the main thread and the animation sampling of the
+         * next frame can update the asset state while the draw commands are being prepared.
+         */
+        struct DrawCommandSnapshot {
+            /// Whether the scene rendering and mouse picking draw commands have to be regenerated.
+            bool regenerateRenderingNodes;
+
+            /// Whether the outline draw commands have to be regenerated even if the selection is not changed.
+            bool regenerateOutlineNodes;
+
+            /// Whether the meshlet culling is applied to the scene rendering draw commands.
+            bool cullMeshlets;
+
+            /// Mouse picking input in the scene rendering extent.
+            std::optional<std::pair<std::uint32_t, vk::Rect2D>> mousePickingInput;
+
+            std::vector<fastgltf::math::fmat4x4> nodeWorldTransforms;
+
+            /// Indices of the visible nodes. Empty if <tt>regenerateRenderingNodes</tt> is <tt>false</tt>.
+            std::vector<std::size_t> visibleNodeIndices;
+
+            /// Selected nodes whose outline is drawn. Empty if the selected node outline is disabled.
+            std::unordered_set<std::size_t> selectedNodes;
+
+            /// Hovering node whose outline is drawn. <tt>std::nullopt</tt> if the hovering node outline is disabled or
+            /// is the only selected node.
+            std::optional<std::size_t> hoveringNode;
+        };
+
         // Buffer, image and image views.
         vku::raii::AllocatedBuffer cameraBuffer;
+        vku::raii::AllocatedBuffer bloomCounterBuffer;
+        vku::raii::AllocatedBuffer transmissionCounterBuffer;
         std::optional<Viewport> viewport;
 
+        /// Scale factor of the scene rendering extent, which is applied to <tt>viewport</tt> whenever it is recreated.
+        float renderScale = 1.f;
+
         // Descriptor/command pools.
         vk::raii::DescriptorPool descriptorPool;
         vk::raii::CommandPool computeCommandPool;
         vk::raii::CommandPool graphicsCommandPool;
+        std::vector<SecondaryCommandBufferAllocator> secondaryCommandBufferAllocators;
 
         // Descriptor sets.
         vku::DescriptorSet<dsl::Renderer> rendererSet;
+        vku::DescriptorSet<dsl::ImageBasedLighting> imageBasedLightingSet;
+        vku::DescriptorSet<dsl::Skybox> skyboxSet;
         vku::DescriptorSet<dsl::MousePicking> mousePickingSet;
-        vku::DescriptorSet<JumpFloodComputePipeline::DescriptorSetLayout> hoveringNodeJumpFloodSet;
-        vku::DescriptorSet<JumpFloodComputePipeline::DescriptorSetLayout> selectedNodeJumpFloodSet;
-        vku::DescriptorSet<dsl::Outline> hoveringNodeOutlineSet;
-        vku::DescriptorSet<dsl::Outline> selectedNodeOutlineSet;
+        vku::DescriptorSet<JumpFloodComputePipeline::DescriptorSetLayout> jumpFloodSet;
+        vku::DescriptorSet<dsl::Outline> outlineSet;
         vku::DescriptorSet<dsl::WeightedBlendedComposition> weightedBlendedCompositionSet;
         vku::DescriptorSet<dsl::InverseToneMapping> inverseToneMappingSet;
         vku::DescriptorSet<bloom::BloomComputePipeline::DescriptorSetLayout> bloomSet;
         vku::DescriptorSet<dsl::BloomApply> bloomApplySet;
+        vku::DescriptorSet<bloom::BloomComputePipeline::DescriptorSetLayout> transmissionSet;
 
         // Command buffers.
         vk::CommandBuffer scenePrepassCommandBuffer;
@@ -269,25 +521,89 @@ namespace vk_gltf_viewer::vulkan {
         vk::CommandBuffer jumpFloodCommandBuffer;
 
         // Synchronization stuffs.
-        vk::raii::Semaphore scenePrepassFinishSema;
-        vk::raii::Semaphore sceneRenderingFinishSema;
-        vk::raii::Semaphore jumpFloodFinishSema;
+
+        /// Graphics queue timeline value signaled by the last submission of the frame, which is the composition and
+        /// waits for all the other submissions. Therefore, the frame execution is finished when the timeline reaches it.
+        std::uint64_t frameFinishValue = 0;
+
         vk::raii::Semaphore swapchainImageAcquireSema;
-        vk::raii::Fence inFlightFence;
+
+        /**
+         * @brief GPU passes whose execution ranges are measured by the timestamp queries.
+         *
+         * Each pass <tt>p</tt> uses the queries <tt>[2 * p, 2 * p + 2)</tt> of <tt>timestampQueryPool</tt>, which are
+         * reset by the command buffer that records the pass.
+         */
+        enum class GpuPass : std::uint8_t {
+            ScenePrepass,
+            JumpFlood,
+            Scene,
+            Bloom,
+            Composition,
+        };
+        static constexpr std::size_t gpuPassCount = 5;
+
+        /// Timestamps of the GpuPass begin/end, has value only if Gpu::supportGraphicsQueueTimestamp == true.
+        std::optional<vk::raii::QueryPool> timestampQueryPool;
+        std::bitset<gpuPassCount> timestampQueryWrittenPasses;
+
+        /// Pipeline statistics of the scene render pass, has value only if Gpu::supportPipelineStatisticsQuery == true.
+        std::optional<vk::raii::QueryPool> pipelineStatisticsQueryPool;
+        bool recordPipelineStatistics = false;
+        bool pipelineStatisticsQueryWritten = false;
 
         vk::Offset2D passthruOffset;
         std::optional<RenderingNodes> renderingNodes;
         std::optional<SelectedNodes> selectedNodes;
         std::optional<HoveringNode> hoveringNode;
+        std::vector<ExecutionResult::LevelOfDetailMarker> levelOfDetailMarkers;
+
+        /// Draw command preparation started by the last <tt>update()</tt>. <tt>renderingNodes</tt>, <tt>selectedNodes</tt>,
+        /// <tt>hoveringNode</tt>, <tt>levelOfDetailMarkers</tt> and the meshlet culling resources must not be accessed
+        /// until it is joined.
+        std::shared_future<void> drawCommandPreparation;
+
+        // Meshlet culling of renderingNodes->indirectDrawCommandBuffers, whose buffers are grown on demand.
+
+        /// Host-written <tt>MeshletCullingComputePipeline::Header</tt>, followed by <tt>meshletCullingDrawCount</tt> draws.
+        std::optional<vku::raii::AllocatedBuffer> meshletCullingInputBuffer;
+
+        /// Indices of the visible meshlets, written by <tt>MeshletCullingComputePipeline</tt>.
+        std::optional<vku::raii::AllocatedBuffer> meshletCulledIndexBuffer;
+
+        /// Number of the draws to be culled. If 0, every meshlet culled draw command is culled by the frustum culling.
+        std::uint32_t meshletCullingDrawCount = 0;
         std::variant<vku::DescriptorSet<dsl::Skybox>, glm::vec3> background;
 
         [[nodiscard]] vk::raii::DescriptorPool createDescriptorPool() const;
 
-        void recordScenePrepassCommands(vk::CommandBuffer cb) const;
+        /**
+         * @brief Acquire the next swapchain image.
+         * @return Index of the acquired swapchain image, or <tt>std::nullopt</tt> if the swapchain is out of date (or
+         * suboptimal in MoltenVK) and the frame must be skipped.
+         */
+        [[nodiscard]] std::optional<std::uint32_t> acquireSwapchainImage();
+
+        /**
+         * @brief Wait for <tt>drawCommandPreparation</tt> if it is valid, and rethrow its exception if any.
+         */
+        void joinDrawCommandPreparation();
+
+        void prepareDrawCommands(const DrawCommandSnapshot &snapshot);
+
+        void beginGpuPass(vk::CommandBuffer cb, GpuPass pass) const;
+        void endGpuPass(vk::CommandBuffer cb, GpuPass pass);
+
+        void recordJumpFloodSeedCommands(vk::CommandBuffer cb, std::uint32_t baseLayer, const ag::JumpFloodSeed &attachmentGroup, const std::map<CommandSeparationCriteriaNoShading, buffer::IndirectDrawCommands> &indirectDrawCommandBuffers) const;
+        void recordMousePickingCommands(vk::CommandBuffer cb) const;
+        void recordMeshletCullingCommands(vk::CommandBuffer cb) const;
         // Return true if last jump flood calculation direction is forward (result is in pong image), false if backward.
-        [[nodiscard]] bool recordJumpFloodComputeCommands(vk::CommandBuffer cb, const vku::Image &image, vku::DescriptorSet<JumpFloodComputePipeline::DescriptorSetLayout> descriptorSet, std::uint32_t initialSampleOffset) const;
-        void recordSceneOpaqueMeshDrawCommands(vk::CommandBuffer cb) const;
-        bool recordSceneBlendMeshDrawCommands(vk::CommandBuffer cb) const;
-        void recordNodeOutlineCompositionCommands(vk::CommandBuffer cb, std::optional<bool> hoveringNodeJumpFloodForward, std::optional<bool> selectedNodeJumpFloodForward) const;
+        [[nodiscard]] bool recordJumpFloodComputeCommands(vk::CommandBuffer cb) const;
+        void recordSceneOpaqueMeshDrawCommands(vk::CommandBuffer cb, IndirectDrawCommandBufferIterator first, IndirectDrawCommandBufferIterator last) const;
+        void recordSceneBackgroundCommands(vk::CommandBuffer cb) const;
+        void recordSceneBlendMeshDrawCommands(vk::CommandBuffer cb, IndirectDrawCommandBufferIterator first, IndirectDrawCommandBufferIterator last) const;
+        void recordNodeOutlineCompositionCommands(vk::CommandBuffer cb, bool jumpFloodForward) const;
+        void updateJumpFloodDescriptorSets();
+        void updateTransmissionDescriptorSets();
     };
 }
\ No newline at end of file
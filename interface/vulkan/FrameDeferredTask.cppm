@@ -23,17 +23,24 @@ namespace vk_gltf_viewer::vulkan {
          * - <tt>updateNodeWorldTransformHierarchical</tt>
          * - <tt>updateNodeWorldTransformScene</tt>
          * - <tt>updateNodeTargetWeights</tt>
+         * - <tt>updateMaterialBuffer</tt>
          */
         void resetAssetRelated();
 
         void setViewportExtent(const vk::Extent2D &extent);
+        void setRenderScale(float renderScale);
         void updateSampleCount();
         void updateViewCount();
+        void updateJumpFloodResolution();
 
         void updateNodeWorldTransform(std::size_t nodeIndex);
         void updateNodeWorldTransformHierarchical(std::size_t nodeIndex);
         void updateNodeWorldTransformScene(std::size_t sceneIndex);
         void updateNodeTargetWeights(std::size_t nodeIndex, std::size_t startIndex, std::size_t count);
+        void updateMaterialBuffer();
+
+        void updateImageBasedLighting(const vk::DescriptorBufferInfo &sphericalHarmonicsBufferInfo, vk::ImageView prefilteredmapImageView, vk::ImageView brdfmapImageView);
+        void updateSkybox(vk::ImageView cubemapImageView);
 
     private:
         struct UpdateNodeWorldTransform {
@@ -45,12 +52,24 @@ namespace vk_gltf_viewer::vulkan {
             std::size_t sceneIndex;
         };
 
+        struct UpdateImageBasedLighting {
+            vk::DescriptorBufferInfo sphericalHarmonicsBufferInfo;
+            vk::ImageView prefilteredmapImageView;
+            vk::ImageView brdfmapImageView;
+        };
+
         std::optional<vk::Extent2D> viewportExtent;
+        std::optional<float> renderScale;
         bool needUpdateSampleCount = false;
         bool needUpdateViewCount = false;
+        bool needUpdateJumpFloodResolution = false;
 
         std::variant<std::monostate, UpdateNodeWorldTransform, UpdateNodeWorldTransformScene> nodeWorldTransformUpdateTask;
         std::unordered_map<std::size_t /* node index */, std::pair<std::size_t /* weight start index */, std::size_t /* weight count */>> nodeTargetWeightUpdateTask;
+        bool needUpdateMaterialBuffer = false;
+
+        std::optional<UpdateImageBasedLighting> imageBasedLightingUpdateTask;
+        std::optional<vk::ImageView> skyboxUpdateTask;
     };
 }
 
@@ -62,13 +81,20 @@ module :private;
 #define LIFT(...) [&](auto &&...xs) { return __VA_ARGS__(FWD(xs)...); }
 
 void vk_gltf_viewer::vulkan::FrameDeferredTask::executeAndReset(Frame &frame) {
+    if (renderScale) {
+        frame.setRenderScale(*renderScale);
+        renderScale.reset();
+    }
+
     if (viewportExtent) {
         frame.setViewportExtent(*viewportExtent);
         viewportExtent.reset();
 
-        // Frame::setViewportExtent(const vk::Extent2D&) will also re-construct the sample count/ view count related resources.
+        // Frame::setViewportExtent(const vk::Extent2D&) will also re-construct the sample count/view count/jump
+        // flood resolution related resources.
         needUpdateSampleCount = false;
         needUpdateViewCount = false;
+        needUpdateJumpFloodResolution = false;
     }
     else {
         if (needUpdateSampleCount) {
@@ -80,6 +106,11 @@ void vk_gltf_viewer::vulkan::FrameDeferredTask::executeAndReset(Frame &frame) {
             frame.updateViewCount();
             needUpdateViewCount = false;
         }
+
+        if (needUpdateJumpFloodResolution) {
+            frame.updateJumpFloodResolution();
+            needUpdateJumpFloodResolution = false;
+        }
     }
 
     visit(multilambda {
@@ -119,17 +150,40 @@ void vk_gltf_viewer::vulkan::FrameDeferredTask::executeAndReset(Frame &frame) {
         frame.gltfAsset->updateNodeTargetWeights(nodeIndex, weightStart, weightCount);
     }
     nodeTargetWeightUpdateTask.clear();
+
+    if (needUpdateMaterialBuffer) {
+        frame.updateMaterialBuffer();
+        needUpdateMaterialBuffer = false;
+    }
+
+    if (imageBasedLightingUpdateTask) {
+        frame.updateImageBasedLighting(
+            imageBasedLightingUpdateTask->sphericalHarmonicsBufferInfo,
+            imageBasedLightingUpdateTask->prefilteredmapImageView,
+            imageBasedLightingUpdateTask->brdfmapImageView);
+        imageBasedLightingUpdateTask.reset();
+    }
+
+    if (skyboxUpdateTask) {
+        frame.updateSkybox(*skyboxUpdateTask);
+        skyboxUpdateTask.reset();
+    }
 }
 
 void vk_gltf_viewer::vulkan::FrameDeferredTask::resetAssetRelated() {
     nodeWorldTransformUpdateTask.emplace<std::monostate>();
     nodeTargetWeightUpdateTask.clear();
+    needUpdateMaterialBuffer = false;
 }
 
 void vk_gltf_viewer::vulkan::FrameDeferredTask::setViewportExtent(const vk::Extent2D &extent) {
     viewportExtent.emplace(extent);
 }
 
+void vk_gltf_viewer::vulkan::FrameDeferredTask::setRenderScale(float renderScale) {
+    this->renderScale.emplace(renderScale);
+}
+
 void vk_gltf_viewer::vulkan::FrameDeferredTask::updateSampleCount() {
     needUpdateSampleCount = true;
 }
@@ -138,6 +192,10 @@ void vk_gltf_viewer::vulkan::FrameDeferredTask::updateViewCount() {
     needUpdateViewCount = true;
 }
 
+void vk_gltf_viewer::vulkan::FrameDeferredTask::updateJumpFloodResolution() {
+    needUpdateJumpFloodResolution = true;
+}
+
 void vk_gltf_viewer::vulkan::FrameDeferredTask::updateNodeWorldTransform(std::size_t nodeIndex) {
     visit(multilambda {
         [&](std::monostate) noexcept {
@@ -185,4 +243,21 @@ void vk_gltf_viewer::vulkan::FrameDeferredTask::updateNodeTargetWeights(std::siz
         const std::size_t end = std::min(weightStart + weightCount, startIndex + count);
         weightCount = end - weightStart;
     }
-}
\ No newline at end of file
+}
+
+void vk_gltf_viewer::vulkan::FrameDeferredTask::updateMaterialBuffer() {
+    needUpdateMaterialBuffer = true;
+}
+
+void vk_gltf_viewer::vulkan::FrameDeferredTask::updateImageBasedLighting(
+    const vk::DescriptorBufferInfo &sphericalHarmonicsBufferInfo,
+    vk::ImageView prefilteredmapImageView,
+    vk::ImageView brdfmapImageView
+) {
+    // Only the latest resources matter, as the previous ones may be already retired.
+    imageBasedLightingUpdateTask.emplace(sphericalHarmonicsBufferInfo, prefilteredmapImageView, brdfmapImageView);
+}
+
+void vk_gltf_viewer::vulkan::FrameDeferredTask::updateSkybox(vk::ImageView cubemapImageView) {
+    skyboxUpdateTask.emplace(cubemapImageView);
+}
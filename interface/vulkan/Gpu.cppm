@@ -55,6 +55,7 @@ namespace vk_gltf_viewer::vulkan {
         bool isUmaDevice;
         bool supportSwapchainMutableFormat;
         bool supportShaderBufferInt64Atomics;
+        bool supportVulkanMemoryModel;
         bool supportDrawIndirectCount;
         bool supportUint8Index;
         bool supportAttachmentFeedbackLoopLayout;
@@ -68,6 +69,14 @@ namespace vk_gltf_viewer::vulkan {
         bool supportR8G8SrgbImageFormat;
         bool supportS8UintDepthStencilAttachment;
         bool supportDynamicPrimitiveTopologyUnrestricted;
+        bool supportComputeQueueTimestamp;
+        bool supportGraphicsQueueTimestamp;
+        bool supportPipelineStatisticsQuery;
+
+        /**
+         * @brief Number of nanoseconds required for a timestamp query to be incremented by 1.
+         */
+        float timestampPeriod;
 
         Workaround workaround;
 
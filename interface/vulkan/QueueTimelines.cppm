@@ -0,0 +1,217 @@
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+#include <lifetimebound.hpp>
+
+export module vk_gltf_viewer.vulkan.QueueTimelines;
+
+import std;
+export import vku;
+
+export import vk_gltf_viewer.vulkan.Gpu;
+
+namespace vk_gltf_viewer::vulkan {
+    export class QueueTimeline;
+
+    /**
+     * @brief A point of the queue timeline, e.g. at which a resource written by the queue becomes ready to use.
+     */
+    export struct TimelinePoint {
+        std::reference_wrapper<const QueueTimeline> timeline;
+        std::uint64_t value;
+    };
+
+    /**
+     * @brief Timeline semaphore that is signaled by every submission to a queue.
+     *
+     * As every submission through <tt>submit()</tt> signals the next counter value, a counter value identifies the
+     * point of the queue execution. It is used for:
+     * - Gating: a resource written by the queue is ready at the value signaled by the writing submission, and the
+     *   submissions of the other queues that read the resource must wait for the value (<tt>addDependency()</tt>).
+     * - Retirement: a resource that is read by the submissions up to the value can be destroyed after the counter
+     *   reaches the value (<tt>retire()</tt>), without waiting for the queue to be idle.
+     */
+    export class QueueTimeline {
+    public:
+        QueueTimeline(const vk::raii::Device &device LIFETIMEBOUND, vk::Queue queue);
+
+        /**
+         * @brief Get the value signaled by the last submission, or <tt>0</tt> if nothing is submitted.
+         */
+        [[nodiscard]] std::uint64_t getLastSubmittedValue() const noexcept;
+
+        /**
+         * @brief Check whether the semaphore counter reached \p value, i.e. the submissions up to the value are
+         * finished.
+         *
+         * The counter value is queried only if the last queried value is less than \p value.
+         */
+        [[nodiscard]] bool isReached(std::uint64_t value) const;
+
+        /**
+         * @brief Block until the semaphore counter reaches \p value.
+         */
+        void wait(std::uint64_t value) const;
+
+        /**
+         * @brief Get the semaphore submit info to wait for \p value at \p stageMask.
+         */
+        [[nodiscard]] vk::SemaphoreSubmitInfo getWaitInfo(std::uint64_t value, vk::PipelineStageFlags2 stageMask) const noexcept;
+
+        /**
+         * @brief Make the next submission to the queue wait for \p readyAt at \p stageMask.
+         *
+         * As the wait orders every later submission of the queue, the dependency is dropped after the next submission.
+         *
+         * Use it for the resource written by another submission (of any queue) that are used by the submissions whose
+         * recording is not aware of the resource, e.g. frame rendering using the asset textures in uploading.
+         */
+        void addDependency(const TimelinePoint &readyAt, vk::PipelineStageFlags2 stageMask);
+
+        /**
+         * @brief Submit the command buffers to the queue, which signals the next counter value.
+         *
+         * The submission also waits for the dependencies that are added by <tt>addDependency()</tt> since the last
+         * submission.
+         *
+         * @param waitSemaphoreInfos Semaphores to be waited, in addition to the dependencies.
+         * @param commandBufferInfos Command buffers to be executed.
+         * @param signalSemaphoreInfos Semaphores to be signaled, in addition to the timeline semaphore.
+         * @return Signaled counter value, which will be reached when the submission is finished.
+         */
+        std::uint64_t submit(
+            vk::ArrayProxy<const vk::SemaphoreSubmitInfo> waitSemaphoreInfos,
+            vk::ArrayProxy<const vk::CommandBufferSubmitInfo> commandBufferInfos,
+            vk::ArrayProxy<const vk::SemaphoreSubmitInfo> signalSemaphoreInfos = {}
+        );
+
+        /**
+         * @brief Take ownership of \p resource and destroy it after the counter reaches \p value.
+         */
+        template <typename T>
+        void retire(std::uint64_t value, T &&resource) {
+            retiredResources.emplace_back(value, std::make_shared<std::remove_cvref_t<T>>(std::forward<T>(resource)));
+        }
+
+        /**
+         * @brief Destroy the retired resources whose counter values are reached.
+         */
+        void collect();
+
+    private:
+        struct Dependency {
+            TimelinePoint readyAt;
+            vk::PipelineStageFlags2 stageMask;
+        };
+
+        std::reference_wrapper<const vk::raii::Device> device;
+        vk::Queue queue;
+        vk::raii::Semaphore semaphore;
+
+        std::uint64_t lastSubmittedValue = 0;
+        mutable std::uint64_t lastReachedValue = 0;
+
+        std::vector<Dependency> dependencies;
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<void>>> retiredResources;
+    };
+
+    /**
+     * @brief Timelines of the queues in <tt>Gpu::queues</tt>.
+     *
+     * Submissions through them are identified by a single counter value per queue, therefore the resource gating and
+     * retirement among the queues can be tracked without the per-resource semaphores or fences.
+     */
+    export struct QueueTimelines {
+        QueueTimeline compute;
+        QueueTimeline graphicsPresent;
+        QueueTimeline transfer;
+
+        explicit QueueTimelines(const Gpu &gpu LIFETIMEBOUND);
+
+        /**
+         * @brief Destroy the retired resources of all queues whose counter values are reached.
+         */
+        void collect();
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+vk_gltf_viewer::vulkan::QueueTimeline::QueueTimeline(const vk::raii::Device &device, vk::Queue queue)
+    : device { device }
+    , queue { queue }
+    , semaphore { device, vk::StructureChain {
+        vk::SemaphoreCreateInfo{},
+        vk::SemaphoreTypeCreateInfo { vk::SemaphoreType::eTimeline, 0 },
+    }.get() } { }
+
+std::uint64_t vk_gltf_viewer::vulkan::QueueTimeline::getLastSubmittedValue() const noexcept {
+    return lastSubmittedValue;
+}
+
+bool vk_gltf_viewer::vulkan::QueueTimeline::isReached(std::uint64_t value) const {
+    if (value > lastReachedValue) {
+        lastReachedValue = semaphore.getCounterValue();
+    }
+    return value <= lastReachedValue;
+}
+
+void vk_gltf_viewer::vulkan::QueueTimeline::wait(std::uint64_t value) const {
+    if (isReached(value)) {
+        return;
+    }
+
+    std::ignore = device.get().waitSemaphores({ {}, *semaphore, value }, ~0ULL);
+    lastReachedValue = value;
+}
+
+vk::SemaphoreSubmitInfo vk_gltf_viewer::vulkan::QueueTimeline::getWaitInfo(std::uint64_t value, vk::PipelineStageFlags2 stageMask) const noexcept {
+    return { *semaphore, value, stageMask };
+}
+
+void vk_gltf_viewer::vulkan::QueueTimeline::addDependency(const TimelinePoint &readyAt, vk::PipelineStageFlags2 stageMask) {
+    dependencies.emplace_back(readyAt, stageMask);
+}
+
+std::uint64_t vk_gltf_viewer::vulkan::QueueTimeline::submit(
+    vk::ArrayProxy<const vk::SemaphoreSubmitInfo> waitSemaphoreInfos,
+    vk::ArrayProxy<const vk::CommandBufferSubmitInfo> commandBufferInfos,
+    vk::ArrayProxy<const vk::SemaphoreSubmitInfo> signalSemaphoreInfos
+) {
+    // Dependencies must be waited by the device even if they are already reached from the host, as the host side
+    // observation of the counter does not make the written memory visible to this queue.
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos { std::from_range, waitSemaphoreInfos };
+    for (const auto &[readyAt, stageMask] : dependencies) {
+        waitInfos.push_back(readyAt.timeline.get().getWaitInfo(readyAt.value, stageMask));
+    }
+
+    // Semaphore wait operation's second synchronization scope includes the later submissions of the queue,
+    // therefore the dependencies have to be waited only once.
+    dependencies.clear();
+
+    std::vector<vk::SemaphoreSubmitInfo> signalInfos { std::from_range, signalSemaphoreInfos };
+    signalInfos.emplace_back(*semaphore, ++lastSubmittedValue, vk::PipelineStageFlagBits2::eAllCommands);
+
+    queue.submit2KHR(vk::SubmitInfo2 { {}, waitInfos, commandBufferInfos, signalInfos });
+    return lastSubmittedValue;
+}
+
+void vk_gltf_viewer::vulkan::QueueTimeline::collect() {
+    std::erase_if(retiredResources, [this](const auto &retired) {
+        return isReached(retired.first);
+    });
+}
+
+vk_gltf_viewer::vulkan::QueueTimelines::QueueTimelines(const Gpu &gpu)
+    : compute { gpu.device, gpu.queues.compute }
+    , graphicsPresent { gpu.device, gpu.queues.graphicsPresent }
+    , transfer { gpu.device, gpu.queues.transfer } { }
+
+void vk_gltf_viewer::vulkan::QueueTimelines::collect() {
+    compute.collect();
+    graphicsPresent.collect();
+    transfer.collect();
+}
@@ -24,6 +24,7 @@ export import vk_gltf_viewer.vulkan.pipeline.GridRenderPipeline;
 export import vk_gltf_viewer.vulkan.pipeline.InverseToneMappingRenderPipeline;
 export import vk_gltf_viewer.vulkan.pipeline.JumpFloodComputePipeline;
 export import vk_gltf_viewer.vulkan.pipeline.JumpFloodSeedRenderPipeline;
+export import vk_gltf_viewer.vulkan.pipeline.MeshletCullingComputePipeline;
 export import vk_gltf_viewer.vulkan.pipeline.MultiNodeMousePickingRenderPipeline;
 export import vk_gltf_viewer.vulkan.pipeline.NodeMousePickingRenderPipeline;
 export import vk_gltf_viewer.vulkan.pipeline.OutlineRenderPipeline;
@@ -45,6 +46,7 @@ namespace vk_gltf_viewer::vulkan {
         // Buffer, image and image views and samplers.
         sampler::Cubemap cubemapSampler;
         sampler::BrdfLut brdfLutSampler;
+        sampler::Transmission transmissionSampler;
 
         // Descriptor set layouts.
         dsl::Asset assetDescriptorSetLayout;
@@ -70,6 +72,7 @@ namespace vk_gltf_viewer::vulkan {
         rp::BloomApply bloomApplyRenderPass;
 
         JumpFloodComputePipeline jumpFloodComputePipeline;
+        MeshletCullingComputePipeline meshletCullingComputePipeline;
         bloom::BloomComputePipeline bloomComputePipeline;
         OutlineRenderPipeline outlineRenderPipeline;
         BloomApplyRenderPipeline bloomApplyRenderPipeline;
@@ -107,6 +110,15 @@ namespace vk_gltf_viewer::vulkan {
         std::reference_wrapper<MultiviewPipelines> currentMultiviewPipelines;
 
     public:
+        /**
+         * @brief Number of the scene rendering pipelines created for the current sample count.
+         */
+        struct ScenePipelineCounts {
+            std::size_t primitive;
+            std::size_t primitiveWithMaterialExtension;
+            std::size_t unlitPrimitive;
+        };
+
         // --------------------
         // Attachment groups.
         // --------------------
@@ -114,13 +126,6 @@ namespace vk_gltf_viewer::vulkan {
         Swapchain swapchain;
         ag::ImGui imGuiAttachmentGroup;
 
-        // Descriptor pools.
-        vk::raii::DescriptorPool descriptorPool;
-
-        // Descriptor sets.
-        vku::DescriptorSet<dsl::ImageBasedLighting> imageBasedLightingDescriptorSet;
-        vku::DescriptorSet<dsl::Skybox> skyboxDescriptorSet;
-
         // --------------------
         // glTF assets.
         // --------------------
@@ -170,6 +175,12 @@ namespace vk_gltf_viewer::vulkan {
         [[nodiscard]] const PrimitiveRenderPipeline &getPrimitiveRenderPipeline(const PrimitiveRenderPipeline::Config &config) const;
         [[nodiscard]] const UnlitPrimitiveRenderPipeline &getUnlitPrimitiveRenderPipeline(const UnlitPrimitiveRenderPipeline::Config &config) const;
 
+        /**
+         * @brief Get the number of the primitive pipelines created so far, to monitor the growth of the shader
+         * variant and specialization constant permutations.
+         */
+        [[nodiscard]] ScenePipelineCounts getScenePipelineCounts() const noexcept;
+
     private:
         [[nodiscard]] MultisamplePipelines createMultisamplePipelines(vk::SampleCountFlagBits sampleCount) const;
     };
@@ -183,13 +194,14 @@ vk_gltf_viewer::vulkan::SharedData::SharedData(const Gpu &gpu, vk::SurfaceKHR su
     : gpu { gpu }
     , cubemapSampler { gpu.device }
     , brdfLutSampler { gpu.device }
+    , transmissionSampler { gpu.device }
     , assetDescriptorSetLayout { gpu }
     , bloomApplyDescriptorSetLayout { gpu.device }
     , imageBasedLightingDescriptorSetLayout { gpu.device, cubemapSampler, brdfLutSampler }
     , inverseToneMappingDescriptorSetLayout { gpu.device }
     , mousePickingDescriptorSetLayout { gpu.device }
     , outlineDescriptorSetLayout { gpu.device }
-    , rendererDescriptorSetLayout { gpu.device }
+    , rendererDescriptorSetLayout { gpu.device, transmissionSampler }
     , skyboxDescriptorSetLayout { gpu.device, cubemapSampler }
     , weightedBlendedCompositionDescriptorSetLayout { gpu.device }
     , bloomApplyPipelineLayout { gpu.device, bloomApplyDescriptorSetLayout }
@@ -202,7 +214,11 @@ vk_gltf_viewer::vulkan::SharedData::SharedData(const Gpu &gpu, vk::SurfaceKHR su
     , weightedBlendedCompositionPipelineLayout { gpu.device, weightedBlendedCompositionDescriptorSetLayout }
     , bloomApplyRenderPass { gpu }
     , jumpFloodComputePipeline { gpu.device }
-    , bloomComputePipeline { gpu.device, { .useAMDShaderImageLoadStoreLod = gpu.supportShaderImageLoadStoreLod } }
+    , meshletCullingComputePipeline { gpu.device }
+    , bloomComputePipeline { gpu.device, {
+        .useAMDShaderImageLoadStoreLod = gpu.supportShaderImageLoadStoreLod,
+        .useVulkanMemoryModel = gpu.supportVulkanMemoryModel,
+    } }
     , outlineRenderPipeline { gpu.device, outlinePipelineLayout }
     , bloomApplyRenderPipeline { gpu, bloomApplyPipelineLayout, bloomApplyRenderPass }
     , viewMask { 0b1U }
@@ -215,19 +231,7 @@ vk_gltf_viewer::vulkan::SharedData::SharedData(const Gpu &gpu, vk::SurfaceKHR su
     , currentMultiviewPipelines { multiviewPipelines[viewMask] } // will create an entry for viewMask = 0b1
     , swapchain { gpu, surface, swapchainExtent }
     , imGuiAttachmentGroup { gpu, swapchain.images }
-    , descriptorPool { [&] {
-        const auto [maxSets, poolSizes] = vku::DescriptorPoolSizeBuilder{}
-            .add(imageBasedLightingDescriptorSetLayout)
-            .add(skyboxDescriptorSetLayout)
-            .build();
-        return vk::raii::DescriptorPool { gpu.device, vk::DescriptorPoolCreateInfo { {}, maxSets, poolSizes } };
-    }() }
-    , fallbackTexture { gpu }{
-    vku::DescriptorSetAllocationBuilder{}
-        .add(imageBasedLightingDescriptorSetLayout, imageBasedLightingDescriptorSet)
-        .add(skyboxDescriptorSetLayout, skyboxDescriptorSet)
-        .allocate(gpu.device, *descriptorPool);
-}
+    , fallbackTexture { gpu } { }
 
 // --------------------
 // The below public methods will modify the GPU resources, therefore they MUST be called before the command buffer
@@ -296,6 +300,17 @@ auto vk_gltf_viewer::vulkan::SharedData::getUnlitPrimitiveRenderPipeline(
     return currentMultisamplePipelines.get().unlitPrimitiveRenderPipelines.try_emplace(config, gpu.device, primitivePipelineLayout, currentMultisamplePipelines.get().sceneRenderPass, config).first->second;
 }
 
+auto vk_gltf_viewer::vulkan::SharedData::getScenePipelineCounts() const noexcept -> ScenePipelineCounts {
+    const MultisamplePipelines &pipelines = currentMultisamplePipelines.get();
+    return {
+        .primitive = pipelines.primitiveRenderPipelines.size(),
+        .primitiveWithMaterialExtension = static_cast<std::size_t>(std::ranges::count_if(
+            pipelines.primitiveRenderPipelines | std::views::keys,
+            &PrimitiveRenderPipeline::Config::useMaterialExtension)),
+        .unlitPrimitive = pipelines.unlitPrimitiveRenderPipelines.size(),
+    };
+}
+
 auto vk_gltf_viewer::vulkan::SharedData::createMultisamplePipelines(vk::SampleCountFlagBits sampleCount) const -> MultisamplePipelines {
     rp::Scene sceneRenderPass { gpu, sampleCount };
     GridRenderPipeline gridRenderPipeline { gpu.device, rendererDescriptorSetLayout, sceneRenderPass };
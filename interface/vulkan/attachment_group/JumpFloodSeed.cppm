@@ -15,7 +15,10 @@ namespace vk_gltf_viewer::vulkan::ag {
         vku::raii::AllocatedImage depthImage;
         vk::raii::ImageView depthImageView;
 
-        JumpFloodSeed(const Gpu &gpu LIFETIMEBOUND, const vku::Image &seedImage, std::uint32_t viewCount);
+        /**
+         * @brief Create the attachment group that writes seeds into the layers <tt>[baseLayer, baseLayer + viewCount)</tt> of \p seedImage.
+         */
+        JumpFloodSeed(const Gpu &gpu LIFETIMEBOUND, const vku::Image &seedImage, std::uint32_t baseLayer, std::uint32_t viewCount);
     };
 }
 
@@ -23,8 +26,8 @@ namespace vk_gltf_viewer::vulkan::ag {
 module :private;
 #endif
 
-vk_gltf_viewer::vulkan::ag::JumpFloodSeed::JumpFloodSeed(const Gpu &gpu, const vku::Image &seedImage, std::uint32_t viewCount)
-    : seedImageView { gpu.device, seedImage.getViewCreateInfo(vk::ImageViewType::e2DArray, { vk::ImageAspectFlagBits::eColor, 0, 1, 0, viewCount } /* ping image subresource */) }
+vk_gltf_viewer::vulkan::ag::JumpFloodSeed::JumpFloodSeed(const Gpu &gpu, const vku::Image &seedImage, std::uint32_t baseLayer, std::uint32_t viewCount)
+    : seedImageView { gpu.device, seedImage.getViewCreateInfo(vk::ImageViewType::e2DArray, { vk::ImageAspectFlagBits::eColor, 0, 1, baseLayer, viewCount } /* ping image subresource */) }
     , depthImage {
         gpu.allocator,
         vk::ImageCreateInfo {
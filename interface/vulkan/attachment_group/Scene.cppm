@@ -75,8 +75,12 @@ vk_gltf_viewer::vulkan::ag::Scene::MultisampleResources::MultisampleResources(
         vma::AllocationCreateInfo {
             {},
             vma::MemoryUsage::eAutoPreferDevice,
+        // Stored by rp::Scene::opaqueRenderPass when the transmissive meshes are rendered, which cannot be done for the
+        // memoryless MTLStorageMode in MoltenVK.
+        #if !__APPLE__
             {},
             vk::MemoryPropertyFlagBits::eLazilyAllocated,
+        #endif
         },
     },
     colorImageView { gpu.device, colorImage.getViewCreateInfo(vk::ImageViewType::e2D) },
@@ -32,7 +32,8 @@ namespace vk_gltf_viewer::vulkan::buffer {
                 vk::BufferCreateInfo {
                     {},
                     sizeof(std::uint32_t) /* draw count */ + sizeof(Command) * commands.size(),
-                    vk::BufferUsageFlagBits::eIndirectBuffer,
+                    vk::BufferUsageFlagBits::eIndirectBuffer
+                        | vk::BufferUsageFlagBits::eShaderDeviceAddress /* indexCount might be written by MeshletCullingComputePipeline */,
                 },
                 vma::AllocationCreateInfo {
                     vma::AllocationCreateFlagBits::eHostAccessRandom | vma::AllocationCreateFlagBits::eMapped,
@@ -13,26 +13,44 @@ export import vku;
 
 import vk_gltf_viewer.helpers.fastgltf;
 export import vk_gltf_viewer.vulkan.shader_type.Material;
+export import vk_gltf_viewer.vulkan.shader_type.MaterialExtension;
 
 namespace vk_gltf_viewer::vulkan::buffer {
+    /**
+     * @brief Device local buffer of <tt>shader_type::Material</tt>s, including the fallback material.
+     *
+     * As the frames in flight may be reading the buffer, edits are only applied to the host side copy of the materials.
+     * The edited materials are coalesced into the contiguous index ranges and copied to the buffer by
+     * <tt>recordPendingUpdates(vk::CommandBuffer)</tt>, in the queue submission order.
+     */
     export class Materials final : public vku::raii::AllocatedBuffer {
     public:
         vk::DescriptorBufferInfo descriptorInfo;
 
+        /**
+         * @brief Side table of <tt>shader_type::MaterialExtension</tt>, which only has the entries for the materials
+         * that use any of KHR_materials_(anisotropy|clearcoat|diffuse_transmission|iridescence|sheen|specular|transmission|volume)
+         * extensions. The first entry is a placeholder, as <tt>shader_type::Material::extensionIndex = 0</tt> means
+         * the material does not use any of them.
+         */
+        vku::raii::AllocatedBuffer extensionBuffer;
+        vk::DescriptorBufferInfo extensionDescriptorInfo;
+
         Materials(const fastgltf::Asset &asset, const vma::raii::Allocator &allocator, vkgltf::StagingBufferStorage &stagingBufferStorage);
 
         /**
          * @brief Replace self with a new buffer with doubled size.
          *
-         * The original data is preserved by:
-         * - If the old buffer data can be copied to the new buffer in host, data is copied and <tt>std::nullopt</tt> returned.
-         * - Otherwise, \p transferCommandBuffer is recorded and the old buffer is returned. You must retain the lifetime
-         *   of the returned buffer until the command buffer is executed.
+         * The copy command from the old buffer is recorded into \p transferCommandBuffer. The old buffer is returned
+         * rather than destroyed, as it may still be read by the frames in flight. You must retain its lifetime until
+         * both the frames and \p transferCommandBuffer are finished, and rewrite the descriptors that point to the old
+         * buffer with <tt>descriptorInfo</tt>.
          *
-         * @param transferCommandBuffer If buffer is not host-visible memory and so is unable to be updated from the host, this command buffer will be used for recording the buffer update command. Then, its execution MUST be synchronized to be available to the buffer usage. Otherwise, this parameter is unused.
-         * @return <tt>std::nullopt</tt> if the buffer is host-visible memory and the data is copied, or an <tt>AllocatedBuffer</tt> with the old buffer data recorded in \p transferCommandBuffer.
+         * @param transferCommandBuffer Command buffer to record the buffer copy command. Its execution MUST be
+         * synchronized to be available to the buffer usage.
+         * @return The old buffer.
          */
-        [[nodiscard]] std::optional<AllocatedBuffer> enlarge(vk::CommandBuffer transferCommandBuffer);
+        [[nodiscard]] AllocatedBuffer enlarge(vk::CommandBuffer transferCommandBuffer);
 
         /**
          * @brief Check if a material can be added at the end of the buffer.
@@ -47,55 +65,62 @@ namespace vk_gltf_viewer::vulkan::buffer {
          * if the buffer can store the new material. If the method returns <tt>false</tt>, use
          * <tt>enlarge(vk::CommandBuffer)</tt> to enlarge the buffer by 2x capacity.
          *
+         * The material is not written to the buffer until <tt>recordPendingUpdates(vk::CommandBuffer)</tt> is called.
+         *
          * @param asset Asset to which the material belongs.
          * @param material Material to add.
-         * @param transferCommandBuffer If buffer is not host-visible memory and so is unable to be updated from the host, this command buffer will be used for recording the buffer update command. Then, its execution MUST be synchronized to be available to the buffer usage. Otherwise, this parameter is unused.
-         * @return <tt>true</tt> if the buffer is not host-visible memory and the update command is recorded, <tt>false</tt> otherwise.
          */
-        [[nodiscard]] bool add(const fastgltf::Asset &asset, const fastgltf::Material &material, vk::CommandBuffer transferCommandBuffer);
+        void add(const fastgltf::Asset &asset, const fastgltf::Material &material);
 
         /**
          * @brief Update material property with field accessor.
          *
+         * Only the host side copy of the material is updated, and the material is marked as dirty. Multiple updates
+         * in a frame are coalesced and written to the buffer by <tt>recordPendingUpdates(vk::CommandBuffer)</tt>.
+         *
          * @tparam accessor Member accessor of <tt>shader_type::Material</tt> to update.
          * @param materialIndex Index of asset material to update.
          * @param data Data to update, must be the type of accessor function's return type.
-         * @param transferCommandBuffer If buffer is not host-visible memory and so is unable to be updated from the host, this command buffer will be used for recording the buffer update command. Then, its execution MUST be synchronized to be available to the buffer usage. Otherwise, this parameter is unused.
-         * @return <tt>true</tt> if the buffer is not host-visible memory and the update command is recorded, <tt>false</tt> otherwise.
          * @note <tt>materialIndex = 0</tt> will refer <tt>asset.materials[0]</tt>, NOT fallback material.
          */
         template <auto shader_type::Material::*accessor>
-        bool update(
+        void update(
             std::size_t materialIndex,
-            const std::remove_cvref_t<std::invoke_result_t<decltype(accessor), shader_type::Material&>>& data,
-            vk::CommandBuffer transferCommandBuffer
+            const std::remove_cvref_t<std::invoke_result_t<decltype(accessor), shader_type::Material&>>& data
         ) {
-            // Obtain byte offset and size of the field to be updated.
-            static constexpr shader_type::Material dummy{};
-            constexpr auto fieldAddress = &std::invoke(accessor, dummy);
-            const vk::DeviceSize byteOffset
-                = sizeof(shader_type::Material) * (1 + materialIndex)
-                + reinterpret_cast<std::uintptr_t>(fieldAddress) - reinterpret_cast<std::uintptr_t>(&dummy);
-            constexpr vk::DeviceSize byteSize = sizeof(data);
-            static_assert(byteSize % 4 == 0 && "Data size bytes must be multiple of 4.");
-
-            if (vku::contains(getAllocation().getMemoryProperties(), vk::MemoryPropertyFlagBits::eHostVisible)) {
-                getAllocation().copyFromMemory(&data, byteOffset, byteSize);
-                return false;
-            }
-            else {
-                transferCommandBuffer.updateBuffer(*this, byteOffset, byteSize, &data);
-                return true;
-            }
+            std::invoke(accessor, hostMaterials[1 + materialIndex]) = data;
+            dirtyMaterialIndices.emplace(1 + materialIndex);
         }
 
+        /**
+         * @brief Check if there is any material that is not written to the buffer yet.
+         */
+        [[nodiscard]] bool hasPendingUpdates() const noexcept;
+
+        /**
+         * @brief Write the dirty materials to the buffer, by copying the contiguous index ranges from a staging buffer.
+         *
+         * There must be at least one dirty material. You can use <tt>hasPendingUpdates()</tt> to check it.
+         *
+         * @param transferCommandBuffer Command buffer to record the buffer copy commands. Its execution MUST be
+         * synchronized with the previous accesses of the buffer, and to be available to the next reads.
+         * @return The staging buffer that is the source of the recorded copy commands. You must retain its lifetime
+         * until \p transferCommandBuffer is finished.
+         */
+        [[nodiscard]] AllocatedBuffer recordPendingUpdates(vk::CommandBuffer transferCommandBuffer);
+
     private:
         std::reference_wrapper<const vma::raii::Allocator> allocator;
 
         /**
-         * @brief Count of the currently stored materials, including the fallback material.
+         * @brief Host side copy of the stored materials, including the fallback material.
+         */
+        std::vector<shader_type::Material> hostMaterials;
+
+        /**
+         * @brief Indices of the materials in <tt>hostMaterials</tt> that are not written to the buffer yet.
          */
-        std::size_t count;
+        std::set<std::size_t> dirtyMaterialIndices;
     };
 }
 
@@ -112,6 +137,20 @@ module :private;
     };
 }
 
+[[nodiscard]] std::uint16_t getShaderTextureIndex([[maybe_unused]] const fastgltf::Asset &asset, const fastgltf::TextureInfo &textureInfo) noexcept {
+#if __APPLE__
+    std::uint16_t result = 0;
+    const fastgltf::Texture &texture = asset.textures[textureInfo.textureIndex];
+    if (texture.samplerIndex) {
+        result = (*texture.samplerIndex + 1) << 12;
+    }
+    result |= static_cast<std::uint16_t>(getPreferredImageIndex(texture)) + 1;
+    return result;
+#else
+    return static_cast<std::uint16_t>(textureInfo.textureIndex) + 1;
+#endif
+}
+
 [[nodiscard]] vk_gltf_viewer::vulkan::shader_type::Material getShaderMaterial(const fastgltf::Asset &asset, const fastgltf::Material &material) {
     vk_gltf_viewer::vulkan::shader_type::Material result {
         .baseColorFactor = glm::gtc::make_vec4(material.pbrData.baseColorFactor.data()),
@@ -123,17 +162,7 @@ module :private;
     };
 
     const auto getTextureIndex = [&](const fastgltf::TextureInfo &textureInfo) noexcept {
-    #if __APPLE__
-        std::uint16_t result = 0;
-        const fastgltf::Texture &texture = asset.textures[textureInfo.textureIndex];
-        if (texture.samplerIndex) {
-            result = (*texture.samplerIndex + 1) << 12;
-        }
-        result |= static_cast<std::uint16_t>(getPreferredImageIndex(texture)) + 1;
-        return result;
-    #else
-        return static_cast<std::uint16_t>(textureInfo.textureIndex) + 1;
-    #endif
+        return getShaderTextureIndex(asset, textureInfo);
     };
 
     if (const auto& baseColorTexture = material.pbrData.baseColorTexture) {
@@ -197,6 +226,107 @@ module :private;
     return result;
 }
 
+[[nodiscard]] bool hasMaterialExtension(const fastgltf::Material &material) noexcept {
+    return material.anisotropy || material.clearcoat || material.diffuseTransmission || material.iridescence
+        || material.sheen || material.specular || material.transmission || material.volume;
+}
+
+[[nodiscard]] vk_gltf_viewer::vulkan::shader_type::MaterialExtension getShaderMaterialExtension(const fastgltf::Asset &asset, const fastgltf::Material &material) {
+    using TextureSlot = vk_gltf_viewer::vulkan::shader_type::MaterialExtension::TextureSlot;
+
+    vk_gltf_viewer::vulkan::shader_type::MaterialExtension result{};
+
+    const auto setTexture = [&](TextureSlot slot, const fastgltf::Optional<fastgltf::TextureInfo> &textureInfo) {
+        if (!textureInfo) return;
+
+        auto &target = result.textures[slot];
+        target.index = getShaderTextureIndex(asset, *textureInfo);
+        target.texcoordIndex = textureInfo->texCoordIndex;
+
+        if (const auto &transform = textureInfo->transform) {
+            target.transform = getTextureTransform(*transform);
+            if (transform->texCoordIndex) {
+                target.texcoordIndex = *transform->texCoordIndex;
+            }
+        }
+    };
+
+    if (const auto &transmission = material.transmission) {
+        result.transmissionFactor = transmission->transmissionFactor;
+        setTexture(TextureSlot::Transmission, transmission->transmissionTexture);
+    }
+    if (const auto &volume = material.volume) {
+        result.thicknessFactor = volume->thicknessFactor;
+        result.attenuationColor = glm::gtc::make_vec3(volume->attenuationColor.data());
+        result.attenuationDistance = volume->attenuationDistance;
+        setTexture(TextureSlot::VolumeThickness, volume->thicknessTexture);
+    }
+    if (const auto &clearcoat = material.clearcoat) {
+        result.clearcoatFactor = clearcoat->clearcoatFactor;
+        result.clearcoatRoughnessFactor = clearcoat->clearcoatRoughnessFactor;
+        setTexture(TextureSlot::Clearcoat, clearcoat->clearcoatTexture);
+        setTexture(TextureSlot::ClearcoatRoughness, clearcoat->clearcoatRoughnessTexture);
+    }
+    if (const auto &sheen = material.sheen) {
+        result.sheenColorFactor = glm::gtc::make_vec3(sheen->sheenColorFactor.data());
+        result.sheenRoughnessFactor = sheen->sheenRoughnessFactor;
+        setTexture(TextureSlot::SheenColor, sheen->sheenColorTexture);
+        setTexture(TextureSlot::SheenRoughness, sheen->sheenRoughnessTexture);
+    }
+    if (const auto &specular = material.specular) {
+        result.specularColorFactor = glm::gtc::make_vec3(specular->specularColorFactor.data());
+        result.specularFactor = specular->specularFactor;
+        setTexture(TextureSlot::Specular, specular->specularTexture);
+        setTexture(TextureSlot::SpecularColor, specular->specularColorTexture);
+    }
+    if (const auto &iridescence = material.iridescence) {
+        result.iridescenceFactor = iridescence->iridescenceFactor;
+        result.iridescenceIor = iridescence->iridescenceIor;
+        result.iridescenceThicknessMinimum = iridescence->iridescenceThicknessMinimum;
+        result.iridescenceThicknessMaximum = iridescence->iridescenceThicknessMaximum;
+        setTexture(TextureSlot::Iridescence, iridescence->iridescenceTexture);
+        setTexture(TextureSlot::IridescenceThickness, iridescence->iridescenceThicknessTexture);
+    }
+    if (const auto &anisotropy = material.anisotropy) {
+        result.anisotropyDirection = { std::cos(anisotropy->anisotropyRotation), std::sin(anisotropy->anisotropyRotation) };
+        result.anisotropyStrength = anisotropy->anisotropyStrength;
+        setTexture(TextureSlot::Anisotropy, anisotropy->anisotropyTexture);
+    }
+    if (const auto &diffuseTransmission = material.diffuseTransmission) {
+        result.diffuseTransmissionColorFactor = glm::gtc::make_vec3(diffuseTransmission->diffuseTransmissionColorFactor.data());
+        result.diffuseTransmissionFactor = diffuseTransmission->diffuseTransmissionFactor;
+        setTexture(TextureSlot::DiffuseTransmission, diffuseTransmission->diffuseTransmissionTexture);
+        setTexture(TextureSlot::DiffuseTransmissionColor, diffuseTransmission->diffuseTransmissionColorTexture);
+    }
+
+    return result;
+}
+
+[[nodiscard]] vku::raii::AllocatedBuffer createMaterialExtensionBuffer(const fastgltf::Asset &asset, const vma::raii::Allocator &allocator) {
+    std::vector<vk_gltf_viewer::vulkan::shader_type::MaterialExtension> extensions;
+    extensions.push_back({}); // Placeholder for the materials without extension.
+    for (const fastgltf::Material &material : asset.materials) {
+        if (hasMaterialExtension(material)) {
+            extensions.push_back(getShaderMaterialExtension(asset, material));
+        }
+    }
+
+    vku::raii::AllocatedBuffer result {
+        allocator,
+        vk::BufferCreateInfo {
+            {},
+            sizeof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension) * extensions.size(),
+            vk::BufferUsageFlagBits::eStorageBuffer,
+        },
+        vma::AllocationCreateInfo {
+            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+            vma::MemoryUsage::eAutoPreferHost,
+        },
+    };
+    result.getAllocation().copyFromMemory(extensions.data(), 0, sizeof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension) * extensions.size());
+    return result;
+}
+
 vk_gltf_viewer::vulkan::buffer::Materials::Materials(
     const fastgltf::Asset &asset,
     const vma::raii::Allocator &allocator,
@@ -207,7 +337,8 @@ vk_gltf_viewer::vulkan::buffer::Materials::Materials(
             {},
             sizeof(shader_type::Material) * (1 + asset.materials.size()), // +1 for fallback material.
             vk::BufferUsageFlagBits::eStorageBuffer
-                | vk::BufferUsageFlagBits::eTransferSrc /* might be copy source when enlarging the buffer */,
+                | vk::BufferUsageFlagBits::eTransferSrc /* might be copy source when enlarging the buffer */
+                | vk::BufferUsageFlagBits::eTransferDst,
         },
         vma::AllocationCreateInfo {
             vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
@@ -215,69 +346,106 @@ vk_gltf_viewer::vulkan::buffer::Materials::Materials(
         },
     },
     descriptorInfo { *this, 0, vk::WholeSize },
-    allocator { allocator },
-    count { 1 + asset.materials.size() } {
-    auto it = std::span { static_cast<shader_type::Material*>(getAllocation().getInfo().pMappedData), 1 + asset.materials.size() }.begin();
-    *it++ = {}; // Initialize fallback material.
-    std::ranges::transform(asset.materials, it, [&](const fastgltf::Material &material) {
-        return getShaderMaterial(asset, material);
-    });
+    extensionBuffer { createMaterialExtensionBuffer(asset, allocator) },
+    extensionDescriptorInfo { extensionBuffer, 0, vk::WholeSize },
+    allocator { allocator } {
+    hostMaterials.reserve(1 + asset.materials.size());
+    hostMaterials.push_back({}); // Initialize fallback material.
+    std::uint32_t extensionCount = 0;
+    for (const fastgltf::Material &material : asset.materials) {
+        shader_type::Material &shaderMaterial = hostMaterials.emplace_back(getShaderMaterial(asset, material));
+        if (hasMaterialExtension(material)) {
+            // Must be matched to the order in createMaterialExtensionBuffer.
+            shaderMaterial.extensionIndex = ++extensionCount;
+        }
+    }
 
-    getAllocation().flush(0, vk::WholeSize);
+    getAllocation().copyFromMemory(hostMaterials.data(), 0, sizeof(shader_type::Material) * hostMaterials.size());
 
-    if (stagingBufferStorage.stage(*this, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc /* might be copy source when enlarging the buffer */)) {
+    if (stagingBufferStorage.stage(*this, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)) {
         descriptorInfo.buffer = *this;
     }
+    if (stagingBufferStorage.stage(extensionBuffer, vk::BufferUsageFlagBits::eStorageBuffer)) {
+        extensionDescriptorInfo.buffer = extensionBuffer;
+    }
 }
 
-std::optional<vku::raii::AllocatedBuffer> vk_gltf_viewer::vulkan::buffer::Materials::enlarge(vk::CommandBuffer transferCommandBuffer) {
+vku::raii::AllocatedBuffer vk_gltf_viewer::vulkan::buffer::Materials::enlarge(vk::CommandBuffer transferCommandBuffer) {
     // Create new buffer with doubled size.
     AllocatedBuffer newBuffer {
         allocator,
         vk::BufferCreateInfo {
             {},
             size * 2,
-            vk::BufferUsageFlagBits::eTransferDst /* copy destination */
-                | vk::BufferUsageFlagBits::eStorageBuffer
-                | vk::BufferUsageFlagBits::eTransferSrc /* might be copy source when enlarging the buffer */,
-        },
-        vma::AllocationCreateInfo {
-            {},
-            vma::MemoryUsage::eAutoPreferDevice,
+            vk::BufferUsageFlagBits::eStorageBuffer
+                | vk::BufferUsageFlagBits::eTransferSrc /* might be copy source when enlarging the buffer */
+                | vk::BufferUsageFlagBits::eTransferDst,
         },
+        vma::AllocationCreateInfo { {}, vma::MemoryUsage::eAutoPreferDevice },
     };
 
     descriptorInfo.buffer = newBuffer;
 
-    if (vku::contains(getAllocation().getMemoryProperties(), vk::MemoryPropertyFlagBits::eHostCached) &&
-        vku::contains(newBuffer.getAllocation().getMemoryProperties(), vk::MemoryPropertyFlagBits::eHostVisible)) {
-        // Old buffer data can be copied to the new buffer in host.
-        newBuffer.getAllocation().copyFromMemory(getAllocation().getInfo().pMappedData, 0, size);
+    // The pending updates will be recorded after the copy, therefore make the copy finished before them.
+    transferCommandBuffer.copyBuffer(*this, newBuffer, vk::BufferCopy { 0, 0, size });
+    transferCommandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,
+        {}, vk::MemoryBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferWrite }, {}, {});
 
-        static_cast<AllocatedBuffer&>(*this) = std::move(newBuffer);
-        return std::nullopt;
-    }
-    else {
-        // Copy needed to be done in GPU.
-        transferCommandBuffer.copyBuffer(*this, newBuffer, vk::BufferCopy { 0, 0, size });
-        return std::exchange(static_cast<AllocatedBuffer&>(*this), std::move(newBuffer));
-    }
+    return std::exchange(static_cast<AllocatedBuffer&>(*this), std::move(newBuffer));
 }
 
 bool vk_gltf_viewer::vulkan::buffer::Materials::canAddMaterial() const noexcept {
-    return sizeof(shader_type::Material) * (count + 1) <= size;
+    return sizeof(shader_type::Material) * (hostMaterials.size() + 1) <= size;
 }
 
-bool vk_gltf_viewer::vulkan::buffer::Materials::add(const fastgltf::Asset &asset, const fastgltf::Material &material, vk::CommandBuffer transferCommandBuffer) {
+void vk_gltf_viewer::vulkan::buffer::Materials::add(const fastgltf::Asset &asset, const fastgltf::Material &material) {
     assert(canAddMaterial() && "Buffer size is not enough to push back a new material.");
 
-    const shader_type::Material shaderMaterial = getShaderMaterial(asset, material);
-    if (vku::contains(getAllocation().getMemoryProperties(), vk::MemoryPropertyFlagBits::eHostVisible)) {
-        getAllocation().copyFromMemory(&shaderMaterial, sizeof(shader_type::Material) * count++, sizeof(shader_type::Material));
-        return false;
+    dirtyMaterialIndices.emplace(hostMaterials.size());
+    hostMaterials.push_back(getShaderMaterial(asset, material));
+}
+
+bool vk_gltf_viewer::vulkan::buffer::Materials::hasPendingUpdates() const noexcept {
+    return !dirtyMaterialIndices.empty();
+}
+
+vku::raii::AllocatedBuffer vk_gltf_viewer::vulkan::buffer::Materials::recordPendingUpdates(vk::CommandBuffer transferCommandBuffer) {
+    assert(hasPendingUpdates() && "There is no material to be written.");
+
+    // Coalesce the dirty material indices into the contiguous ranges, which are tightly packed in the staging buffer.
+    std::vector<vk::BufferCopy> copyRegions;
+    for (std::size_t materialIndex : dirtyMaterialIndices) {
+        const vk::DeviceSize dstOffset = sizeof(shader_type::Material) * materialIndex;
+        if (!copyRegions.empty() && copyRegions.back().dstOffset + copyRegions.back().size == dstOffset) {
+            copyRegions.back().size += sizeof(shader_type::Material);
+        }
+        else {
+            const vk::DeviceSize srcOffset = copyRegions.empty() ? 0 : copyRegions.back().srcOffset + copyRegions.back().size;
+            copyRegions.emplace_back(srcOffset, dstOffset, sizeof(shader_type::Material));
+        }
     }
-    else {
-        transferCommandBuffer.updateBuffer(*this, sizeof(shader_type::Material) * count++, sizeof(shader_type::Material), &shaderMaterial);
-        return true;
+    dirtyMaterialIndices.clear();
+
+    AllocatedBuffer stagingBuffer {
+        allocator,
+        vk::BufferCreateInfo {
+            {},
+            copyRegions.back().srcOffset + copyRegions.back().size,
+            vk::BufferUsageFlagBits::eTransferSrc,
+        },
+        vma::AllocationCreateInfo {
+            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+            vma::MemoryUsage::eAutoPreferHost,
+        },
+    };
+    for (const vk::BufferCopy &copyRegion : copyRegions) {
+        stagingBuffer.getAllocation().copyFromMemory(
+            &hostMaterials[copyRegion.dstOffset / sizeof(shader_type::Material)],
+            copyRegion.srcOffset,
+            copyRegion.size);
     }
+
+    transferCommandBuffer.copyBuffer(stagingBuffer, *this, copyRegions);
+    return stagingBuffer;
 }
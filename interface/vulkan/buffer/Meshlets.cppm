@@ -0,0 +1,137 @@
+module;
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+export module vk_gltf_viewer.vulkan.buffer.Meshlets;
+
+import std;
+export import fastgltf;
+export import vkgltf; // vkgltf::StagingBufferStorage
+export import vku;
+
+export import vk_gltf_viewer.gltf.algorithm.meshlet;
+export import vk_gltf_viewer.vulkan.Gpu;
+export import vk_gltf_viewer.vulkan.shader_type.Meshlet;
+
+namespace vk_gltf_viewer::vulkan::buffer {
+    /**
+     * @brief Meshlets of the primitives and their expanded triangle list indices, which are accessed by the buffer
+     * device address in <tt>MeshletCullingComputePipeline</tt>.
+     */
+    export class Meshlets {
+    public:
+        struct PrimitiveRange {
+            /// Index of the primitive's first meshlet in <tt>meshletBuffer</tt>.
+            std::uint32_t firstMeshlet;
+
+            std::uint32_t meshletCount;
+
+            /// Total index count of the primitive's meshlets, which is the upper bound of the culled index count.
+            std::uint32_t indexCount;
+        };
+
+        /// Buffer of <tt>shader_type::Meshlet</tt>s.
+        vku::raii::AllocatedBuffer meshletBuffer;
+
+        /// Buffer of the meshlet indices (<tt>std::uint32_t</tt>), which are referencing the primitive's vertices.
+        vku::raii::AllocatedBuffer indexBuffer;
+
+        vk::DeviceAddress meshletBufferAddress;
+        vk::DeviceAddress indexBufferAddress;
+
+        Meshlets(
+            const std::unordered_map<const fastgltf::Primitive*, gltf::algorithm::PrimitiveMeshlets> &primitiveMeshlets,
+            const Gpu &gpu,
+            vkgltf::StagingBufferStorage &stagingBufferStorage
+        );
+
+        /**
+         * @brief Get the meshlet range of \p primitive.
+         * @param primitive Primitive to get the range.
+         * @return Pointer to the range, or <tt>nullptr</tt> if the primitive has no meshlets.
+         */
+        [[nodiscard]] const PrimitiveRange *getPrimitiveRange(const fastgltf::Primitive &primitive) const noexcept;
+
+    private:
+        std::unordered_map<const fastgltf::Primitive*, PrimitiveRange> primitiveRanges;
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+[[nodiscard]] vku::raii::AllocatedBuffer createHostBuffer(const vma::raii::Allocator &allocator, std::span<const std::byte> data) {
+    vku::raii::AllocatedBuffer result {
+        allocator,
+        vk::BufferCreateInfo {
+            {},
+            data.size_bytes(),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+        },
+        vma::AllocationCreateInfo {
+            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+            vma::MemoryUsage::eAutoPreferHost,
+        },
+    };
+    result.getAllocation().copyFromMemory(data.data(), 0, data.size_bytes());
+    return result;
+}
+
+vk_gltf_viewer::vulkan::buffer::Meshlets::Meshlets(
+    const std::unordered_map<const fastgltf::Primitive*, gltf::algorithm::PrimitiveMeshlets> &primitiveMeshlets,
+    const Gpu &gpu,
+    vkgltf::StagingBufferStorage &stagingBufferStorage
+) : meshletBuffer { [&] {
+        std::vector<shader_type::Meshlet> meshlets;
+        std::uint32_t firstIndex = 0;
+        for (const gltf::algorithm::PrimitiveMeshlets &primitiveMeshlet : primitiveMeshlets | std::views::values) {
+            for (const gltf::algorithm::Meshlet &meshlet : primitiveMeshlet.meshlets) {
+                meshlets.push_back({
+                    .center = glm::make_vec3(meshlet.center.data()),
+                    .radius = meshlet.radius,
+                    .coneApex = glm::make_vec3(meshlet.coneApex.data()),
+                    .coneCutoff = meshlet.coneCutoff,
+                    .coneAxis = glm::make_vec3(meshlet.coneAxis.data()),
+                    .firstIndex = firstIndex + meshlet.firstIndex,
+                    .indexCount = meshlet.indexCount,
+                });
+            }
+            firstIndex += primitiveMeshlet.indices.size();
+        }
+        return createHostBuffer(gpu.allocator, as_bytes(std::span { meshlets }));
+    }() },
+    indexBuffer { [&] {
+        // Indices are concatenated in the same order to the meshlets.
+        std::vector<std::uint32_t> indices;
+        for (const gltf::algorithm::PrimitiveMeshlets &primitiveMeshlet : primitiveMeshlets | std::views::values) {
+            indices.append_range(primitiveMeshlet.indices);
+        }
+        return createHostBuffer(gpu.allocator, as_bytes(std::span { indices }));
+    }() } {
+    std::uint32_t firstMeshlet = 0;
+    for (const auto &[primitive, primitiveMeshlet] : primitiveMeshlets) {
+        primitiveRanges.emplace(primitive, PrimitiveRange {
+            .firstMeshlet = firstMeshlet,
+            .meshletCount = static_cast<std::uint32_t>(primitiveMeshlet.meshlets.size()),
+            .indexCount = static_cast<std::uint32_t>(primitiveMeshlet.indices.size()),
+        });
+        firstMeshlet += primitiveMeshlet.meshlets.size();
+    }
+
+    stagingBufferStorage.stage(meshletBuffer, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+    stagingBufferStorage.stage(indexBuffer, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+
+    // Buffers may be replaced by the staging, therefore the addresses must be queried after it.
+    meshletBufferAddress = gpu.device.getBufferAddress({ static_cast<vk::Buffer>(meshletBuffer) });
+    indexBufferAddress = gpu.device.getBufferAddress({ static_cast<vk::Buffer>(indexBuffer) });
+}
+
+const vk_gltf_viewer::vulkan::buffer::Meshlets::PrimitiveRange *vk_gltf_viewer::vulkan::buffer::Meshlets::getPrimitiveRange(
+    const fastgltf::Primitive &primitive
+) const noexcept {
+    if (auto it = primitiveRanges.find(&primitive); it != primitiveRanges.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
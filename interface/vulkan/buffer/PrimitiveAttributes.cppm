@@ -11,15 +11,35 @@ export import BS.thread_pool;
 export import vkgltf;
 
 export import vk_gltf_viewer.gltf.AssetExtended;
+import vk_gltf_viewer.gltf.AssetProcessError;
+import vk_gltf_viewer.cpu_profiler;
+import vk_gltf_viewer.gltf.algorithm.vertexQuantization;
 export import vk_gltf_viewer.vulkan.Gpu;
 
 namespace vk_gltf_viewer::vulkan::buffer {
+    /**
+     * @brief Create the attribute buffers of the primitives in \p assetExtended, and stage them.
+     *
+     * If \p quantizeVertexAttributes is <tt>true</tt>, <tt>FLOAT</tt> typed <tt>POSITION</tt>, <tt>NORMAL</tt>,
+     * <tt>TANGENT</tt> and <tt>TEXCOORD_<i></tt> accessors are quantized into the 16-bit streams by
+     * <tt>gltf::algorithm::quantizeVertexAttributes</tt>, and the resulting attribute infos have the proper
+     * <tt>octahedral</tt> and dequantization parameters.
+     *
+     * Sparse morph target accessors without the base buffer view (i.e. whose omitted elements are zero) are uploaded as
+     * is, with the bitmap of the presented vertices, instead of being densified. Their attribute infos are marked as
+     * <tt>sparse</tt>, and the vertex shader skips the vertices that are not presented.
+     *
+     * Missing tangents are generated by MikkTSpace algorithm, or by the non-welded fast path if \p fastTangentGeneration
+     * is <tt>true</tt>.
+     */
     export
     [[nodiscard]] std::unordered_map<const fastgltf::Primitive*, vkgltf::PrimitiveAttributeBuffers> createPrimitiveAttributeBuffers(
         const gltf::AssetExtended &assetExtended LIFETIMEBOUND,
         const Gpu &gpu LIFETIMEBOUND,
         vkgltf::StagingBufferStorage &stagingBufferStorage,
-        BS::thread_pool<> &threadPool
+        BS::thread_pool<> &threadPool,
+        bool quantizeVertexAttributes = false,
+        bool fastTangentGeneration = false
     );
 
 }
@@ -28,13 +48,119 @@ namespace vk_gltf_viewer::vulkan::buffer {
 module :private;
 #endif
 
+using namespace std::string_view_literals;
+
+/**
+ * @brief Create the attribute info of sparse \p accessor, whose data layout is described in
+ * <tt>vkgltf::PrimitiveAttributeBuffers::AttributeInfo::sparse</tt>.
+ * @param asset Asset that contains \p accessor.
+ * @param accessor Sparse accessor without the buffer view.
+ * @param externalBuffers Buffer data adapter of \p asset.
+ * @param allocator VMA allocator to allocate the host visible buffer.
+ * @return Attribute info whose buffer is not staged yet.
+ * @throw vk_gltf_viewer::gltf::AssetProcessError::InvalidSparseAccessor If the index component type is not unsigned
+ * integer or an index is out of the accessor range.
+ */
+[[nodiscard]] vkgltf::PrimitiveAttributeBuffers::AttributeInfo createSparseAttributeInfo(
+    const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    const vk_gltf_viewer::gltf::AssetExternalBuffers &externalBuffers,
+    const vma::raii::Allocator &allocator
+) {
+    const fastgltf::SparseAccessor &sparse = *accessor.sparse;
+    const std::size_t elementByteSize = fastgltf::getElementByteSize(accessor.type, accessor.componentType);
+    const std::size_t stride = (elementByteSize + 3) & ~3UZ;
+
+    // (bitmap, rank) pairs per 32 elements.
+    const std::size_t blockCount = (accessor.count + 31) / 32;
+    std::vector<std::uint32_t> blocks(2 * blockCount);
+
+    // glTF 2.0 specification:
+    //   The indices MUST strictly increase.
+    //   https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#sparse-accessors
+    // Therefore the values are already in ascending element index order, and they can be copied without sorting.
+    const std::span indexBytes = externalBuffers(asset, sparse.indicesBufferView).subspan(sparse.indicesByteOffset);
+    for (std::size_t i = 0; i < sparse.count; ++i) {
+        std::uint32_t index;
+        switch (sparse.indexComponentType) {
+            case fastgltf::ComponentType::UnsignedByte:
+                index = static_cast<std::uint8_t>(indexBytes[i]);
+                break;
+            case fastgltf::ComponentType::UnsignedShort: {
+                std::uint16_t value;
+                std::memcpy(&value, &indexBytes[sizeof(value) * i], sizeof(value));
+                index = value;
+                break;
+            }
+            case fastgltf::ComponentType::UnsignedInt:
+                std::memcpy(&index, &indexBytes[sizeof(index) * i], sizeof(index));
+                break;
+            default:
+                throw vk_gltf_viewer::gltf::AssetProcessError::InvalidSparseAccessor;
+        }
+
+        if (index >= accessor.count) {
+            throw vk_gltf_viewer::gltf::AssetProcessError::InvalidSparseAccessor;
+        }
+        blocks[2 * (index / 32)] |= 1U << (index % 32);
+    }
+
+    std::uint32_t rank = 0;
+    for (std::size_t i = 0; i < blockCount; ++i) {
+        blocks[2 * i + 1] = rank;
+        rank += std::popcount(blocks[2 * i]);
+    }
+
+    const std::uint32_t valuesByteOffset = 8 + sizeof(std::uint32_t) * blocks.size();
+    std::vector<std::byte> data(valuesByteOffset + stride * sparse.count);
+    std::memcpy(data.data(), &valuesByteOffset, sizeof(valuesByteOffset));
+    std::memcpy(data.data() + 8, blocks.data(), sizeof(std::uint32_t) * blocks.size());
+
+    // Sparse values are tightly packed.
+    const std::span valueBytes = externalBuffers(asset, sparse.valuesBufferView).subspan(sparse.valuesByteOffset);
+    for (std::size_t i = 0; i < sparse.count; ++i) {
+        std::memcpy(data.data() + valuesByteOffset + stride * i, &valueBytes[elementByteSize * i], elementByteSize);
+    }
+
+    vkgltf::PrimitiveAttributeBuffers::AttributeInfo result {
+        .buffer = std::make_shared<vku::raii::AllocatedBuffer>(
+            allocator,
+            vk::BufferCreateInfo {
+                {},
+                data.size(),
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eTransferSrc,
+            },
+            vma::AllocationCreateInfo {
+                vma::AllocationCreateFlagBits::eHostAccessSequentialWrite,
+                vma::MemoryUsage::eAutoPreferHost,
+            }),
+        .offset = 0,
+        .size = data.size(),
+        .stride = stride,
+        .componentType = accessor.componentType,
+        .normalized = accessor.normalized,
+        .sparse = true,
+    };
+    result.buffer->getAllocation().copyFromMemory(data.data(), 0, data.size());
+    return result;
+}
+
 std::unordered_map<const fastgltf::Primitive*, vkgltf::PrimitiveAttributeBuffers> vk_gltf_viewer::vulkan::buffer::createPrimitiveAttributeBuffers(
     const gltf::AssetExtended &assetExtended,
     const Gpu &gpu,
     vkgltf::StagingBufferStorage &stagingBufferStorage,
-    BS::thread_pool<> &threadPool
+    BS::thread_pool<> &threadPool,
+    bool quantizeVertexAttributes,
+    bool fastTangentGeneration
 ) {
-    const vkgltf::PrimitiveAttributeBuffers::AttributeInfoCache cache {
+    std::unordered_map<std::size_t, gltf::algorithm::QuantizedAttribute> quantizedAttributes;
+    if (quantizeVertexAttributes) {
+        quantizedAttributes = cpu_profiler::zoned("Quantize vertex attributes", [&] {
+            return gltf::algorithm::quantizeVertexAttributes(assetExtended.asset, assetExtended.externalBuffers, 4, threadPool);
+        });
+    }
+
+    vkgltf::PrimitiveAttributeBuffers::AttributeInfoCache cache {
         assetExtended.asset,
         gpu.allocator,
         vkgltf::PrimitiveAttributeBuffers::AttributeInfoCache::Config {
@@ -42,13 +168,80 @@ std::unordered_map<const fastgltf::Primitive*, vkgltf::PrimitiveAttributeBuffers
             .maxTexcoordAttributeCount = 4,
             .maxJointsAttributeCount = std::numeric_limits<std::size_t>::max(),
             .maxWeightsAttributeCount = std::numeric_limits<std::size_t>::max(),
-            .usageFlagsFn = [](const fastgltf::Accessor &accessor) -> std::optional<vk::BufferUsageFlags> {
+            .usageFlagsFn = [&](const fastgltf::Accessor &accessor) -> std::optional<vk::BufferUsageFlags> {
                 if (accessor.sparse) return std::nullopt;
+
+                // Quantized accessor doesn't need its buffer view data.
+                if (quantizedAttributes.contains(&accessor - assetExtended.asset.accessors.data())) return std::nullopt;
+
                 return vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eTransferSrc;
             },
         },
     };
 
+    // Quantized attribute infos are inserted to the cache, therefore they are shared by the primitives that reference
+    // the same accessor.
+    for (const auto &[accessorIndex, quantized] : quantizedAttributes) {
+        vkgltf::PrimitiveAttributeBuffers::AttributeInfo info {
+            .buffer = std::make_shared<vku::raii::AllocatedBuffer>(
+                gpu.allocator,
+                vk::BufferCreateInfo {
+                    {},
+                    quantized.data.size(),
+                    vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eTransferSrc,
+                },
+                vma::AllocationCreateInfo {
+                    vma::AllocationCreateFlagBits::eHostAccessSequentialWrite,
+                    vma::MemoryUsage::eAutoPreferHost,
+                }),
+            .offset = 0,
+            .size = quantized.data.size(),
+            .stride = quantized.byteStride,
+            .componentType = quantized.componentType,
+            .normalized = true,
+            .octahedral = quantized.octahedral,
+            .dequantizationOffset = quantized.dequantizationOffset,
+            .dequantizationScale = quantized.dequantizationScale,
+        };
+        info.buffer->getAllocation().copyFromMemory(quantized.data.data(), 0, quantized.data.size());
+        cache.accessorAttributeInfos.insert_or_assign(accessorIndex, std::move(info));
+    }
+
+    // Sparse morph target accessors are inserted to the cache in the same manner. Accessors that are also used as the
+    // base attribute are excluded, as the base attribute data must be dense.
+    cpu_profiler::zoned("Upload sparse morph targets", [&] {
+        std::unordered_set<std::size_t> baseAttributeAccessorIndices;
+        std::unordered_set<std::size_t> sparseMorphTargetAccessorIndices;
+        for (const fastgltf::Mesh &mesh : assetExtended.asset.meshes) {
+            for (const fastgltf::Primitive &primitive : mesh.primitives) {
+                for (const fastgltf::Attribute &attribute : primitive.attributes) {
+                    baseAttributeAccessorIndices.emplace(attribute.accessorIndex);
+                }
+
+                for (const auto &attributes : primitive.targets) {
+                    for (const auto &[attributeName, accessorIndex] : attributes) {
+                        if (attributeName != "POSITION"sv && attributeName != "NORMAL"sv && attributeName != "TANGENT"sv) {
+                            continue;
+                        }
+
+                        const fastgltf::Accessor &accessor = assetExtended.asset.accessors[accessorIndex];
+                        if (accessor.sparse && !accessor.bufferViewIndex) {
+                            sparseMorphTargetAccessorIndices.emplace(accessorIndex);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (std::size_t accessorIndex : sparseMorphTargetAccessorIndices) {
+            if (baseAttributeAccessorIndices.contains(accessorIndex)) continue;
+
+            cache.accessorAttributeInfos.insert_or_assign(
+                accessorIndex,
+                createSparseAttributeInfo(assetExtended.asset, assetExtended.asset.accessors[accessorIndex], assetExtended.externalBuffers, gpu.allocator));
+        }
+    });
+
     const vkgltf::PrimitiveAttributeBuffers::Config config {
         .adapter = assetExtended.externalBuffers,
         .cache = &cache,
@@ -89,6 +282,7 @@ std::unordered_map<const fastgltf::Primitive*, vkgltf::PrimitiveAttributeBuffers
     // ----- Generate MikkTSpace tangents with threads -----
 
     threadPool.submit_loop(0, primitiveNeedsMikkTSpaceTangents.size(), [&](std::size_t i) {
+        const cpu_profiler::Zone zone { "Generate MikkTSpace tangents" };
         const fastgltf::Primitive *primitive = primitiveNeedsMikkTSpaceTangents[i];
         result.at(primitive).emplaceMikkTSpaceTangents(
             fastgltf::ComponentType::Byte,
@@ -99,7 +293,8 @@ std::unordered_map<const fastgltf::Primitive*, vkgltf::PrimitiveAttributeBuffers
                 vma::AllocationCreateFlagBits::eHostAccessSequentialWrite,
                 vma::MemoryUsage::eAutoPreferHost,
             },
-            assetExtended.externalBuffers);
+            assetExtended.externalBuffers,
+            fastTangentGeneration);
     }).wait();
 
     // ----- Collect distinct buffers for staging -----
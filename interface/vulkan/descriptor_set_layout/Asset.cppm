@@ -17,9 +17,9 @@ namespace vk_gltf_viewer::vulkan::dsl {
     //
     // For workaround, we'll manually separate the sampler and image (see SEPARATE_IMAGE_SAMPLER macro definition in the
     // primitive rendering pipeline's fragment shader).
-    export struct Asset : vku::raii::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eSampler, vk::DescriptorType::eSampledImage> {
+    export struct Asset : vku::raii::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eSampler, vk::DescriptorType::eSampledImage> {
 #else
-    export struct Asset : vku::raii::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eCombinedImageSampler> {
+    export struct Asset : vku::raii::DescriptorSetLayout<vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eCombinedImageSampler> {
 #endif
         explicit Asset(const Gpu &gpu LIFETIMEBOUND);
 
@@ -55,11 +55,12 @@ vk_gltf_viewer::vulkan::dsl::Asset::Asset(const Gpu &gpu)
                 DescriptorSetLayout::getCreateInfoBinding<0>(1, vk::ShaderStageFlagBits::eVertex),
                 DescriptorSetLayout::getCreateInfoBinding<1>(1, vk::ShaderStageFlagBits::eVertex),
                 DescriptorSetLayout::getCreateInfoBinding<2>(1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment),
+                DescriptorSetLayout::getCreateInfoBinding<3>(1, vk::ShaderStageFlagBits::eFragment),
             #if __APPLE__
-                DescriptorSetLayout::getCreateInfoBinding<3>(maxSamplerCount(gpu), vk::ShaderStageFlagBits::eFragment),
-                DescriptorSetLayout::getCreateInfoBinding<4>(maxImageCount(gpu), vk::ShaderStageFlagBits::eFragment),
+                DescriptorSetLayout::getCreateInfoBinding<4>(maxSamplerCount(gpu), vk::ShaderStageFlagBits::eFragment),
+                DescriptorSetLayout::getCreateInfoBinding<5>(maxImageCount(gpu), vk::ShaderStageFlagBits::eFragment),
             #else
-                DescriptorSetLayout::getCreateInfoBinding<3>(maxSamplerCount(gpu), vk::ShaderStageFlagBits::eFragment),
+                DescriptorSetLayout::getCreateInfoBinding<4>(maxSamplerCount(gpu), vk::ShaderStageFlagBits::eFragment),
             #endif
             }),
         },
@@ -68,6 +69,7 @@ vk_gltf_viewer::vulkan::dsl::Asset::Asset(const Gpu &gpu)
                 {},
                 {},
                 {},
+                {},
             #if __APPLE__
                 vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::ePartiallyBound,
                 vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eVariableDescriptorCount,
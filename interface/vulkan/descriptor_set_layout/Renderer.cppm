@@ -4,14 +4,21 @@ module;
 
 export module vk_gltf_viewer.vulkan.descriptor_set_layout.Renderer;
 
-#ifdef _MSC_VER
 import std;
-#endif
 export import vku;
 
+export import vk_gltf_viewer.vulkan.sampler.Transmission;
+
 namespace vk_gltf_viewer::vulkan::dsl {
-    export struct Renderer final : vku::raii::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer> {
-        explicit Renderer(const vk::raii::Device &device LIFETIMEBOUND);
+    /**
+     * @brief Descriptor set layout of the per-frame renderer resources.
+     *
+     * - Binding 0: camera uniform buffer.
+     * - Binding 1: mip-chained scene color sampled by the transmissive materials. It is written only if any
+     *   transmissive primitive is rendered in the frame.
+     */
+    export struct Renderer final : vku::raii::DescriptorSetLayout<vk::DescriptorType::eUniformBuffer, vk::DescriptorType::eCombinedImageSampler> {
+        Renderer(const vk::raii::Device &device LIFETIMEBOUND, const sampler::Transmission &transmissionSampler LIFETIMEBOUND);
     };
 }
 
@@ -19,8 +26,11 @@ namespace vk_gltf_viewer::vulkan::dsl {
 module :private;
 #endif
 
-vk_gltf_viewer::vulkan::dsl::Renderer::Renderer(const vk::raii::Device &device)
+vk_gltf_viewer::vulkan::dsl::Renderer::Renderer(const vk::raii::Device &device, const sampler::Transmission &transmissionSampler)
     : DescriptorSetLayout { device, vk::DescriptorSetLayoutCreateInfo {
         {},
-        vku::lvalue(DescriptorSetLayout::getCreateInfoBinding<0>(1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)),
+        vku::lvalue({
+            DescriptorSetLayout::getCreateInfoBinding<0>(1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment),
+            DescriptorSetLayout::getCreateInfoBinding<1>(vk::ShaderStageFlagBits::eFragment, *transmissionSampler),
+        }),
     } } { }
\ No newline at end of file
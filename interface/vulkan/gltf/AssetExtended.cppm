@@ -9,8 +9,11 @@ export import BS.thread_pool;
 export import vkgltf.bindless;
 
 export import vk_gltf_viewer.gltf.AssetExtended;
+import vk_gltf_viewer.cpu_profiler;
+import vk_gltf_viewer.gltf.algorithm.levelOfDetail;
 import vk_gltf_viewer.helpers.fastgltf;
 export import vk_gltf_viewer.vulkan.buffer.Materials;
+export import vk_gltf_viewer.vulkan.buffer.Meshlets;
 export import vk_gltf_viewer.vulkan.buffer.PrimitiveAttributes;
 export import vk_gltf_viewer.vulkan.pipeline.PrepassPipelineConfig;
 export import vk_gltf_viewer.vulkan.pipeline.PrimitiveRenderPipeline;
@@ -36,8 +39,36 @@ namespace vk_gltf_viewer::vulkan::gltf {
         /// texture coordinates in the fragment shader is cheaper than recreating all pipelines.
     	bool useTextureTransformInPipeline;
 
-        buffer::Materials materialBuffer;
+        buffer::Materials materials;
+
+        /**
+         * @brief Simplification errors of the primitives' level of details, relative to their bounding sphere radius.
+         *
+         * Only contains the primitives that have the level of details in <tt>combinedIndexBuffer</tt>, and the errors
+         * are in the same order to <tt>vkgltf::CombinedIndexBuffer::getLevelOfDetailFirstIndexAndCounts</tt> (therefore
+         * the first element is always 0).
+         */
+        std::unordered_map<const fastgltf::Primitive*, std::vector<float>> levelOfDetailErrors;
+
+        /**
+         * @brief Level of detail of the node primitives selected by the last updated frame, for the hysteresis.
+         *
+         * Key is the draw command's <tt>firstInstance</tt> (node index << 16 | primitive index). It is shared by all
+         * frames in flight, as the selection must not depend on which frame is updated. It is a selection state rather
+         * than the asset data, therefore mutable for the frames that have the const reference to the asset.
+         */
+        mutable std::unordered_map<std::uint32_t /* firstInstance */, std::uint32_t /* level */> levelOfDetailHistory;
+
         vkgltf::CombinedIndexBuffer combinedIndexBuffer;
+
+        /**
+         * @brief Meshlets of the static indexed triangle list primitives, for the per-cluster culling. <tt>std::nullopt</tt>
+         * if meshlets are not built or no primitive is eligible.
+         *
+         * Primitive that has the level of details is not contained, as the meshlets are only built for its finest level.
+         */
+        std::optional<buffer::Meshlets> meshletBuffer;
+
         std::unordered_map<const fastgltf::Primitive*, vkgltf::PrimitiveAttributeBuffers> primitiveAttributeBuffers;
         vkgltf::PrimitiveBuffer primitiveBuffer;
         std::optional<vkgltf::SkinBuffer> skinBuffer;
@@ -47,9 +78,15 @@ namespace vk_gltf_viewer::vulkan::gltf {
         AssetExtended(
             const std::filesystem::path &path,
             const Gpu &gpu LIFETIMEBOUND,
+            QueueTimelines &timelines,
             const texture::Fallback &fallbackTexture LIFETIMEBOUND,
             vkgltf::StagingBufferStorage &stagingBufferStorage,
-            BS::thread_pool<> threadPool = {}
+            BS::thread_pool<> &threadPool LIFETIMEBOUND,
+            bool optimizeMeshes = false,
+            bool generateLevelOfDetails = false,
+            bool buildMeshlets = false,
+            bool quantizeVertexAttributes = false,
+            bool fastTangentGeneration = false
         );
 
         [[nodiscard]] ImTextureID getEmissiveTextureID(std::size_t materialIndex) const override;
@@ -169,39 +206,88 @@ vk::PrimitiveTopology getListPrimitiveTopology(fastgltf::PrimitiveType type) noe
 vk_gltf_viewer::vulkan::gltf::AssetExtended::AssetExtended(
     const std::filesystem::path &path,
     const Gpu &gpu,
+    QueueTimelines &timelines,
     const texture::Fallback &fallbackTexture,
     vkgltf::StagingBufferStorage &stagingBufferStorage,
-    BS::thread_pool<> threadPool
-) : vk_gltf_viewer::gltf::AssetExtended { path },
+    BS::thread_pool<> &threadPool,
+    bool optimizeMeshes,
+    bool generateLevelOfDetails,
+    bool buildMeshlets,
+    bool quantizeVertexAttributes,
+    bool fastTangentGeneration
+) : vk_gltf_viewer::gltf::AssetExtended { path, threadPool, optimizeMeshes },
     gpu { gpu },
 	useTextureTransformInPipeline { std::ranges::contains(asset.extensionsUsed, "KHR_texture_transform"sv) },
-    materialBuffer { asset, gpu.allocator, stagingBufferStorage },
-    combinedIndexBuffer { asset, gpu.allocator, vkgltf::CombinedIndexBuffer::Config {
-        .adapter = externalBuffers,
-        .promoteUnsignedByteToUnsignedShort = !gpu.supportUint8Index,
-        .topologyConvertFn = [](fastgltf::PrimitiveType type) noexcept {
-            if (type == fastgltf::PrimitiveType::LineLoop) {
-                return fastgltf::PrimitiveType::LineStrip;
-            }
-        #if __APPLE__
-            if (type == fastgltf::PrimitiveType::TriangleFan) {
-                return fastgltf::PrimitiveType::Triangles;
+    materials { asset, gpu.allocator, stagingBufferStorage },
+    combinedIndexBuffer { cpu_profiler::zoned("Combine indices", [&] {
+        std::unordered_map<const fastgltf::Primitive*, std::vector<vk_gltf_viewer::gltf::algorithm::LevelOfDetail>> levelOfDetails;
+        if (generateLevelOfDetails) {
+            levelOfDetails = cpu_profiler::zoned("Generate level of details", [&] {
+                return vk_gltf_viewer::gltf::algorithm::generateLevelOfDetails(asset, externalBuffers, threadPool);
+            });
+            for (const auto &[primitive, primitiveLevelOfDetails] : levelOfDetails) {
+                std::vector<float> &errors = levelOfDetailErrors[primitive];
+                errors.reserve(1 + primitiveLevelOfDetails.size());
+                errors.push_back(0.f); // Primitive's own indices.
+                errors.append_range(primitiveLevelOfDetails | std::views::transform(&vk_gltf_viewer::gltf::algorithm::LevelOfDetail::error));
             }
-        #endif
-            return type;
-        },
-        .usageFlags = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferSrc,
-        .queueFamilies = gpu.queueFamilies.uniqueIndices,
-        .stagingInfo = &vku::lvalue(vkgltf::StagingInfo { stagingBufferStorage }),
-    } },
-    primitiveAttributeBuffers { buffer::createPrimitiveAttributeBuffers(*this, gpu, stagingBufferStorage, threadPool) },
+        }
+
+        return vkgltf::CombinedIndexBuffer { asset, gpu.allocator, vkgltf::CombinedIndexBuffer::Config {
+            .adapter = externalBuffers,
+            .promoteUnsignedByteToUnsignedShort = !gpu.supportUint8Index,
+            .topologyConvertFn = [](fastgltf::PrimitiveType type) noexcept {
+                if (type == fastgltf::PrimitiveType::LineLoop) {
+                    return fastgltf::PrimitiveType::LineStrip;
+                }
+            #if __APPLE__
+                if (type == fastgltf::PrimitiveType::TriangleFan) {
+                    return fastgltf::PrimitiveType::Triangles;
+                }
+            #endif
+                return type;
+            },
+            .levelOfDetailIndicesFn = [&](const fastgltf::Primitive &primitive) -> std::vector<std::span<const std::uint32_t>> {
+                if (auto it = levelOfDetails.find(&primitive); it != levelOfDetails.end()) {
+                    return it->second
+                        | std::views::transform([](const vk_gltf_viewer::gltf::algorithm::LevelOfDetail &levelOfDetail) {
+                            return std::span<const std::uint32_t> { levelOfDetail.indices };
+                        })
+                        | std::ranges::to<std::vector>();
+                }
+                return {};
+            },
+            .usageFlags = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+            .queueFamilies = gpu.queueFamilies.uniqueIndices,
+            .stagingInfo = &vku::lvalue(vkgltf::StagingInfo { stagingBufferStorage }),
+        } };
+    }) },
+    meshletBuffer { [&] -> std::optional<buffer::Meshlets> {
+        if (!buildMeshlets) {
+            return std::nullopt;
+        }
+
+        const auto primitiveMeshlets = cpu_profiler::zoned("Build meshlets", [&] {
+            return vk_gltf_viewer::gltf::algorithm::buildMeshlets(asset, externalBuffers, threadPool, [&](const fastgltf::Primitive &primitive) {
+                // Meshlets are only built for the primitive's own indices.
+                return !levelOfDetailErrors.contains(&primitive);
+            });
+        });
+        if (primitiveMeshlets.empty()) {
+            return std::nullopt;
+        }
+        return std::optional<buffer::Meshlets> { std::in_place, primitiveMeshlets, gpu, stagingBufferStorage };
+    }() },
+    primitiveAttributeBuffers { cpu_profiler::zoned("Create primitive attribute buffers", [&] { return buffer::createPrimitiveAttributeBuffers(*this, gpu, stagingBufferStorage, threadPool, quantizeVertexAttributes, fastTangentGeneration); }) },
     primitiveBuffer { asset, primitiveAttributeBuffers, gpu.device, gpu.allocator, vkgltf::PrimitiveBuffer::Config {
         .materialIndexFn = [](const fastgltf::Primitive &primitive) noexcept -> std::int32_t {
             // First element of the material storage buffer is reserved for the fallback material.
             if (!primitive.materialIndex) return 0;
             return 1 + *primitive.materialIndex;
         },
-        .usageFlags = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eTransferSrc,
+        // Material index of a primitive is updated by vkCmdUpdateBuffer(), regardless of whether the buffer is host visible,
+        // to not write the memory that may be read by the frames in flight.
+        .usageFlags = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
         .queueFamilies = gpu.queueFamilies.uniqueIndices,
         .stagingInfo = &vku::lvalue(vkgltf::StagingInfo { stagingBufferStorage }),
     } },
@@ -211,7 +297,7 @@ vk_gltf_viewer::vulkan::gltf::AssetExtended::AssetExtended(
         .queueFamilies = gpu.queueFamilies.uniqueIndices,
         .stagingInfo = &vku::lvalue(vkgltf::StagingInfo { stagingBufferStorage }),
     }) },
-    textures { *this, gpu, fallbackTexture, threadPool },
+    textures { cpu_profiler::zoned("Load textures", [&] { return texture::Textures { *this, gpu, timelines, fallbackTexture, threadPool }; }) },
     imGuiColorSpaceAndUsageCorrectedTextures { asset, textures, gpu } { }
 
 ImTextureID vk_gltf_viewer::vulkan::gltf::AssetExtended::getEmissiveTextureID(std::size_t materialIndex) const {
@@ -266,6 +352,7 @@ vk_gltf_viewer::vulkan::PrimitiveRenderPipeline::Config vk_gltf_viewer::vulkan::
 
     if (accessors.normal) {
         result.normalComponentType = accessors.normal->attributeInfo.componentType;
+        result.normalOctahedral = accessors.normal->attributeInfo.octahedral;
         result.normalMorphTargetCount = accessors.normal->morphTargets.size();
     }
     else {
@@ -280,6 +367,7 @@ vk_gltf_viewer::vulkan::PrimitiveRenderPipeline::Config vk_gltf_viewer::vulkan::
     if (primitive.materialIndex) {
         if (accessors.tangent) {
             result.tangentComponentType = accessors.tangent->attributeInfo.componentType;
+            result.tangentOctahedral = accessors.tangent->attributeInfo.octahedral;
             result.tangentMorphTargetCount = accessors.tangent->morphTargets.size();
         }
 
@@ -289,6 +377,13 @@ vk_gltf_viewer::vulkan::PrimitiveRenderPipeline::Config vk_gltf_viewer::vulkan::
 
         const fastgltf::Material &material = asset.materials[*primitive.materialIndex];
         result.alphaMode = material.alphaMode;
+        result.useTransmission = material.transmission != nullptr;
+        result.useClearcoat = material.clearcoat != nullptr;
+        result.useSheen = material.sheen != nullptr;
+        result.useSpecular = material.specular != nullptr;
+        result.useIridescence = material.iridescence != nullptr;
+        result.useAnisotropy = material.anisotropy != nullptr;
+        result.useDiffuseTransmission = material.diffuseTransmission != nullptr;
     }
 
     return result;
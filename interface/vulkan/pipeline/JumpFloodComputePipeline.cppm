@@ -22,12 +22,29 @@ namespace vk_gltf_viewer::vulkan::inline pipeline {
 
         explicit JumpFloodComputePipeline(const vk::raii::Device &device LIFETIMEBOUND);
 
+        /**
+         * @brief Record the jump flood commands for the layers <tt>[baseLayer, baseLayer + layerCount)</tt> of the ping
+         * image, with the sample offset halved from \p initialSampleOffset to 1.
+         *
+         * The bound image must be a ping-pong image whose first half layers are ping layers and the second half layers
+         * are pong layers. As each step can propagate the seed by the current sample offset, the seeds are flooded up to
+         * <tt>2 * initialSampleOffset - 1</tt> texels away.
+         *
+         * @param commandBuffer Command buffer to be recorded.
+         * @param descriptorSet Descriptor set that contains the ping-pong image.
+         * @param initialSampleOffset Sample offset of the first step. Must be power of 2.
+         * @param imageExtent Extent of the ping-pong image.
+         * @param baseLayer Base ping layer to be flooded.
+         * @param layerCount Number of the ping layers to be flooded.
+         * @return <tt>true</tt> if the result is in the pong layers, <tt>false</tt> if in the ping layers.
+         */
         [[nodiscard]] bool compute(
             vk::CommandBuffer commandBuffer,
             vk::DescriptorSet descriptorSet,
             std::uint32_t initialSampleOffset,
             const vk::Extent2D &imageExtent,
-            std::uint32_t viewCount
+            std::uint32_t baseLayer,
+            std::uint32_t layerCount
         ) const;
 
     private:
@@ -42,6 +59,7 @@ module :private;
 struct vk_gltf_viewer::vulkan::pipeline::JumpFloodComputePipeline::PushConstant {
     vk::Bool32 forward;
     std::uint32_t sampleOffset;
+    std::uint32_t baseLayer;
 };
 
 vk_gltf_viewer::vulkan::pipeline::JumpFloodComputePipeline::JumpFloodComputePipeline(const vk::raii::Device &device)
@@ -76,19 +94,20 @@ bool vk_gltf_viewer::vulkan::pipeline::JumpFloodComputePipeline::compute(
     vk::DescriptorSet descriptorSet,
     std::uint32_t initialSampleOffset,
     const vk::Extent2D &imageExtent,
-    std::uint32_t viewCount
+    std::uint32_t baseLayer,
+    std::uint32_t layerCount
 ) const {
     commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
     commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, descriptorSet, {});
 
-    PushConstant pushConstant { .forward = true, .sampleOffset = initialSampleOffset };
+    PushConstant pushConstant { .forward = true, .sampleOffset = initialSampleOffset, .baseLayer = baseLayer };
 
     for (; pushConstant.sampleOffset > 0U; pushConstant.forward = !pushConstant.forward, pushConstant.sampleOffset >>= 1U) {
         commandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, pushConstant);
         commandBuffer.dispatch(
             vku::divCeil(imageExtent.width, 16U),
             vku::divCeil(imageExtent.height, 16U),
-            viewCount);
+            layerCount);
 
         if (pushConstant.sampleOffset != 1U) {
             commandBuffer.pipelineBarrier(
@@ -0,0 +1,158 @@
+module;
+
+#include <cstddef>
+
+#include <vulkan/vulkan_hpp_macros.hpp>
+
+#include <lifetimebound.hpp>
+
+export module vk_gltf_viewer.vulkan.pipeline.MeshletCullingComputePipeline;
+
+import std;
+export import glm;
+export import vku;
+
+import vk_gltf_viewer.shader.meshlet_culling_comp;
+
+namespace vk_gltf_viewer::vulkan::inline pipeline {
+    /**
+     * @brief Compute pipeline that culls the meshlets of the indexed draw commands, and compacts the indices of the
+     * visible meshlets into a single index buffer.
+     *
+     * Each workgroup processes a draw, whose meshlets are tested by the frustum and the normal cone (backface). Indices
+     * of the visible meshlets are copied to <tt>[Draw::firstIndex, Draw::firstIndex + (total meshlet index count))</tt>
+     * of the culled index buffer, and their count is atomically accumulated to the draw command's <tt>indexCount</tt>.
+     */
+    export class MeshletCullingComputePipeline {
+    public:
+        enum DrawFlags : std::uint32_t {
+            FrustumCulling = 1U << 0,
+            ConeCulling = 1U << 1,
+        };
+
+        /**
+         * @brief Header of the culling input buffer, which is followed by <tt>drawCount</tt> <tt>Draw</tt>s.
+         */
+        struct Header {
+            /// Frustum planes in the world space, as (normal, distance).
+            std::array<glm::vec4, 6> frustumPlanes;
+            glm::vec3 cameraPosition;
+            std::uint32_t drawCount;
+        };
+
+        struct Draw {
+            glm::mat4 worldTransform;
+
+            /// Device address of the draw command's <tt>indexCount</tt>, which must be zeroed before the dispatch.
+            vk::DeviceAddress indexCountAddress;
+
+            std::uint32_t firstMeshlet;
+            std::uint32_t meshletCount;
+
+            /// First index of the draw's region in the culled index buffer.
+            std::uint32_t firstIndex;
+
+            /// Scale factor of the meshlet bounding sphere radius, i.e. the maximum axis scale of <tt>worldTransform</tt>.
+            float radiusScale;
+
+            /// Combination of <tt>DrawFlags</tt>. If <tt>0</tt>, every meshlet is regarded as visible.
+            std::uint32_t flags;
+
+            char padding0[4];
+        };
+
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::Pipeline pipeline;
+
+        explicit MeshletCullingComputePipeline(const vk::raii::Device &device LIFETIMEBOUND);
+
+        /**
+         * @brief Record the meshlet culling commands.
+         *
+         * The culled index buffer and the draw commands' <tt>indexCount</tt> are written in the compute shader stage,
+         * therefore you must synchronize their usage with the proper pipeline barrier.
+         *
+         * @param commandBuffer Command buffer to be recorded.
+         * @param cullingInputAddress Device address of the culling input buffer (<tt>Header</tt> followed by <tt>Draw</tt>s).
+         * @param meshletBufferAddress Device address of <tt>shader_type::Meshlet</tt>s.
+         * @param meshletIndexBufferAddress Device address of the meshlet indices.
+         * @param culledIndexBufferAddress Device address of the culled index buffer to be written.
+         * @param drawCount Number of the draws.
+         */
+        void compute(
+            vk::CommandBuffer commandBuffer,
+            vk::DeviceAddress cullingInputAddress,
+            vk::DeviceAddress meshletBufferAddress,
+            vk::DeviceAddress meshletIndexBufferAddress,
+            vk::DeviceAddress culledIndexBufferAddress,
+            std::uint32_t drawCount
+        ) const;
+
+    private:
+        struct PushConstant;
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+static_assert(sizeof(vk_gltf_viewer::vulkan::pipeline::MeshletCullingComputePipeline::Header) == 112);
+static_assert(sizeof(vk_gltf_viewer::vulkan::pipeline::MeshletCullingComputePipeline::Draw) == 96);
+static_assert(offsetof(vk_gltf_viewer::vulkan::pipeline::MeshletCullingComputePipeline::Draw, firstMeshlet) == 72);
+
+struct vk_gltf_viewer::vulkan::pipeline::MeshletCullingComputePipeline::PushConstant {
+    vk::DeviceAddress cullingInputAddress;
+    vk::DeviceAddress meshletBufferAddress;
+    vk::DeviceAddress meshletIndexBufferAddress;
+    vk::DeviceAddress culledIndexBufferAddress;
+    std::uint32_t baseDraw;
+};
+
+vk_gltf_viewer::vulkan::pipeline::MeshletCullingComputePipeline::MeshletCullingComputePipeline(const vk::raii::Device &device)
+    : pipelineLayout { device, vk::PipelineLayoutCreateInfo {
+        {},
+        {},
+        vku::lvalue(vk::PushConstantRange {
+            vk::ShaderStageFlagBits::eCompute,
+            0, sizeof(PushConstant),
+        }),
+    } }
+    , pipeline { device, nullptr, vk::ComputePipelineCreateInfo {
+        {},
+        vk::PipelineShaderStageCreateInfo {
+            {},
+            vk::ShaderStageFlagBits::eCompute,
+            *vku::lvalue(vk::raii::ShaderModule { device, vk::ShaderModuleCreateInfo {
+                {},
+                shader::meshlet_culling_comp,
+            } }),
+            "main",
+        },
+        *pipelineLayout,
+    } } { }
+
+void vk_gltf_viewer::vulkan::pipeline::MeshletCullingComputePipeline::compute(
+    vk::CommandBuffer commandBuffer,
+    vk::DeviceAddress cullingInputAddress,
+    vk::DeviceAddress meshletBufferAddress,
+    vk::DeviceAddress meshletIndexBufferAddress,
+    vk::DeviceAddress culledIndexBufferAddress,
+    std::uint32_t drawCount
+) const {
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+
+    PushConstant pushConstant {
+        .cullingInputAddress = cullingInputAddress,
+        .meshletBufferAddress = meshletBufferAddress,
+        .meshletIndexBufferAddress = meshletIndexBufferAddress,
+        .culledIndexBufferAddress = culledIndexBufferAddress,
+    };
+
+    // Draws are dispatched in chunks, as maxComputeWorkGroupCount[0] is only guaranteed to be at least 65535.
+    constexpr std::uint32_t maxWorkGroupCount = 65535;
+    for (; pushConstant.baseDraw < drawCount; pushConstant.baseDraw += maxWorkGroupCount) {
+        commandBuffer.pushConstants<PushConstant>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, pushConstant);
+        commandBuffer.dispatch(std::min(drawCount - pushConstant.baseDraw, maxWorkGroupCount), 1, 1);
+    }
+}
@@ -25,6 +25,8 @@ namespace vk_gltf_viewer::vulkan::inline pipeline {
             bool positionNormalized;
             std::optional<fastgltf::ComponentType> normalComponentType;
             std::optional<fastgltf::ComponentType> tangentComponentType;
+            bool normalOctahedral;
+            bool tangentOctahedral;
             boost::container::static_vector<std::pair<fastgltf::ComponentType, bool>, 4> texcoordComponentTypeAndNormalized;
             std::optional<std::pair<fastgltf::ComponentType, std::uint8_t>> color0ComponentTypeAndCount;
             std::uint32_t positionMorphTargetCount;
@@ -35,8 +37,23 @@ namespace vk_gltf_viewer::vulkan::inline pipeline {
             bool useTextureTransform;
             fastgltf::AlphaMode alphaMode;
             bool usePerFragmentEmissiveStencilExport;
+            bool useTransmission;
+            bool useClearcoat;
+            bool useSheen;
+            bool useSpecular;
+            bool useIridescence;
+            bool useAnisotropy;
+            bool useDiffuseTransmission;
 
             [[nodiscard]] std::strong_ordering operator<=>(const Config&) const noexcept = default;
+
+            /**
+             * @brief Check if any of the material extension lobes is used, which requires the fragment shader variant
+             * that reads the material extension side table.
+             */
+            [[nodiscard]] bool useMaterialExtension() const noexcept {
+                return useTransmission || useClearcoat || useSheen || useSpecular || useIridescence || useAnisotropy || useDiffuseTransmission;
+            }
         };
 
         PrimitiveRenderPipeline(
@@ -52,7 +69,7 @@ namespace vk_gltf_viewer::vulkan::inline pipeline {
 
         [[nodiscard]] static std::array<int, 3> getVertexShaderVariants(const Config &config) noexcept;
         [[nodiscard]] static VertexShaderSpecialization getVertexShaderSpecialization(const Config &config) noexcept;
-        [[nodiscard]] static std::array<int, 5> getFragmentShaderVariants(const Config &config) noexcept;
+        [[nodiscard]] static std::array<int, 6> getFragmentShaderVariants(const Config &config) noexcept;
         [[nodiscard]] static FragmentShaderSpecialization getFragmentShaderSpecialization(const Config &config, vk::SampleCountFlagBits sampleCount) noexcept;
     };
 }
@@ -64,6 +81,10 @@ module :private;
 #define FWD(...) static_cast<decltype(__VA_ARGS__)&&>(__VA_ARGS__)
 #define LIFT(...) [](auto &&...xs) { return __VA_ARGS__(FWD(xs)...); }
 
+/// Specialization constant value of the octahedral mapped NORMAL and TANGENT, which is not a GL component type. Must
+/// match to <tt>OCTAHEDRAL_SHORT_NORMALIZED</tt> in vertex_pulling.glsl.
+constexpr std::uint32_t octahedralShortNormalizedComponentType = 65536U;
+
 struct vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::VertexShaderSpecialization {
     std::uint32_t positionComponentType;
     vk::Bool32 positionNormalized;
@@ -88,6 +109,13 @@ struct vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::VertexShaderSp
 struct vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::FragmentShaderSpecialization {
     vk::Bool32 useTextureTransform;
     vk::Bool32 useLodBasedAlphaCutoff;
+    vk::Bool32 useTransmission;
+    vk::Bool32 useClearcoat;
+    vk::Bool32 useSheen;
+    vk::Bool32 useSpecular;
+    vk::Bool32 useIridescence;
+    vk::Bool32 useAnisotropy;
+    vk::Bool32 useDiffuseTransmission;
 };
 
 vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::PrimitiveRenderPipeline(
@@ -249,8 +277,12 @@ vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::VertexShaderSpecializ
     VertexShaderSpecialization result {
         .positionComponentType = getGLComponentType(config.positionComponentType),
         .positionNormalized = config.positionNormalized,
-        .normalComponentType = config.normalComponentType.transform(fastgltf::getGLComponentType).value_or(0U),
-        .tangentComponentType = config.tangentComponentType.transform(fastgltf::getGLComponentType).value_or(0U),
+        .normalComponentType = config.normalOctahedral
+            ? octahedralShortNormalizedComponentType
+            : config.normalComponentType.transform(fastgltf::getGLComponentType).value_or(0U),
+        .tangentComponentType = config.tangentOctahedral
+            ? octahedralShortNormalizedComponentType
+            : config.tangentComponentType.transform(fastgltf::getGLComponentType).value_or(0U),
         .positionMorphTargetCount = config.positionMorphTargetCount,
         .normalMorphTargetCount = config.normalMorphTargetCount,
         .tangentMorphTargetCount = config.tangentMorphTargetCount,
@@ -268,13 +300,14 @@ vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::VertexShaderSpecializ
     return result;
 }
 
-std::array<int, 5> vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::getFragmentShaderVariants(const Config &config) noexcept {
+std::array<int, 6> vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::getFragmentShaderVariants(const Config &config) noexcept {
     return {
         static_cast<int>(config.texcoordComponentTypeAndNormalized.size()),
         config.color0ComponentTypeAndCount.has_value(),
         config.fragmentShaderGeneratedTBN,
         static_cast<int>(config.alphaMode),
         config.usePerFragmentEmissiveStencilExport,
+        config.useMaterialExtension(),
     };
 }
 
@@ -282,5 +315,15 @@ auto vk_gltf_viewer::vulkan::pipeline::PrimitiveRenderPipeline::getFragmentShade
     const Config &config,
     vk::SampleCountFlagBits sampleCount
 ) noexcept -> FragmentShaderSpecialization {
-    return { config.useTextureTransform, sampleCount != vk::SampleCountFlagBits::e1 };
+    return {
+        .useTextureTransform = config.useTextureTransform,
+        .useLodBasedAlphaCutoff = sampleCount != vk::SampleCountFlagBits::e1,
+        .useTransmission = config.useTransmission,
+        .useClearcoat = config.useClearcoat,
+        .useSheen = config.useSheen,
+        .useSpecular = config.useSpecular,
+        .useIridescence = config.useIridescence,
+        .useAnisotropy = config.useAnisotropy,
+        .useDiffuseTransmission = config.useDiffuseTransmission,
+    };
 }
\ No newline at end of file
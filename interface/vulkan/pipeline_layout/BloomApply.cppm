@@ -17,10 +17,14 @@ namespace vk_gltf_viewer::vulkan::pl {
         struct PushConstant {
             static constexpr vk::PushConstantRange range = {
                 vk::ShaderStageFlagBits::eFragment,
-                0, 4,
+                0, 8,
             };
 
             float factor;
+
+            /// If <tt>true</tt>, bloom image mip level 1 is upsampled and added to the mip level 0 in the fragment
+            /// shader, as it is not done by <tt>bloom::BloomComputePipeline</tt>.
+            vk::Bool32 upsampleHalfResolution;
         };
 
         BloomApply(const vk::raii::Device &device LIFETIMEBOUND, const dsl::BloomApply &descriptorSetLayout LIFETIMEBOUND);
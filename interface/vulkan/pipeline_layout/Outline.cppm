@@ -4,9 +4,7 @@ module;
 
 export module vk_gltf_viewer.vulkan.pipeline_layout.Outline;
 
-#ifdef _MSC_VER
 import std;
-#endif
 export import glm;
 export import vulkan;
 import vku;
@@ -18,11 +16,20 @@ namespace vk_gltf_viewer::vulkan::pl {
         struct PushConstant {
             static constexpr vk::PushConstantRange range = {
                 vk::ShaderStageFlagBits::eFragment,
-                0, 20,
+                0, 36,
             };
 
             glm::vec4 outlineColor;
             float outlineThickness;
+
+            /// Base layer of the jump flood image that contains the flooded result of the outline.
+            std::uint32_t layerOffset;
+
+            /// Extent of each view in the framebuffer.
+            glm::u32vec2 viewExtent;
+
+            /// Binary logarithm of the ratio of the view extent to the jump flood image extent.
+            std::uint32_t resolutionShift;
         };
 
         Outline(const vk::raii::Device &device LIFETIMEBOUND, const dsl::Outline &descriptorSetLayout LIFETIMEBOUND);
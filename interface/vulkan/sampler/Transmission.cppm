@@ -0,0 +1,35 @@
+module;
+
+#include <lifetimebound.hpp>
+
+export module vk_gltf_viewer.vulkan.sampler.Transmission;
+
+#ifdef _MSC_VER
+import std;
+#endif
+export import vulkan;
+
+namespace vk_gltf_viewer::vulkan::sampler {
+    /**
+     * @brief Sampler for the mip-chained scene color, which is sampled by the transmissive materials with the
+     * roughness-derived LOD.
+     */
+    export struct Transmission : vk::raii::Sampler {
+        explicit Transmission(const vk::raii::Device &device LIFETIMEBOUND);
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+vk_gltf_viewer::vulkan::sampler::Transmission::Transmission(const vk::raii::Device &device)
+    : Sampler { device, vk::SamplerCreateInfo {
+        {},
+        vk::Filter::eLinear, vk::Filter::eLinear, vk::SamplerMipmapMode::eLinear,
+        vk::SamplerAddressMode::eClampToEdge, vk::SamplerAddressMode::eClampToEdge, vk::SamplerAddressMode::eClampToEdge,
+        {},
+        false, {},
+        {}, {},
+        {}, vk::LodClampNone,
+    } } {}
\ No newline at end of file
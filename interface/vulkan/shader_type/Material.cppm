@@ -33,7 +33,7 @@ namespace vk_gltf_viewer::vulkan::shader_type {
         glm::mat3x2 occlusionTextureTransform = { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f };
         glm::mat3x2 emissiveTextureTransform = { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f };
         float ior = 1.5;
-        char padding1[4];
+        std::uint32_t extensionIndex = 0; // Index of MaterialExtension in the side table, 0 if not used.
     };
 }
 
@@ -45,4 +45,5 @@ static_assert(sizeof(vk_gltf_viewer::vulkan::shader_type::Material) == 192);
 static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Material, baseColorTextureIndex) == 6);
 static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Material, baseColorFactor) == 16);
 static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Material, emissive) == 48);
-static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Material, baseColorTextureTransform) == 64);
\ No newline at end of file
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Material, baseColorTextureTransform) == 64);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Material, extensionIndex) == 188);
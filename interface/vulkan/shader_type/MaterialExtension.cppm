@@ -0,0 +1,89 @@
+module;
+
+#include <cstddef>
+
+export module vk_gltf_viewer.vulkan.shader_type.MaterialExtension;
+
+import std;
+export import glm;
+
+namespace vk_gltf_viewer::vulkan::shader_type {
+    /**
+     * @brief Parameters of the material extensions, which are stored in a side table that only has the entries for the
+     * materials using any of them (referenced by <tt>Material::extensionIndex</tt>).
+     *
+     * Unlike <tt>Material</tt>, it is laid out by the scalar block layout.
+     */
+    export struct MaterialExtension {
+        /**
+         * @brief Index of the texture in <tt>textures</tt>.
+         */
+        enum TextureSlot : std::uint8_t {
+            Transmission,
+            VolumeThickness,
+            Clearcoat,
+            ClearcoatRoughness,
+            SheenColor,
+            SheenRoughness,
+            Specular,
+            SpecularColor,
+            Iridescence,
+            IridescenceThickness,
+            Anisotropy,
+            DiffuseTransmission,
+            DiffuseTransmissionColor,
+            TextureSlotCount,
+        };
+
+        struct TextureInfo {
+            glm::mat3x2 transform = { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f };
+            std::uint16_t index = 0;
+            std::uint8_t texcoordIndex = 0;
+            char padding0[1];
+        };
+
+        // KHR_materials_transmission and KHR_materials_volume.
+        float transmissionFactor = 0.f;
+        float thicknessFactor = 0.f;
+        glm::vec3 attenuationColor = { 1.f, 1.f, 1.f };
+        float attenuationDistance = std::numeric_limits<float>::infinity();
+
+        // KHR_materials_clearcoat.
+        float clearcoatFactor = 0.f;
+        float clearcoatRoughnessFactor = 0.f;
+
+        // KHR_materials_sheen.
+        glm::vec3 sheenColorFactor = { 0.f, 0.f, 0.f };
+        float sheenRoughnessFactor = 0.f;
+
+        // KHR_materials_specular.
+        glm::vec3 specularColorFactor = { 1.f, 1.f, 1.f };
+        float specularFactor = 1.f;
+
+        // KHR_materials_iridescence.
+        float iridescenceFactor = 0.f;
+        float iridescenceIor = 1.3f;
+        float iridescenceThicknessMinimum = 100.f;
+        float iridescenceThicknessMaximum = 400.f;
+
+        // KHR_materials_anisotropy. The rotation is stored as (cos, sin).
+        glm::vec2 anisotropyDirection = { 1.f, 0.f };
+        float anisotropyStrength = 0.f;
+
+        // KHR_materials_diffuse_transmission.
+        glm::vec3 diffuseTransmissionColorFactor = { 1.f, 1.f, 1.f };
+        float diffuseTransmissionFactor = 0.f;
+
+        std::array<TextureInfo, TextureSlotCount> textures{};
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+static_assert(sizeof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension::TextureInfo) == 28);
+static_assert(sizeof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension) == 472);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension, clearcoatFactor) == 24);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension, iridescenceFactor) == 64);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::MaterialExtension, textures) == 108);
@@ -0,0 +1,30 @@
+module;
+
+#include <cstddef>
+
+export module vk_gltf_viewer.vulkan.shader_type.Meshlet;
+
+import std;
+export import glm;
+
+namespace vk_gltf_viewer::vulkan::shader_type {
+    export struct Meshlet {
+        glm::vec3 center;
+        float radius;
+        glm::vec3 coneApex;
+        float coneCutoff;
+        glm::vec3 coneAxis;
+        std::uint32_t firstIndex; // Index of the first meshlet index in buffer::Meshlets::indexBuffer.
+        std::uint32_t indexCount;
+        char padding0[12];
+    };
+}
+
+#if !defined(__GNUC__) || defined(__clang__)
+module :private;
+#endif
+
+static_assert(sizeof(vk_gltf_viewer::vulkan::shader_type::Meshlet) == 64);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Meshlet, coneApex) == 16);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Meshlet, coneAxis) == 32);
+static_assert(offsetof(vk_gltf_viewer::vulkan::shader_type::Meshlet, indexCount) == 48);
@@ -46,7 +46,7 @@ vk_gltf_viewer::vulkan::texture::ImGuiColorSpaceAndUsageCorrectedTextures::ImGui
     for (const auto &[textureIndex, texture] : asset.textures | ranges::views::enumerate) {
         auto [sampler, imageView, _] = textures.descriptorInfos[textureIndex];
         const vku::Image &image = textures.images.at(getPreferredImageIndex(texture)).image;
-        if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format)) {
+        if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format) && vkgltf::hasSrgbCounterpart(image.format)) {
             // Image view format is incompatible, need to be regenerated.
             const vk::ComponentMapping components = [&]() -> vk::ComponentMapping {
                 switch (componentCount(image.format)) {
@@ -86,7 +86,7 @@ vk_gltf_viewer::vulkan::texture::ImGuiColorSpaceAndUsageCorrectedTextures::ImGui
             }
             else {
                 vk::Format colorSpaceCompatibleFormat = image.format;
-                if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format)) {
+                if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format) && vkgltf::hasSrgbCounterpart(image.format)) {
                     colorSpaceCompatibleFormat = vku::toggleSrgb(image.format);
                 }
 
@@ -117,7 +117,7 @@ vk_gltf_viewer::vulkan::texture::ImGuiColorSpaceAndUsageCorrectedTextures::ImGui
                 }
                 else {
                     vk::Format colorSpaceCompatibleFormat = image.format;
-                    if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format)) {
+                    if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format) && vkgltf::hasSrgbCounterpart(image.format)) {
                         colorSpaceCompatibleFormat = vku::toggleSrgb(image.format);
                     }
 
@@ -140,7 +140,7 @@ vk_gltf_viewer::vulkan::texture::ImGuiColorSpaceAndUsageCorrectedTextures::ImGui
                 }
                 else {
                     vk::Format colorSpaceCompatibleFormat = image.format;
-                    if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format)) {
+                    if (gpu.supportSwapchainMutableFormat == vku::isSrgb(image.format) && vkgltf::hasSrgbCounterpart(image.format)) {
                         colorSpaceCompatibleFormat = vku::toggleSrgb(image.format);
                     }
 
@@ -165,7 +165,7 @@ vk_gltf_viewer::vulkan::texture::ImGuiColorSpaceAndUsageCorrectedTextures::ImGui
                     // Emissive texture must be sRGB encoded, therefore image view format must be mutated if color space
                     // is not sRGB.
                     vk::Format colorSpaceCompatibleFormat = image.format;
-                    if (gpu.supportSwapchainMutableFormat) {
+                    if (gpu.supportSwapchainMutableFormat && vkgltf::hasSrgbCounterpart(image.format)) {
                         colorSpaceCompatibleFormat = vku::toggleSrgb(image.format);
                     }
 
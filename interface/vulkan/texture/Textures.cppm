@@ -13,9 +13,11 @@ export import vkgltf;
 
 export import vk_gltf_viewer.gltf.AssetExtended;
 export import vk_gltf_viewer.gltf.AssetProcessError;
+import vk_gltf_viewer.cpu_profiler;
 import vk_gltf_viewer.helpers.fastgltf;
 import vk_gltf_viewer.vulkan.descriptor_set_layout.Asset;
 export import vk_gltf_viewer.vulkan.Gpu;
+export import vk_gltf_viewer.vulkan.QueueTimelines;
 export import vk_gltf_viewer.vulkan.texture.Fallback;
 
 #if __APPLE__
@@ -33,9 +35,16 @@ namespace vk_gltf_viewer::vulkan::texture {
 
         std::vector<vk::DescriptorImageInfo> descriptorInfos;
 
+        /**
+         * @brief Create the textures and submit their uploads without waiting for the completion.
+         *
+         * The subsequent graphics queue submissions of \p timelines wait for the upload completion, and the staging
+         * resources are retired to the upload completion value.
+         */
         Textures(
             const gltf::AssetExtended &assetExtended,
             const Gpu &gpu LIFETIMEBOUND,
+            QueueTimelines &timelines,
             const Fallback &fallbackTexture LIFETIMEBOUND,
             BS::thread_pool<> &threadPool
         );
@@ -49,6 +58,7 @@ module :private;
 vk_gltf_viewer::vulkan::texture::Textures::Textures(
     const gltf::AssetExtended &assetExtended,
     const Gpu &gpu,
+    [[maybe_unused]] QueueTimelines &timelines,
     const Fallback &fallbackTexture,
     BS::thread_pool<> &threadPool
 ) {
@@ -76,25 +86,37 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
         return;
     }
 
-    // Base color and emissive texture must be in SRGB format.
+    // Base color, emissive and the color textures of the material extensions must be in SRGB format.
     // First traverse the asset textures and fetch the image index that must be in SRGB format.
     std::unordered_set<std::size_t> srgbImageIndices;
+    const auto addSrgbTexture = [&](const fastgltf::Optional<fastgltf::TextureInfo> &textureInfo) {
+        if (textureInfo) {
+            srgbImageIndices.emplace(getPreferredImageIndex(assetExtended.asset.textures[textureInfo->textureIndex]));
+        }
+    };
     for (const fastgltf::Material &material : assetExtended.asset.materials) {
-        if (const auto &baseColorTexture = material.pbrData.baseColorTexture) {
-            srgbImageIndices.emplace(getPreferredImageIndex(assetExtended.asset.textures[baseColorTexture->textureIndex]));
+        addSrgbTexture(material.pbrData.baseColorTexture);
+        addSrgbTexture(material.emissiveTexture);
+        if (const auto &sheen = material.sheen) {
+            addSrgbTexture(sheen->sheenColorTexture);
+        }
+        if (const auto &specular = material.specular) {
+            addSrgbTexture(specular->specularColorTexture);
         }
-        if (const auto &emissiveTexture = material.emissiveTexture) {
-            srgbImageIndices.emplace(getPreferredImageIndex(assetExtended.asset.textures[emissiveTexture->textureIndex]));
+        if (const auto &diffuseTransmission = material.diffuseTransmission) {
+            addSrgbTexture(diffuseTransmission->diffuseTransmissionColorTexture);
         }
     }
 
 #if !__APPLE__
     vk::raii::CommandPool transferCommandPool { gpu.device, vk::CommandPoolCreateInfo { {}, gpu.queueFamilies.transfer } };
-    vkgltf::StagingBufferStorage stagingBufferStorage { gpu.device, gpu.allocator, transferCommandPool, gpu.queues.transfer };
+
+    // Staging buffers are retired after the upload, therefore the storage is heap allocated.
+    auto stagingBufferStorage = std::make_unique<vkgltf::StagingBufferStorage>(gpu.device, gpu.allocator, *transferCommandPool, gpu.queues.transfer);
 
     std::mutex mutex;
     vkgltf::StagingInfo stagingInfo {
-        .stagingBufferStorage = stagingBufferStorage,
+        .stagingBufferStorage = *stagingBufferStorage,
         .mutex = &mutex,
     };
     if (gpu.queueFamilies.transfer != gpu.queueFamilies.graphicsPresent) {
@@ -103,6 +125,7 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
 #endif
 
     images.insert_range(threadPool.submit_sequence(0, usedImageIndices.size(), [&](std::size_t i) {
+        const cpu_profiler::Zone zone { "Decode texture" };
         const std::size_t imageIndex = usedImageIndices[i];
 
         const bool isSrgbImage = srgbImageIndices.contains(imageIndex);
@@ -145,9 +168,7 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
         #else
             .uncompressedImageUsageFlags = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled,
             .uncompressedImageDstLayout = vk::ImageLayout::eTransferSrcOptimal,
-        #ifdef SUPPORT_KHR_TEXTURE_BASISU
             .compressedImageUsageFlags = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-        #endif
             .stagingInfo = &stagingInfo,
         #endif
         };
@@ -159,8 +180,10 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
     }).get() | std::views::as_rvalue);
 
 #if !__APPLE__
-    vk::raii::Semaphore copyFinishSemaphore { gpu.device, vk::SemaphoreCreateInfo{} };
-    stagingBufferStorage.execute(*copyFinishSemaphore);
+    std::optional<std::uint64_t> copyFinishValue;
+    if (const std::optional<vk::CommandBuffer> copyCommandBuffer = stagingBufferStorage->end()) {
+        copyFinishValue.emplace(timelines.transfer.submit({}, vk::CommandBufferSubmitInfo { *copyCommandBuffer }));
+    }
 #endif
 
     // Do some nice things during the GPU execution.
@@ -254,7 +277,6 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
         std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
         std::vector<vku::Image> imagesToGenerateMipmap;
         for (const auto &[image, _] : images | std::views::values) {
-        #ifdef SUPPORT_KHR_TEXTURE_BASISU
             if (isCompressed(image.format)) {
                 if (stagingInfo.queueFamilyOwnershipTransfer) {
                     // Change the image layout of the copied region from TransferDstOptimal to ShaderReadOnlyOptimal, and do
@@ -269,9 +291,7 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
                     });
                 }
             }
-            else
-        #endif
-            {
+            else {
                 if (stagingInfo.queueFamilyOwnershipTransfer) {
                     const auto& [src, dst] = *stagingInfo.queueFamilyOwnershipTransfer;
                     if (image.mipLevels == 1) {
@@ -359,16 +379,21 @@ vk_gltf_viewer::vulkan::texture::Textures::Textures(
         graphicsCommandBuffer.end();
     }
 
-    vk::raii::Fence fence { gpu.device, vk::FenceCreateInfo{} };
-    gpu.queues.graphicsPresent.submit2KHR(vk::SubmitInfo2 {
-        {},
-        vku::lvalue(vk::SemaphoreSubmitInfo { *copyFinishSemaphore, {}, dependencyChain }),
-        vku::lvalue(vk::CommandBufferSubmitInfo { graphicsCommandBuffer }),
-    }, *fence);
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+    if (copyFinishValue) {
+        waitInfos.push_back(timelines.transfer.getWaitInfo(*copyFinishValue, dependencyChain));
+    }
+    const std::uint64_t uploadFinishValue = timelines.graphicsPresent.submit(waitInfos, vk::CommandBufferSubmitInfo { graphicsCommandBuffer });
 
-    std::ignore = gpu.device.waitForFences(*fence, true, ~0ULL);
+    // Frames that sample the textures are submitted after this, and their submission order does not guarantee the
+    // upload completion.
+    timelines.graphicsPresent.addDependency({ timelines.graphicsPresent, uploadFinishValue }, vk::PipelineStageFlagBits2::eFragmentShader);
 
-    // Destroy staging buffers.
-    stagingBufferStorage.reset(false /* stagingBufferStorage will not be used anymore */);
+    // Staging buffers and command buffers are destroyed after the upload, as the transfer is finished before it.
+    timelines.graphicsPresent.retire(uploadFinishValue, std::move(stagingBufferStorage));
+    timelines.graphicsPresent.retire(uploadFinishValue, std::move(transferCommandPool));
+    if (graphicsCommandPool) {
+        timelines.graphicsPresent.retire(uploadFinishValue, std::move(*graphicsCommandPool));
+    }
 #endif
 }
\ No newline at end of file
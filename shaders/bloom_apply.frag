@@ -11,6 +11,7 @@ layout (set = 0, binding = 1) uniform texture2DArray bloomImage;
 
 layout (push_constant) uniform PushConstant {
     float factor;
+    bool upsampleHalfResolution;
 } pc;
 
 float trinaryMax(vec3 v) {
@@ -32,6 +33,25 @@ vec3 tonemapInvert(vec3 color) {
     return min(color / (1.0 - trinaryMax(color)), vec3(509.0));
 }
 
+// Same as the 3x3 tent filter in bloom upsample compute shader, but evaluated by texel fetches from the mip level 1.
+// See bloom/shader/upsample.comp for the weights.
+vec4 upsampleMip1(ivec3 coord) {
+    ivec2 srcMaxCoord = textureSize(bloomImage, 1).xy - 1;
+    ivec2 start = (coord.xy >> 1) - 2 + (coord.xy & 1);
+    vec4 weightsX = (coord.x & 1) == 0 ? vec4(1.0, 5.0, 7.0, 3.0) : vec4(3.0, 7.0, 5.0, 1.0);
+    vec4 weightsY = (coord.y & 1) == 0 ? vec4(1.0, 5.0, 7.0, 3.0) : vec4(3.0, 7.0, 5.0, 1.0);
+
+    vec4 result = vec4(0.0);
+    for (int y = 0; y < 4; ++y) {
+        vec4 row = vec4(0.0);
+        for (int x = 0; x < 4; ++x) {
+            row += weightsX[x] * texelFetch(bloomImage, ivec3(clamp(start + ivec2(x, y), ivec2(0), srcMaxCoord), coord.z), 1);
+        }
+        result += weightsY[y] * row;
+    }
+    return result / 256.0;
+}
+
 void main() {
     vec4 inputColor = subpassLoad(inputResult);
     inputColor.rgb = tonemapInvert(inputColor.rgb);
@@ -59,7 +79,11 @@ void main() {
         fetchCoord.z |= 2;
     }
 
-    vec4 bloomColor = texelFetch(bloomImage, fetchCoord, 0) * pc.factor;
+    vec4 bloomColor = texelFetch(bloomImage, fetchCoord, 0);
+    if (pc.upsampleHalfResolution) {
+        bloomColor += upsampleMip1(fetchCoord);
+    }
+    bloomColor *= pc.factor;
 
     // Alpha blending with premultiplied alpha.
     outColor.rgb = tonemap(bloomColor.rgb + inputColor.rgb * (1.0 - bloomColor.a));
@@ -19,5 +19,6 @@
 
 #define MATERIAL_INDEX inMaterialIndex
 #define MATERIAL materials[inMaterialIndex]
+#define MATERIAL_EXTENSION materialExtensions[MATERIAL.extensionIndex]
 
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef IRIDESCENCE_GLSL
+#define IRIDESCENCE_GLSL
+
+// Thin-film interference Fresnel term for KHR_materials_iridescence.
+// See: Belcour and Barla, A Practical Extension to Microfacet Theory for the Modeling of Varying Iridescence (2017).
+
+// CIE XYZ to linear sRGB (Rec. 709) color space conversion.
+const mat3 XYZ_TO_REC709 = mat3(
+     3.2404542, -0.9692660,  0.0556434,
+    -1.5371385,  1.8760108, -0.2040259,
+    -0.4985314,  0.0415560,  1.0572252
+);
+
+float square(float x) {
+    return x * x;
+}
+
+vec3 square(vec3 x) {
+    return x * x;
+}
+
+vec3 fresnelSchlick(float cosTheta, vec3 F0) {
+    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+// Fourier transform of the spectral sensitivity of the CIE XYZ color matching functions, evaluated at the optical path
+// difference OPD (in nanometers) and phase shift.
+vec3 evalSensitivity(float OPD, vec3 shift) {
+    const float PI = 3.1415926535;
+
+    float phase = 2.0 * PI * OPD * 1e-9;
+    const vec3 val = vec3(5.4856e-13, 4.4201e-13, 5.2481e-13);
+    const vec3 pos = vec3(1.6810e+06, 1.7953e+06, 2.2084e+06);
+    const vec3 var = vec3(4.3278e+09, 9.3046e+09, 6.6121e+09);
+
+    vec3 xyz = val * sqrt(2.0 * PI * var) * cos(pos * phase + shift) * exp(-square(phase) * var);
+    xyz.x += 9.7470e-14 * sqrt(2.0 * PI * 4.5282e+09) * cos(2.2399e+06 * phase + shift.x) * exp(-4.5282e+09 * square(phase));
+    return XYZ_TO_REC709 * (xyz / 1.0685e-7);
+}
+
+// Get the Fresnel reflectance of the base layer (whose F0 is baseF0) covered by the thin film of iridescenceIor and
+// thickness (in nanometers), for the incident angle cosTheta1 from the air.
+vec3 evalIridescence(float iridescenceIor, float cosTheta1, float thickness, vec3 baseF0) {
+    const float PI = 3.1415926535;
+
+    // Film with zero thickness should be invisible, therefore smoothly fade out its IOR to the outside (air).
+    iridescenceIor = mix(1.0, iridescenceIor, smoothstep(0.0, 0.03, thickness));
+
+    // Snell's law, total internal reflection.
+    float cosTheta2Sq = 1.0 - square(1.0 / iridescenceIor) * (1.0 - square(cosTheta1));
+    if (cosTheta2Sq < 0.0) {
+        return vec3(1.0);
+    }
+    float cosTheta2 = sqrt(cosTheta2Sq);
+
+    // First interface (air -> film).
+    float R12 = fresnelSchlick(cosTheta1, vec3(square((iridescenceIor - 1.0) / (iridescenceIor + 1.0)))).x;
+    float T121 = 1.0 - R12;
+    float phi12 = iridescenceIor < 1.0 ? PI : 0.0;
+    float phi21 = PI - phi12;
+
+    // Second interface (film -> base).
+    vec3 sqrtBaseF0 = sqrt(clamp(baseF0, 0.0, 0.9999));
+    vec3 baseIor = (1.0 + sqrtBaseF0) / (1.0 - sqrtBaseF0);
+    vec3 R23 = fresnelSchlick(cosTheta2, square((baseIor - iridescenceIor) / (baseIor + iridescenceIor)));
+    vec3 phi23 = mix(vec3(0.0), vec3(PI), lessThan(baseIor, vec3(iridescenceIor)));
+
+    // Phase shift.
+    float OPD = 2.0 * iridescenceIor * thickness * cosTheta2;
+    vec3 phi = phi21 + phi23;
+
+    // Compound terms.
+    vec3 R123 = clamp(R12 * R23, 1e-5, 0.9999);
+    vec3 r123 = sqrt(R123);
+    vec3 Rs = square(T121) * R23 / (1.0 - R123);
+
+    // Reflectance term for m = 0 (DC term amplitude) and the first two orders of the interference.
+    vec3 I = R12 + Rs;
+    vec3 Cm = Rs - T121;
+    for (int m = 1; m <= 2; ++m) {
+        Cm *= r123;
+        I += Cm * 2.0 * evalSensitivity(m * OPD, m * phi);
+    }
+    return max(I, vec3(0.0));
+}
+
+#endif
@@ -33,10 +33,10 @@ layout (set = 1, binding = 2, std430) readonly buffer MaterialBuffer {
     Material materials[];
 };
 #if SEPARATE_IMAGE_SAMPLER == 1
-layout (set = 1, binding = 3) uniform sampler samplers[];
-layout (set = 1, binding = 4) uniform texture2D images[];
+layout (set = 1, binding = 4) uniform sampler samplers[];
+layout (set = 1, binding = 5) uniform texture2D images[];
 #else
-layout (set = 1, binding = 3) uniform sampler2D textures[];
+layout (set = 1, binding = 4) uniform sampler2D textures[];
 #endif
 
 layout (set = 2, binding = 0) buffer MousePickingResultBuffer {
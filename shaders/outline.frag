@@ -8,6 +8,9 @@ layout (set = 0, binding = 0) uniform utexture2DArray jumpFloodImage;
 layout (push_constant) uniform PushConstant {
     vec4 outlineColor;
     float outlineThickness;
+    uint layerOffset;
+    uvec2 viewExtent;
+    uint resolutionShift;
 } pc;
 
 void main(){
@@ -15,26 +18,34 @@ void main(){
 
     // Determining the fetch coordinate:
     //
-    // Currently the application supports view count of 1, 2 and 4. For view count of 1, the jump flood image extent is the
-    // same as the framebuffer extent. For view count of 2, the framebuffer extent width is doubled. For view count of 4,
-    // both the framebuffer extent width and height are doubled.
+    // Currently the application supports view count of 1, 2 and 4. For view count of 1, the view extent is the same as
+    // the framebuffer extent. For view count of 2, the framebuffer extent width is doubled. For view count of 4, both
+    // the framebuffer extent width and height are doubled.
     //
     // Therefore, the fetch coordinate can be determined by the following rule:
-    // - if gl_FragCoord.x >= jumpFloodImageSize.x, (fetch coordinate x) = (gl_FragCoord.x - jumpFloodImageSize.x), and the layer bit 0 is set.
-    // - if gl_FragCoord.y >= jumpFloodImageSize.y, (fetch coordinate y) = (gl_FragCoord.y - jumpFloodImageSize.y), and the layer bit 1 is set.
-    // The result layer index will be the bitwise OR of the two bits.
+    // - if gl_FragCoord.x >= viewExtent.x, (fetch coordinate x) = (gl_FragCoord.x - viewExtent.x), and the layer bit 0 is set.
+    // - if gl_FragCoord.y >= viewExtent.y, (fetch coordinate y) = (gl_FragCoord.y - viewExtent.y), and the layer bit 1 is set.
+    // The result layer index will be the bitwise OR of the two bits, offset by pc.layerOffset.
 
-    ivec2 jumpFloodImageSize = textureSize(jumpFloodImage, 0).xy;
-    if (fetchCoord.x >= jumpFloodImageSize.x) {
-        fetchCoord.x -= jumpFloodImageSize.x;
+    if (fetchCoord.x >= int(pc.viewExtent.x)) {
+        fetchCoord.x -= int(pc.viewExtent.x);
         fetchCoord.z |= 1;
     }
-    if (fetchCoord.y >= jumpFloodImageSize.y) {
-        fetchCoord.y -= jumpFloodImageSize.y;
+    if (fetchCoord.y >= int(pc.viewExtent.y)) {
+        fetchCoord.y -= int(pc.viewExtent.y);
         fetchCoord.z |= 2;
     }
 
-    float signedDistance = distance(texelFetch(jumpFloodImage, fetchCoord, 0).xy, fetchCoord.xy);
+    vec2 viewCoord = vec2(fetchCoord.xy);
+    fetchCoord.xy >>= pc.resolutionShift;
+    fetchCoord.z += int(pc.layerOffset);
+
+    // If the jump flood image is downsampled, a texel covers (1 << resolutionShift)^2 fragments and its seed
+    // coordinate has to be mapped to the center of the covered fragments.
+    float resolutionScale = float(1U << pc.resolutionShift);
+    vec2 seedCoord = (vec2(texelFetch(jumpFloodImage, fetchCoord, 0).xy) + 0.5) * resolutionScale - 0.5;
+
+    float signedDistance = distance(seedCoord, viewCoord);
     outColor = pc.outlineColor;
     outColor.a = (signedDistance > 1.0 ? outColor.a * smoothstep(pc.outlineThickness + 1.0, pc.outlineThickness, signedDistance) : 0.0);
 }
\ No newline at end of file
@@ -12,6 +12,9 @@
 
 #define FRAGMENT_SHADER
 #include "indexing.glsl"
+#if HAS_MATERIAL_EXTENSION
+#include "iridescence.glsl"
+#endif
 #include "spherical_harmonics.glsl"
 #include "types.glsl"
 
@@ -19,6 +22,17 @@
 
 layout (constant_id = 0) const bool USE_TEXTURE_TRANSFORM = false;
 layout (constant_id = 1) const bool USE_LOD_BASED_ALPHA_CUTOFF = false;
+#if HAS_MATERIAL_EXTENSION
+// Material extensions that are used by any material drawn by this pipeline. Disabled ones are eliminated at the
+// pipeline creation.
+layout (constant_id = 2) const bool USE_TRANSMISSION = false;
+layout (constant_id = 3) const bool USE_CLEARCOAT = false;
+layout (constant_id = 4) const bool USE_SHEEN = false;
+layout (constant_id = 5) const bool USE_SPECULAR = false;
+layout (constant_id = 6) const bool USE_IRIDESCENCE = false;
+layout (constant_id = 7) const bool USE_ANISOTROPY = false;
+layout (constant_id = 8) const bool USE_DIFFUSE_TRANSMISSION = false;
+#endif
 
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) flat in uint inMaterialIndex;
@@ -52,8 +66,11 @@ layout (location = 1) out float outRevealage;
 #endif
 
 layout (set = 0, binding = 0) uniform CameraBuffer {
+    mat4 projectionViews[4];
     layout (offset = 512) vec3 viewPositions[4];
 } camera;
+// Tone mapped scene color of the opaque meshes with full mip chain, whose array layers are the views.
+layout (set = 0, binding = 1) uniform sampler2DArray transmissionSampler;
 
 layout (set = 1, binding = 0, scalar) uniform SphericalHarmonicsBuffer {
     vec3 coefficients[9];
@@ -64,11 +81,16 @@ layout (set = 1, binding = 2) uniform sampler2D brdfmap;
 layout (set = 2, binding = 2, std430) readonly buffer MaterialBuffer {
     Material materials[];
 };
+#if HAS_MATERIAL_EXTENSION
+layout (set = 2, binding = 3, scalar) readonly buffer MaterialExtensionBuffer {
+    MaterialExtension materialExtensions[];
+};
+#endif
 #if SEPARATE_IMAGE_SAMPLER == 1
-layout (set = 2, binding = 3) uniform sampler samplers[];
-layout (set = 2, binding = 4) uniform texture2D images[];
+layout (set = 2, binding = 4) uniform sampler samplers[];
+layout (set = 2, binding = 5) uniform texture2D images[];
 #else
-layout (set = 2, binding = 3) uniform sampler2D textures[];
+layout (set = 2, binding = 4) uniform sampler2D textures[];
 #endif
 
 layout (push_constant) uniform PushConstant {
@@ -114,6 +136,58 @@ vec3 tonemap(vec3 color) {
     return color / (1.0 + trinaryMax(color));
 }
 
+vec3 tonemapInvert(vec3 color) {
+    // See inverse_tone_mapping.frag for the clamping.
+    return min(color / (1.0 - trinaryMax(color)), vec3(509.0));
+}
+
+#if HAS_MATERIAL_EXTENSION
+// Get the radiance that is refracted into the volume at the current fragment and exits at its back side, which is
+// approximated by sampling the opaque scene color at the projected exit point.
+vec3 getTransmittedRadiance(vec3 N, vec3 V, float roughness, float thickness) {
+    // KHR_materials_volume thickness is given in the mesh local space, but the node scale is not available here.
+    // Therefore, it is regarded as in the world space.
+    vec3 exitPosition = inPosition + normalize(refract(-V, N, 1.0 / MATERIAL.ior)) * thickness;
+    vec4 clipPosition = camera.projectionViews[pc.viewIndex] * vec4(exitPosition, 1.0);
+    // Viewport is y-flipped, therefore NDC y = 1 is the top of the view.
+    vec2 texcoord = vec2(0.5, -0.5) * (clipPosition.xy / clipPosition.w) + 0.5;
+
+    // Rougher surface scatters the transmitted light more, approximated by sampling the blurrier mip level. Scattering
+    // is also scaled by the IOR, as IOR = 1 does not bend the light at all.
+    float lod = log2(float(textureSize(transmissionSampler, 0).x)) * roughness * clamp(MATERIAL.ior * 2.0 - 2.0, 0.0, 1.0);
+    vec3 radiance = tonemapInvert(textureLod(transmissionSampler, vec3(texcoord, pc.viewIndex), lod).rgb);
+
+    // Beer-Lambert law, where attenuationDistance is the distance that the light travels to be attenuationColor.
+    vec3 attenuation = pow(MATERIAL_EXTENSION.attenuationColor, vec3(thickness / MATERIAL_EXTENSION.attenuationDistance));
+    return radiance * attenuation;
+}
+
+// Sample the texture at the slot (MATERIAL_TEXTURE_*) of the material extension. If the material does not have the
+// texture, the fallback texture (white) is sampled.
+vec4 sampleMaterialExtensionTexture(uint slot) {
+#if TEXCOORD_COUNT >= 1
+    vec2 texcoord = getTexcoord(MATERIAL_EXTENSION.textures[slot].texcoordIndex);
+    if (USE_TEXTURE_TRANSFORM) {
+        texcoord = mat2(MATERIAL_EXTENSION.textures[slot].transform) * texcoord + MATERIAL_EXTENSION.textures[slot].transform[2];
+    }
+#if SEPARATE_IMAGE_SAMPLER == 1
+    return texture(sampler2D(images[uint(MATERIAL_EXTENSION.textures[slot].index) & 0xFFFU], samplers[uint(MATERIAL_EXTENSION.textures[slot].index) >> 12U]), texcoord);
+#else
+    return texture(textures[uint(MATERIAL_EXTENSION.textures[slot].index)], texcoord);
+#endif
+#else
+    return vec4(1.0);
+#endif
+}
+
+// Approximated directional albedo of the Charlie sheen BRDF, which is used for energy conservation of the base layer.
+// See: Estevez and Kulla, Production Friendly Microfacet Sheen BRDF (2017).
+float sheenAlbedo(float NdotV, float sheenRoughness) {
+    float alpha = max(sheenRoughness, 0.07);
+    return clamp(0.65 * pow(1.0 - NdotV, 4.0 * alpha + 1.0) * alpha + 0.13 * alpha + 0.05, 0.0, 1.0);
+}
+#endif
+
 void writeOutput(vec4 color) {
 #if ALPHA_MODE == 0
     outColor = vec4(color.rgb, 1.0);
@@ -250,6 +324,11 @@ void main(){
     gl_FragStencilRefARB = trinaryMax(emissive) > 1.0 ? 1 : 0;
 #endif
 
+#if HAS_MATERIAL_EXTENSION
+    // Derivatives must be evaluated in the uniform control flow.
+    vec3 positionDx = dFdx(inPosition);
+#endif
+
     vec3 V = normalize(camera.viewPositions[pc.viewIndex] - inPosition);
     float NdotV = dot(N, V);
     // If normal is not facing the camera, normal have to be flipped.
@@ -261,23 +340,116 @@ void main(){
 
     float dielectric_f0 = (MATERIAL.ior - 1.0) / (MATERIAL.ior + 1.0);
     dielectric_f0 = dielectric_f0 * dielectric_f0;
+    vec3 dielectricF0 = vec3(dielectric_f0);
+    float specularWeight = 1.0;
+
+#if HAS_MATERIAL_EXTENSION
+    // KHR_materials_specular: strength and color of the dielectric specular reflection.
+    if (USE_SPECULAR) {
+        specularWeight = MATERIAL_EXTENSION.specularFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_SPECULAR).a;
+        dielectricF0 = min(dielectricF0 * MATERIAL_EXTENSION.specularColorFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_SPECULAR_COLOR).rgb, vec3(1.0));
+    }
+
+    // KHR_materials_anisotropy: the reflection is looked up along the normal bent toward the anisotropy direction.
+    if (USE_ANISOTROPY) {
+        vec3 anisotropyTexel = MATERIAL_EXTENSION.textures[MATERIAL_TEXTURE_ANISOTROPY].index == 0US
+            ? vec3(1.0, 0.5, 1.0) // Default value of the anisotropy texture, which is not the same as the fallback texture.
+            : sampleMaterialExtensionTexture(MATERIAL_TEXTURE_ANISOTROPY).rgb;
+        vec2 direction = anisotropyTexel.rg * 2.0 - 1.0;
+        vec2 rotation = MATERIAL_EXTENSION.anisotropyDirection;
+        direction = normalize(mat2(rotation.x, rotation.y, -rotation.y, rotation.x) * direction);
+        float anisotropy = MATERIAL_EXTENSION.anisotropyStrength * anisotropyTexel.b;
+
+    #if FRAGMENT_SHADER_GENERATED_TBN
+        vec3 T = positionDx;
+    #else
+        // TANGENT attribute may be missing, then the screen space derivative is used instead.
+        vec3 T = dot(variadic_in.tbn[0], variadic_in.tbn[0]) > 1e-8 ? variadic_in.tbn[0] : positionDx;
+    #endif
+        T = normalize(T - dot(T, N) * N);
+        vec3 B = cross(N, T);
+
+        vec3 anisotropicT = T * direction.x + B * direction.y;
+        vec3 anisotropicN = cross(cross(anisotropicT, V), anisotropicT);
+        float bendFactor = 1.0 - anisotropy * (1.0 - roughness);
+        bendFactor *= bendFactor;
+        R = reflect(-V, normalize(mix(anisotropicN, N, bendFactor * bendFactor)));
+    }
+#endif
 
-    vec3 F0 = mix(vec3(dielectric_f0), baseColor.rgb, metallic);
+    vec3 F0 = mix(dielectricF0, baseColor.rgb, metallic);
     float maxNdotV = max(NdotV, 0.0);
     vec3 F = fresnelSchlickRoughness(maxNdotV, F0, roughness);
 
-    vec3 kS = F;
+#if HAS_MATERIAL_EXTENSION
+    // KHR_materials_iridescence: thin-film interference over the base layer.
+    if (USE_IRIDESCENCE) {
+        float iridescence = MATERIAL_EXTENSION.iridescenceFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_IRIDESCENCE).r;
+        float thickness = mix(
+            MATERIAL_EXTENSION.iridescenceThicknessMinimum,
+            MATERIAL_EXTENSION.iridescenceThicknessMaximum,
+            sampleMaterialExtensionTexture(MATERIAL_TEXTURE_IRIDESCENCE_THICKNESS).g);
+        F = mix(F, evalIridescence(MATERIAL_EXTENSION.iridescenceIor, maxNdotV, thickness, F0), iridescence);
+    }
+#endif
+
+    // Only the dielectric specular reflection is scaled by KHR_materials_specular.
+    vec3 specularScale = vec3(mix(specularWeight, 1.0, metallic));
+    vec3 kS = F * specularScale;
     vec3 kD = (1.0 - kS) * (1.0 - metallic);
 
     vec3 irradiance = diffuseIrradiance(N);
     vec3 diffuse    = irradiance * baseColor.rgb;
 
+#if HAS_MATERIAL_EXTENSION
+    // KHR_materials_diffuse_transmission: the light from the back side is scattered through the thin surface.
+    if (USE_DIFFUSE_TRANSMISSION) {
+        float diffuseTransmission = MATERIAL_EXTENSION.diffuseTransmissionFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_DIFFUSE_TRANSMISSION).a;
+        vec3 diffuseTransmissionColor = MATERIAL_EXTENSION.diffuseTransmissionColorFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_DIFFUSE_TRANSMISSION_COLOR).rgb;
+        diffuse = mix(diffuse, diffuseIrradiance(-N) * diffuseTransmissionColor * baseColor.rgb, diffuseTransmission);
+    }
+
+    // KHR_materials_transmission: transmitted light replaces the diffuse reflection of the dielectric part.
+    if (USE_TRANSMISSION) {
+        float transmission = MATERIAL_EXTENSION.transmissionFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_TRANSMISSION).r;
+        float thickness = MATERIAL_EXTENSION.thicknessFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_VOLUME_THICKNESS).g;
+        diffuse = mix(diffuse, getTransmittedRadiance(N, V, roughness, thickness) * baseColor.rgb, transmission);
+    }
+#endif
+
     uint prefilteredmapMipLevels = textureQueryLevels(prefilteredmap);
     vec3 prefilteredColor = textureLod(prefilteredmap, R, roughness * (prefilteredmapMipLevels - 1U)).rgb;
     vec2 brdf  = texture(brdfmap, vec2(maxNdotV, roughness)).rg;
-    vec3 specular = prefilteredColor * (F * brdf.x + brdf.y);
+    vec3 specular = prefilteredColor * (F * brdf.x + brdf.y) * specularScale;
+
+    vec3 color = (kD * diffuse + specular) * occlusion;
+
+#if HAS_MATERIAL_EXTENSION
+    // KHR_materials_sheen: retro-reflective layer on top of the base, which is approximated by the diffuse
+    // irradiance scaled by its albedo.
+    if (USE_SHEEN) {
+        vec3 sheenColor = MATERIAL_EXTENSION.sheenColorFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_SHEEN_COLOR).rgb;
+        float sheenRoughness = MATERIAL_EXTENSION.sheenRoughnessFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_SHEEN_ROUGHNESS).a;
+        float albedo = sheenAlbedo(maxNdotV, sheenRoughness);
+        color = color * (1.0 - trinaryMax(sheenColor) * albedo) + irradiance * sheenColor * albedo * occlusion;
+    }
+
+    // KHR_materials_clearcoat: dielectric (IOR = 1.5) layer on top of the base. Clearcoat normal texture is not
+    // supported, therefore it shares the normal with the base.
+    if (USE_CLEARCOAT) {
+        float clearcoat = MATERIAL_EXTENSION.clearcoatFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_CLEARCOAT).r;
+        float clearcoatRoughness = MATERIAL_EXTENSION.clearcoatRoughnessFactor * sampleMaterialExtensionTexture(MATERIAL_TEXTURE_CLEARCOAT_ROUGHNESS).g;
+        vec3 clearcoatF = fresnelSchlickRoughness(maxNdotV, vec3(0.04), clearcoatRoughness);
+        vec3 clearcoatPrefilteredColor = textureLod(prefilteredmap, reflect(-V, N), clearcoatRoughness * (prefilteredmapMipLevels - 1U)).rgb;
+        vec2 clearcoatBrdf = texture(brdfmap, vec2(maxNdotV, clearcoatRoughness)).rg;
+        vec3 clearcoatSpecular = clearcoatPrefilteredColor * (clearcoatF * clearcoatBrdf.x + clearcoatBrdf.y);
+
+        color = color * (1.0 - clearcoat * clearcoatF) + clearcoat * clearcoatSpecular * occlusion;
+        emissive *= 1.0 - clearcoat * clearcoatF;
+    }
+#endif
 
-    vec3 color = (kD * diffuse + specular) * occlusion + emissive;
+    color += emissive;
 
     writeOutput(vec4(tonemap(color), baseColor.a));
 }
\ No newline at end of file
@@ -26,9 +26,54 @@ struct Material {
     mat3x2 occlusionTextureTransform;
     mat3x2 emissiveTextureTransform;
     float ior;
-    float padding1;
+    uint extensionIndex;
 }; // 192 bytes.
 
+// Texture slots of MaterialExtension.
+#define MATERIAL_TEXTURE_TRANSMISSION 0
+#define MATERIAL_TEXTURE_VOLUME_THICKNESS 1
+#define MATERIAL_TEXTURE_CLEARCOAT 2
+#define MATERIAL_TEXTURE_CLEARCOAT_ROUGHNESS 3
+#define MATERIAL_TEXTURE_SHEEN_COLOR 4
+#define MATERIAL_TEXTURE_SHEEN_ROUGHNESS 5
+#define MATERIAL_TEXTURE_SPECULAR 6
+#define MATERIAL_TEXTURE_SPECULAR_COLOR 7
+#define MATERIAL_TEXTURE_IRIDESCENCE 8
+#define MATERIAL_TEXTURE_IRIDESCENCE_THICKNESS 9
+#define MATERIAL_TEXTURE_ANISOTROPY 10
+#define MATERIAL_TEXTURE_DIFFUSE_TRANSMISSION 11
+#define MATERIAL_TEXTURE_DIFFUSE_TRANSMISSION_COLOR 12
+
+struct MaterialTextureInfo {
+    mat3x2 transform;
+    uint16_t index;
+    uint8_t texcoordIndex;
+    uint8_t padding0;
+}; // 28 bytes.
+
+// Must be used with the scalar block layout.
+struct MaterialExtension {
+    float transmissionFactor;
+    float thicknessFactor;
+    vec3 attenuationColor;
+    float attenuationDistance;
+    float clearcoatFactor;
+    float clearcoatRoughnessFactor;
+    vec3 sheenColorFactor;
+    float sheenRoughnessFactor;
+    vec3 specularColorFactor;
+    float specularFactor;
+    float iridescenceFactor;
+    float iridescenceIor;
+    float iridescenceThicknessMinimum;
+    float iridescenceThicknessMaximum;
+    vec2 anisotropyDirection;
+    float anisotropyStrength;
+    vec3 diffuseTransmissionColorFactor;
+    float diffuseTransmissionFactor;
+    MaterialTextureInfo textures[13];
+}; // 472 bytes.
+
 // --------------------
 // Vertex shader only types
 // --------------------
@@ -79,6 +124,8 @@ struct Primitive {
     Accessors weightAccessors;
     int materialIndex;
     uint _padding;
+    vec3 positionDequantizationOffset;
+    vec3 positionDequantizationScale;
 };
 
 #endif
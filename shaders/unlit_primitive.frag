@@ -35,10 +35,10 @@ layout (set = 2, binding = 2, std430) readonly buffer MaterialBuffer {
     Material materials[];
 };
 #if SEPARATE_IMAGE_SAMPLER == 1
-layout (set = 2, binding = 3) uniform sampler samplers[];
-layout (set = 2, binding = 4) uniform texture2D images[];
+layout (set = 2, binding = 4) uniform sampler samplers[];
+layout (set = 2, binding = 5) uniform texture2D images[];
 #else
-layout (set = 2, binding = 3) uniform sampler2D textures[];
+layout (set = 2, binding = 4) uniform sampler2D textures[];
 #endif
 
 #if ALPHA_MODE == 0 || ALPHA_MODE == 2
@@ -21,6 +21,57 @@ layout (std430, buffer_reference, buffer_reference_align = 4) readonly buffer Ve
 layout (std430, buffer_reference, buffer_reference_align = 4) readonly buffer UIntRef { uint data; };
 layout (std430, buffer_reference, buffer_reference_align = 4) readonly buffer UVec2Ref { uvec2 data; };
 
+// Specialization constant value of NORMAL_COMPONENT_TYPE and TANGENT_COMPONENT_TYPE for the octahedral mapped unit
+// vector stream, which is not a GL component type.
+#define OCTAHEDRAL_SHORT_NORMALIZED 65536U
+
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 v = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    // Fold the lower hemisphere.
+    float t = max(-v.z, 0.0);
+    v.xy += mix(vec2(t), vec2(-t), greaterThanEqual(v.xy, vec2(0.0)));
+    return normalize(v);
+}
+
+vec3 fetchOctahedralNormal(uvec2 fetchAddress) {
+    return decodeOctahedral(unpackSnorm2x16(UIntRef(fetchAddress).data));
+}
+
+vec4 fetchOctahedralTangent(uvec2 fetchAddress) {
+    // Least significant bit of the second component is the bitangent sign, and the rest is 15-bit SNORM.
+    int fetched = int(UIntRef(fetchAddress).data);
+    int x = bitfieldExtract(fetched, 0, 16);
+    int y = bitfieldExtract(fetched, 16, 16);
+    vec2 encoded = vec2(max(float(x) / 32767.0, -1.0), max(float(y >> 1) / 16383.0, -1.0));
+    return vec4(decodeOctahedral(encoded), (y & 1) != 0 ? -1.0 : 1.0);
+}
+
+// Bit of the morph target Accessor::componentType, which indicates the accessor data is stored as the sparse (index,
+// value) lists. See vkgltf::PrimitiveAttributeBuffers::AttributeInfo::sparse for the data layout.
+#define SPARSE_MORPH_TARGET_BIT 16U
+
+// Get the fetch address of the current vertex in the morph target accessor, or return false if the accessor is sparse
+// and doesn't contain the vertex (i.e. its displacement is zero).
+bool getMorphTargetFetchAddress(Accessor accessor, out uvec2 fetchAddress) {
+    uint vertexIndex = uint(gl_VertexIndex);
+    if ((accessor.componentType & SPARSE_MORPH_TARGET_BIT) == 0U) {
+        fetchAddress = getFetchAddress(accessor, vertexIndex);
+        return true;
+    }
+
+    // (bitmap of the presented vertices, number of the presented vertices before them) per 32 vertices.
+    uvec2 block = UVec2Ref(add64(accessor.bufferAddress, 8U + 8U * (vertexIndex >> 5U))).data;
+    uint vertexBit = 1U << (vertexIndex & 31U);
+    if ((block.x & vertexBit) == 0U) {
+        return false;
+    }
+
+    uint valueIndex = block.y + uint(bitCount(block.x & (vertexBit - 1U)));
+    uint valuesByteOffset = UIntRef(accessor.bufferAddress).data;
+    fetchAddress = add64(accessor.bufferAddress, valuesByteOffset + accessor.stride * valueIndex);
+    return true;
+}
+
 vec3 getPosition(uint componentType, bool normalized, uint morphTargetWeightCount) {
     vec3 position;
 
@@ -44,8 +95,9 @@ vec3 getPosition(uint componentType, bool normalized, uint morphTargetWeightCoun
         break;
     case 5122U: // SHORT
         if (normalized) {
+            // Position may be quantized relative to the primitive's bounding box by the application.
             uvec2 fetched = UVec2Ref(fetchAddress).data;
-            position = vec3(unpackSnorm2x16(fetched.x), unpackSnorm2x16(fetched.y).x);
+            position = PRIMITIVE.positionDequantizationOffset + PRIMITIVE.positionDequantizationScale * vec3(unpackSnorm2x16(fetched.x), unpackSnorm2x16(fetched.y).x);
         }
         else {
             position = vec3(I16Vec3Ref(fetchAddress).data);
@@ -67,10 +119,13 @@ vec3 getPosition(uint componentType, bool normalized, uint morphTargetWeightCoun
 
     for (uint i = 0; i < morphTargetWeightCount; i++) {
         Accessor accessor = PRIMITIVE.positionMorphTargetAccessors.data[i];
-        fetchAddress = getFetchAddress(accessor, gl_VertexIndex);
+        if (!getMorphTargetFetchAddress(accessor, fetchAddress)) {
+            // Vertex is not displaced by the sparse morph target.
+            continue;
+        }
 
         float weight = NODE.morphTargetWeights.data[i];
-        switch (accessor.componentType) {
+        switch (accessor.componentType & ~SPARSE_MORPH_TARGET_BIT) {
         case 0U: // BYTE
             position += weight * vec3(I8Vec3Ref(fetchAddress).data);
             break;
@@ -108,14 +163,20 @@ vec3 getNormal(uint componentType, uint morphTargetWeightCount) {
         uvec2 fetched = UVec2Ref(fetchAddress).data;
         normal = vec3(unpackSnorm2x16(fetched.x), unpackSnorm2x16(fetched.y).x);
         break;
+    case OCTAHEDRAL_SHORT_NORMALIZED:
+        normal = fetchOctahedralNormal(fetchAddress);
+        break;
     }
 
     for (uint i = 0; i < morphTargetWeightCount; i++) {
         Accessor accessor = PRIMITIVE.normalMorphTargetAccessors.data[i];
-        fetchAddress = getFetchAddress(accessor, gl_VertexIndex);
+        if (!getMorphTargetFetchAddress(accessor, fetchAddress)) {
+            // Vertex is not displaced by the sparse morph target.
+            continue;
+        }
 
         float weight = NODE.morphTargetWeights.data[i];
-        switch (accessor.componentType) {
+        switch (accessor.componentType & ~SPARSE_MORPH_TARGET_BIT) {
         case 6U: // FLOAT
             normal += weight * Vec3Ref(fetchAddress).data;
             break;
@@ -147,15 +208,21 @@ vec4 getTangent(uint componentType, uint morphTargetWeightCount) {
         uvec2 fetched = UVec2Ref(fetchAddress).data;
         tangent = vec4(unpackSnorm2x16(fetched.x), unpackSnorm2x16(fetched.y));
         break;
+    case OCTAHEDRAL_SHORT_NORMALIZED:
+        tangent = fetchOctahedralTangent(fetchAddress);
+        break;
     }
 
     for (uint i = 0; i < morphTargetWeightCount; i++) {
         Accessor accessor = PRIMITIVE.tangentMorphTargetAccessors.data[i];
-        fetchAddress = getFetchAddress(accessor, gl_VertexIndex);
+        if (!getMorphTargetFetchAddress(accessor, fetchAddress)) {
+            // Vertex is not displaced by the sparse morph target.
+            continue;
+        }
 
         // Tangent morph target only adds XYZ vertex tangent displacements.
         float weight = NODE.morphTargetWeights.data[i];
-        switch (accessor.componentType) {
+        switch (accessor.componentType & ~SPARSE_MORPH_TARGET_BIT) {
         case 6U: // FLOAT
             tangent.xyz += weight * Vec3Ref(fetchAddress).data;
             break;
@@ -189,6 +189,16 @@ namespace vkgltf {
              */
             std::function<fastgltf::PrimitiveType(fastgltf::PrimitiveType)> topologyConvertFn = DefaultTopologyConvertFn{};
 
+            /**
+             * @brief Function returns the additional level of detail (LOD) indices of the given indexed triangle list
+             * primitive, ordered from the finest to the coarsest.
+             *
+             * Returned indices must refer the vertices of the primitive (i.e. be representable by the primitive's index
+             * type), and are stored right after the primitive's indices. The function is not invoked if it is empty,
+             * and the returned spans are only required to be valid during the <tt>CombinedIndexBuffer</tt> construction.
+             */
+            std::function<std::vector<std::span<const std::uint32_t>>(const fastgltf::Primitive&)> levelOfDetailIndicesFn;
+
             /**
              * @brief Vulkan buffer usage flags for the buffer creation.
              *
@@ -240,6 +250,14 @@ namespace vkgltf {
          */
         [[nodiscard]] std::pair<vk::IndexType, std::uint32_t> getIndexTypeAndFirstIndex(const fastgltf::Primitive &primitive) const;
 
+        /**
+         * @brief Get (first index, index count) pairs of the level of details for the given primitive.
+         * @param primitive Primitive to get the level of details.
+         * @return Pairs of first index and index count, ordered from the finest to the coarsest. The first element is
+         * the primitive's own indices. Empty if no level of detail is generated for the primitive.
+         */
+        [[nodiscard]] std::span<const std::pair<std::uint32_t, std::uint32_t>> getLevelOfDetailFirstIndexAndCounts(const fastgltf::Primitive &primitive) const noexcept;
+
         /**
          * @brief Construct <tt>CombinedIndexBuffer</tt> from \p asset, only if the asset has index data.
          *
@@ -274,7 +292,9 @@ namespace vkgltf {
             std::unordered_map<const fastgltf::Primitive*, std::span<const std::byte>> unsignedByteIndexBytes;
             std::unordered_map<const fastgltf::Primitive*, std::span<const std::byte>> unsignedShortIndexBytes;
             std::unordered_map<const fastgltf::Primitive*, std::span<const std::byte>> unsignedIntIndexBytes;
+            std::unordered_map<const fastgltf::Primitive*, std::vector<std::span<const std::byte>>> levelOfDetailIndexBytes;
             std::unordered_map<const fastgltf::Primitive*, std::pair<vk::IndexType, std::uint32_t>> indexTypeAndFirstIndexByPrimitive;
+            std::unordered_map<const fastgltf::Primitive*, std::vector<std::pair<std::uint32_t, std::uint32_t>>> levelOfDetailFirstIndexAndCountsByPrimitive;
             vk::DeviceSize bufferSize;
             vk::DeviceSize unsignedShortIndexOffset;
             vk::DeviceSize unsignedByteIndexOffset;
@@ -422,12 +442,57 @@ namespace vkgltf {
                     }
                 }
 
+                if (config.levelOfDetailIndicesFn) {
+                    const auto generateLevelOfDetailBytes = [&]<typename T>(const std::unordered_map<const fastgltf::Primitive*, std::span<const std::byte>> &indexBytesByPrimitive) {
+                        for (const fastgltf::Primitive *primitive : indexBytesByPrimitive | std::views::keys) {
+                            // Topology converted primitive's indices are generated, therefore the LOD indices
+                            // (which refer the original primitive's vertices) are only applicable to the triangle list
+                            // primitive.
+                            if (primitive->type != fastgltf::PrimitiveType::Triangles || !primitive->indicesAccessor) {
+                                continue;
+                            }
+
+                            for (std::span<const std::uint32_t> indices : std::invoke(config.levelOfDetailIndicesFn, *primitive)) {
+                                const std::size_t byteSize = sizeof(T) * indices.size();
+                                auto bytes = std::make_unique_for_overwrite<std::byte[]>(byteSize);
+                                std::ranges::transform(indices, reinterpret_cast<T*>(bytes.get()), [](std::uint32_t index) {
+                                    return static_cast<T>(index);
+                                });
+                                levelOfDetailIndexBytes[primitive].emplace_back(generatedBytes.emplace_back(std::move(bytes)).get(), byteSize);
+                            }
+                        }
+                    };
+                    generateLevelOfDetailBytes.template operator()<std::uint32_t>(unsignedIntIndexBytes);
+                    generateLevelOfDetailBytes.template operator()<std::uint16_t>(unsignedShortIndexBytes);
+                    generateLevelOfDetailBytes.template operator()<std::uint8_t>(unsignedByteIndexBytes);
+                }
+
+                // Level of detail indices are placed right after their primitive's indices.
+                const auto placeLevelOfDetails = [&](const fastgltf::Primitive *primitive, std::span<const std::byte> indexBytes, std::size_t indexByteSize, vk::DeviceSize regionOffset) {
+                    const auto it = levelOfDetailIndexBytes.find(primitive);
+                    if (it == levelOfDetailIndexBytes.end()) {
+                        return;
+                    }
+
+                    auto &firstIndexAndCounts = levelOfDetailFirstIndexAndCountsByPrimitive[primitive];
+                    firstIndexAndCounts.emplace_back(
+                        static_cast<std::uint32_t>((bufferSize - indexBytes.size_bytes() - regionOffset) / indexByteSize),
+                        static_cast<std::uint32_t>(indexBytes.size_bytes() / indexByteSize));
+                    for (std::span<const std::byte> levelOfDetailBytes : it->second) {
+                        firstIndexAndCounts.emplace_back(
+                            static_cast<std::uint32_t>((bufferSize - regionOffset) / indexByteSize),
+                            static_cast<std::uint32_t>(levelOfDetailBytes.size_bytes() / indexByteSize));
+                        bufferSize += levelOfDetailBytes.size_bytes();
+                    }
+                };
+
                 bufferSize = 0;
                 for (const auto &[primitive, indexBytes] : unsignedIntIndexBytes) {
                     indexTypeAndFirstIndexByPrimitive.try_emplace(
                         primitive, 
                         vk::IndexType::eUint32, static_cast<std::uint32_t>(bufferSize / sizeof(std::uint32_t)));
                     bufferSize += indexBytes.size_bytes();
+                    placeLevelOfDetails(primitive, indexBytes, sizeof(std::uint32_t), 0);
                 }
 
                 unsignedShortIndexOffset = bufferSize;
@@ -436,6 +501,7 @@ namespace vkgltf {
                         primitive, 
                         vk::IndexType::eUint16, static_cast<std::uint32_t>((bufferSize - unsignedShortIndexOffset) / sizeof(std::uint16_t)));
                     bufferSize += indexBytes.size_bytes();
+                    placeLevelOfDetails(primitive, indexBytes, sizeof(std::uint16_t), unsignedShortIndexOffset);
                 }
 
                 unsignedByteIndexOffset = bufferSize;
@@ -444,6 +510,7 @@ namespace vkgltf {
                         primitive, 
                         vk::IndexType::eUint8, static_cast<std::uint32_t>((bufferSize - unsignedByteIndexOffset) / sizeof(std::uint8_t)));
                     bufferSize += indexBytes.size_bytes();
+                    placeLevelOfDetails(primitive, indexBytes, sizeof(std::uint8_t), unsignedByteIndexOffset);
                 }
             }
         };
@@ -463,19 +530,25 @@ namespace vkgltf {
                 config.allocationCreateInfo,
             },
             indexTypeAndFirstIndexByPrimitive { std::move(intermediateData.indexTypeAndFirstIndexByPrimitive) },
+            levelOfDetailFirstIndexAndCountsByPrimitive { std::move(intermediateData.levelOfDetailFirstIndexAndCountsByPrimitive) },
             unsignedShortIndexOffset { intermediateData.unsignedShortIndexOffset },
             unsignedByteIndexOffset { intermediateData.unsignedByteIndexOffset },
             actualDataSize { intermediateData.bufferSize } {
             std::byte *dst = static_cast<std::byte*>(getAllocation().getInfo().pMappedData);
-            for (std::span indexBytes : intermediateData.unsignedIntIndexBytes | std::views::values) {
-                dst = std::ranges::copy(indexBytes, dst).out;
-            }
-            for (std::span indexBytes : intermediateData.unsignedShortIndexBytes | std::views::values) {
-                dst = std::ranges::copy(indexBytes, dst).out;
-            }
-            for (std::span indexBytes : intermediateData.unsignedByteIndexBytes | std::views::values) {
-                dst = std::ranges::copy(indexBytes, dst).out;
-            }
+            const auto copyIndexBytes = [&](const std::unordered_map<const fastgltf::Primitive*, std::span<const std::byte>> &indexBytesByPrimitive) {
+                // Must be iterated in the same order as IData, which places the level of details after the primitive.
+                for (const auto &[primitive, indexBytes] : indexBytesByPrimitive) {
+                    dst = std::ranges::copy(indexBytes, dst).out;
+                    if (auto it = intermediateData.levelOfDetailIndexBytes.find(primitive); it != intermediateData.levelOfDetailIndexBytes.end()) {
+                        for (std::span levelOfDetailBytes : it->second) {
+                            dst = std::ranges::copy(levelOfDetailBytes, dst).out;
+                        }
+                    }
+                }
+            };
+            copyIndexBytes(intermediateData.unsignedIntIndexBytes);
+            copyIndexBytes(intermediateData.unsignedShortIndexBytes);
+            copyIndexBytes(intermediateData.unsignedByteIndexBytes);
 
             getAllocation().flush(0, size);
 
@@ -485,6 +558,7 @@ namespace vkgltf {
         }
 
         std::unordered_map<const fastgltf::Primitive*, std::pair<vk::IndexType, std::uint32_t>> indexTypeAndFirstIndexByPrimitive;
+        std::unordered_map<const fastgltf::Primitive*, std::vector<std::pair<std::uint32_t, std::uint32_t>>> levelOfDetailFirstIndexAndCountsByPrimitive;
         vk::DeviceSize unsignedShortIndexOffset;
         vk::DeviceSize unsignedByteIndexOffset;
         vk::DeviceSize actualDataSize;
@@ -502,6 +576,7 @@ public:
     bool avoidZeroSizeBuffer = true;
     bool promoteUnsignedByteToUnsignedShort = true;
     std::function<fastgltf::PrimitiveType(fastgltf::PrimitiveType)> topologyConvertFn = DefaultTopologyConvertFn{};
+    std::function<std::vector<std::span<const std::uint32_t>>(const fastgltf::Primitive&)> levelOfDetailIndicesFn;
     vk::BufferUsageFlags usageFlags = vk::BufferUsageFlagBits::eIndexBuffer;
     vk::ArrayProxyNoTemporaries<const std::uint32_t> queueFamilies = {};
     vma::AllocationCreateInfo allocationCreateInfo = {
@@ -538,4 +613,13 @@ std::pair<vk::IndexType, std::uint32_t> vkgltf::CombinedIndexBuffer::getIndexTyp
     const fastgltf::Primitive &primitive
 ) const {
     return indexTypeAndFirstIndexByPrimitive.at(&primitive);
+}
+
+std::span<const std::pair<std::uint32_t, std::uint32_t>> vkgltf::CombinedIndexBuffer::getLevelOfDetailFirstIndexAndCounts(
+    const fastgltf::Primitive &primitive
+) const noexcept {
+    if (auto it = levelOfDetailFirstIndexAndCountsByPrimitive.find(&primitive); it != levelOfDetailFirstIndexAndCountsByPrimitive.end()) {
+        return it->second;
+    }
+    return {};
 }
\ No newline at end of file
@@ -1,12 +1,15 @@
 module;
 
-#include <cassert>
 #include <stb_image.h>
 
 #ifdef USE_KTX
 #include <ktx.h>
 #endif
 
+#ifdef USE_WEBP
+#include <webp/decode.h>
+#endif
+
 export module vkgltf.image;
 
 import std;
@@ -31,10 +34,17 @@ struct StagingData {
 
     std::variant<std::pair<vku::raii::AllocatedBuffer, std::vector<vk::BufferImageCopy>>, std::vector<vk::MemoryToImageCopy>> data;
     void *hostBackedData;
+    void (*hostBackedDataDeleter)(void*);
 
     [[nodiscard]] static StagingData fromJpgPng(const char *path, const std::function<vk::Format(int)> &formatFn, const vma::raii::Allocator *allocator);
     [[nodiscard]] static StagingData fromJpgPng(std::span<const std::byte> memory, const std::function<vk::Format(int)> &formatFn, const vma::raii::Allocator *allocator);
-    [[nodiscard]] static StagingData fromJpgPng(const vk::Extent2D &extent, stbi_uc* &&data, vk::Format format, const vma::raii::Allocator *allocator);
+#ifdef USE_WEBP
+    [[nodiscard]] static StagingData fromWebp(const std::filesystem::path &path, const std::function<vk::Format(int)> &formatFn, const vma::raii::Allocator *allocator);
+    [[nodiscard]] static StagingData fromWebp(std::span<const std::byte> memory, const std::function<vk::Format(int)> &formatFn, const vma::raii::Allocator *allocator);
+#endif
+    [[nodiscard]] static StagingData fromPixels(const vk::Extent2D &extent, void *data, void (*deleter)(void*), vk::Format format, const vma::raii::Allocator *allocator);
+    [[nodiscard]] static StagingData fromDds(const std::filesystem::path &path, const vma::raii::Allocator *allocator);
+    [[nodiscard]] static StagingData fromDds(std::span<const std::byte> memory, const vma::raii::Allocator *allocator);
 #ifdef USE_KTX
     [[nodiscard]] static StagingData fromKtx(const char *path, const vma::raii::Allocator *allocator);
     [[nodiscard]] static StagingData fromKtx(std::span<const std::byte> memory, const vma::raii::Allocator *allocator);
@@ -45,6 +55,15 @@ struct StagingData {
 };
 
 namespace vkgltf {
+    /**
+     * @brief Check if \p format has the sRGB (or linear, if \p format is sRGB) counterpart, i.e. the image of the
+     * format can be viewed with the mutated sRGB-ness.
+     *
+     * Block compressed formats for the one or two channel data (BC4 and BC5) do not have the counterpart.
+     */
+    export
+    [[nodiscard]] bool hasSrgbCounterpart(vk::Format format) noexcept;
+
     export class Image {
     public:
         enum class MipmapPolicy : std::uint8_t {
@@ -72,8 +91,9 @@ namespace vkgltf {
              * the image will be displayed properly.
              *
              * @note If this is enabled, the format determined by either <tt>uncompressedImageFormatFn</tt> (for
-             * uncompressed images) or <tt>ktxTexture2::vkFormat</tt> (for KTX images) must have the corresponding
-             * sRGB format.
+             * uncompressed images), <tt>ktxTexture2::vkFormat</tt> (for KTX images) or DXGI format (for DDS images)
+             * should have the corresponding sRGB format. Otherwise (see <tt>hasSrgbCounterpart(vk::Format)</tt>), this
+             * is ignored.
              */
             bool allowMutateSrgbFormat = false;
 
@@ -99,6 +119,9 @@ namespace vkgltf {
              *
              * For example, if the original PNG image has 3 channels (RGB), and <tt>uncompressedImageFormatFn(3) == vk::Format::eR8G8B8A8Unorm</tt>,
              * image will be decoded to 4 channels (RGBA).
+             *
+             * WebP image is queried as 3 or 4 channels depending on whether it has the alpha channel, and can only be
+             * decoded to 3 or 4 channels.
              */
             std::function<vk::Format(int)> uncompressedImageFormatFn = [](int channels) noexcept {
                 switch (channels) {
@@ -137,9 +160,8 @@ namespace vkgltf {
              */
             vk::ImageLayout uncompressedImageDstLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
-        #ifdef USE_KTX
             /**
-             * @brief Image usage flags for compressed images.
+             * @brief Image usage flags for compressed (KTX or DDS) images.
              *
              * The final usage flags is determined by combining the given flags with
              * - <tt>vk::ImageUsageFlagBits::eTransferDst</tt> if <tt>stagingInfo</tt> is given.
@@ -155,7 +177,6 @@ namespace vkgltf {
              * subresource will have this layout, and the rest will be in the undefined layout.
              */
             vk::ImageLayout compressedImageDstLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        #endif
 
             /**
              * @brief Queue family indices that the image can be concurrently accessed.
@@ -200,7 +221,7 @@ namespace vkgltf {
             const vma::raii::Allocator &allocator,
             const Config<BufferDataAdapter> &config = {}
         ) : image { createImage(asset, image, directory, device, allocator, config) },
-            view { device, this->image.getViewCreateInfo(vk::ImageViewType::e2D).setComponents(getComponentMapping(componentCount(this->image.format))) } { }
+            view { device, this->image.getViewCreateInfo(vk::ImageViewType::e2D).setComponents(getComponentMapping(this->image.format)) } { }
 
     private:
         template <typename BufferDataAdapter>
@@ -225,10 +246,16 @@ namespace vkgltf {
                     switch (embedded.mimeType) {
                         case fastgltf::MimeType::JPEG: case fastgltf::MimeType::PNG:
                             return StagingData::fromJpgPng(memory, config.uncompressedImageFormatFn, nullableAllocator);
+                    #ifdef USE_WEBP
+                        case fastgltf::MimeType::WEBP:
+                            return StagingData::fromWebp(memory, config.uncompressedImageFormatFn, nullableAllocator);
+                    #endif
                     #ifdef USE_KTX
                         case fastgltf::MimeType::KTX2:
                             return StagingData::fromKtx(memory, nullableAllocator);
                     #endif
+                        case fastgltf::MimeType::DDS:
+                            return StagingData::fromDds(memory, nullableAllocator);
                         default:
                             throw std::runtime_error { "Unknown image MIME type" };
                     }
@@ -256,20 +283,34 @@ namespace vkgltf {
                         else if (extension == ".png") {
                             mimeType = fastgltf::MimeType::PNG;
                         }
+                    #ifdef USE_WEBP
+                        else if (extension == ".webp") {
+                            mimeType = fastgltf::MimeType::WEBP;
+                        }
+                    #endif
                     #ifdef USE_KTX
                         else if (extension == ".ktx2") {
                             mimeType = fastgltf::MimeType::KTX2;
                         }
                     #endif
+                        else if (extension == ".dds") {
+                            mimeType = fastgltf::MimeType::DDS;
+                        }
                     }
 
                     switch (mimeType) {
                         case fastgltf::MimeType::JPEG: case fastgltf::MimeType::PNG:
                             return StagingData::fromJpgPng(PATH_C_STR(filePath), config.uncompressedImageFormatFn, nullableAllocator);
+                    #ifdef USE_WEBP
+                        case fastgltf::MimeType::WEBP:
+                            return StagingData::fromWebp(filePath, config.uncompressedImageFormatFn, nullableAllocator);
+                    #endif
                     #ifdef USE_KTX
                         case fastgltf::MimeType::KTX2:
                             return StagingData::fromKtx(PATH_C_STR(filePath), nullableAllocator);
                     #endif
+                        case fastgltf::MimeType::DDS:
+                            return StagingData::fromDds(filePath, nullableAllocator);
                         default:
                             throw std::runtime_error { "Unknown image MIME type" };
                     }
@@ -299,14 +340,11 @@ namespace vkgltf {
             #endif
             };
 
-        #ifdef USE_KTX
             if (isCompressed(createInfo.get().format)) {
                 createInfo.get().usage = config.compressedImageUsageFlags
                     | (config.stagingInfo ? vk::ImageUsageFlagBits::eTransferDst : vk::ImageUsageFlagBits::eHostTransfer);
             }
-            else
-        #endif
-            {
+            else {
                 if (config.uncompressedImageMipmapPolicy != MipmapPolicy::No) {
                     createInfo.get().mipLevels = vku::maxMipLevels(stagingData.extent);
                 }
@@ -315,7 +353,7 @@ namespace vkgltf {
                     | (config.stagingInfo ? vk::ImageUsageFlagBits::eTransferDst : vk::ImageUsageFlagBits::eHostTransfer);
             }
 
-            if (config.allowMutateSrgbFormat) {
+            if (config.allowMutateSrgbFormat && hasSrgbCounterpart(stagingData.format)) {
                 createInfo.get().flags |= vk::ImageCreateFlagBits::eMutableFormat;
                 get<1>(formatList) = vku::toggleSrgb(stagingData.format);
             }
@@ -332,13 +370,10 @@ namespace vkgltf {
             vku::raii::AllocatedImage result { allocator, createInfo.get(), config.allocationCreateInfo };
 
             vk::ImageLayout dstLayout;
-        #ifdef USE_KTX
             if (isCompressed(stagingData.format)) {
                 dstLayout = config.compressedImageDstLayout;
             }
-            else
-        #endif
-            {
+            else {
                 dstLayout = config.uncompressedImageDstLayout;
             }
 
@@ -393,7 +428,7 @@ namespace vkgltf {
             return result;
         }
 
-        [[nodiscard]] static vk::ComponentMapping getComponentMapping(std::uint8_t componentCount) noexcept;
+        [[nodiscard]] static vk::ComponentMapping getComponentMapping(vk::Format format) noexcept;
     };
 
     export template <>
@@ -423,10 +458,8 @@ namespace vkgltf {
         MipmapPolicy uncompressedImageMipmapPolicy = MipmapPolicy::No;
         vk::ImageUsageFlags uncompressedImageUsageFlags = vk::ImageUsageFlagBits::eSampled;
         vk::ImageLayout uncompressedImageDstLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    #ifdef USE_KTX
         vk::ImageUsageFlags compressedImageUsageFlags = vk::ImageUsageFlagBits::eSampled;
         vk::ImageLayout compressedImageDstLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    #endif
         vk::ArrayProxyNoTemporaries<const std::uint32_t> queueFamilies = {};
         vma::AllocationCreateInfo allocationCreateInfo = { {}, vma::MemoryUsage::eAutoPreferDevice };
         StagingInfo *stagingInfo = nullptr;
@@ -459,7 +492,7 @@ StagingData StagingData::fromJpgPng(
         throw std::runtime_error { stbi_failure_reason() };
     }
 
-    return fromJpgPng({ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height) }, std::move(data), format, allocator);
+    return fromPixels({ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height) }, data, stbi_image_free, format, allocator);
 }
 
 StagingData StagingData::fromJpgPng(
@@ -482,10 +515,65 @@ StagingData StagingData::fromJpgPng(
         throw std::runtime_error { stbi_failure_reason() };
     }
 
-    return fromJpgPng({ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height) }, std::move(data), format, allocator);
+    return fromPixels({ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height) }, data, stbi_image_free, format, allocator);
+}
+
+[[nodiscard]] std::vector<std::byte> readFile(const std::filesystem::path &path) {
+    std::ifstream file { path, std::ios::binary };
+    if (!file) {
+        throw std::runtime_error { std::format("Failed to open {}", path.string()) };
+    }
+
+    std::vector<std::byte> result(std::filesystem::file_size(path));
+    file.read(reinterpret_cast<char*>(result.data()), result.size());
+    return result;
+}
+
+#ifdef USE_WEBP
+StagingData StagingData::fromWebp(
+    const std::filesystem::path &path,
+    const std::function<vk::Format(int)> &formatFn,
+    const vma::raii::Allocator *allocator
+) {
+    // Decoded pixels are owned by libwebp, therefore the file content can be discarded right after decoding.
+    return fromWebp(readFile(path), formatFn, allocator);
+}
+
+StagingData StagingData::fromWebp(
+    std::span<const std::byte> memory,
+    const std::function<vk::Format(int)> &formatFn,
+    const vma::raii::Allocator *allocator
+) {
+    const auto *bytes = reinterpret_cast<const std::uint8_t*>(memory.data());
+
+    WebPBitstreamFeatures features;
+    if (WebPGetFeatures(bytes, memory.size_bytes(), &features) != VP8_STATUS_OK) {
+        throw std::runtime_error { "Failed to read the WebP bitstream features" };
+    }
+
+    const vk::Format format = std::invoke(formatFn, features.has_alpha ? 4 : 3);
+
+    int width, height;
+    std::uint8_t *data;
+    switch (componentCount(format)) {
+        case 3:
+            data = WebPDecodeRGB(bytes, memory.size_bytes(), &width, &height);
+            break;
+        case 4:
+            data = WebPDecodeRGBA(bytes, memory.size_bytes(), &width, &height);
+            break;
+        default:
+            throw std::runtime_error { "WebP image can only be decoded to 3 or 4 channels" };
+    }
+    if (!data) {
+        throw std::runtime_error { "Failed to decode the WebP image" };
+    }
+
+    return fromPixels({ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height) }, data, WebPFree, format, allocator);
 }
+#endif
 
-StagingData StagingData::fromJpgPng(const vk::Extent2D &extent, stbi_uc *&&data, vk::Format format, const vma::raii::Allocator *allocator) {
+StagingData StagingData::fromPixels(const vk::Extent2D &extent, void *data, void (*deleter)(void*), vk::Format format, const vma::raii::Allocator *allocator) {
     StagingData result {
         .extent = extent,
         .format = format,
@@ -516,7 +604,7 @@ StagingData StagingData::fromJpgPng(const vk::Extent2D &extent, stbi_uc *&&data,
                 };
 
                 get_if<0>(&result)->first.getAllocation().copyFromMemory(data, 0, get_if<0>(&result)->first.size);
-                stbi_image_free(data);
+                deleter(data);
 
                 return result;
             }
@@ -534,11 +622,221 @@ StagingData StagingData::fromJpgPng(const vk::Extent2D &extent, stbi_uc *&&data,
             }
         }(),
         .hostBackedData = allocator ? nullptr : data,
+        .hostBackedDataDeleter = deleter,
     };
 
     return result;
 }
 
+struct DdsImage {
+    vk::Extent2D extent;
+    vk::Format format;
+    std::uint32_t mipLevels;
+
+    /**
+     * @brief Tightly packed mip chain, starting from the base level.
+     */
+    std::span<const std::byte> data;
+
+    /**
+     * @brief Byte offset of each mip level in <tt>data</tt>.
+     */
+    std::vector<std::size_t> levelOffsets;
+};
+
+/**
+ * @brief Parse the DDS container that has the block compressed (BC1-5, BC7) 2D image.
+ *
+ * Array, cube map and volume textures, and premultiplied alpha formats (DXT2, DXT4) are not supported.
+ *
+ * Image data is not copied, and the result references \p memory.
+ *
+ * @param memory DDS file content.
+ * @return Parsed image.
+ * @throw std::runtime_error If the container is malformed or the image format is not supported.
+ * @see https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dx-graphics-dds-pguide
+ */
+[[nodiscard]] DdsImage parseDds(std::span<const std::byte> memory) {
+    constexpr auto fourCC = [](const char (&code)[5]) noexcept -> std::uint32_t {
+        return static_cast<std::uint32_t>(code[0])
+            | static_cast<std::uint32_t>(code[1]) << 8
+            | static_cast<std::uint32_t>(code[2]) << 16
+            | static_cast<std::uint32_t>(code[3]) << 24;
+    };
+
+    // All header fields are little-endian 32-bit integers.
+    const auto read = [&](std::size_t offset) {
+        if (offset + sizeof(std::uint32_t) > memory.size_bytes()) {
+            throw std::runtime_error { "DDS header is truncated" };
+        }
+
+        std::uint32_t value;
+        std::memcpy(&value, memory.data() + offset, sizeof(value));
+        return value;
+    };
+
+    if (read(0) != fourCC("DDS ")) {
+        throw std::runtime_error { "Invalid DDS magic number" };
+    }
+
+    // Field offsets are from the start of the file (the 4-byte magic number precedes the DDS_HEADER).
+    constexpr std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    constexpr std::uint32_t DDPF_FOURCC = 0x4;
+    constexpr std::uint32_t DDSCAPS2_CUBEMAP = 0x200;
+    constexpr std::uint32_t DDSCAPS2_VOLUME = 0x200000;
+    const std::uint32_t flags = read(8);
+    const vk::Extent2D extent { read(16), read(12) };
+    const std::uint32_t mipMapCount = read(28);
+    const std::uint32_t pixelFormatFlags = read(80);
+    const std::uint32_t pixelFormatFourCC = read(84);
+    const std::uint32_t caps2 = read(112);
+
+    if (!(pixelFormatFlags & DDPF_FOURCC)) {
+        throw std::runtime_error { "Uncompressed DDS image is not supported" };
+    }
+    if (extent.width == 0 || extent.height == 0) {
+        throw std::runtime_error { "DDS image has zero extent" };
+    }
+    if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) {
+        throw std::runtime_error { "Cube map or volume DDS image is not supported" };
+    }
+
+    vk::Format format;
+    std::size_t dataOffset = 128;
+    if (pixelFormatFourCC == fourCC("DX10")) {
+        // DDS_HEADER_DXT10 follows: DXGI_FORMAT, resource dimension, misc flags, array size and misc flags 2.
+        constexpr std::uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+        constexpr std::uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+        if (read(132) != D3D10_RESOURCE_DIMENSION_TEXTURE2D) {
+            throw std::runtime_error { "Non-2D DDS image is not supported" };
+        }
+        if (read(136) & DDS_RESOURCE_MISC_TEXTURECUBE) {
+            throw std::runtime_error { "Cube map DDS image is not supported" };
+        }
+        if (read(140) != 1) {
+            throw std::runtime_error { "Array DDS image is not supported" };
+        }
+
+        dataOffset = 148;
+        switch (read(128)) {
+            case 71: format = vk::Format::eBc1RgbaUnormBlock; break;
+            case 72: format = vk::Format::eBc1RgbaSrgbBlock; break;
+            case 74: format = vk::Format::eBc2UnormBlock; break;
+            case 75: format = vk::Format::eBc2SrgbBlock; break;
+            case 77: format = vk::Format::eBc3UnormBlock; break;
+            case 78: format = vk::Format::eBc3SrgbBlock; break;
+            case 80: format = vk::Format::eBc4UnormBlock; break;
+            case 83: format = vk::Format::eBc5UnormBlock; break;
+            case 98: format = vk::Format::eBc7UnormBlock; break;
+            case 99: format = vk::Format::eBc7SrgbBlock; break;
+            default:
+                throw std::runtime_error { std::format("Unsupported DXGI format {} in DDS image", read(128)) };
+        }
+    }
+    else {
+        switch (pixelFormatFourCC) {
+            case fourCC("DXT1"): format = vk::Format::eBc1RgbaUnormBlock; break;
+            case fourCC("DXT3"): format = vk::Format::eBc2UnormBlock; break;
+            case fourCC("DXT5"): format = vk::Format::eBc3UnormBlock; break;
+            case fourCC("DXT2"): case fourCC("DXT4"):
+                // Color is premultiplied by alpha, which is not expected by glTF.
+                throw std::runtime_error { "Premultiplied alpha DDS image is not supported" };
+            case fourCC("ATI1"): case fourCC("BC4U"): format = vk::Format::eBc4UnormBlock; break;
+            case fourCC("ATI2"): case fourCC("BC5U"): format = vk::Format::eBc5UnormBlock; break;
+            default:
+                throw std::runtime_error { "Unsupported FourCC in DDS image" };
+        }
+    }
+
+    // Mip chain beyond the 1x1 level is ill-formed and ignored.
+    const std::uint32_t mipLevels = std::min((flags & DDSD_MIPMAPCOUNT) ? std::max(mipMapCount, 1U) : 1U, vku::maxMipLevels(extent));
+
+    std::vector<std::size_t> levelOffsets;
+    levelOffsets.reserve(mipLevels);
+    std::size_t dataSize = 0;
+    for (std::uint32_t level = 0; level < mipLevels; ++level) {
+        const vk::Extent2D mipExtent = vku::mipExtent(extent, level);
+        levelOffsets.push_back(dataSize);
+        dataSize += static_cast<std::size_t>((mipExtent.width + 3) / 4) * ((mipExtent.height + 3) / 4) * blockSize(format);
+    }
+    if (dataOffset + dataSize > memory.size_bytes()) {
+        throw std::runtime_error { "DDS image data is truncated" };
+    }
+
+    return { extent, format, mipLevels, memory.subspan(dataOffset, dataSize), std::move(levelOffsets) };
+}
+
+StagingData StagingData::fromDds(const std::filesystem::path &path, const vma::raii::Allocator *allocator) {
+    auto content = std::make_unique<std::vector<std::byte>>(readFile(path));
+    StagingData result = fromDds(*content, allocator);
+    if (!allocator) {
+        // Copy regions reference the file content, therefore it has to be alive until the copy is done.
+        result.hostBackedData = content.release();
+        result.hostBackedDataDeleter = [](void *data) noexcept {
+            delete static_cast<std::vector<std::byte>*>(data);
+        };
+    }
+    return result;
+}
+
+StagingData StagingData::fromDds(std::span<const std::byte> memory, const vma::raii::Allocator *allocator) {
+    DdsImage image = parseDds(memory);
+
+    return {
+        .extent = image.extent,
+        .format = image.format,
+        .mipLevels = image.mipLevels,
+        .data = [&] -> std::variant<std::pair<vku::raii::AllocatedBuffer, std::vector<vk::BufferImageCopy>>, std::vector<vk::MemoryToImageCopy>> {
+            if (allocator) {
+                std::vector<vk::BufferImageCopy> copyRegions;
+                copyRegions.reserve(image.mipLevels);
+                for (std::uint32_t level = 0; level < image.mipLevels; ++level) {
+                    copyRegions.push_back(vk::BufferImageCopy {
+                        image.levelOffsets[level], 0, 0,
+                        vk::ImageSubresourceLayers { vk::ImageAspectFlagBits::eColor, level, 0, 1 },
+                        vk::Offset3D{}, vk::Extent3D { vku::mipExtent(image.extent, level), 1 },
+                    });
+                }
+                std::pair result {
+                    vku::raii::AllocatedBuffer {
+                        *allocator,
+                        vk::BufferCreateInfo {
+                            {},
+                            image.data.size_bytes(),
+                            vk::BufferUsageFlagBits::eTransferSrc,
+                        },
+                        vma::AllocationCreateInfo {
+                            vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped,
+                            vma::MemoryUsage::eAutoPreferHost,
+                        },
+                    },
+                    std::move(copyRegions),
+                };
+
+                // Mip chain is already block compressed, therefore it can be copied as is.
+                result.first.getAllocation().copyFromMemory(image.data.data(), 0, result.first.size);
+
+                return std::move(result);
+            }
+            else {
+                std::vector<vk::MemoryToImageCopy> copies;
+                copies.reserve(image.mipLevels);
+                for (std::uint32_t level = 0; level < image.mipLevels; ++level) {
+                    copies.push_back({
+                        image.data.data() + image.levelOffsets[level], 0, 0,
+                        vk::ImageSubresourceLayers { vk::ImageAspectFlagBits::eColor, level, 0, 1 },
+                        vk::Offset3D{}, vk::Extent3D { vku::mipExtent(image.extent, level), 1 },
+                    });
+                }
+                return std::move(copies);
+            }
+        }(),
+        // Image data is referenced from the caller-owned memory.
+        .hostBackedData = nullptr,
+        .hostBackedDataDeleter = nullptr,
+    };
+}
+
 #ifdef USE_KTX
 StagingData StagingData::fromKtx(const char *path, const vma::raii::Allocator *allocator) {
     ktxTexture2 *texture;
@@ -639,26 +937,37 @@ StagingData StagingData::fromKtx(ktxTexture2 *&&texture, const vma::raii::Alloca
             }
         }(),
         .hostBackedData = allocator ? nullptr : texture,
+        .hostBackedDataDeleter = [](void *texture) {
+            ktxTexture_Destroy(ktxTexture(texture));
+        },
     };
 }
 #endif
 
 void StagingData::destroyHostBackedData() noexcept {
-    assert(hostBackedData && "Data is not host backed");
-
-#ifdef USE_KTX
-    if (isCompressed(format)) {
-        ktxTexture_Destroy(ktxTexture(hostBackedData));
+    // Data may be referenced from the caller-owned memory (e.g. DDS image in the glTF buffer).
+    if (hostBackedData) {
+        hostBackedDataDeleter(hostBackedData);
     }
-    else
-#endif
-    {
-        stbi_image_free(hostBackedData);
+}
+
+bool vkgltf::hasSrgbCounterpart(vk::Format format) noexcept {
+    switch (format) {
+        case vk::Format::eBc4UnormBlock: case vk::Format::eBc4SnormBlock:
+        case vk::Format::eBc5UnormBlock: case vk::Format::eBc5SnormBlock:
+            return false;
+        default:
+            return true;
     }
 }
 
-vk::ComponentMapping vkgltf::Image::getComponentMapping(std::uint8_t componentCount) noexcept {
-    switch (componentCount) {
+vk::ComponentMapping vkgltf::Image::getComponentMapping(vk::Format format) noexcept {
+    if (format == vk::Format::eBc5UnormBlock || format == vk::Format::eBc5SnormBlock) {
+        // Two-channel block compression is for the RG data (e.g. normal map), not grayscale with alpha.
+        return { vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eG, vk::ComponentSwizzle::eOne, vk::ComponentSwizzle::eOne };
+    }
+
+    switch (componentCount(format)) {
         case 1:
             // Grayscale: red channel have to be propagated to green/blue channels.
             return { vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eOne };
@@ -83,6 +83,41 @@ namespace vkgltf {
              * <tt>fastgltf::ComponentType::Float</tt> for them.
              */
             bool normalized;
+
+            /**
+             * @brief Boolean indicating whether the attribute data is a unit vector that is mapped to the octahedron and
+             * stored as two <tt>componentType</tt> components.
+             *
+             * This is never set by <tt>PrimitiveAttributeBuffers</tt> itself, but by the attribute info that you
+             * manually inserted to <tt>AttributeInfoCache::accessorAttributeInfos</tt>.
+             */
+            bool octahedral = false;
+
+            /**
+             * @brief Offset and scale to dequantize the fetched attribute data, i.e. the attribute value is
+             * <tt>dequantizationOffset + dequantizationScale * (fetched value)</tt>.
+             *
+             * Like <tt>octahedral</tt>, they are only different from the identity if you manually inserted the
+             * quantized attribute info. Only used for <tt>POSITION</tt> by <tt>PrimitiveBuffer</tt>.
+             */
+            fastgltf::math::fvec3 dequantizationOffset { 0.f, 0.f, 0.f };
+            fastgltf::math::fvec3 dequantizationScale { 1.f, 1.f, 1.f };
+
+            /**
+             * @brief Boolean indicating whether the attribute data is stored as the sparse (index, value) lists, whose
+             * omitted elements are zero.
+             *
+             * If <tt>true</tt>, the data in <tt>buffer</tt> starting from <tt>offset</tt> is laid out as:
+             * - <tt>u32</tt>: byte offset of the values from <tt>offset</tt>,
+             * - <tt>u32</tt>: padding,
+             * - <tt>ceil(count / 32)</tt> pairs of <tt>u32</tt>, where the first is the bitmap of the presented
+             *   elements in the 32 elements, and the second is the number of the presented elements before them,
+             * - values of the presented elements in ascending element index order, with <tt>stride</tt>.
+             *
+             * Like <tt>octahedral</tt>, this is never set by <tt>PrimitiveAttributeBuffers</tt> itself, but by the
+             * attribute info that you manually inserted to <tt>AttributeInfoCache::accessorAttributeInfos</tt>.
+             */
+            bool sparse = false;
         };
 
         struct AttributeInfoWithMorphTargets {
@@ -591,6 +626,8 @@ namespace vkgltf {
          * @param usageFlags Vulkan buffer usage flags for the buffer.
          * @param allocationCreateInfo VMA allocation creation flags for the buffer.
          * @param adapter Buffer data adapter.
+         * @param fast If <tt>true</tt>, non-welded per-vertex tangents are generated by <tt>createFastTangents</tt>
+         * instead of MikkTSpace algorithm, which is much faster but not MikkTSpace compliant (intended for the previews).
          */
         template <typename BufferDataAdapter = fastgltf::DefaultBufferDataAdapter>
         void emplaceMikkTSpaceTangents(
@@ -602,18 +639,19 @@ namespace vkgltf {
                 vma::AllocationCreateFlagBits::eHostAccessSequentialWrite,
                 vma::MemoryUsage::eAutoPreferHost,
             },
-            const BufferDataAdapter &adapter = {}
+            const BufferDataAdapter &adapter = {},
+            bool fast = false
         ) {
             std::variant<std::vector<fastgltf::math::fvec4>, std::vector<fastgltf::math::s16vec4>, std::vector<fastgltf::math::s8vec4>> generated;
             switch (componentType) {
                 case fastgltf::ComponentType::Float:
-                    generated = createMikkTSpaceTangents<float>(asset, primitive, adapter);
+                    generated = fast ? createFastTangents<float>(asset, primitive, adapter) : createMikkTSpaceTangents<float>(asset, primitive, adapter);
                     break;
                 case fastgltf::ComponentType::Short:
-                    generated = createMikkTSpaceTangents<std::int16_t>(asset, primitive, adapter);
+                    generated = fast ? createFastTangents<std::int16_t>(asset, primitive, adapter) : createMikkTSpaceTangents<std::int16_t>(asset, primitive, adapter);
                     break;
                 case fastgltf::ComponentType::Byte:
-                    generated = createMikkTSpaceTangents<std::int8_t>(asset, primitive, adapter);
+                    generated = fast ? createFastTangents<std::int8_t>(asset, primitive, adapter) : createMikkTSpaceTangents<std::int8_t>(asset, primitive, adapter);
                     break;
                 default:
                     throw std::runtime_error { "Unsupported MikkTSpace tangent component type: only FLOAT, SHORT normalized and BYTE normalized are supported." };
@@ -131,11 +131,25 @@ namespace vkgltf {
          *
          * @param signalSemaphores Semaphores to be signalled when copy command execution is end.
          * @param fence Fence to be signalled when copy command execution is end.
-         * @warning You MUST call <tt>reset()</tt> method after calling this method. Otherwise, the destructor will
-         * re-submit the command buffer to the queue, which violates the command buffer usage.
+         * @warning Staging buffers are destroyed by <tt>reset()</tt> method or destructor, therefore they MUST be
+         * called after the command buffer execution is finished.
          */
         void execute(vk::ArrayProxy<const vk::Semaphore> signalSemaphores = {}, vk::Fence fence = {});
 
+        /**
+         * @brief Record all deferred pipeline barriers to the command buffer and end it, to be submitted by yourself.
+         *
+         * Use it instead of <tt>execute()</tt> if the submission has to be done in another way, e.g. signaling a
+         * timeline semaphore. Once the command buffer is ended, the destructor will not submit it again, but the
+         * staging buffers are still owned by the storage. Therefore, you MUST keep the storage alive until the command
+         * buffer execution is finished.
+         *
+         * @return Ended command buffer, or <tt>std::nullopt</tt> if the command buffer has no recorded commands.
+         * @warning You MUST call <tt>reset()</tt> method after the command buffer execution if you want to reuse the
+         * class instance.
+         */
+        [[nodiscard]] std::optional<vk::CommandBuffer> end();
+
         /**
          * @brief Clear all staging buffers and copy/transition commands from memory.
          *
@@ -309,26 +323,38 @@ void vkgltf::StagingBufferStorage::memoryBarrierToBottom(
 }
 
 void vkgltf::StagingBufferStorage::execute(vk::ArrayProxy<const vk::Semaphore> signalSemaphores, vk::Fence fence) {
+    if (const std::optional<vk::CommandBuffer> commandBuffer = end()) {
+        queue.submit(vk::SubmitInfo {
+            {},
+            {},
+            *commandBuffer,
+            signalSemaphores,
+        }, fence, *device.get().getDispatcher());
+    }
+}
+
+std::optional<vk::CommandBuffer> vkgltf::StagingBufferStorage::end() {
     if (!bufferMemoryBarriersToBottom.empty() || !imageMemoryBarriersToBottom.empty()) {
         cb.pipelineBarrier(
             vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
             {}, {}, bufferMemoryBarriersToBottom, imageMemoryBarriersToBottom,
             *device.get().getDispatcher());
         commandRecorded = true;
-    }
 
-    if (commandRecorded) {
-        cb.end(*device.get().getDispatcher());
-        queue.submit(vk::SubmitInfo {
-            {},
-            {},
-            cb,
-            signalSemaphores,
-        }, fence, *device.get().getDispatcher());
+        // Barriers are recorded, and must not be recorded again by the destructor.
+        bufferMemoryBarriersToBottom.clear();
+        imageMemoryBarriersToBottom.clear();
+    }
 
-        // Command buffer is allocated for one time submit.
-        commandRecorded = false;
+    if (!commandRecorded) {
+        return std::nullopt;
     }
+
+    cb.end(*device.get().getDispatcher());
+
+    // Command buffer is allocated for one time submit.
+    commandRecorded = false;
+    return cb;
 }
 
 void vkgltf::StagingBufferStorage::reset(bool beginCommandBuffer) {
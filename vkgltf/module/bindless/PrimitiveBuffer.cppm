@@ -37,8 +37,8 @@ namespace vkgltf {
      *     |                   |                            |     - UNSIGNED BYTE normalized: 9
      *  80 +                   +----------------------------+     - SHORT normalized: 10
      *     |                   |                            |     - UNSIGNED SHORT normalized: 11
-     *     |                   |     TEXCOORD_2: Accessor   |
-     *     |     Primitive     |                            |
+     *     |                   |     TEXCOORD_2: Accessor   |   +16 if the morph target accessor is sparse (see
+     *     |     Primitive     |                            |   PrimitiveAttributeBuffers::AttributeInfo::sparse).
      *  96 +                   +----------------------------+
      *     |                   |                            |
      *     |                   |     TEXCOORD_3: Accessor   |
@@ -60,8 +60,14 @@ namespace vkgltf {
      * 168 +                   +----------------------------+    |   |
      *     |                   |     Material index: u32    |    |   |
      * 172 +                   +----------------------------+    |   |
-     *     |                   |          [PADDING]         |    |   | (for make sizeof(shader_type::Primitive) % 16 == 0)
-     * 176 +-------------------+----------------------------+    |   |
+     *     |                   |          [PADDING]         |    |   |
+     * 176 +                   +----------------------------+    |   |
+     *     |                   | POSITION dequant. offset:  |    |   | position = offset + scale * (fetched POSITION),
+     *     |                   |     vec3 (+ [PADDING])     |    |   | identity if POSITION is not quantized by the
+     * 192 +                   +----------------------------+    |   | application.
+     *     |                   | POSITION dequant. scale:   |    |   |
+     *     |                   |     vec3 (+ [PADDING])     |    |   |
+     * 208 +-------------------+----------------------------+    |   |
      *     |     Primitive     |                                 |   |
      *     +-------------------+                                 |   |
      *     |        ...        |                                 |   |
@@ -288,7 +294,7 @@ vkgltf::PrimitiveBuffer::PrimitiveBuffer(
         constexpr std::uint32_t byteComponentType = getGLComponentType(fastgltf::ComponentType::Byte);
         return shader_type::Accessor {
             .bufferAddress = device.getBufferAddress({ static_cast<vk::Buffer>(*info.buffer) }) + info.offset,
-            .componentType = (info.normalized ? 8U : 0U) | (getGLComponentType(info.componentType) - byteComponentType),
+            .componentType = (info.sparse ? 16U : 0U) | (info.normalized ? 8U : 0U) | (getGLComponentType(info.componentType) - byteComponentType),
             .byteStride = static_cast<std::uint32_t>(info.stride),
         };
     };
@@ -323,6 +329,10 @@ vkgltf::PrimitiveBuffer::PrimitiveBuffer(
                 .materialIndex = std::invoke(config.materialIndexFn, *primitive),
             };
 
+            const PrimitiveAttributeBuffers::AttributeInfo &positionInfo = attributes.position.attributeInfo;
+            result.positionDequantizationOffset = { positionInfo.dequantizationOffset.x(), positionInfo.dequantizationOffset.y(), positionInfo.dequantizationOffset.z() };
+            result.positionDequantizationScale = { positionInfo.dequantizationScale.x(), positionInfo.dequantizationScale.y(), positionInfo.dequantizationScale.z() };
+
             if (attributes.normal) {
                 result.normalAccessor = toGpuAccessor(attributes.normal->attributeInfo);
                 result.normalMorphTargetAccessorBufferDeviceAddress = emplaceAccessors(attributes.normal->morphTargets);
@@ -23,6 +23,10 @@ namespace vkgltf::shader_type {
         vk::DeviceAddress weightAccessorBufferDeviceAddress;
         std::int32_t materialIndex;
         char _padding[4];
+        std::array<float, 3> positionDequantizationOffset;
+        char _padding2[4];
+        std::array<float, 3> positionDequantizationScale;
+        char _padding3[4];
     };
 }
 
@@ -30,7 +34,7 @@ namespace vkgltf::shader_type {
 module :private;
 #endif
 
-static_assert(sizeof(vkgltf::shader_type::Primitive) == 176);
+static_assert(sizeof(vkgltf::shader_type::Primitive) == 208);
 ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, positionAccessor);
 ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, normalAccessor);
 ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, tangentAccessor);
@@ -42,4 +46,6 @@ ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, normalMorphTargetAccessorBuffer
 ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, tangentMorphTargetAccessorBufferDeviceAddress);
 ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, jointAccessorBufferDeviceAddress);
 ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, weightAccessorBufferDeviceAddress);
-ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, materialIndex);
\ No newline at end of file
+ASSERT_ALIGNMENT(vkgltf::shader_type::Primitive, materialIndex);
+static_assert(offsetof(vkgltf::shader_type::Primitive, positionDequantizationOffset) % 16 == 0);
+static_assert(offsetof(vkgltf::shader_type::Primitive, positionDequantizationScale) % 16 == 0);
\ No newline at end of file
@@ -13,30 +13,34 @@ export template <typename T, typename... Ts>
 concept one_of = (std::same_as<T, Ts> || ...);
 
 namespace vkgltf {
-    template <typename T, typename BufferDataAdapter>
+    /**
+     * @brief Prefetched vertex data of a primitive for the tangent generation.
+     *
+     * Attributes are decoded into the flat arrays once, and indices are resolved per face corner, therefore the
+     * tangent generation callbacks only do the array lookups, instead of decoding the accessor element every time
+     * (MikkTSpace calls them many times per face).
+     */
+    template <typename T>
     struct PrimitiveInfo {
-        const fastgltf::Asset &asset;
+        std::vector<fastgltf::math::fvec3> positions;
+        std::vector<fastgltf::math::fvec3> normals;
+        std::vector<fastgltf::math::fvec2> texcoords;
 
-        const fastgltf::Accessor &positionAccessor;
-        const fastgltf::Accessor &normalAccessor;
-        const fastgltf::Accessor &texcoordAccessor;
-        const fastgltf::Accessor &indicesAccessor;
+        /// Vertex indices of the face corners, i.e. <tt>cornerIndices[3 * iFace + iVert]</tt> is the index of the
+        /// <tt>iVert</tt>-th vertex of the <tt>iFace</tt>-th face.
+        std::vector<std::uint32_t> cornerIndices;
 
-        fastgltf::PrimitiveType type;
         int faceCount;
 
         std::vector<fastgltf::math::vec<T, 4>> tangents;
 
-        const BufferDataAdapter &adapter;
+        template <typename BufferDataAdapter>
+        PrimitiveInfo(const fastgltf::Asset &asset, const fastgltf::Primitive &primitive, const BufferDataAdapter &adapter) {
+            const fastgltf::Accessor &positionAccessor = asset.accessors[primitive.findAttribute("POSITION")->accessorIndex];
+            const fastgltf::Accessor &normalAccessor = asset.accessors[primitive.findAttribute("NORMAL")->accessorIndex];
+            const fastgltf::Accessor &texcoordAccessor = asset.accessors[primitive.findAttribute(std::format("TEXCOORD_{}", utils::getTexcoordIndex(asset.materials[*primitive.materialIndex].normalTexture.value())))->accessorIndex];
+            const fastgltf::Accessor &indicesAccessor = asset.accessors[primitive.indicesAccessor.value()];
 
-        PrimitiveInfo(const fastgltf::Asset &asset, const fastgltf::Primitive &primitive, const BufferDataAdapter &adapter)
-            : asset { asset }
-            , positionAccessor { asset.accessors[primitive.findAttribute("POSITION")->accessorIndex] }
-            , normalAccessor { asset.accessors[primitive.findAttribute("NORMAL")->accessorIndex] }
-            , texcoordAccessor { asset.accessors[primitive.findAttribute(std::format("TEXCOORD_{}", utils::getTexcoordIndex(asset.materials[*primitive.materialIndex].normalTexture.value())))->accessorIndex] }
-            , indicesAccessor { asset.accessors[primitive.indicesAccessor.value()] }
-            , type { primitive.type }
-            , adapter { adapter } {
             switch (primitive.type) {
                 case fastgltf::PrimitiveType::Triangles:
                     faceCount = indicesAccessor.count / 3;
@@ -48,24 +52,74 @@ namespace vkgltf {
                 default:
                     throw std::runtime_error { "Non-triangle topology is unsupported" };
             }
+
+            positions.resize(positionAccessor.count);
+            fastgltf::copyFromAccessor<fastgltf::math::fvec3>(asset, positionAccessor, positions.data(), adapter);
+
+            normals.resize(normalAccessor.count);
+            fastgltf::copyFromAccessor<fastgltf::math::fvec3>(asset, normalAccessor, normals.data(), adapter);
+
+            texcoords.resize(texcoordAccessor.count);
+            fastgltf::copyFromAccessor<fastgltf::math::fvec2>(asset, texcoordAccessor, texcoords.data(), adapter);
+
+            std::vector<std::uint32_t> indices(indicesAccessor.count);
+            fastgltf::copyFromAccessor<std::uint32_t>(asset, indicesAccessor, indices.data(), adapter);
+            if (primitive.type == fastgltf::PrimitiveType::Triangles) {
+                indices.resize(3 * faceCount);
+                cornerIndices = std::move(indices);
+            }
+            else {
+                cornerIndices.reserve(3 * faceCount);
+                for (int iFace = 0; iFace < faceCount; ++iFace) {
+                    if (primitive.type == fastgltf::PrimitiveType::TriangleStrip) {
+                        cornerIndices.append_range(std::array { indices[iFace], indices[iFace + 1], indices[iFace + 2] });
+                    }
+                    else {
+                        cornerIndices.append_range(std::array { indices[0], indices[iFace + 1], indices[iFace + 2] });
+                    }
+                }
+            }
+
             tangents.resize(positionAccessor.count);
         }
 
-        [[nodiscard]] std::size_t getFetchIndex(int iFace, int iVert) const noexcept {
-            switch (type) {
-                case fastgltf::PrimitiveType::Triangles:
-                    return 3 * iFace + iVert;
-                case fastgltf::PrimitiveType::TriangleStrip:
-                    return iFace + iVert;
-                case fastgltf::PrimitiveType::TriangleFan:
-                    return (iVert == 0 ? 0 : iFace) + iVert;
-                default:
-                    std::unreachable();
-            }
+        [[nodiscard]] std::uint32_t getIndex(int iFace, int iVert) const noexcept {
+            return cornerIndices[3 * iFace + iVert];
         }
 
-        [[nodiscard]] int getIndex(int iFace, int iVert) const noexcept {
-            return fastgltf::getAccessorElement<int>(asset, indicesAccessor, getFetchIndex(iFace, iVert), adapter);
+        void setTangent(std::uint32_t index, const fastgltf::math::fvec3 &t, float sign) noexcept {
+            fastgltf::math::vec<T, 4> &tangent = tangents[index];
+            if constexpr (std::signed_integral<T>) {
+                // KHR_mesh_quantization:
+                //   When KHR_mesh_quantization extension is supported, the following extra types are allowed for
+                //   storing mesh attributes in addition to the types defined in Section 3.7.2.1.
+                //   ...
+                //   TANGENT: byte normalized, short normalized
+                //   https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md#extending-mesh-attributes
+                //   ...
+                //   Implementations should assume following equations are used to get corresponding floating-point
+                //   value f from a normalized integer c and should use the specified equations to encode
+                //   floating-point values to integers after range normalization:
+                //
+                //   | accessor.componentType |        int-to-float        |      float-to-int      |
+                //   |------------------------|----------------------------|------------------------|
+                //   | 5120 (BYTE)            | f = max(c / 127.0, -1.0)   | c = round(f * 127.0)   |
+                //   | 5121 (UNSIGNED_BYTE)   | f = c / 255.0              | c = round(f * 255.0)   |
+                //   | 5122 (SHORT)           | f = max(c / 32767.0, -1.0) | c = round(f * 32767.0) |
+                //   | 5123 (UNSIGNED_SHORT)  | f = c / 65535.0            | c = round(f * 65535.0) |
+                //   https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md#encoding-quantized-data
+                constexpr T max = std::numeric_limits<T>::max();
+                tangent.x() = static_cast<T>(t.x() * max);
+                tangent.y() = static_cast<T>(t.y() * max);
+                tangent.z() = static_cast<T>(t.z() * max);
+                tangent.w() = static_cast<T>(sign * max);
+            }
+            else {
+                tangent.x() = t.x();
+                tangent.y() = t.y();
+                tangent.z() = t.z();
+                tangent.w() = sign;
+            }
         }
     };
 
@@ -80,67 +134,28 @@ namespace vkgltf {
      */
     export template <one_of<float, std::int16_t, std::int8_t> T, typename BufferDataAdapter = fastgltf::DefaultBufferDataAdapter>
     [[nodiscard]] std::vector<fastgltf::math::vec<T, 4>> createMikkTSpaceTangents(const fastgltf::Asset &asset, const fastgltf::Primitive &primitive, const BufferDataAdapter &adapter = {}) {
-        PrimitiveInfo<T, BufferDataAdapter> info { asset, primitive, adapter };
+        PrimitiveInfo<T> info { asset, primitive, adapter };
 
         SMikkTSpaceInterface interface {
             .m_getNumFaces = [](const SMikkTSpaceContext *pContext) noexcept {
-                return static_cast<const PrimitiveInfo<T, BufferDataAdapter>*>(pContext->m_pUserData)->faceCount;
+                return static_cast<const PrimitiveInfo<T>*>(pContext->m_pUserData)->faceCount;
             },
             .m_getNumVerticesOfFace = [](const SMikkTSpaceContext*, int) noexcept { return 3; },
-            .m_getPosition = [](const SMikkTSpaceContext *pContext, float fvPosOut[], int iFace, int iVert) {
-                const PrimitiveInfo<T, BufferDataAdapter> &info = *static_cast<const PrimitiveInfo<T, BufferDataAdapter>*>(pContext->m_pUserData);
-                const auto v = getAccessorElement<fastgltf::math::fvec3>(info.asset, info.positionAccessor, info.getIndex(iFace, iVert), info.adapter);
-                fvPosOut[0] = v.x();
-                fvPosOut[1] = v.y();
-                fvPosOut[2] = v.z();
+            .m_getPosition = [](const SMikkTSpaceContext *pContext, float fvPosOut[], int iFace, int iVert) noexcept {
+                const PrimitiveInfo<T> &info = *static_cast<const PrimitiveInfo<T>*>(pContext->m_pUserData);
+                std::ranges::copy_n(info.positions[info.getIndex(iFace, iVert)].data(), 3, fvPosOut);
             },
-            .m_getNormal = [](const SMikkTSpaceContext *pContext, float fvNormOut[], int iFace, int iVert) {
-                const PrimitiveInfo<T, BufferDataAdapter> &info = *static_cast<const PrimitiveInfo<T, BufferDataAdapter>*>(pContext->m_pUserData);
-                const auto v = getAccessorElement<fastgltf::math::fvec3>(info.asset, info.normalAccessor, info.getIndex(iFace, iVert), info.adapter);
-                fvNormOut[0] = v.x();
-                fvNormOut[1] = v.y();
-                fvNormOut[2] = v.z();
+            .m_getNormal = [](const SMikkTSpaceContext *pContext, float fvNormOut[], int iFace, int iVert) noexcept {
+                const PrimitiveInfo<T> &info = *static_cast<const PrimitiveInfo<T>*>(pContext->m_pUserData);
+                std::ranges::copy_n(info.normals[info.getIndex(iFace, iVert)].data(), 3, fvNormOut);
             },
-            .m_getTexCoord = [](const SMikkTSpaceContext *pContext, float fvTexcOut[], int iFace, int iVert) {
-                const PrimitiveInfo<T, BufferDataAdapter> &info = *static_cast<const PrimitiveInfo<T, BufferDataAdapter>*>(pContext->m_pUserData);
-                const auto v = getAccessorElement<fastgltf::math::fvec2>(info.asset, info.texcoordAccessor, info.getIndex(iFace, iVert), info.adapter);
-                fvTexcOut[0] = v.x();
-                fvTexcOut[1] = v.y();
+            .m_getTexCoord = [](const SMikkTSpaceContext *pContext, float fvTexcOut[], int iFace, int iVert) noexcept {
+                const PrimitiveInfo<T> &info = *static_cast<const PrimitiveInfo<T>*>(pContext->m_pUserData);
+                std::ranges::copy_n(info.texcoords[info.getIndex(iFace, iVert)].data(), 2, fvTexcOut);
             },
-            .m_setTSpaceBasic = [](const SMikkTSpaceContext *pContext, const float *fvTangent, float fSign, int iFace, int iVert) {
-                PrimitiveInfo<T, BufferDataAdapter> &info = *static_cast<PrimitiveInfo<T, BufferDataAdapter>*>(pContext->m_pUserData);
-                fastgltf::math::vec<T, 4> &tangent = info.tangents[info.getIndex(iFace, iVert)];
-                if constexpr (std::signed_integral<T>) {
-                    // KHR_mesh_quantization:
-                    //   When KHR_mesh_quantization extension is supported, the following extra types are allowed for
-                    //   storing mesh attributes in addition to the types defined in Section 3.7.2.1.
-                    //   ...
-                    //   TANGENT: byte normalized, short normalized
-                    //   https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md#extending-mesh-attributes
-                    //   ...
-                    //   Implementations should assume following equations are used to get corresponding floating-point
-                    //   value f from a normalized integer c and should use the specified equations to encode
-                    //   floating-point values to integers after range normalization:
-                    //
-                    //   | accessor.componentType |        int-to-float        |      float-to-int      |
-                    //   |------------------------|----------------------------|------------------------|
-                    //   | 5120 (BYTE)            | f = max(c / 127.0, -1.0)   | c = round(f * 127.0)   |
-                    //   | 5121 (UNSIGNED_BYTE)   | f = c / 255.0              | c = round(f * 255.0)   |
-                    //   | 5122 (SHORT)           | f = max(c / 32767.0, -1.0) | c = round(f * 32767.0) |
-                    //   | 5123 (UNSIGNED_SHORT)  | f = c / 65535.0            | c = round(f * 65535.0) |
-                    //   https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md#encoding-quantized-data
-                    constexpr T max = std::numeric_limits<T>::max();
-                    tangent.x() = static_cast<T>(fvTangent[0] * max);
-                    tangent.y() = static_cast<T>(fvTangent[1] * max);
-                    tangent.z() = static_cast<T>(fvTangent[2] * max);
-                    tangent.w() = static_cast<T>(fSign * max);
-                }
-                else {
-                    tangent.x() = fvTangent[0];
-                    tangent.y() = fvTangent[1];
-                    tangent.z() = fvTangent[2];
-                    tangent.w() = fSign;
-                }
+            .m_setTSpaceBasic = [](const SMikkTSpaceContext *pContext, const float *fvTangent, float fSign, int iFace, int iVert) noexcept {
+                PrimitiveInfo<T> &info = *static_cast<PrimitiveInfo<T>*>(pContext->m_pUserData);
+                info.setTangent(info.getIndex(iFace, iVert), { fvTangent[0], fvTangent[1], fvTangent[2] }, fSign);
             },
         };
 
@@ -152,4 +167,75 @@ namespace vkgltf {
         return std::move(info.tangents);
     }
 
-}
\ No newline at end of file
+    /**
+     * @brief Create the per-vertex tangents by accumulating the texture space derivatives of the adjacent triangles,
+     * without the vertex welding and splitting of MikkTSpace.
+     *
+     * It is much faster than <tt>createMikkTSpaceTangents</tt> (a single pass over the faces and vertices), but the
+     * result is not MikkTSpace compliant: baked normal maps may show the seams at the mirrored texture coordinates or
+     * the vertices shared by the faces of the different handedness. Therefore it is only intended for the previews.
+     *
+     * @tparam T Component type of the tangent vector. Can be <tt>float</tt>, <tt>std::int16_t</tt>, or <tt>std::int8_t</tt>.
+     * @tparam BufferDataAdapter A functor type that return the bytes span from a glTF buffer view.
+     * @param asset glTF asset that owns \p primitive.
+     * @param primitive Primitive to create tangents for. Same requirements as <tt>createMikkTSpaceTangents</tt>.
+     * @param adapter Buffer data adapter.
+     * @return Vector of tangents, with the same layout as <tt>createMikkTSpaceTangents</tt>.
+     */
+    export template <one_of<float, std::int16_t, std::int8_t> T, typename BufferDataAdapter = fastgltf::DefaultBufferDataAdapter>
+    [[nodiscard]] std::vector<fastgltf::math::vec<T, 4>> createFastTangents(const fastgltf::Asset &asset, const fastgltf::Primitive &primitive, const BufferDataAdapter &adapter = {}) {
+        PrimitiveInfo<T> info { asset, primitive, adapter };
+
+        std::vector<fastgltf::math::fvec3> accumulatedTangents(info.positions.size());
+        std::vector<fastgltf::math::fvec3> accumulatedBitangents(info.positions.size());
+        for (int iFace = 0; iFace < info.faceCount; ++iFace) {
+            const std::uint32_t i0 = info.getIndex(iFace, 0), i1 = info.getIndex(iFace, 1), i2 = info.getIndex(iFace, 2);
+            const fastgltf::math::fvec3 e1 = info.positions[i1] - info.positions[i0];
+            const fastgltf::math::fvec3 e2 = info.positions[i2] - info.positions[i0];
+            const fastgltf::math::fvec2 duv1 = info.texcoords[i1] - info.texcoords[i0];
+            const fastgltf::math::fvec2 duv2 = info.texcoords[i2] - info.texcoords[i0];
+
+            // Determinant is compared relative to the UV edge lengths, as it is their product times the sine of the
+            // angle between them. Faces with the small but valid UV extent (e.g. a texture atlas) must not be skipped.
+            const float determinant = duv1.x() * duv2.y() - duv2.x() * duv1.y();
+            if (!(std::abs(determinant) > std::numeric_limits<float>::epsilon() * length(duv1) * length(duv2))) {
+                // Degenerated or non-finite texture coordinates.
+                continue;
+            }
+
+            const fastgltf::math::fvec3 tangent = (e1 * duv2.y() - e2 * duv1.y()) / determinant;
+            const fastgltf::math::fvec3 bitangent = (e2 * duv1.x() - e1 * duv2.x()) / determinant;
+            for (std::uint32_t index : { i0, i1, i2 }) {
+                accumulatedTangents[index] = accumulatedTangents[index] + tangent;
+                accumulatedBitangents[index] = accumulatedBitangents[index] + bitangent;
+            }
+        }
+
+        for (std::uint32_t index = 0; index < info.positions.size(); ++index) {
+            const fastgltf::math::fvec3 &normal = info.normals[index];
+
+            // Gram-Schmidt orthogonalization.
+            fastgltf::math::fvec3 tangent = accumulatedTangents[index] - normal * dot(normal, accumulatedTangents[index]);
+            if (const float tangentLength = length(tangent); tangentLength > std::numeric_limits<float>::epsilon()) {
+                tangent = tangent / tangentLength;
+            }
+            else {
+                // No texture space derivative (e.g. unreferenced vertex). Use arbitrary vector perpendicular to the normal.
+                tangent = std::abs(normal.x()) < 0.9f ? cross(normal, fastgltf::math::fvec3 { 1.f, 0.f, 0.f }) : cross(normal, fastgltf::math::fvec3 { 0.f, 1.f, 0.f });
+                if (const float fallbackLength = length(tangent); fallbackLength > 0.f) {
+                    tangent = tangent / fallbackLength;
+                }
+                else {
+                    // Zero (or non-finite) normal does not have a perpendicular vector.
+                    tangent = { 1.f, 0.f, 0.f };
+                }
+            }
+
+            // glTF 2.0 specification: bitangent = cross(normal.xyz, tangent.xyz) * tangent.w
+            const float sign = dot(cross(normal, tangent), accumulatedBitangents[index]) < 0.f ? -1.f : 1.f;
+            info.setTangent(index, tangent, sign);
+        }
+
+        return std::move(info.tangents);
+    }
+}